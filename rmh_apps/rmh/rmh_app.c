@@ -31,9 +31,20 @@
 /***********************************************************
  * Search Functions
  ***********************************************************/
+static
+const RMHApp_API* RMHApp_FindHandlerById(const RMHApp *app, const RMH_APIId apiId) {
+    return (apiId < RMH_NUM_APIS) ? app->handlerById[apiId] : NULL;
+}
+
 static
 const RMHApp_API* RMHApp_FindHandler(const RMHApp *app, const char *apiName) {
     uint32_t i;
+    const RMH_API* api;
+    if (RMH_GetAPIByName(app->rmh, apiName, &api) == RMH_SUCCESS) {
+        return RMHApp_FindHandlerById(app, api->apiId);
+    }
+
+    /* Not an RMH API. Check the local APIs */
     for (i=0; i != app->handledAPIs.apiListSize; i++) {
         if (strcasecmp(app->handledAPIs.apiList[i].apiName, apiName) == 0) {
             return &app->handledAPIs.apiList[i];
@@ -62,10 +73,9 @@ const RMHApp_API* RMHApp_FindHandler(const RMHApp *app, const char *apiName) {
 static
 const RMH_API* RMHApp_FindAPI(const RMHApp *app, const char *apiName) {
     uint32_t i;
-    for (i=0; i != app->allAPIs->apiListSize; i++) {
-        if (strcasecmp(app->allAPIs->apiList[i]->apiName, apiName) == 0) {
-            return app->allAPIs->apiList[i];
-        }
+    const RMH_API* api;
+    if (RMH_GetAPIByName(app->rmh, apiName, &api) == RMH_SUCCESS) {
+        return api;
     }
 
     for (i=0; i != app->local.apiListSize; i++) {
@@ -177,7 +187,7 @@ RMH_Result RMHApp_PrintAPIHelp(RMHApp *app, const RMH_API* api) {
     bool first = true;
     char rmh_args[512];
     int rmh_args_written =0;
-    const RMHApp_API *apiHandler=RMHApp_FindHandler(app, api->apiName);
+    const RMHApp_API *apiHandler=(api->apiId < RMH_NUM_APIS) ? RMHApp_FindHandlerById(app, api->apiId) : RMHApp_FindHandler(app, api->apiName);
     rmh_args[0] = '\0';
 
     RMH_PrintMsg("****************************************\n");
@@ -239,14 +249,12 @@ RMH_Result RMHApp_PrintAPIHelp(RMHApp *app, const RMH_API* api) {
 }
 
 static
-RMH_Result RMHApp_PrintList(RMHApp *app, const RMH_APIList *list, const char *exitString) {
+RMH_Result RMHApp_PrintList(RMHApp *app, RMH_API * const *apiList, const uint32_t apiListSize, const char *exitString) {
     uint32_t i;
     RMH_PrintMsg("\n\n");
     RMH_PrintMsg("%02d. %s\n", 1, exitString);
-    if (list) {
-        for (i=0; i != list->apiListSize; i++) {
-            RMH_PrintMsg("%02d. %s\n", i+2, list->apiList[i]->apiName);
-        }
+    for (i=0; i != apiListSize; i++) {
+        RMH_PrintMsg("%02d. %s\n", i+2, apiList[i]->apiName);
     }
     return RMH_SUCCESS;
 }
@@ -261,7 +269,7 @@ RMH_Result RMHApp_PrintTagList(RMHApp *app, const RMH_APITagList *tagList) {
     RMH_PrintMsg("%02d. %s\n", 4, "RMH Local APIs");
     if (tagList) {
         for (i=0; i != tagList->tagListSize; i++) {
-            RMH_PrintMsg("%02d. %s\n", i+5, tagList->tagList[i].apiListName);
+            RMH_PrintMsg("%02d. %s\n", i+5, tagList->tagList[i].tagName);
         }
     }
     return RMH_SUCCESS;
@@ -309,20 +317,20 @@ RMH_Result RMHApp_ExecuteMonitorDriverDebug(RMHApp *app) {
 }
 
 static
-RMH_Result RMHApp_ExecuteAPIList(RMHApp *app, const RMH_APIList *list, const char *exitString) {
+RMH_Result RMHApp_ExecuteAPIs(RMHApp *app, RMH_API * const *apiList, const uint32_t apiListSize, const char *exitString) {
     uint32_t option;
     bool helpRequested = false;
 
-    RMHApp_PrintList(app, list, exitString);
+    RMHApp_PrintList(app, apiList, apiListSize, exitString);
     while(true) {
         if (RMHApp_ReadMenuOption(app, &option, true, &helpRequested) == RMH_SUCCESS) {
             if ( option > 0) {
                 if ( option == 1 ) break;
                 option-=2;
 
-                if (list && option<list->apiListSize) {
+                if (option<apiListSize) {
                     RMH_Result ret;
-                    const RMH_API* api = list->apiList[option];
+                    const RMH_API* api = apiList[option];
                     if (app->argHelpRequested || helpRequested) {
                         RMHApp_PrintAPIHelp(app, api);
                         continue;
@@ -332,7 +340,7 @@ RMH_Result RMHApp_ExecuteAPIList(RMHApp *app, const RMH_APIList *list, const cha
                     RMH_PrintMsg("|----------------------------------------------------------------------------\n");
                     app->appPrefix="|  ";
 
-                    const RMHApp_API *apiHandler=RMHApp_FindHandler(app, api->apiName);
+                    const RMHApp_API *apiHandler=(api->apiId < RMH_NUM_APIS) ? RMHApp_FindHandlerById(app, api->apiId) : RMHApp_FindHandler(app, api->apiName);
                     if (apiHandler == NULL) {
                         RMH_PrintErr("The RMH library supports '%s' however it has not been exposed in RMH!\n", api->apiName);
                         RMH_PrintErr("Please add a handler function for this API in the rmh test by using SET_API_HANDLER()\n");
@@ -351,12 +359,17 @@ RMH_Result RMHApp_ExecuteAPIList(RMHApp *app, const RMH_APIList *list, const cha
             }
             RMH_PrintErr("Invalid selection\n");
         }
-        RMHApp_PrintList(app, list, exitString);
+        RMHApp_PrintList(app, apiList, apiListSize, exitString);
 
     }
     return RMH_SUCCESS;
 }
 
+static
+RMH_Result RMHApp_ExecuteAPIList(RMHApp *app, const RMH_APIList *list, const char *exitString) {
+    return RMHApp_ExecuteAPIs(app, list ? list->apiList : NULL, list ? list->apiListSize : 0, exitString);
+}
+
 static
 RMH_Result RMHApp_ExecuteCommand(RMHApp *app) {
     const RMH_API* api;
@@ -420,7 +433,7 @@ RMH_Result RMHApp_ExecuteTagList(RMHApp *app, const RMH_APITagList *tagList) {
                 else {
                     option-=5;
                     if (tagList && option < tagList->tagListSize) {
-                        RMHApp_ExecuteAPIList(app, &tagList->tagList[option], "Go back");
+                        RMHApp_ExecuteAPIs(app, tagList->tagList[option].apiList, tagList->tagList[option].apiListSize, "Go back");
                     }
                 }
             }
@@ -444,6 +457,9 @@ void RMHApp_EventCallback(const enum RMH_Event event, const struct RMH_EventData
     case RMH_EVENT_MOCA_VERSION_CHANGED:
         RMH_PrintMsg("\n%p: MoCA Version Changed to %s\n", userContext, RMH_MoCAVersionToString(eventData->RMH_EVENT_MOCA_VERSION_CHANGED.version));
         break;
+    case RMH_EVENT_INTERFACE_STATUS_CHANGED:
+        RMH_PrintMsg("\n%p: MoCA interface is now %s\n", userContext, eventData->RMH_EVENT_INTERFACE_STATUS_CHANGED.enabled ? "enabled" : "disabled");
+        break;
     case RMH_EVENT_API_PRINT:
         RMH_PrintMsg("%s", eventData->RMH_EVENT_API_PRINT.logMsg);
         break;
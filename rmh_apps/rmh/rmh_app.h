@@ -37,6 +37,7 @@
 struct RMHApp;
 typedef struct RMHApp_API {
     const char* apiName;
+    RMH_APIId apiId;
     const char* apiAlias;
     RMH_Result (*apiFunc)();
     const RMH_Result (*apiHandlerFunc)(const struct RMHApp *app, void *api);
@@ -67,6 +68,7 @@ typedef struct RMHApp {
     RMH_APITagList* rmhAPITags;
 
     RMHApp_List handledAPIs;
+    const RMHApp_API* handlerById[RMH_NUM_APIS];
     RMH_APIList local;
 } RMHApp;
 
@@ -23,6 +23,7 @@
 
 #define RDK_FILE_PATH_PREVENT_MOCA_START        "/opt/sysproperties/mocakillswitchenable"
 #define RDK_FILE_PATH_PREVENT_MOCA_START2       "/opt/mocakillswitchenable"
+#define RMHAPP_STATS_RATE_INTERVAL_SEC          1
 
 #undef AS
 #define AS(x,y) #x,
@@ -164,6 +165,95 @@ RMH_Result RMHApp_Start(const RMHApp *app) {
     return ret;
 }
 
+RMH_Result RMHApp_Perf(const RMHApp *app) {
+    RMH_APIStats stats;
+    const RMH_API* api;
+    uint32_t i;
+
+    /* Run the status dumps without printing them so we have a set of calls to measure */
+    RMH_Instrumentation_Reset(app->rmh);
+    RMH_Log_PrintStatus(app->rmh, "/dev/null");
+    RMH_Log_PrintStats(app->rmh, "/dev/null");
+    RMH_Log_PrintFlows(app->rmh, "/dev/null");
+
+    RMH_PrintMsg("%-55s %8s %8s %10s %10s %10s %10s %12s %12s\n", "API", "Calls", "Errors", "Min(us)", "P50(us)", "P99(us)", "Max(us)", "Total(us)", "Self(us)");
+    for (i=0; i < RMH_NUM_APIS; i++) {
+        if (RMH_Instrumentation_GetStats(app->rmh, i, &stats) != RMH_SUCCESS || stats.numCalls == 0) continue;
+        if (RMH_GetAPIById(app->rmh, i, &api) != RMH_SUCCESS) continue;
+        RMH_PrintMsg("%-55s %8llu %8llu %10llu %10llu %10llu %10llu %12llu %12llu\n", api->apiName,
+                                                        (unsigned long long)stats.numCalls,
+                                                        (unsigned long long)(stats.numCalls - stats.numResults[RMH_SUCCESS]),
+                                                        (unsigned long long)stats.minTimeUs,
+                                                        (unsigned long long)stats.p50TimeUs,
+                                                        (unsigned long long)stats.p99TimeUs,
+                                                        (unsigned long long)stats.maxTimeUs,
+                                                        (unsigned long long)stats.totalTimeUs,
+                                                        (unsigned long long)stats.totalSelfTimeUs);
+    }
+    return RMH_SUCCESS;
+}
+
+RMH_Result RMHApp_Cache(const RMHApp *app) {
+    RMH_CacheStats stats;
+    const RMH_API* api;
+    uint32_t i;
+
+    /* Run the status dumps twice with the cache enabled so the second pass shows what it saves */
+    if (RMH_Cache_SetEnabled(app->rmh, true) != RMH_SUCCESS) {
+        RMH_PrintErr("Unable to enable the cache!\n");
+        return RMH_FAILURE;
+    }
+    for (i=0; i < 2; i++) {
+        RMH_Log_PrintStatus(app->rmh, "/dev/null");
+        RMH_Log_PrintStats(app->rmh, "/dev/null");
+        RMH_Log_PrintFlows(app->rmh, "/dev/null");
+    }
+
+    RMH_PrintMsg("%-55s %10s %10s %14s\n", "API", "Hits", "Misses", "Invalidations");
+    for (i=0; i < RMH_NUM_APIS; i++) {
+        if (RMH_Cache_GetStats(app->rmh, i, &stats) != RMH_SUCCESS) continue;
+        if (RMH_GetAPIById(app->rmh, i, &api) != RMH_SUCCESS) continue;
+        RMH_PrintMsg("%-55s %10llu %10llu %14llu\n", api->apiName, (unsigned long long)stats.numHits,
+                                                                    (unsigned long long)stats.numMisses,
+                                                                    (unsigned long long)stats.numInvalidations);
+    }
+    return RMH_SUCCESS;
+}
+
+static
+RMH_Result RMHApp_TraceDump(const RMHApp *app, const char *filename) {
+    RMH_TraceRecord *records;
+    size_t numRecords=0;
+    size_t i;
+    RMH_Result ret;
+
+    records=malloc(RMH_MAX_TRACE_RECORDS * sizeof(*records));
+    if (!records) {
+        RMH_PrintErr("Unable to allocate memory for %u trace records\n", RMH_MAX_TRACE_RECORDS);
+        return RMH_FAILURE;
+    }
+
+    ret=RMH_Trace_Dump(app->rmh, filename, records, RMH_MAX_TRACE_RECORDS, &numRecords);
+    if (ret == RMH_SUCCESS) {
+        RMH_PrintMsg("%12s %8s %6s %-55s %12s %s\n", "Time(ms)", "Thread", "Depth", "API", "Duration(us)", "Result");
+        for (i=0; i < numRecords; i++) {
+            const RMH_API* api=NULL;
+            RMH_GetAPIById(app->rmh, records[i].apiId, &api);
+            RMH_PrintMsg("%12.03f %8u %6u %*s%-*s %12.01f %s\n", (records[i].timestampNs - records[0].timestampNs)/1000000.0,
+                                                        records[i].threadId,
+                                                        records[i].depth,
+                                                        records[i].depth > 1 ? (records[i].depth-1)*2 : 0, "",
+                                                        records[i].depth > 1 ? 55-(records[i].depth-1)*2 : 55,
+                                                        api ? api->apiName : "Unknown",
+                                                        records[i].durationNs/1000.0,
+                                                        RMH_ResultToString(records[i].result));
+        }
+        RMH_PrintMsg("%u records\n", (uint32_t)numRecords);
+    }
+    free(records);
+    return ret;
+}
+
 /***********************************************************
  * Input Fuctions
  ***********************************************************/
@@ -326,6 +416,83 @@ RMH_Result RMHApp_ReadString(RMHApp *app, char *buf, const uint32_t bufSize) {
     return RMH_FAILURE;
 }
 
+RMH_Result RMHApp_Trace(RMHApp *app) {
+    char input[256];
+    const char *filename=NULL;
+
+    if (!ReadLine("Enter 'on', 'off' or 'dump [file]': ", app, input, sizeof(input))) {
+        RMH_PrintErr("Bad input. Please provide 'on', 'off' or 'dump [file]'.\n");
+        return RMH_FAILURE;
+    }
+
+    if (strcasecmp(input, "on") == 0) {
+        return RMH_Trace_SetEnabled(app->rmh, true);
+    }
+    else if (strcasecmp(input, "off") == 0) {
+        return RMH_Trace_SetEnabled(app->rmh, false);
+    }
+    else if (strncasecmp(input, "dump", 4) == 0 && (input[4] == '\0' || input[4] == ' ')) {
+        /* The file can follow on the same line when interactive or be the next argument on the command line */
+        filename=&input[4];
+        while (*filename == ' ') filename++;
+        if (*filename == '\0') {
+            filename=app->argRunCommand ? RMHApp_ReadNextArg(app) : NULL;
+        }
+        return RMHApp_TraceDump(app, filename);
+    }
+
+    RMH_PrintErr("Unknown trace command '%s'. Please provide 'on', 'off' or 'dump [file]'.\n", input);
+    return RMH_INVALID_PARAM;
+}
+
+static
+void RMHApp_PrintStatsExtended(const RMHApp *app, const RMH_StatsExtended *stats) {
+    uint32_t i;
+
+    RMH_PrintMsg("%-35s %20s %16s\n", "Counter", "Total", "Rate(/s)");
+    for (i=0; i < RMH_STATS_NUM_COUNTERS; i++) {
+        if (stats->valid & (1u << i)) {
+            RMH_PrintMsg("%-35s %20llu %16.01f%s\n", RMH_StatsCounterToString(i), (unsigned long long)stats->total[i], stats->rate[i],
+                                                    (i == RMH_STATS_TX_TOTAL_BYTES || i == RMH_STATS_RX_TOTAL_BYTES) ? " bps" : "");
+        }
+    }
+    for (i=0; i < RMH_MAX_MOCA_NODES; i++) {
+        if (stats->nodePresent[i]) {
+            RMH_PrintMsg("NodeId:%02u -- RxPackets:%llu (%.01f/s) TxPackets:%llu (%.01f/s)\n", i,
+                                                    (unsigned long long)stats->nodeRxPackets[i], stats->nodeRxPacketsPerSec[i],
+                                                    (unsigned long long)stats->nodeTxPackets[i], stats->nodeTxPacketsPerSec[i]);
+        }
+    }
+    RMH_PrintMsg("Rates measured over %ums. Counter resets seen:%u\n", stats->rateWindowMs, stats->numCounterResets);
+}
+
+RMH_Result RMHApp_Stats(RMHApp *app) {
+    RMH_StatsExtended stats;
+    const char *option;
+    RMH_Result ret;
+
+    /* Only taken from the command line so running 'stats' interactively doesn't wait for input */
+    option=app->argRunCommand ? RMHApp_ReadNextArg(app) : NULL;
+    if (!option) {
+        return RMH_Log_PrintStats(app->rmh, NULL);
+    }
+    if (strcmp(option, "--rates") != 0) {
+        RMH_PrintErr("Unknown stats option '%s'. Please provide '--rates' or nothing.\n", option);
+        return RMH_INVALID_PARAM;
+    }
+
+    /* This is the first sample of the handle so take a second one to measure the rates over */
+    ret=RMH_Stats_GetExtended(app->rmh, &stats);
+    if (ret == RMH_SUCCESS) {
+        sleep(RMHAPP_STATS_RATE_INTERVAL_SEC);
+        ret=RMH_Stats_GetExtended(app->rmh, &stats);
+    }
+    if (ret == RMH_SUCCESS) {
+        RMHApp_PrintStatsExtended(app, &stats);
+    }
+    return ret;
+}
+
 static
 RMH_Result RMHApp_ReadACAType(RMHApp *app, RMH_ACAType *value) {
     char input[32];
@@ -817,6 +984,45 @@ RMH_Result RMHApp__OUT_UINT32_NODEMESH(RMHApp *app, RMH_Result (*api)(const RMH_
     return ret;
 }
 
+static
+RMH_Result RMHApp__OUT_NETWORK_SNAPSHOT(RMHApp *app, RMH_Result (*api)(const RMH_Handle handle, RMH_NetworkSnapshot* response)) {
+    RMH_NetworkSnapshot response;
+    char macStr[24];
+    uint32_t i;
+
+    RMH_Result ret = api(app->rmh, &response);
+    if (ret == RMH_SUCCESS) {
+        RMH_PrintMsg("Enabled:%s LinkStatus:%s MAC:%s LOF:%u\n", response.selfEnabled ? "TRUE" : "FALSE",
+                                  (response.selfValid & RMH_SELF_SNAPSHOT_LINK_STATUS) ? RMH_LinkStatusToString(response.linkStatus) : "-",
+                                  (response.selfValid & RMH_SELF_SNAPSHOT_MAC) ? RMH_MacToString(response.mac, macStr, sizeof(macStr)) : "-",
+                                  response.lof);
+        if (response.networkValid) {
+            RMH_PrintMsg("Nodes:%u NodeId:%u NC:%u BackupNC:%u MoCA:%s Uptime:%us Freq:%u Tx:%u Rx:%u RxErrors:%u\n", response.numNodes,
+                                  response.nodeId, response.ncNodeId, response.backupNCNodeId, RMH_MoCAVersionToString(response.mocaVersion),
+                                  response.linkUptime, response.rfChannelFreq, response.txTotalPackets, response.rxTotalPackets,
+                                  response.rxTotalErrors);
+        }
+        for (i = 0; i < response.numRemoteNodes; i++) {
+            const RMH_NodeSnapshot *node=&response.remoteNodes[i];
+            RMH_PrintMsg("NodeId:%02u -- MAC:%s MoCA:%s TxPhy:%u RxPackets:%u TxPackets:%u RxErrors:%u RxPower:%.02f SNR:%.02f\n", node->nodeId,
+                                  (node->valid & RMH_NODE_SNAPSHOT_MAC) ? RMH_MacToString(node->mac, macStr, sizeof(macStr)) : "-",
+                                  RMH_MoCAVersionToString(node->highestSupportedMoCAVersion), node->txUnicastPhyRate, node->rxPackets,
+                                  node->txPackets, node->rxTotalErrors, node->rxUnicastPower, node->rxSNR);
+        }
+    }
+    return ret;
+}
+
+static
+RMH_Result RMHApp__OUT_STATS_EXTENDED(RMHApp *app, RMH_Result (*api)(const RMH_Handle handle, RMH_StatsExtended* response)) {
+    RMH_StatsExtended response;
+    RMH_Result ret = api(app->rmh, &response);
+    if (ret == RMH_SUCCESS) {
+        RMHApp_PrintStatsExtended(app, &response);
+    }
+    return ret;
+}
+
 static
 RMH_Result RMHApp__IN_BOOL (RMHApp *app, RMH_Result (*api)(const RMH_Handle handle, const bool value)) {
     bool value;
@@ -923,6 +1129,11 @@ RMH_Result RMHApp__LOCAL_HANDLE_ONLY(const RMHApp *app, RMH_Result (*api)(const
     return api(app);
 }
 
+static
+RMH_Result RMHApp__LOCAL_WITH_ARGS(RMHApp *app, RMH_Result (*api)(RMHApp* app)) {
+    return api(app);
+}
+
 static
 RMH_Result RMHApp__GET_TABOO(RMHApp *app, RMH_Result (*api)(const RMH_Handle handle, uint32_t* start, uint32_t* mask)) {
     uint32_t start=0;
@@ -1137,22 +1348,30 @@ RMH_Result RMHApp__OUT_MODULATION(RMHApp *app, RMH_Result (*api)(const RMH_Handl
  * Registration Functions
  ***********************************************************/
 #define SET_LOCAL_API_HANDLER(HANDLER_FUNCTION, API_FUNCTION, ALIAS_STRING, DESCRIPTION_STR) \
-    static RMH_API pRMH_API_##API_FUNCTION = { #API_FUNCTION, false, false, NULL, NULL, DESCRIPTION_STR, NULL, 0, NULL }; \
+    static RMH_API pRMH_API_##API_FUNCTION = { #API_FUNCTION, false, false, NULL, NULL, DESCRIPTION_STR, NULL, 0, NULL, RMH_NUM_APIS }; \
     if (app->local.apiListSize < RMH_MAX_NUM_APIS) app->local.apiList[app->local.apiListSize++]=&pRMH_API_##API_FUNCTION; \
-    SET_API_HANDLER(HANDLER_FUNCTION, API_FUNCTION, ALIAS_STRING);
+    __SET_API_HANDLER(HANDLER_FUNCTION, API_FUNCTION, RMH_NUM_APIS, ALIAS_STRING);
 
-#define SET_API_HANDLER(HANDLER_FUNCTION, API_FUNCTION, ALIAS_STRING) { \
+#define SET_API_HANDLER(HANDLER_FUNCTION, API_FUNCTION, ALIAS_STRING) \
+    __SET_API_HANDLER(HANDLER_FUNCTION, API_FUNCTION, RMH_API_ID__##API_FUNCTION, ALIAS_STRING)
+
+#define __SET_API_HANDLER(HANDLER_FUNCTION, API_FUNCTION, API_ID, ALIAS_STRING) { \
     while(0) HANDLER_FUNCTION(NULL, API_FUNCTION); \
-    RMHApp_AddAPI(app, #API_FUNCTION, API_FUNCTION, HANDLER_FUNCTION, ALIAS_STRING); \
+    RMHApp_AddAPI(app, #API_FUNCTION, API_ID, API_FUNCTION, HANDLER_FUNCTION, ALIAS_STRING); \
 }
 
 static
-void RMHApp_AddAPI(RMHApp* app, const char* apiName, const void *apiFunc, const void *apiHandlerFunc, const char* apiAlias) {
-    memset(&app->handledAPIs.apiList[app->handledAPIs.apiListSize], 0, sizeof(app->handledAPIs.apiList[app->handledAPIs.apiListSize]));
-    app->handledAPIs.apiList[app->handledAPIs.apiListSize].apiName = apiName;
-    app->handledAPIs.apiList[app->handledAPIs.apiListSize].apiAlias = (apiAlias && apiAlias[0] != '\0' ) ? apiAlias : NULL;
-    app->handledAPIs.apiList[app->handledAPIs.apiListSize].apiFunc = apiFunc;
-    app->handledAPIs.apiList[app->handledAPIs.apiListSize].apiHandlerFunc = apiHandlerFunc;
+void RMHApp_AddAPI(RMHApp* app, const char* apiName, const RMH_APIId apiId, const void *apiFunc, const void *apiHandlerFunc, const char* apiAlias) {
+    RMHApp_API* handler=&app->handledAPIs.apiList[app->handledAPIs.apiListSize];
+    memset(handler, 0, sizeof(*handler));
+    handler->apiName = apiName;
+    handler->apiId = apiId;
+    handler->apiAlias = (apiAlias && apiAlias[0] != '\0' ) ? apiAlias : NULL;
+    handler->apiFunc = apiFunc;
+    handler->apiHandlerFunc = apiHandlerFunc;
+    if (apiId < RMH_NUM_APIS) {
+        app->handlerById[apiId] = handler;
+    }
     app->handledAPIs.apiListSize++;
 }
 
@@ -1187,6 +1406,7 @@ void RMHApp_RegisterAPIHandlers(RMHApp *app) {
     SET_API_HANDLER(RMHApp__HANDLE_ONLY,                        RMH_Self_RestoreDefaultSettings,                        "");
     SET_API_HANDLER(RMHApp__HANDLE_ONLY,                        RMH_Self_RestoreRDKDefaultSettings,                     "");
     SET_API_HANDLER(RMHApp__OUT_LINK_STATUS,                    RMH_Self_GetLinkStatus,                                 "");
+    SET_API_HANDLER(RMHApp__OUT_LINK_STATUS,                    RMH_Self_RefreshLinkStatus,                             "");
     SET_API_HANDLER(RMHApp__OUT_BOOL,                           RMH_Self_GetQAM256Enabled,                              "");
     SET_API_HANDLER(RMHApp__OUT_BAND,                           RMH_Self_GetSupportedBand,                              "");
     SET_API_HANDLER(RMHApp__IN_BOOL,                            RMH_Self_SetQAM256Enabled,                              "");
@@ -1267,6 +1487,9 @@ void RMHApp_RegisterAPIHandlers(RMHApp *app) {
     SET_API_HANDLER(RMHApp__OUT_UINT32_ARRAY,                   RMH_Stats_GetRxPacketAggregation,                       "");
     SET_API_HANDLER(RMHApp__OUT_UINT32_ARRAY,                   RMH_Stats_GetTxPacketAggregation,                       "");
     SET_API_HANDLER(RMHApp__HANDLE_ONLY,                        RMH_Stats_Reset,                                        "");
+    SET_API_HANDLER(RMHApp__OUT_STATS_EXTENDED,                 RMH_Stats_GetExtended,                                  "");
+    SET_API_HANDLER(RMHApp__IN_UINT32,                          RMH_Stats_SetRateWindow,                                "");
+    SET_API_HANDLER(RMHApp__OUT_UINT32,                         RMH_Stats_GetRateWindow,                                "");
 
     SET_API_HANDLER(RMHApp__OUT_UINT32,                         RMH_PQOS_GetMaxIngressFlows,                            "");
     SET_API_HANDLER(RMHApp__OUT_UINT32,                         RMH_PQOS_GetMaxEgressFlows,                             "");
@@ -1300,6 +1523,7 @@ void RMHApp_RegisterAPIHandlers(RMHApp *app) {
     SET_API_HANDLER(RMHApp__OUT_UINT32_NODELIST,                RMH_Network_GetNodeIds,                                 "");
     SET_API_HANDLER(RMHApp__OUT_UINT32_NODELIST,                RMH_Network_GetRemoteNodeIds,                           "");
     SET_API_HANDLER(RMHApp__OUT_UINT32_NODELIST,                RMH_Network_GetAssociatedIds,                           "");
+    SET_API_HANDLER(RMHApp__OUT_NETWORK_SNAPSHOT,               RMH_Network_GetSnapshot,                                "snapshot");
     SET_API_HANDLER(RMHApp__OUT_UINT32,                         RMH_Network_GetNCNodeId,                                "");
     SET_API_HANDLER(RMHApp__OUT_MAC,                            RMH_Network_GetNCMac,                                   "");
     SET_API_HANDLER(RMHApp__OUT_UINT32,                         RMH_Network_GetBackupNCNodeId,                          "");
@@ -1369,9 +1593,14 @@ void RMHApp_RegisterAPIHandlers(RMHApp *app) {
     SET_API_HANDLER(RMHApp__OUT_STRING,                         RMH_Log_GetDriverFilename,                              "");
     SET_API_HANDLER(RMHApp__IN_STRING,                          RMH_Log_SetDriverFilename,                              "");
     SET_API_HANDLER(RMHApp__PRINT_STATUS,                       RMH_Log_PrintStatus,                                    "status");
-    SET_API_HANDLER(RMHApp__PRINT_STATUS,                       RMH_Log_PrintStats,                                     "stats");
+    SET_API_HANDLER(RMHApp__PRINT_STATUS,                       RMH_Log_PrintStats,                                     "");
     SET_API_HANDLER(RMHApp__PRINT_STATUS,                       RMH_Log_PrintFlows,                                     "flows");
     SET_API_HANDLER(RMHApp__PRINT_STATUS,                       RMH_Log_PrintModulation,                                "modulation");
+    SET_API_HANDLER(RMHApp__OUT_BOOL,                           RMH_Trace_GetEnabled,                                   "");
+    SET_API_HANDLER(RMHApp__IN_BOOL,                            RMH_Trace_SetEnabled,                                   "");
+    SET_API_HANDLER(RMHApp__OUT_BOOL,                           RMH_Cache_GetEnabled,                                   "");
+    SET_API_HANDLER(RMHApp__IN_BOOL,                            RMH_Cache_SetEnabled,                                   "");
+    SET_API_HANDLER(RMHApp__HANDLE_ONLY,                        RMH_Cache_Flush,                                        "");
 
     SET_API_HANDLER(RMHApp__REQUEST_ACA,                        RMH_ACA_Request,                                        "");
     SET_API_HANDLER(RMHApp__OUT_UINT32,                         RMH_ACA_GetChannel,                                     "");
@@ -1393,4 +1622,8 @@ void RMHApp_RegisterAPIHandlers(RMHApp *app) {
     SET_LOCAL_API_HANDLER(RMHApp__LOCAL_HANDLE_ONLY,            RMHApp_DisableDriverDebugLogging,                       "log_stop,logstop",                             "Disable MoCA debug logging");
     SET_LOCAL_API_HANDLER(RMHApp__LOCAL_HANDLE_ONLY,            RMHApp_Start,                                           "start",                                        "Shortcut to Enable MoCA");
     SET_LOCAL_API_HANDLER(RMHApp__LOCAL_HANDLE_ONLY,            RMHApp_Stop,                                            "stop",                                         "Shortcut to disable MoCA");
+    SET_LOCAL_API_HANDLER(RMHApp__LOCAL_HANDLE_ONLY,            RMHApp_Perf,                                            "perf",                                         "Run the status dumps and print the number of calls, errors and latency of every RMH API they used");
+    SET_LOCAL_API_HANDLER(RMHApp__LOCAL_HANDLE_ONLY,            RMHApp_Cache,                                           "cache",                                        "Enable the cache, run the status dumps twice and print the cache hits and misses of every cached API");
+    SET_LOCAL_API_HANDLER(RMHApp__LOCAL_WITH_ARGS,              RMHApp_Trace,                                           "trace",                                        "Turn the RMH trace buffer 'on' or 'off', or 'dump' it. Provide a file to dump the trace of another process which set RMH_TRACE to that file");
+    SET_LOCAL_API_HANDLER(RMHApp__LOCAL_WITH_ARGS,              RMHApp_Stats,                                           "stats",                                        "Print the MoCA statistics. Provide '--rates' to print the 64 bit totals of the counters and their rate per second over one second");
 }
@@ -0,0 +1,582 @@
+/*
+ * If not stated otherwise in this file or this component's Licenses.txt file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2016 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <dlfcn.h>
+#include "rdk_moca_hal.h"
+
+/**********************************************************************************************************************
+rmh_bench measures the cost of calling through the generic library. It's meant to be run against the simulated SoC
+library (rmh_soc_sim) or a stub so the numbers reflect RMH and not the MoCA driver.
+
+The generic library is opened with dlopen rather than linked so the cost of loading it can be measured as well. Every
+benchmark runs 'repeat' times and the fastest run is reported in ns/op along with the number of heap allocations per
+operation. Results are written as CSV, or JSON with --json, so runs before and after a change can be compared by script.
+**********************************************************************************************************************/
+#define RMHBENCH_GENERIC_LIB                "librdkmocahal.so.0"
+#define RMHBENCH_SOC_LIB                    "librdkmocahalsoc.so.0"
+#define RMHBENCH_DEFAULT_ITERATIONS         100000
+#define RMHBENCH_DEFAULT_REPEAT             3
+#define RMHBENCH_BATCH_SIZE                 100
+
+/**********************************************************************************************************************
+Allocation counting. With glibc the allocator can be replaced by the executable, so these wrappers see every allocation
+made by RMH, the SoC library and libc itself. Elsewhere allocations are not counted and reported as -1.
+**********************************************************************************************************************/
+#if defined(__GLIBC__)
+#define RMHBENCH_COUNT_ALLOCS 1
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t nmemb, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void __libc_free(void *ptr);
+
+static uint64_t hRMHBench_NumAllocs;
+
+void *malloc(size_t size) {
+    __atomic_fetch_add(&hRMHBench_NumAllocs, 1, __ATOMIC_RELAXED);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t nmemb, size_t size) {
+    __atomic_fetch_add(&hRMHBench_NumAllocs, 1, __ATOMIC_RELAXED);
+    return __libc_calloc(nmemb, size);
+}
+
+void *realloc(void *ptr, size_t size) {
+    __atomic_fetch_add(&hRMHBench_NumAllocs, 1, __ATOMIC_RELAXED);
+    return __libc_realloc(ptr, size);
+}
+
+void free(void *ptr) {
+    __libc_free(ptr);
+}
+
+static inline
+uint64_t RMHBench_NumAllocs() {
+    return __atomic_load_n(&hRMHBench_NumAllocs, __ATOMIC_RELAXED);
+}
+#else
+#define RMHBENCH_COUNT_ALLOCS 0
+static inline
+uint64_t RMHBench_NumAllocs() {
+    return 0;
+}
+#endif
+
+/* APIs used from the generic library. They're resolved with dlsym so the prototypes come from rdk_moca_hal.h */
+#define RMHBENCH_API(API_NAME) __typeof__(API_NAME) *API_NAME
+
+typedef struct RMHBench {
+    const char *genericLibName;
+    const char *filter;
+    uint32_t iterations;
+    uint32_t repeat;
+    bool json;
+    uint32_t numResults;
+
+    void *genericLib;
+    RMH_Handle rmh;
+    RMH_Handle cachedRmh;       /* A second handle with its cache enabled */
+    struct {
+        RMHBENCH_API(RMH_Initialize);
+        RMHBENCH_API(RMH_InitializeEx);
+        RMHBENCH_API(RMH_Destroy);
+        RMHBENCH_API(RMH_SetEventCallbacks);
+        RMHBENCH_API(RMH_GetEventCallbacks);
+        RMHBENCH_API(RMH_Self_GetEnabled);
+        RMHBENCH_API(RMH_Self_SetEnabled);
+        RMHBENCH_API(RMH_Interface_GetName);
+        RMHBENCH_API(RMH_Cache_SetEnabled);
+        RMHBENCH_API(RMH_Log_GetAPILevel);
+        RMHBENCH_API(RMH_Network_GetSnapshot);
+        RMHBENCH_API(RMH_Stats_GetExtended);
+        RMHBENCH_API(RMH_Self_GetLinkStatus);
+        RMHBENCH_API(RMH_Self_RefreshLinkStatus);
+        RMHBENCH_API(RMH_ExecuteBatch);
+        RMHBENCH_API(RMH_Log_PrintStatus);
+        RMHBENCH_API(RMH_Log_PrintStats);
+        RMHBENCH_API(RMH_Log_PrintFlows);
+        RMHBENCH_API(RMH_Log_PrintModulation);
+        RMHBENCH_API(RMH_ResultToString);
+    } api;
+
+    /* A poll of RMHBENCH_BATCH_SIZE getters for RMH_ExecuteBatch */
+    RMH_BatchOp batchOps[RMHBENCH_BATCH_SIZE];
+    RMH_Result batchResults[RMHBENCH_BATCH_SIZE];
+    bool batchResponses[RMHBENCH_BATCH_SIZE];
+
+    /* Written back unchanged by RMH_Self_SetEnabled so the benchmark doesn't change the device */
+    bool selfEnabled;
+
+    /* The SoC library called directly, without the generic library, to give the cost of the SoC itself */
+    void *socLib;
+    void *socHandle;
+    void* (*socInitialize)(const RMH_EventCallback eventCB, void* userContext);
+    RMH_Result (*socDestroy)(void *handle);
+    RMH_Result (*socSelfGetEnabled)(void *handle, bool *response);
+} RMHBench;
+
+typedef RMH_Result (*RMHBench_Func)(RMHBench *bench);
+
+typedef struct RMHBench_Case {
+    const char *name;
+    const char *class;          /* The API implementation class or the kind of operation being measured */
+    uint32_t divisor;           /* Expensive cases run iterations/divisor times */
+    bool needsHandle;           /* The case needs the generic library loaded and a handle created */
+    RMHBench_Func func;
+} RMHBench_Case;
+
+static
+void RMHBench_EventCallback(const enum RMH_Event event, const struct RMH_EventData *eventData, void* userContext) {
+    /* Prints from the composite APIs land here so the benchmark measures formatting rather than the terminal */
+}
+
+static inline
+uint64_t RMHBench_NowNs() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ull + now.tv_nsec;
+}
+
+
+
+/**********************************************************************************************************************
+Benchmarks
+**********************************************************************************************************************/
+static
+RMH_Result RMHBench_Baseline(RMHBench *bench) {
+    /* Cost of the benchmark loop itself */
+    return RMH_SUCCESS;
+}
+
+static
+RMH_Result RMHBench_LoadGenericLib(RMHBench *bench) {
+    void *lib=dlopen(bench->genericLibName, RTLD_NOW|RTLD_LOCAL);
+    if (!lib) return RMH_FAILURE;
+    dlclose(lib);
+    return RMH_SUCCESS;
+}
+
+static
+RMH_Result RMHBench_LoadSoCLib(RMHBench *bench) {
+    void *lib=dlopen(RMHBENCH_SOC_LIB, RTLD_LAZY|RTLD_LOCAL);
+    if (!lib) return RMH_FAILURE;
+    dlclose(lib);
+    return RMH_SUCCESS;
+}
+
+static
+RMH_Result RMHBench_InitializeDestroy(RMHBench *bench) {
+    /* The benchmark handle is open so this handle shares its SoC session */
+    RMH_Handle rmh=bench->api.RMH_Initialize(NULL, NULL);
+    if (!rmh) return RMH_FAILURE;
+    return bench->api.RMH_Destroy(rmh);
+}
+
+static
+RMH_Result RMHBench_InitializePrivateDestroy(RMHBench *bench) {
+    RMH_Handle rmh=bench->api.RMH_InitializeEx(NULL, NULL, RMH_INIT_FLAG_PRIVATE_SESSION);
+    if (!rmh) return RMH_FAILURE;
+    return bench->api.RMH_Destroy(rmh);
+}
+
+static
+RMH_Result RMHBench_SoCDirect(RMHBench *bench) {
+    bool response;
+    if (!bench->socSelfGetEnabled) return RMH_UNIMPLEMENTED;
+    return bench->socSelfGetEnabled(bench->socHandle, &response);
+}
+
+static
+RMH_Result RMHBench_SoCOnly(RMHBench *bench) {
+    bool response;
+    return bench->api.RMH_Self_GetEnabled(bench->rmh, &response);
+}
+
+static
+RMH_Result RMHBench_InterfaceGetName(RMHBench *bench) {
+    char name[32];
+    return bench->api.RMH_Interface_GetName(bench->rmh, name, sizeof(name));
+}
+
+static
+RMH_Result RMHBench_InterfaceGetNameCached(RMHBench *bench) {
+    char name[32];
+    return bench->api.RMH_Interface_GetName(bench->cachedRmh, name, sizeof(name));
+}
+
+static
+RMH_Result RMHBench_GenericOnly(RMHBench *bench) {
+    uint32_t response;
+    return bench->api.RMH_GetEventCallbacks(bench->rmh, &response);
+}
+
+static
+RMH_Result RMHBench_GenericThenSoC(RMHBench *bench) {
+    uint32_t response;
+    return bench->api.RMH_Log_GetAPILevel(bench->rmh, &response);
+}
+
+static
+RMH_Result RMHBench_SoCThenGeneric(RMHBench *bench) {
+    return bench->api.RMH_Self_SetEnabled(bench->rmh, bench->selfEnabled);
+}
+
+static
+RMH_Result RMHBench_Poll(RMHBench *bench) {
+    uint32_t i;
+    for (i=0; i < RMHBENCH_BATCH_SIZE; i++) {
+        RMH_Result ret=bench->api.RMH_Self_GetEnabled(bench->rmh, &bench->batchResponses[i]);
+        if (ret != RMH_SUCCESS) return ret;
+    }
+    return RMH_SUCCESS;
+}
+
+static
+RMH_Result RMHBench_ExecuteBatch(RMHBench *bench) {
+    RMH_Result ret=bench->api.RMH_ExecuteBatch(bench->rmh, bench->batchOps, RMHBENCH_BATCH_SIZE);
+    return (ret == RMH_SUCCESS) ? bench->batchResults[RMHBENCH_BATCH_SIZE-1] : ret;
+}
+
+/* Native when the SoC library implements it. Force it to RMH_UNIMPLEMENTED in the simulator to time the composed version */
+static
+RMH_Result RMHBench_NetworkGetSnapshot(RMHBench *bench) {
+    RMH_NetworkSnapshot response;
+    return bench->api.RMH_Network_GetSnapshot(bench->rmh, &response);
+}
+
+static
+RMH_Result RMHBench_StatsGetExtended(RMHBench *bench) {
+    RMH_StatsExtended response;
+    return bench->api.RMH_Stats_GetExtended(bench->rmh, &response);
+}
+
+/* Read from memory once the first call has asked the SoC for link events */
+static
+RMH_Result RMHBench_SelfGetLinkStatus(RMHBench *bench) {
+    RMH_LinkStatus response;
+    return bench->api.RMH_Self_GetLinkStatus(bench->rmh, &response);
+}
+
+static
+RMH_Result RMHBench_SelfRefreshLinkStatus(RMHBench *bench) {
+    RMH_LinkStatus response;
+    return bench->api.RMH_Self_RefreshLinkStatus(bench->rmh, &response);
+}
+
+static
+RMH_Result RMHBench_PrintStatus(RMHBench *bench) {
+    return bench->api.RMH_Log_PrintStatus(bench->rmh, NULL);
+}
+
+static
+RMH_Result RMHBench_PrintStats(RMHBench *bench) {
+    return bench->api.RMH_Log_PrintStats(bench->rmh, NULL);
+}
+
+static
+RMH_Result RMHBench_PrintFlows(RMHBench *bench) {
+    return bench->api.RMH_Log_PrintFlows(bench->rmh, NULL);
+}
+
+static
+RMH_Result RMHBench_PrintModulation(RMHBench *bench) {
+    return bench->api.RMH_Log_PrintModulation(bench->rmh, NULL);
+}
+
+static const RMHBench_Case hRMHBench_Cases[] = {
+    { "baseline",                              "BASELINE",            1,      false,  RMHBench_Baseline },
+    { "dlopen:" RMHBENCH_GENERIC_LIB,          "LOAD",                100,    false,  RMHBench_LoadGenericLib },
+    { "dlopen:" RMHBENCH_SOC_LIB,              "LOAD",                100,    false,  RMHBench_LoadSoCLib },
+    { "RMH_Initialize+RMH_Destroy",            "INIT_DESTROY",        100,    true,   RMHBench_InitializeDestroy },
+    { "RMH_InitializeEx+RMH_Destroy:private",  "INIT_DESTROY",        100,    true,   RMHBench_InitializePrivateDestroy },
+    { "SoC_IMPL__RMH_Self_GetEnabled",         "SOC_DIRECT",          1,      true,   RMHBench_SoCDirect },
+    { "RMH_Self_GetEnabled",                   "SOC_ONLY",            1,      true,   RMHBench_SoCOnly },
+    { "RMH_Interface_GetName",                 "SOC_ONLY",            1,      true,   RMHBench_InterfaceGetName },
+    { "RMH_Interface_GetName:cached",          "CACHE_HIT",           1,      true,   RMHBench_InterfaceGetNameCached },
+    { "RMH_GetEventCallbacks",                 "GENERIC_ONLY",        1,      true,   RMHBench_GenericOnly },
+    { "RMH_Log_GetAPILevel",                   "GENERIC_THEN_SOC",    1,      true,   RMHBench_GenericThenSoC },
+    { "RMH_Self_SetEnabled:unchanged",         "SOC_THEN_GENERIC",    1,      true,   RMHBench_SoCThenGeneric },
+    { "RMH_Self_GetEnabled:x100",              "POLL",                100,    true,   RMHBench_Poll },
+    { "RMH_ExecuteBatch:x100",                 "BATCH",               100,    true,   RMHBench_ExecuteBatch },
+    { "RMH_Network_GetSnapshot",               "COMPOSITE",           100,    true,   RMHBench_NetworkGetSnapshot },
+    { "RMH_Stats_GetExtended",                 "COMPOSITE",           100,    true,   RMHBench_StatsGetExtended },
+    { "RMH_Self_GetLinkStatus",                "COMPOSITE",           1,      true,   RMHBench_SelfGetLinkStatus },
+    { "RMH_Self_RefreshLinkStatus",            "COMPOSITE",           1,      true,   RMHBench_SelfRefreshLinkStatus },
+    { "RMH_Log_PrintStatus",                   "COMPOSITE",           1000,   true,   RMHBench_PrintStatus },
+    { "RMH_Log_PrintStats",                    "COMPOSITE",           1000,   true,   RMHBench_PrintStats },
+    { "RMH_Log_PrintFlows",                    "COMPOSITE",           1000,   true,   RMHBench_PrintFlows },
+    { "RMH_Log_PrintModulation",               "COMPOSITE",           1000,   true,   RMHBench_PrintModulation },
+};
+
+
+
+/**********************************************************************************************************************
+Setup
+**********************************************************************************************************************/
+static
+bool RMHBench_Open(RMHBench *bench) {
+    uint32_t i;
+
+    bench->genericLib=dlopen(bench->genericLibName, RTLD_NOW|RTLD_LOCAL);
+    if (!bench->genericLib) {
+        fprintf(stderr, "ERROR: Unable to open '%s': %s\n", bench->genericLibName, dlerror());
+        return false;
+    }
+
+#define RMHBENCH_RESOLVE(API_NAME) \
+    bench->api.API_NAME=dlsym(bench->genericLib, #API_NAME); \
+    if (!bench->api.API_NAME) { \
+        fprintf(stderr, "ERROR: '%s' is missing from '%s'\n", #API_NAME, bench->genericLibName); \
+        return false; \
+    }
+    RMHBENCH_RESOLVE(RMH_Initialize);
+    RMHBENCH_RESOLVE(RMH_InitializeEx);
+    RMHBENCH_RESOLVE(RMH_Destroy);
+    RMHBENCH_RESOLVE(RMH_SetEventCallbacks);
+    RMHBENCH_RESOLVE(RMH_GetEventCallbacks);
+    RMHBENCH_RESOLVE(RMH_Self_GetEnabled);
+    RMHBENCH_RESOLVE(RMH_Self_SetEnabled);
+    RMHBENCH_RESOLVE(RMH_Interface_GetName);
+    RMHBENCH_RESOLVE(RMH_Cache_SetEnabled);
+    RMHBENCH_RESOLVE(RMH_Log_GetAPILevel);
+    RMHBENCH_RESOLVE(RMH_Network_GetSnapshot);
+    RMHBENCH_RESOLVE(RMH_Stats_GetExtended);
+    RMHBENCH_RESOLVE(RMH_Self_GetLinkStatus);
+    RMHBENCH_RESOLVE(RMH_Self_RefreshLinkStatus);
+    RMHBENCH_RESOLVE(RMH_ExecuteBatch);
+    RMHBENCH_RESOLVE(RMH_Log_PrintStatus);
+    RMHBENCH_RESOLVE(RMH_Log_PrintStats);
+    RMHBENCH_RESOLVE(RMH_Log_PrintFlows);
+    RMHBENCH_RESOLVE(RMH_Log_PrintModulation);
+    RMHBENCH_RESOLVE(RMH_ResultToString);
+#undef RMHBENCH_RESOLVE
+
+    bench->rmh=bench->api.RMH_Initialize(RMHBench_EventCallback, bench);
+    if (!bench->rmh) {
+        fprintf(stderr, "ERROR: RMH_Initialize failed\n");
+        return false;
+    }
+    bench->api.RMH_SetEventCallbacks(bench->rmh, RMH_EVENT_API_PRINT);
+
+    if (bench->api.RMH_Self_GetEnabled(bench->rmh, &bench->selfEnabled) != RMH_SUCCESS) {
+        fprintf(stderr, "ERROR: Unable to read if MoCA is enabled\n");
+        return false;
+    }
+
+    for (i=0; i < RMHBENCH_BATCH_SIZE; i++) {
+        bench->batchOps[i].apiId=RMH_API_ID__RMH_Self_GetEnabled;
+        bench->batchOps[i].response=&bench->batchResponses[i];
+        bench->batchOps[i].result=&bench->batchResults[i];
+    }
+
+    bench->cachedRmh=bench->api.RMH_Initialize(NULL, NULL);
+    if (!bench->cachedRmh || bench->api.RMH_Cache_SetEnabled(bench->cachedRmh, true) != RMH_SUCCESS) {
+        fprintf(stderr, "ERROR: Unable to create a handle with the cache enabled\n");
+        return false;
+    }
+
+    /* A separate SoC handle for calling the SoC library directly. Not having one only skips the SOC_DIRECT case */
+    bench->socLib=dlopen(RMHBENCH_SOC_LIB, RTLD_LAZY|RTLD_LOCAL);
+    if (bench->socLib) {
+        bench->socInitialize=dlsym(bench->socLib, "RMH_Initialize");
+        bench->socDestroy=dlsym(bench->socLib, "SoC_IMPL__RMH_Destroy");
+        bench->socSelfGetEnabled=dlsym(bench->socLib, "SoC_IMPL__RMH_Self_GetEnabled");
+        bench->socHandle=bench->socInitialize ? bench->socInitialize(NULL, NULL) : NULL;
+        if (!bench->socHandle) {
+            bench->socSelfGetEnabled=NULL;
+        }
+    }
+    return true;
+}
+
+static
+void RMHBench_Close(RMHBench *bench) {
+    if (bench->socLib) {
+        if (bench->socHandle && bench->socDestroy) {
+            bench->socDestroy(bench->socHandle);
+        }
+        dlclose(bench->socLib);
+    }
+    if (bench->cachedRmh) {
+        bench->api.RMH_Destroy(bench->cachedRmh);
+    }
+    if (bench->rmh) {
+        bench->api.RMH_Destroy(bench->rmh);
+    }
+    if (bench->genericLib) {
+        dlclose(bench->genericLib);
+    }
+}
+
+
+
+/**********************************************************************************************************************
+Running and reporting
+**********************************************************************************************************************/
+static
+void RMHBench_Report(RMHBench *bench, const RMHBench_Case *benchCase, const uint32_t iterations, const double nsPerOp, const double allocsPerOp, const RMH_Result ret) {
+    const char *retStr=bench->api.RMH_ResultToString ? bench->api.RMH_ResultToString(ret) : (ret == RMH_SUCCESS ? "RMH_SUCCESS" : "RMH_FAILURE");
+
+    if (bench->json) {
+        printf("%s\n    { \"name\": \"%s\", \"class\": \"%s\", \"iterations\": %u, \"ns_per_op\": %.1f, \"allocs_per_op\": ",
+                bench->numResults ? "," : "", benchCase->name, benchCase->class, iterations, nsPerOp);
+        if (RMHBENCH_COUNT_ALLOCS) {
+            printf("%.2f", allocsPerOp);
+        }
+        else {
+            printf("null");
+        }
+        printf(", \"result\": \"%s\" }", retStr);
+    }
+    else {
+        printf("%s,%s,%u,%.1f,%.2f,%s\n", benchCase->name, benchCase->class, iterations, nsPerOp, RMHBENCH_COUNT_ALLOCS ? allocsPerOp : -1.0, retStr);
+    }
+    bench->numResults++;
+}
+
+static
+void RMHBench_Run(RMHBench *bench, const RMHBench_Case *benchCase) {
+    uint32_t iterations=bench->iterations / benchCase->divisor;
+    uint64_t bestNs=UINT64_MAX;
+    uint64_t bestAllocs=0;
+    RMH_Result ret=RMH_SUCCESS;
+    uint32_t r, i;
+
+    if (iterations == 0) {
+        iterations=1;
+    }
+
+    /* Warm up caches, lazy binding and anything the library sets up on first use */
+    for (i=0; i < iterations/10 + 1; i++) {
+        ret=benchCase->func(bench);
+    }
+
+    for (r=0; r < bench->repeat; r++) {
+        uint64_t allocs=RMHBench_NumAllocs();
+        uint64_t start=RMHBench_NowNs();
+        for (i=0; i < iterations; i++) {
+            ret=benchCase->func(bench);
+        }
+        start=RMHBench_NowNs() - start;
+        allocs=RMHBench_NumAllocs() - allocs;
+        if (start < bestNs) {
+            bestNs=start;
+            bestAllocs=allocs;
+        }
+    }
+
+    RMHBench_Report(bench, benchCase, iterations, (double)bestNs / iterations, (double)bestAllocs / iterations, ret);
+}
+
+static
+void RMHBench_PrintUsage() {
+    printf("usage: rmh_bench [-h|--help] [-i|--iterations <n>] [-r|--repeat <n>] [-f|--filter <str>] [-j|--json] [-l|--lib <path>]\n");
+    printf("\n");
+    printf("   --help            Print this help message\n");
+    printf("   --iterations      Operations per run of the cheapest benchmarks (default %u). Expensive ones run fewer\n", RMHBENCH_DEFAULT_ITERATIONS);
+    printf("   --repeat          Runs of each benchmark. The fastest is reported (default %u)\n", RMHBENCH_DEFAULT_REPEAT);
+    printf("   --filter          Only run benchmarks whose name or class contains this string\n");
+    printf("   --json            Write results as JSON rather than CSV\n");
+    printf("   --lib             The generic library to benchmark (default %s)\n", RMHBENCH_GENERIC_LIB);
+    printf("\n");
+    printf("Run against the simulated SoC library with no latency configured for numbers which reflect RMH only. The\n");
+    printf("composite dumps need the link up, so point the simulator 'interface' at one which exists, like 'lo'.\n");
+}
+
+static
+bool RMHBench_ParseArguments(RMHBench *bench, const int argc, const char *argv[]) {
+    int i;
+
+    for (i=1; i < argc; i++) {
+        const char* option = argv[i];
+        bool hasValue = (i+1 < argc);
+
+        if ((strcmp(option, "-i") == 0 || strcmp(option, "--iterations") == 0) && hasValue) {
+            bench->iterations=strtoul(argv[++i], NULL, 0);
+        } else if ((strcmp(option, "-r") == 0 || strcmp(option, "--repeat") == 0) && hasValue) {
+            bench->repeat=strtoul(argv[++i], NULL, 0);
+        } else if ((strcmp(option, "-f") == 0 || strcmp(option, "--filter") == 0) && hasValue) {
+            bench->filter=argv[++i];
+        } else if ((strcmp(option, "-l") == 0 || strcmp(option, "--lib") == 0) && hasValue) {
+            bench->genericLibName=argv[++i];
+        } else if (strcmp(option, "-j") == 0 || strcmp(option, "--json") == 0) {
+            bench->json=true;
+        } else {
+            if (strcmp(option, "-h") != 0 && strcmp(option, "--help") != 0) {
+                fprintf(stderr, "ERROR: Unknown or incomplete option '%s'\n", option);
+            }
+            return false;
+        }
+    }
+    return (bench->iterations > 0 && bench->repeat > 0);
+}
+
+/***********************************************************
+ * Main
+ ***********************************************************/
+int main(const int argc, const char *argv[])
+{
+    RMHBench benchStr;
+    RMHBench* bench=&benchStr;
+    uint32_t i;
+    int result=0;
+
+    memset(bench, 0, sizeof(*bench));
+    bench->genericLibName=RMHBENCH_GENERIC_LIB;
+    bench->iterations=RMHBENCH_DEFAULT_ITERATIONS;
+    bench->repeat=RMHBENCH_DEFAULT_REPEAT;
+
+    if (!RMHBench_ParseArguments(bench, argc, argv)) {
+        RMHBench_PrintUsage();
+        return 1;
+    }
+
+    if (bench->json) {
+        printf("{\n  \"iterations\": %u,\n  \"repeat\": %u,\n  \"results\": [", bench->iterations, bench->repeat);
+    }
+    else {
+        printf("name,class,iterations,ns_per_op,allocs_per_op,result\n");
+    }
+
+    /* Cases which load the libraries run first while nothing else holds them open */
+    for (i=0; i < sizeof(hRMHBench_Cases)/sizeof(hRMHBench_Cases[0]); i++) {
+        const RMHBench_Case *benchCase=&hRMHBench_Cases[i];
+
+        if (bench->filter && !strstr(benchCase->name, bench->filter) && !strstr(benchCase->class, bench->filter)) {
+            continue;
+        }
+        if (benchCase->needsHandle && !bench->rmh && !RMHBench_Open(bench)) {
+            result=1;
+            break;
+        }
+        RMHBench_Run(bench, benchCase);
+    }
+
+    if (bench->json) {
+        printf("\n  ]\n}\n");
+    }
+
+    RMHBench_Close(bench);
+    return result;
+}
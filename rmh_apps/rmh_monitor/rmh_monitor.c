@@ -20,21 +20,29 @@
 #include <stdarg.h>
 #include <pthread.h>
 #include <sys/time.h>
+#include <signal.h>
 #include "rmh_monitor.h"
 #include <unistd.h>
 #include <sys/select.h>
-#include "rfcapi.h"
 
 static
 RMH_Result RMHMonitor_PrintUsage(RMHMonitor *app) {
-    RMH_PrintMsg("usage: rmh_monitor [-?|-h|--help] [-n|--no_timestamp] [-t|--trace]\n");
+    RMH_PrintMsg("usage: rmh_monitor [-?|-h|--help] [-n|--no_timestamp] [-t|--trace] [-d|--debug] [-f|--flush-ms <ms>] [-u|--socket <path>]\n");
+    RMH_PrintMsg("                   [-m|--shm <name>] [-r|--shm-ms <ms>]\n");
     RMH_PrintMsg("\n");
     RMH_PrintMsg("   --help            Print this help message\n");
     RMH_PrintMsg("   --no_timestamp    Do not prefix each line with a timestamp\n");
     RMH_PrintMsg("   --timestamp       Prefix each line with a timestamp\n");
     RMH_PrintMsg("   --out-file        Write log messages to a file\n");
-    RMH_PrintMsg("   --debug           Enable API trace messages\n");
+    RMH_PrintMsg("   --flush-ms        The longest time in milliseconds a message can wait before it's written [Default:%u]. Use 0 to write each message right away\n", RMH_MONITOR_LOG_FLUSH_MS_DEFAULT);
+    RMH_PrintMsg("   --socket          The UNIX socket the status is served on [Default:%s]. Use \"\" to disable it\n", RMH_MONITOR_SERVICE_SOCKET_DEFAULT);
+    RMH_PrintMsg("   --shm             Publish the status in this shared memory object for RMH_Shm_Open, usually %s. Disabled by default\n", RMH_SHM_DEFAULT_NAME);
+    RMH_PrintMsg("   --shm-ms          How often in milliseconds the status in shared memory is refreshed when --shm is given [Default:%u]. Use 0 to only refresh it on events\n", RMH_MONITOR_SHM_REFRESH_MS_DEFAULT);
+    RMH_PrintMsg("   --trace           Enable API trace messages\n");
+    RMH_PrintMsg("   --debug           Enable debug messages, such as how long each batch of events took\n");
     RMH_PrintMsg("\n");
+    RMH_PrintMsg("Status dumps only include what changed since the last one. Send SIGUSR1 to print the full status\n");
+    RMH_PrintMsg("Other processes can read the status as JSON by sending 'get' or 'subscribe' on the socket\n");
     RMH_PrintMsg("\n");
     return RMH_SUCCESS;
 }
@@ -61,6 +69,23 @@ void RMHMonitor_RMHCallback(const enum RMH_Event event, const struct RMH_EventDa
 }
 
 
+/**
+ * Ask the app to exit through its normal stop path. The event thread is woken to stop monitoring and main won't
+ * reconnect. This may be called from any thread.
+*/
+void RMHMonitor_RequestStop(RMHMonitor *app) {
+    const uint64_t one=1;
+
+    __atomic_store_n(&app->stopRequested, true, __ATOMIC_SEQ_CST);
+    /* The queue is only sure to exist while the event thread is running */
+    if (__atomic_exchange_n(&app->eventThreadRunning, false, __ATOMIC_SEQ_CST)) {
+        if (write(RMHMonitor_Queue_GetNotifyFd(app), &one, sizeof(one)) != sizeof(one)) {
+            /* Only fails if the counter is about to overflow, in which case the event thread is already being woken */
+        }
+    }
+}
+
+
 /**
  * Handle all arguments passed into the application. Arguments should update values in 'app' and then used later.
 */
@@ -75,6 +100,8 @@ RMH_Result RMHMonitor_ParseArguments(RMHMonitor *app, const int argc, const char
         if (option[0] == '-') {
             if (strcmp(option, "-t") == 0 || strcmp(option, "--trace") == 0) {
                 app->apiLogLevel |= RMH_LOG_TRACE;
+            } else if (strcmp(option, "-d") == 0 || strcmp(option, "--debug") == 0) {
+                app->apiLogLevel |= RMH_LOG_DEBUG;
             } else if (strcmp(option, "-n") == 0 || strcmp(option, "--no_timestamp") == 0) {
                 app->printTimestamp = false;
                 app->userSetTimestamps = true;
@@ -85,6 +112,28 @@ RMH_Result RMHMonitor_ParseArguments(RMHMonitor *app, const int argc, const char
                 app->serviceMode = true;
             } else if (strcmp(option, "-o") == 0 || strcmp(option, "--out-file") == 0) {
                 app->out_file_name = argv[++i];;
+            } else if (strcmp(option, "-f") == 0 || strcmp(option, "--flush-ms") == 0) {
+                char *end;
+                if (i+1 >= argc) return RMH_FAILURE;
+                app->logFlushMs = strtoul(argv[++i], &end, 0);
+                if (*end != '\0') {
+                    RMH_PrintWrn("Invalid flush time '%s'!\n", argv[i]);
+                    return RMH_FAILURE;
+                }
+            } else if (strcmp(option, "-u") == 0 || strcmp(option, "--socket") == 0) {
+                if (i+1 >= argc) return RMH_FAILURE;
+                app->service.socketPath = argv[++i];
+            } else if (strcmp(option, "-m") == 0 || strcmp(option, "--shm") == 0) {
+                if (i+1 >= argc) return RMH_FAILURE;
+                app->shmName = argv[++i];
+            } else if (strcmp(option, "-r") == 0 || strcmp(option, "--shm-ms") == 0) {
+                char *end;
+                if (i+1 >= argc) return RMH_FAILURE;
+                app->shmRefreshMs = strtoul(argv[++i], &end, 0);
+                if (*end != '\0') {
+                    RMH_PrintWrn("Invalid shared memory refresh time '%s'!\n", argv[i]);
+                    return RMH_FAILURE;
+                }
             } else if (strcmp(option, "-?") == 0 || strcmp(option, "-h") == 0 || strcmp(option, "--help") == 0) {
                 return RMH_FAILURE;
             } else {
@@ -124,6 +173,7 @@ bool RMHMonitor_Connect(RMHMonitor *app) {
                                         RMH_EVENT_NODE_DROPPED | \
                                         RMH_EVENT_NC_ID_CHANGED | \
                                         RMH_EVENT_LOW_BANDWIDTH | \
+                                        RMH_EVENT_INTERFACE_STATUS_CHANGED | \
                                         RMH_EVENT_API_PRINT) != RMH_SUCCESS) {
         RMH_PrintErr("Failed setting callback events!\n");
         return true;
@@ -134,8 +184,17 @@ bool RMHMonitor_Connect(RMHMonitor *app) {
         RMH_PrintErr("Failed to set the log level!\n");
     }
 
-    /* Mark the thread as running and create it */
-    app->eventThreadRunning=true;
+    /* Node MACs and versions are read on every change. The cache keeps them until the event which changes them */
+    if (RMH_Cache_SetEnabled(app->rmh, true) != RMH_SUCCESS) {
+        RMH_PrintWrn("Failed to enable the cache!\n");
+    }
+
+    /* Mark the thread as running and create it. A stop requested while we were connecting must not be lost */
+    __atomic_store_n(&app->eventThreadRunning, true, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&app->stopRequested, __ATOMIC_SEQ_CST)) {
+        app->eventThreadRunning=false;
+        return false;
+    }
     if (pthread_create(&app->eventThread, NULL, (void *)RMHMonitor_Event_Thread, app) != 0) {
         RMH_PrintErr("Failed creating event thread!");
         return false;
@@ -147,39 +206,11 @@ bool RMHMonitor_Connect(RMHMonitor *app) {
             RMH_PrintErr("Failed doing pthread_join");
         }
         app->eventThreadRunning=false;
-        return ret ? true : false;
+        return (ret && !__atomic_load_n(&app->stopRequested, __ATOMIC_SEQ_CST)) ? true : false;
     }
     return true;
 }
 
-static
-RMH_Result pRMHMonitor_RFC_GetBool(RMHMonitor* app, const char*name, bool *value) {
-    RFC_ParamData_t rfcParam;
-    WDMP_STATUS wdmpStatus;
-
-    wdmpStatus = getRFCParameter("RMH", name, &rfcParam);
-    if (wdmpStatus != WDMP_SUCCESS) {
-        if (wdmpStatus != WDMP_ERR_VALUE_IS_EMPTY) {
-            RMH_PrintErr("Failed reading from RFC -- %s -- Returned error '%s' (%u)\n", rfcParam.name, getRFCErrorString(wdmpStatus), wdmpStatus);
-        }
-        return RMH_FAILURE;
-    }
-
-    /* There are cases where RFC type might not be set correctly. To be sure of our value We'll explictly test both values. */
-    if (0 == strcasecmp(rfcParam.value, "TRUE")) {
-        *value=true;
-    }
-    else if (0 == strcasecmp(rfcParam.value, "FALSE")) {
-        *value=false;
-    }
-    else {
-        RMH_PrintErr("Unexpected value reading from RFC -- %s -- Returned '%s' which is type %u. Expecting type WDMP_BOOLEAN(%u)\n", rfcParam.name, rfcParam.value, getRFCErrorString(wdmpStatus), rfcParam.type, WDMP_BOOLEAN);
-        return RMH_FAILURE;
-    }
-
-    return RMH_SUCCESS;
-}
-
 /***********************************************************
  * Main
  ***********************************************************/
@@ -190,14 +221,20 @@ int main(const int argc, const char *argv[])
     RMH_Result result=RMH_FAILURE;
     fd_set fdset;
     struct timeval timeout;
-    bool rmhEnableStatusLogging = false;
+    RMH_RFCValue rmhEnableStatusLogging;
+    sigset_t sigSet;
+    uint32_t i;
 
     /* Initialize everything to defaults */
     memset(app, 0, sizeof(*app));
     app->apiLogLevel = RMH_LOG_DEFAULT;
+    app->logFlushMs = RMH_MONITOR_LOG_FLUSH_MS_DEFAULT;
+    app->service.socketPath = RMH_MONITOR_SERVICE_SOCKET_DEFAULT;
+    app->shmName = "";
+    app->shmRefreshMs = RMH_MONITOR_SHM_REFRESH_MS_DEFAULT;
 
-    if (RMH_SUCCESS == pRMHMonitor_RFC_GetBool(app, "Device.DeviceInfo.X_RDKCENTRAL-COM_RFC.Feature.RMHLogging.Enable", &rmhEnableStatusLogging)) {
-        if (rmhEnableStatusLogging == false) {
+    if (RMH_SUCCESS == RMH_RFC_Get(RMH_RFC_LOGGING_ENABLE, &rmhEnableStatusLogging)) {
+        if (rmhEnableStatusLogging.boolValue == false) {
             RMH_PrintErr("RMH Loogging has been disabled via RFC. Exiting\n");
             exit(0);
         }
@@ -230,21 +267,35 @@ int main(const int argc, const char *argv[])
         }
     }
 
-    /* Initialize the event queue. The event queue and thread allow us to get out of the callbacks ASAP */
-    TAILQ_INIT(&app->eventQueue);
-    app->eventNotify=RMHMonitor_Semaphore_Create();
-    if (!app->eventNotify) {
-        RMH_PrintErr("Failed RMHMonitor_Semaphore_Create!\n");
-        goto exit_err_init;
+    /* SIGUSR1 asks the event thread for a full status. Block it before any thread is created so it's only seen there */
+    sigemptyset(&sigSet);
+    sigaddset(&sigSet, SIGUSR1);
+    pthread_sigmask(SIG_BLOCK, &sigSet, NULL);
+
+    /* Hand output to the log writer thread. This must happen before any other thread is created */
+    if (RMHMonitor_Log_Start(app) != RMH_SUCCESS) {
+        RMH_PrintWrn("Failed to start the log writer. Output will be written directly\n");
     }
 
-    /* Setup the event notify semaphore */
-    RMHMonitor_Semaphore_Reset(app->eventNotify);
+    /* The snapshots let status dumps print only what changed. Without them every dump is a full status */
+    if (RMHMonitor_Snapshot_Init(app) != RMH_SUCCESS) {
+        RMH_PrintWrn("Status dumps will always include the full status\n");
+    }
 
-    /* Initialize the threads mutex */
-    if (pthread_mutex_init(&app->eventQueueProtect, NULL) != 0) {
-        RMH_PrintErr("Failed to create eventQueueProtect mutex!\n");
-        goto exit_err_eventNotify;
+    /* Serve the status to other processes so they don't each need to poll the driver */
+    if (RMHMonitor_Service_Start(app) != RMH_SUCCESS) {
+        RMH_PrintWrn("The status will not be served on '%s'\n", app->service.socketPath);
+    }
+
+    /* Publish the status in shared memory so other processes can read it without any calls at all */
+    if (RMHMonitor_Shm_Start(app) != RMH_SUCCESS) {
+        RMH_PrintWrn("The status will not be published in shared memory\n");
+    }
+
+    /* Initialize the event queue. The event queue and thread allow us to get out of the callbacks ASAP */
+    if (RMHMonitor_Queue_Init(app) != RMH_SUCCESS) {
+        RMH_PrintErr("Failed RMHMonitor_Queue_Init!\n");
+        goto exit_err_init;
     }
 
     if (!app->serviceMode) {
@@ -265,17 +316,24 @@ int main(const int argc, const char *argv[])
         }
 
         /* If we're not reconnecting, exit the loop */
-        if (!reconnect) break;
+        if (!reconnect || __atomic_load_n(&app->stopRequested, __ATOMIC_SEQ_CST)) break;
 
         RMH_PrintErr("There was a failure communicating with the MoCA driver. Sleeping %u seconds before attempting to reconnect...\n", app->reconnectSeconds);
-        /* Sleep 5 seconds before trying again */
-        usleep(app->reconnectSeconds*1000000);
+        /* Sleep 5 seconds before trying again. Wake up now and then in case we're asked to exit */
+        for (i=0; i < app->reconnectSeconds*10 && !__atomic_load_n(&app->stopRequested, __ATOMIC_SEQ_CST); i++) {
+            usleep(100000);
+        }
         app->reconnectSeconds+=5;
         if (app->reconnectSeconds > 60) app->reconnectSeconds = 60;
     }
 
     RMH_PrintMsg("Exit status monitor\n");
 
+    RMHMonitor_Service_Stop(app);
+    RMHMonitor_Shm_Stop(app);
+
+    /* Write out everything still queued before closing the output */
+    RMHMonitor_Log_Stop(app);
     if (app->out_file) {
         fclose(app->out_file);
     }
@@ -285,16 +343,13 @@ int main(const int argc, const char *argv[])
     result=RMH_SUCCESS;
 
     /* Shutdown the event queue */
-    pthread_mutex_destroy (&app->eventQueueProtect);
-
-exit_err_eventNotify:
-    /* Delete the semaphore */
-    if (app->eventNotify) {
-        RMHMonitor_Semaphore_Destroy(app->eventNotify);
-        app->eventNotify = NULL;
-    }
+    RMHMonitor_Queue_Destroy(app);
 
 exit_err_init:
+    RMHMonitor_Service_Stop(app);
+    RMHMonitor_Shm_Stop(app);
+    RMHMonitor_Snapshot_Destroy(app);
+    RMHMonitor_Log_Stop(app);
 
     return result;
 }
@@ -22,17 +22,14 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
-#include <sys/queue.h>
+#include <sys/time.h>
+#include <time.h>
 #include "rdk_moca_hal.h"
 
 /**
- * A simple semaphore based on pthread
+ * The number of events which can wait to be handled by the event thread. Must be a power of 2.
  */
-typedef struct RMHMonitor_Semaphore {
-    pthread_mutex_t lock;
-    pthread_cond_t cond;
-    bool signal;
-} RMHMonitor_Semaphore, *RMHMonitor_hSemaphore;
+#define RMH_MONITOR_EVENT_QUEUE_SIZE 256
 
 /**
  * Contains all necessary information to describe a callback from RMH. This allows
@@ -43,9 +40,75 @@ typedef struct RMHMonitor_CallbackEvent {
   RMH_EventData eventData;                          /* Whatever event data was provided with the event. Because this event will be handled
                                                        on a different thread, if eventData is ever a pointer we will need to copy. */
   struct timeval eventTime;                         /* The time the event occurred */
-  TAILQ_ENTRY(RMHMonitor_CallbackEvent) entries;    /* For queuing */
+  uint64_t sequence;                                /* Position of the event in the queue. Events are always handled in this order */
 } RMHMonitor_CallbackEvent;
 
+/**
+ * One entry of the event queue. 'turn' says whether the slot is waiting to be written or read for a given queue position.
+ */
+typedef struct RMHMonitor_EventSlot {
+  uint64_t turn;                                    /* Position+1 once the event for that position is written, position when free */
+  RMHMonitor_CallbackEvent cbE;                     /* The queued event */
+} RMHMonitor_EventSlot;
+
+/**
+ * A bounded FIFO of events passed from the RMH callbacks to the event thread. All the memory is allocated up front and
+ * enqueuing never takes a lock so the callback can't be held up by the event thread. Events are only dropped when the
+ * queue is full, and that is counted so the event thread knows its state is out of date.
+ */
+typedef struct RMHMonitor_EventQueue {
+  RMHMonitor_EventSlot slots[RMH_MONITOR_EVENT_QUEUE_SIZE];
+  uint64_t head;                                    /* Next position to be written. Updated by the callbacks */
+  uint64_t tail;                                    /* Next position to be read. Only used by the event thread */
+  uint64_t numDropped;                              /* Events dropped because the queue was full */
+  uint64_t numOverflows;                            /* Number of times the queue became full */
+  bool full;                                        /* Set when an event has been dropped until the next one is read */
+  int notifyFd;                                     /* eventfd written when an event is queued to wake the event thread */
+} RMHMonitor_EventQueue;
+
+
+/**
+ * The number of preformatted log records which can wait for the log writer thread. Must be a power of 2.
+ */
+#define RMH_MONITOR_LOG_QUEUE_SIZE 1024
+
+/**
+ * The most text held by one log record. Longer messages are split over several records.
+ */
+#define RMH_MONITOR_LOG_RECORD_SIZE 256
+
+/**
+ * The default for the longest time in milliseconds a message may wait in the log queue before it's written.
+ */
+#define RMH_MONITOR_LOG_FLUSH_MS_DEFAULT 100
+
+/**
+ * One entry of the log queue. 'turn' works the same way as in RMHMonitor_EventSlot.
+ */
+typedef struct RMHMonitor_LogRecord {
+  uint64_t turn;                                    /* Position+1 once the record for that position is written, position when free */
+  uint32_t len;                                     /* Number of bytes used in 'text' */
+  char text[RMH_MONITOR_LOG_RECORD_SIZE];           /* Formatted output including the timestamp and prefix. Not terminated */
+} RMHMonitor_LogRecord;
+
+/**
+ * Output formatted by any thread waiting to be written by the log writer thread. It's a bounded multi-producer ring like
+ * the event queue. Records are written to 'outFd' in batches with writev.
+ */
+typedef struct RMHMonitor_LogQueue {
+  RMHMonitor_LogRecord records[RMH_MONITOR_LOG_QUEUE_SIZE];
+  uint64_t head;                                    /* Next position to be written. Updated by any thread which prints */
+  uint64_t tail;                                    /* Next position to be written to 'outFd'. Only updated by the writer thread */
+  uint64_t numStalls;                               /* Number of times a print had to wait because the queue was full */
+  bool running;                                     /* Set while the writer thread is handling output. Otherwise prints are written right away */
+  bool writerIdle;                                  /* Set by the writer thread when it's waiting for the first record of a batch */
+  bool flushRequested;                              /* Set when a print is waiting for room so the writer thread doesn't wait for more */
+  int notifyFd;                                     /* eventfd used to wake the writer thread */
+  int signalFd;                                     /* signalfd for the signals which should flush the log before exiting */
+  int outFd;                                        /* Where the output is written */
+  pthread_t writerThread;                           /* The thread which writes the queued records */
+} RMHMonitor_LogQueue;
+
 
 /**
  * Stores information about a given node. We store this interally it so if a node leaves the network we still know something about it.
@@ -71,23 +134,80 @@ typedef struct RMHMonitor_NetworkStatus {
 } RMHMonitor_NetworkStatus;
 
 
+/**
+ * The number of minutes the status handle can go unused before it's reopened rather than trusted.
+ */
+#define RMH_MONITOR_STATUS_HANDLE_IDLE_MIN 30
+
+/**
+ * A second, long lived RMH handle with its own session used to read the status. See RMHMonitor_StatusHandle_Get.
+ */
+typedef struct RMHMonitor_StatusHandle {
+    RMH_Handle rmh;                                 /* The handle. NULL if it isn't open */
+    struct timespec lastUsed;                       /* The CLOCK_MONOTONIC time the handle was last handed out */
+    uint32_t numOpens;                              /* Number of times the handle was opened */
+    uint32_t numProbeFailures;                      /* Number of times it was reopened because RMH_ValidateHandle failed */
+    uint32_t numIdleReopens;                        /* Number of times it was reopened because it was idle too long */
+} RMHMonitor_StatusHandle;
+
+
+/**
+ * A structured copy of the full status used to print only what changed. Defined in rmh_monitor_snapshot.c.
+ */
+typedef struct RMHMonitor_Snapshot RMHMonitor_Snapshot;
+
+
+/**
+ * The default UNIX socket the status is served on.
+ */
+#define RMH_MONITOR_SERVICE_SOCKET_DEFAULT "/var/run/rmh_monitor.sock"
+
+/**
+ * The largest status which can be served.
+ */
+#define RMH_MONITOR_SERVICE_MSG_SIZE 16384
+
+/**
+ * Serves the status to other processes over a UNIX socket. See rmh_monitor_service.c.
+ */
+typedef struct RMHMonitor_Service {
+    const char *socketPath;                         /* Where the socket is created. The service is disabled if this is empty */
+    bool running;                                   /* Set while the service thread is running */
+    pthread_t thread;                               /* The thread which handles the clients */
+    int listenFd;                                   /* The listening socket */
+    int notifyFd;                                   /* eventfd written when a new status is published */
+    pthread_mutex_t lock;                           /* Protects 'published', 'publishedLen' and 'sequence' */
+    char published[RMH_MONITOR_SERVICE_MSG_SIZE];   /* The latest status as a line of JSON */
+    size_t publishedLen;                            /* Number of bytes used in 'published' */
+    uint64_t sequence;                              /* Incremented each time 'published' changes */
+} RMHMonitor_Service;
+
+
+/**
+ * The default for how often in milliseconds the status in shared memory is refreshed when there are no events.
+ */
+#define RMH_MONITOR_SHM_REFRESH_MS_DEFAULT 1000
+
+
 /**
  * This is the main sturcture of the applicaiton and contains everything needing to be shared between functions.
  */
 typedef struct RMHMonitor {
     RMH_Handle rmh;                                 /* The handle to RMH for all MoCA calls */
+    RMHMonitor_StatusHandle statusHandle;           /* The handle used to read the status for dumps and pings */
 
     pthread_t eventThread;                          /* The thread which handles the MoCA events */
     bool eventThreadRunning;                        /* Must remain set to true to continue monitoring. If this goes to false the thread will exit. */
-    TAILQ_HEAD(tailhead, RMHMonitor_CallbackEvent) eventQueue;
-                                                    /* The queue where events are stored while they are moved to the event thread */
-    pthread_mutex_t eventQueueProtect;              /* A mutex to ensure safe enqueue/dequeue of events */
-    RMHMonitor_hSemaphore eventNotify;              /* A semaphore to notify the event thread there is work to be done */
-    struct timeval lastPrint;                       /* The time the last message was print to the log */
+    bool stopRequested;                             /* Set once a SIGINT, SIGTERM or SIGHUP asks the app to exit. See RMHMonitor_RequestStop */
+    RMHMonitor_EventQueue eventQueue;               /* The queue where events are stored while they are moved to the event thread */
+    struct timespec lastPrint;                      /* The CLOCK_MONOTONIC time the last message was print to the log */
 
     RMH_LinkStatus linkStatus;                      /* The current state of the MoCA link for this device */
     bool linkStatusValid;                           /* Set to true if the value of 'linkStatus' is valid */
     RMHMonitor_NetworkStatus netStatus;             /* The current state of the MoCA network */
+    RMHMonitor_Snapshot *lastSnapshot;              /* The status as of the last status dump */
+    RMHMonitor_Snapshot *snapshot;                  /* Where the next snapshot is captured before it replaces 'lastSnapshot' */
+    bool lastSnapshotValid;                         /* Set to true once 'lastSnapshot' has been captured */
     uint32_t reconnectSeconds;                      /* Number of seconds to wait between attempts to reconnect to MoCA */
 
     RMH_LogLevel apiLogLevel;                       /* The logging level to print from the app and RMH */
@@ -98,6 +218,12 @@ typedef struct RMHMonitor {
     bool serviceMode;                               /* Set to true if the app is being started as a service. This will allow us to do things like systemd notify */
     const char *out_file_name;                      /* The name of the file to write output to */
     FILE* out_file;                                 /* The handle of the file to write output to */
+    uint32_t logFlushMs;                            /* The longest time in milliseconds a message may wait before it's written */
+    RMHMonitor_LogQueue logQueue;                   /* Output waiting to be written by the log writer thread */
+    RMHMonitor_Service service;                     /* Serves the status to other processes */
+    const char *shmName;                            /* The shared memory object the status is published in. Disabled if this is empty */
+    uint32_t shmRefreshMs;                          /* How often in milliseconds the status in shared memory is refreshed. 0 for only on events */
+    RMH_ShmHandle shm;                              /* Where the status is published. NULL if it isn't */
 } RMHMonitor;
 
 
@@ -114,7 +240,7 @@ void RMH_Print_Raw(RMHMonitor *app, struct timeval *time, const char*fmt, ...);
     if (app && (app->apiLogLevel & level) == level) { \
         struct timeval now; \
         gettimeofday(&now, NULL); \
-        app->lastPrint=now; \
+        clock_gettime(CLOCK_MONOTONIC, &app->lastPrint); \
         if (time != NULL) { \
             RMH_Print_Raw(app, time, fmt, ##__VA_ARGS__); \
         } \
@@ -126,16 +252,39 @@ void RMH_Print_Raw(RMHMonitor *app, struct timeval *time, const char*fmt, ...);
 
 
 
-RMHMonitor_hSemaphore RMHMonitor_Semaphore_Create();
-void RMHMonitor_Semaphore_Destroy(RMHMonitor_hSemaphore eventHandle);
-RMH_Result RMHMonitor_Semaphore_Reset(RMHMonitor_hSemaphore eventHandle);
-RMH_Result RMHMonitor_Semaphore_Signal(RMHMonitor_hSemaphore eventHandle);
-RMH_Result RMHMonitor_Semaphore_WaitTimeout(RMHMonitor_hSemaphore eventHandle, const int timeoutMsec);
-void RMHMonitor_Queue_Dequeue(RMHMonitor *app);
+RMH_Result RMHMonitor_Queue_Init(RMHMonitor *app);
+void RMHMonitor_Queue_Destroy(RMHMonitor *app);
 void RMHMonitor_Queue_Enqueue(RMHMonitor *app, const enum RMH_Event event, const struct RMH_EventData *eventData);
+bool RMHMonitor_Queue_Dequeue(RMHMonitor *app, RMHMonitor_CallbackEvent *cbE);
+int RMHMonitor_Queue_GetNotifyFd(RMHMonitor *app);
+void RMHMonitor_Queue_ResetNotify(RMHMonitor *app);
+uint64_t RMHMonitor_Queue_GetDropped(RMHMonitor *app, uint64_t *numOverflows);
+
+size_t RMHMonitor_Append(char *buf, const size_t bufSize, size_t len, const char *fmt, ...);
+
+RMH_Handle RMHMonitor_StatusHandle_Get(RMHMonitor *app);
+void RMHMonitor_StatusHandle_Close(RMHMonitor *app);
+
+RMH_Result RMHMonitor_Shm_Start(RMHMonitor *app);
+void RMHMonitor_Shm_Stop(RMHMonitor *app);
+void RMHMonitor_Shm_Publish(RMHMonitor *app);
+
+RMH_Result RMHMonitor_Snapshot_Init(RMHMonitor *app);
+void RMHMonitor_Snapshot_Destroy(RMHMonitor *app);
+void RMHMonitor_Snapshot_Update(RMHMonitor *app, const RMH_Handle handle, const struct timeval *time);
+RMH_Result RMHMonitor_Snapshot_PrintChanged(RMHMonitor *app, const RMH_Handle handle, const struct timeval *time);
+size_t RMHMonitor_Snapshot_PrintStatsJSON(RMHMonitor *app, char *buf, const size_t bufSize, size_t len);
+
+RMH_Result RMHMonitor_Service_Start(RMHMonitor *app);
+void RMHMonitor_Service_Stop(RMHMonitor *app);
+void RMHMonitor_Service_Publish(RMHMonitor *app);
+
+RMH_Result RMHMonitor_Log_Start(RMHMonitor *app);
+void RMHMonitor_Log_Stop(RMHMonitor *app);
 
 
 void RMHMonitor_Event_Thread(void * context);
+void RMHMonitor_RequestStop(RMHMonitor *app);
 void RMHMonitor_RMHCallback(const enum RMH_Event event, const struct RMH_EventData *eventData, void* userContext);
 
 #endif
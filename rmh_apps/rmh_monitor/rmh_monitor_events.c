@@ -17,14 +17,28 @@
  * limitations under the License.
 */
 #include <pthread.h>
+#include <errno.h>
+#include <unistd.h>
 #include <sys/time.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <sys/signalfd.h>
+#include <signal.h>
+#include <time.h>
 #include "rmh_monitor.h"
 
 /**
- * The frequency in minutes that full network status should be dumpped in a stable environment.
+ * The frequency in minutes that the network status should be dumpped in a stable environment. Only what changed since
+ * the last dump is print.
  */
 #define RMH_MONITOR_STATUS_DUMP_MIN 60
 
+/**
+ * The frequency in minutes that a full baseline of the network status is dumpped. This can also be requested at any
+ * time with SIGUSR1.
+ */
+#define RMH_MONITOR_STATUS_BASELINE_MIN (12*60)
+
 /**
  * The frequency in minutes that a one line 'ping' message will appear in the logs when everything is stable.
  */
@@ -207,7 +221,8 @@ bool RMHMonitor_Event_NetworkMoCAVersionChanged(RMHMonitor *app, struct timeval
 
 
 /**
- * This function is called when we expect that MoCA 'link' status has changed
+ * This function is called when we expect that MoCA 'link' status has changed. It only records the change. If the link
+ * came up the caller must follow with RMHMonitor_Event_RefreshNetwork()
 */
 static inline
 bool RMHMonitor_Event_LinkStatusChanged(RMHMonitor *app, struct timeval *time, const RMH_LinkStatus linkStatus) {
@@ -220,6 +235,20 @@ bool RMHMonitor_Event_LinkStatusChanged(RMHMonitor *app, struct timeval *time, c
     app->linkStatus=linkStatus;
     app->linkStatusValid=true;
 
+    if (app->linkStatus != RMH_LINK_STATUS_UP) {
+        /* MoCA is down, invalidate net status */
+        memset(&app->netStatus, 0, sizeof(app->netStatus));
+    }
+    return true;
+}
+
+
+/**
+ * This function reads the whole network from RMH once the link is up: the self node, every remote node, the NC and the
+ * MoCA version. Anything which differs from what we knew is printed.
+*/
+static
+void RMHMonitor_Event_RefreshNetwork(RMHMonitor *app, struct timeval *time) {
     if (app->linkStatus == RMH_LINK_STATUS_UP) {
         /* Link is up, update netstatus */
         RMH_Result ret;
@@ -264,11 +293,6 @@ bool RMHMonitor_Event_LinkStatusChanged(RMHMonitor *app, struct timeval *time, c
             RMHMonitor_Event_NetworkMoCAVersionChanged(app, time, networkMoCAVer);
         }
     }
-    else {
-        /* MoCA is down, invalidate net status */
-        memset(&app->netStatus, 0, sizeof(app->netStatus));
-    }
-    return true;
 }
 
 
@@ -277,8 +301,9 @@ bool RMHMonitor_Event_LinkStatusChanged(RMHMonitor *app, struct timeval *time, c
  */
 static
 void RMHMonitor_Event_PrintPing(RMHMonitor *app, struct timeval *time) {
+    RMH_Handle rmh=RMHMonitor_StatusHandle_Get(app);
     bool mocaEnabled;
-    if (RMH_Self_GetEnabled(app->rmh, &mocaEnabled) != RMH_SUCCESS || !mocaEnabled) {
+    if (RMH_Self_GetEnabled(rmh, &mocaEnabled) != RMH_SUCCESS || !mocaEnabled) {
         RMH_PrintMsgT(time, "Link:DISABLED\n");
     }
     else if (app->linkStatus != RMH_LINK_STATUS_UP) {
@@ -287,86 +312,299 @@ void RMHMonitor_Event_PrintPing(RMHMonitor *app, struct timeval *time) {
     else {
         uint32_t numNodes, ncNode, selfNode, uptime;
         int32_t numNodesPrint, ncNodePrint, selfNodePrint, uptimePrint;
-        numNodesPrint = RMH_Network_GetNumNodes(app->rmh, &numNodes) == RMH_SUCCESS ? numNodes : -1;
-        selfNodePrint = RMH_Network_GetNodeId(app->rmh, &selfNode)   == RMH_SUCCESS ? selfNode : -1;
-        ncNodePrint =   RMH_Network_GetNCNodeId(app->rmh, &ncNode)   == RMH_SUCCESS ? ncNode   : -1;
-        uptimePrint=    RMH_Network_GetLinkUptime(app->rmh, &uptime) == RMH_SUCCESS ? uptime   : 0;
+        numNodesPrint = RMH_Network_GetNumNodes(rmh, &numNodes) == RMH_SUCCESS ? numNodes : -1;
+        selfNodePrint = RMH_Network_GetNodeId(rmh, &selfNode)   == RMH_SUCCESS ? selfNode : -1;
+        ncNodePrint =   RMH_Network_GetNCNodeId(rmh, &ncNode)   == RMH_SUCCESS ? ncNode   : -1;
+        uptimePrint=    RMH_Network_GetLinkUptime(rmh, &uptime) == RMH_SUCCESS ? uptime   : 0;
         RMH_PrintMsgT(time, "Link:UP [%02uh:%02um:%02us] Nodes:%d Self:%d NC:%d\n", uptimePrint/3600, (uptimePrint%3600)/60, uptimePrint%60, numNodesPrint, selfNodePrint, ncNodePrint);
     }
 }
 
 
 /**
- * This function should print a full status summary.
+ * This function should print a status summary. A 'baseline' prints the full status. Otherwise only what changed since the
+ * last status summary is print.
  */
 static
-void RMHMonitor_Event_PrintFull(RMHMonitor *app, struct timeval *time) {
+void RMHMonitor_Event_PrintStatus(RMHMonitor *app, struct timeval *time, const bool baseline) {
     bool mocaEnabled = false;
-    RMH_Handle rmh=app->rmh;
-
-    /*********************************************************************
-     * We're seeing an issue where after some time (30+ minutes) the MoCA
-     * driver is having issues using handles that have sat inactive. For
-     * Now we'll just create a new temporary handle to dump the status.
-     * Eventually, when this bug is fixed, we should remove this and use
-     * the default handle 'app->rmh'
-     **********************************************************************/
-    rmh=RMH_Initialize(RMHMonitor_RMHCallback, app);
-    if (rmh && RMH_Log_SetAPILevel(rmh, RMH_LOG_DEFAULT ) != RMH_SUCCESS) {
-        RMH_PrintErr("Failed to set the log level on temporary status handle!\n");
-        RMH_Destroy(rmh);
-        rmh=NULL;
-    }
-    if (rmh && RMH_SetEventCallbacks(rmh, RMH_EVENT_API_PRINT) != RMH_SUCCESS) {
-        RMH_PrintErr("Failed setting callback events on temporary status handle!\n");
-        RMH_Destroy(rmh);
-        rmh=NULL;
-    }
-    if (!rmh) {
-        rmh=app->rmh;
-    }
-    /**********************************************************************/
-
-    if (RMH_Self_GetEnabled(rmh, &mocaEnabled) == RMH_SUCCESS && mocaEnabled) {
-        RMH_PrintMsg("==============================================================================================================================\n");
-        RMH_Log_PrintStatus(rmh, NULL);
-        RMH_PrintMsg("==============================================================================================================================\n");
-        RMH_Log_PrintStats(rmh, NULL);
-        RMH_PrintMsg("==============================================================================================================================\n");
-        RMH_Log_PrintModulation(rmh, NULL);
-        RMH_PrintMsg("==============================================================================================================================\n");
-        RMH_Log_PrintFlows(rmh, NULL);
-        RMH_PrintMsg("==============================================================================================================================\n");
-    }
-
-    /**********************************************************************/
-    if (rmh != app->rmh) {
-        RMH_Destroy(rmh);
-    }
-    /**********************************************************************/
+    RMH_Handle rmh=RMHMonitor_StatusHandle_Get(app);
+
+    if (baseline || RMHMonitor_Snapshot_PrintChanged(app, rmh, time) != RMH_SUCCESS) {
+        if (RMH_Self_GetEnabled(rmh, &mocaEnabled) == RMH_SUCCESS && mocaEnabled) {
+            RMH_PrintMsg("==============================================================================================================================\n");
+            RMH_Log_PrintStatus(rmh, NULL);
+            RMH_PrintMsg("==============================================================================================================================\n");
+            RMH_Log_PrintStats(rmh, NULL);
+            RMH_PrintMsg("==============================================================================================================================\n");
+            RMH_Log_PrintModulation(rmh, NULL);
+            RMH_PrintMsg("==============================================================================================================================\n");
+            RMH_Log_PrintFlows(rmh, NULL);
+            RMH_PrintMsg("==============================================================================================================================\n");
+        }
+        /* Keep the status which was just print to compare the next one to */
+        RMHMonitor_Snapshot_Update(app, rmh, time);
+    }
+}
+
+
+/**
+ * This function reads the link status from RMH and updates everything we know about the network from it.
+ */
+static
+RMH_Result RMHMonitor_Event_ReadLinkStatus(RMHMonitor *app, struct timeval *time) {
+    bool mocaEnabled;
+
+    if (RMH_Self_GetEnabled(app->rmh, &mocaEnabled) != RMH_SUCCESS) {
+        return RMH_FAILURE;
+    }
+    else if (mocaEnabled) {
+        RMH_LinkStatus linkStatus;
+        if (RMH_Self_GetLinkStatus(app->rmh, &linkStatus) == RMH_SUCCESS &&
+            RMHMonitor_Event_LinkStatusChanged(app, time, linkStatus)) {
+            RMHMonitor_Event_RefreshNetwork(app, time);
+        }
+    }
+    else {
+        RMHMonitor_Event_LinkStatusChanged(app, time, RMH_LINK_STATUS_DISABLED);
+    }
+    return RMH_SUCCESS;
+}
+
+
+/**
+ * The changes to the network made by one batch of events. Events are applied in order but anything needing calls into
+ * RMH is held here and done once when the batch is finished.
+ */
+typedef struct RMHMonitor_EventBatch {
+    bool refreshNetwork;                            /* The link came up. The whole network must be read again */
+    struct timeval refreshTime;                     /* Time of the event which brought the link up */
+    uint32_t joinedNodes;                           /* Bit mask of the nodes which joined */
+    struct timeval joinTime[RMH_MAX_MOCA_NODES];    /* Time of the join event of each node */
+    bool ncChanged;                                 /* An NC change was reported. 'ncNodeId' is the latest */
+    uint32_t ncNodeId;
+    struct timeval ncTime;
+    bool versionChanged;                            /* A MoCA version change was reported. 'version' is the latest */
+    RMH_MoCAVersion version;
+    struct timeval versionTime;
+} RMHMonitor_EventBatch;
+
+
+/**
+ * This function applies one event from the queue to 'batch', printing it right away when nothing needs to be read.
+ */
+static
+bool RMHMonitor_Event_Apply(RMHMonitor *app, RMHMonitor_EventBatch *batch, RMHMonitor_CallbackEvent *cbE) {
+    char printBuff[128];
+    bool changed=false;
+    uint32_t nodeId;
+
+    switch(cbE->event) {
+    case RMH_EVENT_ADMISSION_STATUS_CHANGED:
+        RMH_PrintMsgT(&cbE->eventTime, "[ADMNSTUS] Admission status: %s\n", RMH_AdmissionStatusToString(cbE->eventData.RMH_EVENT_ADMISSION_STATUS_CHANGED.status));
+        break;
+    case RMH_EVENT_LINK_STATUS_CHANGED:
+        app->appPrefix="[CHANGE] ";
+        changed=RMHMonitor_Event_LinkStatusChanged(app, &cbE->eventTime, cbE->eventData.RMH_EVENT_LINK_STATUS_CHANGED.status);
+        if (changed) {
+            /* Whatever was pending is either out of date or will be read again with the rest of the network */
+            memset(batch, 0, sizeof(*batch));
+            batch->refreshNetwork=(app->linkStatus == RMH_LINK_STATUS_UP);
+            batch->refreshTime=cbE->eventTime;
+        }
+        break;
+    case RMH_EVENT_MOCA_RESET:
+        RMH_PrintMsgT(&cbE->eventTime, "[*RESET* ] MoCA Reset triggered - %s\n", RMH_MoCAResetReasonToString(cbE->eventData.RMH_EVENT_MOCA_RESET.reason));
+        break;
+    case RMH_EVENT_MOCA_VERSION_CHANGED:
+        batch->versionChanged=true;
+        batch->version=cbE->eventData.RMH_EVENT_MOCA_VERSION_CHANGED.version;
+        batch->versionTime=cbE->eventTime;
+        break;
+    case RMH_EVENT_NODE_JOINED:
+        nodeId=cbE->eventData.RMH_EVENT_NODE_JOINED.nodeId;
+        if (nodeId < RMH_MAX_MOCA_NODES) {
+            batch->joinedNodes|=(1u << nodeId);
+            batch->joinTime[nodeId]=cbE->eventTime;
+        }
+        break;
+    case RMH_EVENT_NODE_DROPPED:
+        nodeId=cbE->eventData.RMH_EVENT_NODE_DROPPED.nodeId;
+        app->appPrefix="[CHANGE] ";
+        if (nodeId < RMH_MAX_MOCA_NODES && (batch->joinedNodes & (1u << nodeId))) {
+            batch->joinedNodes&=~(1u << nodeId);
+            if (app->linkStatus == RMH_LINK_STATUS_UP && !app->netStatus.nodes[nodeId].joined) {
+                /* Joined and dropped in the same batch. The node is already gone so there's nothing to read. Log both from the events */
+                RMH_PrintMsgT(&batch->joinTime[nodeId], "Node:%02u joined\n", nodeId);
+                RMH_PrintMsgT(&cbE->eventTime, "Node:%02u dropped before it could be read\n", nodeId);
+                break;
+            }
+        }
+        changed|=RMHMonitor_Event_DropNode(app, &cbE->eventTime, nodeId);
+        break;
+    case RMH_EVENT_NC_ID_CHANGED:
+        if (cbE->eventData.RMH_EVENT_NC_ID_CHANGED.ncValid) {
+            batch->ncChanged=true;
+            batch->ncNodeId=cbE->eventData.RMH_EVENT_NC_ID_CHANGED.ncNodeId;
+            batch->ncTime=cbE->eventTime;
+        }
+        break;
+    case RMH_EVENT_LOW_BANDWIDTH:
+        RMH_PrintMsgT(&cbE->eventTime, "WARNING: Low bandwidth reported\n");
+        break;
+    case RMH_EVENT_INTERFACE_STATUS_CHANGED:
+        RMH_PrintMsgT(&cbE->eventTime, "[IFSTATUS] MoCA interface is %s\n", cbE->eventData.RMH_EVENT_INTERFACE_STATUS_CHANGED.enabled ? "UP" : "DOWN");
+        break;
+    default:
+        RMH_PrintMsgT(&cbE->eventTime, "WARNING: Unhandled MoCA event %s!\n", RMH_EventToString(cbE->event, printBuff, sizeof(printBuff)));
+        break;
+    }
+    return changed;
+}
+
+
+/**
+ * This function makes the RMH calls needed by a batch. Nodes are read before the NC so its MAC is known when it's printed.
+ */
+static
+bool RMHMonitor_Event_Commit(RMHMonitor *app, RMHMonitor_EventBatch *batch) {
+    bool changed=false;
+    uint32_t nodeId;
+
+    app->appPrefix="[CHANGE] ";
+    if (batch->refreshNetwork) {
+        /* This reads every node, the NC and the version so nothing else pending is needed */
+        RMHMonitor_Event_RefreshNetwork(app, &batch->refreshTime);
+        changed=true;
+    }
+    else {
+        for (nodeId=0; nodeId < RMH_MAX_MOCA_NODES; nodeId++) {
+            if (batch->joinedNodes & (1u << nodeId)) {
+                changed|=RMHMonitor_Event_JoinNode(app, &batch->joinTime[nodeId], nodeId);
+            }
+        }
+        if (batch->ncChanged) {
+            changed|=RMHMonitor_Event_NCChanged(app, &batch->ncTime, batch->ncNodeId);
+        }
+        if (batch->versionChanged) {
+            changed|=RMHMonitor_Event_NetworkMoCAVersionChanged(app, &batch->versionTime, batch->version);
+        }
+    }
+    return changed;
+}
+
+
+/**
+ * The timers of the event thread. Each is a one shot timerfd on CLOCK_MONOTONIC armed for the next time it's needed so
+ * nothing wakes the thread while the network is idle.
+ */
+typedef enum RMHMonitor_Timer {
+    RMH_MONITOR_TIMER_BASELINE,                     /* A full status dump is due */
+    RMH_MONITOR_TIMER_DUMP,                         /* A dump of what changed in the status is due */
+    RMH_MONITOR_TIMER_PING,                         /* A one line ping is due */
+    RMH_MONITOR_TIMER_STABILIZE,                    /* A change is waiting for the network to be stable before dumping the status */
+    RMH_MONITOR_TIMER_SHM,                          /* The status in shared memory is due to be refreshed */
+    RMH_MONITOR_NUM_TIMERS
+} RMHMonitor_Timer;
+
+/* Identifies the queue's eventfd and the signalfd in epoll. The timers are identified by their RMHMonitor_Timer */
+#define RMH_MONITOR_EPOLL_QUEUE RMH_MONITOR_NUM_TIMERS
+#define RMH_MONITOR_EPOLL_SIGNAL (RMH_MONITOR_NUM_TIMERS+1)
+
+
+/**
+ * Arm 'timerFd' to fire once in 'timeoutMs'. A timeout of 0 disarms it.
+ */
+static
+void RMHMonitor_Event_ArmTimer(RMHMonitor *app, const int timerFd, const uint64_t timeoutMs) {
+    struct itimerspec timerSpec;
+
+    memset(&timerSpec, 0, sizeof(timerSpec));
+    timerSpec.it_value.tv_sec=timeoutMs/1000;
+    timerSpec.it_value.tv_nsec=(timeoutMs%1000)*1000000;
+    if (timerfd_settime(timerFd, 0, &timerSpec, NULL) != 0) {
+        RMH_PrintErr("Failed to arm a timer -- %s!\n", strerror(errno));
+    }
 }
 
 
 /**
- * This is the main event thread. It will monitor the event queue and when an even occurs it will take some action
+ * Returns the number of milliseconds since anything was last print to the log.
+ */
+static inline
+uint64_t RMHMonitor_Event_MsSinceLastPrint(RMHMonitor *app) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec-app->lastPrint.tv_sec)*1000 + (now.tv_nsec-app->lastPrint.tv_nsec)/1000000;
+}
+
+
+/**
+ * This is the main event thread. It sleeps in epoll until an event is queued or one of its timers fires and then takes
+ * whatever action is needed.
 */
 void RMHMonitor_Event_Thread(void * context) {
     RMHMonitor *app=(RMHMonitor *)context;
-    RMHMonitor_CallbackEvent *cbE;
+    RMHMonitor_CallbackEvent callbackEvent;
+    RMHMonitor_CallbackEvent *cbE=&callbackEvent;
     RMH_Result ret;
-    bool networkStable=false;
-    bool mocaEnabled;
-    char printBuff[128];
+    uint64_t numDropped=0;
+    uint64_t numDroppedNow;
+    uint64_t numOverflows;
+    uint64_t msSinceLastPrint;
     bool printStatus = false;
+    bool timerFired[RMH_MONITOR_NUM_TIMERS];
+    int timerFds[RMH_MONITOR_NUM_TIMERS];
+    struct epoll_event epollEvents[RMH_MONITOR_NUM_TIMERS+2];
+    struct epoll_event epollEvent;
     struct timeval now;
-    struct timeval lastStatusPrint;
-    struct timeval lastStatusPing;
+    sigset_t sigSet;
+    bool baselineRequested;
+    bool publishShm;
+    int epollFd;
+    int signalFd=-1;
+    int numReady;
     int threadRet=1;
+    int i;
 
     /* Reset internal status */
     app->linkStatusValid=false;
     memset(&app->netStatus, 0, sizeof(app->netStatus));
 
+    /* Everything the thread waits for goes in one epoll set */
+    for (i=0; i < RMH_MONITOR_NUM_TIMERS; i++) {
+        timerFds[i]=-1;
+    }
+    epollFd=epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd < 0) {
+        RMH_PrintErr("Failed to create epoll -- %s!\n", strerror(errno));
+        goto exit_err;
+    }
+    memset(&epollEvent, 0, sizeof(epollEvent));
+    epollEvent.events=EPOLLIN;
+    epollEvent.data.u32=RMH_MONITOR_EPOLL_QUEUE;
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, RMHMonitor_Queue_GetNotifyFd(app), &epollEvent) != 0) {
+        RMH_PrintErr("Failed to add the event queue to epoll -- %s!\n", strerror(errno));
+        goto exit_err;
+    }
+    for (i=0; i < RMH_MONITOR_NUM_TIMERS; i++) {
+        timerFds[i]=timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        epollEvent.data.u32=i;
+        if (timerFds[i] < 0 || epoll_ctl(epollFd, EPOLL_CTL_ADD, timerFds[i], &epollEvent) != 0) {
+            RMH_PrintErr("Failed to create timer %d -- %s!\n", i, strerror(errno));
+            goto exit_err;
+        }
+    }
+
+    /* SIGUSR1 requests a full status. It's blocked in every thread by main so it's only seen here */
+    sigemptyset(&sigSet);
+    sigaddset(&sigSet, SIGUSR1);
+    signalFd=signalfd(-1, &sigSet, SFD_NONBLOCK | SFD_CLOEXEC);
+    epollEvent.data.u32=RMH_MONITOR_EPOLL_SIGNAL;
+    if (signalFd < 0 || epoll_ctl(epollFd, EPOLL_CTL_ADD, signalFd, &epollEvent) != 0) {
+        RMH_PrintWrn("Unable to watch for SIGUSR1 -- %s. A full status will only be print every %u minutes\n", strerror(errno), RMH_MONITOR_STATUS_BASELINE_MIN);
+    }
+
     /* Validate the handle */
     ret = RMH_ValidateHandle(app->rmh);
     if (ret == RMH_UNIMPLEMENTED || ret == RMH_NOT_SUPPORTED) {
@@ -380,32 +618,53 @@ void RMHMonitor_Event_Thread(void * context) {
     /* Dump a full status to get things started */
     gettimeofday(&now, NULL);
 
-    if (RMH_Self_GetEnabled(app->rmh, &mocaEnabled) != RMH_SUCCESS) {
+    if (RMHMonitor_Event_ReadLinkStatus(app, &now) != RMH_SUCCESS) {
         goto exit_err;
     }
-    else if (mocaEnabled) {
-        RMH_LinkStatus linkStatus;
-        if (RMH_Self_GetLinkStatus(app->rmh, &linkStatus) == RMH_SUCCESS) {
-            RMHMonitor_Event_LinkStatusChanged(app, &now, linkStatus);
-        }
-    }
-    else {
-        RMHMonitor_Event_LinkStatusChanged(app, &now, RMH_LINK_STATUS_DISABLED);
-    }
-    RMHMonitor_Event_PrintFull(app, &now);
+    RMHMonitor_Event_PrintStatus(app, &now, true);
+    RMHMonitor_Service_Publish(app);
+    RMHMonitor_Shm_Publish(app);
 
     /* Looks like we're connected with a valid handle, reset the timer */
     app->reconnectSeconds=0;
 
     app->appPrefix=NULL;
-    lastStatusPrint=now;
-    lastStatusPing=now;
+    RMHMonitor_Event_ArmTimer(app, timerFds[RMH_MONITOR_TIMER_BASELINE], RMH_MONITOR_STATUS_BASELINE_MIN*60*1000);
+    RMHMonitor_Event_ArmTimer(app, timerFds[RMH_MONITOR_TIMER_DUMP], RMH_MONITOR_STATUS_DUMP_MIN*60*1000);
+    RMHMonitor_Event_ArmTimer(app, timerFds[RMH_MONITOR_TIMER_PING], RMH_MONITOR_STATUS_PING_MIN*60*1000);
+    if (app->shm) {
+        RMHMonitor_Event_ArmTimer(app, timerFds[RMH_MONITOR_TIMER_SHM], app->shmRefreshMs);
+    }
 
     /* Loop forever here until the thread is no longer running */
-    while (app->eventThreadRunning) {
-        ret=RMHMonitor_Semaphore_WaitTimeout(app->eventNotify, 2000);
-        if (ret == RMH_FAILURE) {
-            RMH_PrintErr("Failed in RMHMonitor_Semaphore_WaitTimeout\n");
+    while (__atomic_load_n(&app->eventThreadRunning, __ATOMIC_SEQ_CST)) {
+        numReady=epoll_wait(epollFd, epollEvents, sizeof(epollEvents)/sizeof(epollEvents[0]), -1);
+        if (numReady < 0) {
+            if (errno == EINTR) continue;
+            RMH_PrintErr("Failed in epoll_wait -- %s!\n", strerror(errno));
+            goto exit_err;
+        }
+
+        /* Clear whatever woke us. The queue must be reset before it's drained or an event queued in between could be missed */
+        memset(timerFired, 0, sizeof(timerFired));
+        baselineRequested=false;
+        publishShm=false;
+        for (i=0; i < numReady; i++) {
+            if (epollEvents[i].data.u32 == RMH_MONITOR_EPOLL_QUEUE) {
+                RMHMonitor_Queue_ResetNotify(app);
+            }
+            else if (epollEvents[i].data.u32 == RMH_MONITOR_EPOLL_SIGNAL) {
+                struct signalfd_siginfo sigInfo;
+                while (read(signalFd, &sigInfo, sizeof(sigInfo)) == sizeof(sigInfo)) {
+                    baselineRequested=true;
+                }
+            }
+            else {
+                uint64_t expirations;
+                if (read(timerFds[epollEvents[i].data.u32], &expirations, sizeof(expirations)) == sizeof(expirations)) {
+                    timerFired[epollEvents[i].data.u32]=true;
+                }
+            }
         }
 
         gettimeofday(&now, NULL);
@@ -416,87 +675,133 @@ void RMHMonitor_Event_Thread(void * context) {
             goto exit_err;
         }
 
+        /* If events were lost what we know about the network may be wrong. Throw it away and read it all again. What's
+         * still queued is older than what will be read and applying it on top could undo it, so discard it first */
+        numDroppedNow=RMHMonitor_Queue_GetDropped(app, &numOverflows);
+        if (numDroppedNow != numDropped) {
+            uint32_t numDiscarded=0;
+            while (numDiscarded < RMH_MONITOR_EVENT_QUEUE_SIZE && RMHMonitor_Queue_Dequeue(app, cbE)) {
+                numDiscarded++;
+            }
+            app->appPrefix="[RESYNC] ";
+            RMH_PrintWrn("The event queue was full. %llu events lost [Total lost:%llu Overflows:%llu] and %u queued events discarded. Reading the network status again\n",
+                            (unsigned long long)(numDroppedNow-numDropped), (unsigned long long)numDroppedNow, (unsigned long long)numOverflows, numDiscarded);
+            numDropped=numDroppedNow;
+            app->linkStatusValid=false;
+            memset(&app->netStatus, 0, sizeof(app->netStatus));
+            RMHMonitor_Event_ReadLinkStatus(app, &now);
+            printStatus=true;
+            publishShm=true;
+        }
+
+        /* Handle every event waiting in the queue as one batch */
+        if (RMHMonitor_Queue_Dequeue(app, cbE)) {
+            RMHMonitor_EventBatch batch;
+            struct timespec batchStart;
+            struct timespec batchEnd;
+            struct timeval oldestEvent=cbE->eventTime;
+            uint32_t numEvents=0;
+
+            clock_gettime(CLOCK_MONOTONIC, &batchStart);
+            memset(&batch, 0, sizeof(batch));
+            do {
+                printStatus|=RMHMonitor_Event_Apply(app, &batch, cbE);
+                numEvents++;
+            } while (numEvents < RMH_MONITOR_EVENT_QUEUE_SIZE && RMHMonitor_Queue_Dequeue(app, cbE));
+            printStatus|=RMHMonitor_Event_Commit(app, &batch);
+            publishShm=true;
+
+            /* If we have a request to print the full status, keep the prefix and we'll clear it later. If not clear it now. */
+            if (!printStatus) app->appPrefix=NULL;
+
+            clock_gettime(CLOCK_MONOTONIC, &batchEnd);
+            gettimeofday(&now, NULL);
+            RMH_PrintDbg("Event batch: %u queued events handled in %lldus. The oldest waited %lldus\n", numEvents,
+                            (long long)((batchEnd.tv_sec-batchStart.tv_sec)*1000000 + (batchEnd.tv_nsec-batchStart.tv_nsec)/1000),
+                            (long long)((now.tv_sec-oldestEvent.tv_sec)*1000000 + (now.tv_usec-oldestEvent.tv_usec)));
+
+            /* A batch which didn't stop the loop would otherwise wait for the next event to finish the queue */
+            if (numEvents == RMH_MONITOR_EVENT_QUEUE_SIZE) {
+                const uint64_t one=1;
+                if (write(RMHMonitor_Queue_GetNotifyFd(app), &one, sizeof(one)) != sizeof(one)) {
+                    RMH_PrintErr("Failed to reschedule the event queue -- %s!\n", strerror(errno));
+                }
+            }
+        }
+
         /* We determine that the network is 'stable' when there hasn't been anything print to the
-         * log in at least RMH_MONITOR_MIN_NETWORK_STABALIZE seconds. We can't just use the semaphore
-         * timeout because we might get repeated messages from the MoCA driver which aren't being print
+         * log in at least RMH_MONITOR_MIN_NETWORK_STABALIZE seconds. We can't just wait for a quiet
+         * period of events because we might get repeated messages from the MoCA driver which aren't being print
          * to the log (no change). In that case it will look like the log is frozen.
          */
-        networkStable=(now.tv_sec-app->lastPrint.tv_sec) > RMH_MONITOR_MIN_NETWORK_STABALIZE_SEC;
+        msSinceLastPrint=RMHMonitor_Event_MsSinceLastPrint(app);
 
-        /* We want to first check if we have any pending prints. This will happen because either
-         *    1) An event occurred which indicated a dump should happen
-         *    2) It has been RMH_MONITOR_STATUS_DUMP_MIN minutes has passed since the last status dump
+        /* Check if we have any pending prints. This will happen because either
+         *    1) SIGUSR1 asked for a full status or RMH_MONITOR_STATUS_BASELINE_MIN minutes have passed since the last one
+         *    2) An event occurred which indicated a dump should happen
+         *    3) It has been RMH_MONITOR_STATUS_DUMP_MIN minutes has passed since the last status dump
          *
-         *   Note: Before we print anything make sure the network is stable. This is to make sure we don't
-         *         flood logs with status updates if the network is changing frequently.
+         *   Note: Before we print a dump because of an event make sure the network is stable. This is to make sure
+         *         we don't flood logs with status updates if the network is changing frequently. If it isn't the
+         *         stabilize timer is armed for when it could be. Other than a full status, dumps only print what
+         *         changed since the last one.
          */
-        if ((now.tv_sec-lastStatusPrint.tv_sec) > RMH_MONITOR_STATUS_DUMP_MIN*60 ||
-             (printStatus && networkStable)) {
-            /* Dump the full status and update the last print time */
-            RMHMonitor_Event_PrintFull(app, &now);
+        if (baselineRequested || timerFired[RMH_MONITOR_TIMER_BASELINE]) {
+            /* Dump the full status and restart all the timers */
+            RMHMonitor_Event_PrintStatus(app, &now, true);
             app->appPrefix=NULL;
-            lastStatusPrint=now;
-            lastStatusPing=now;
             printStatus=false;
+            RMHMonitor_Event_ArmTimer(app, timerFds[RMH_MONITOR_TIMER_BASELINE], RMH_MONITOR_STATUS_BASELINE_MIN*60*1000);
+            RMHMonitor_Event_ArmTimer(app, timerFds[RMH_MONITOR_TIMER_DUMP], RMH_MONITOR_STATUS_DUMP_MIN*60*1000);
+            RMHMonitor_Event_ArmTimer(app, timerFds[RMH_MONITOR_TIMER_PING], RMH_MONITOR_STATUS_PING_MIN*60*1000);
+            RMHMonitor_Event_ArmTimer(app, timerFds[RMH_MONITOR_TIMER_STABILIZE], 0);
         }
-        else if (networkStable && (lastStatusPing.tv_sec == 0 || (now.tv_sec-lastStatusPing.tv_sec) > RMH_MONITOR_STATUS_PING_MIN*60)) {
-            /* Dump the ping status and update the last print time */
-            RMHMonitor_Event_PrintPing(app, &now);
-            lastStatusPing=now;
+        else if (timerFired[RMH_MONITOR_TIMER_DUMP] ||
+            (printStatus && msSinceLastPrint >= RMH_MONITOR_MIN_NETWORK_STABALIZE_SEC*1000)) {
+            /* Dump what changed and restart the dump and ping timers */
+            RMHMonitor_Event_PrintStatus(app, &now, false);
+            app->appPrefix=NULL;
+            printStatus=false;
+            RMHMonitor_Event_ArmTimer(app, timerFds[RMH_MONITOR_TIMER_DUMP], RMH_MONITOR_STATUS_DUMP_MIN*60*1000);
+            RMHMonitor_Event_ArmTimer(app, timerFds[RMH_MONITOR_TIMER_PING], RMH_MONITOR_STATUS_PING_MIN*60*1000);
+            RMHMonitor_Event_ArmTimer(app, timerFds[RMH_MONITOR_TIMER_STABILIZE], 0);
         }
-
-        /* We're all caught up on prints, check if there are any events in the queue */
-        cbE = app->eventQueue.tqh_first;
-        if (cbE) {
-            /* There is a pending event, handle it */
-            switch(cbE->event) {
-            case RMH_EVENT_ADMISSION_STATUS_CHANGED:
-                RMH_PrintMsgT(&cbE->eventTime, "[ADMNSTUS] Admission status: %s\n", RMH_AdmissionStatusToString(cbE->eventData.RMH_EVENT_ADMISSION_STATUS_CHANGED.status));
-                break;
-            case RMH_EVENT_LINK_STATUS_CHANGED:
-                app->appPrefix="[CHANGE] ";
-                printStatus|=RMHMonitor_Event_LinkStatusChanged(app, &cbE->eventTime, cbE->eventData.RMH_EVENT_LINK_STATUS_CHANGED.status);
-                break;
-            case RMH_EVENT_MOCA_RESET:
-                RMH_PrintMsgT(&cbE->eventTime, "[*RESET* ] MoCA Reset triggered - %s\n", RMH_MoCAResetReasonToString(cbE->eventData.RMH_EVENT_MOCA_RESET.reason));
-                break;
-            case RMH_EVENT_MOCA_VERSION_CHANGED:
-                app->appPrefix="[CHANGE] ";
-                printStatus|=RMHMonitor_Event_NetworkMoCAVersionChanged(app, &cbE->eventTime, cbE->eventData.RMH_EVENT_MOCA_VERSION_CHANGED.version);
-                break;
-            case RMH_EVENT_NODE_JOINED:
-                app->appPrefix="[CHANGE] ";
-                printStatus|=RMHMonitor_Event_JoinNode(app, &cbE->eventTime, cbE->eventData.RMH_EVENT_NODE_JOINED.nodeId);
-                break;
-            case RMH_EVENT_NODE_DROPPED:
-                app->appPrefix="[CHANGE] ";
-                printStatus|=RMHMonitor_Event_DropNode(app, &cbE->eventTime, cbE->eventData.RMH_EVENT_NODE_JOINED.nodeId);
-                break;
-            case RMH_EVENT_NC_ID_CHANGED:
-                if (cbE->eventData.RMH_EVENT_NC_ID_CHANGED.ncValid) {
-                    app->appPrefix="[CHANGE] ";
-                    printStatus|=RMHMonitor_Event_NCChanged(app, &cbE->eventTime, cbE->eventData.RMH_EVENT_NC_ID_CHANGED.ncNodeId);
+        else {
+            if (printStatus) {
+                RMHMonitor_Event_ArmTimer(app, timerFds[RMH_MONITOR_TIMER_STABILIZE], RMH_MONITOR_MIN_NETWORK_STABALIZE_SEC*1000 - msSinceLastPrint);
+            }
+            if (timerFired[RMH_MONITOR_TIMER_PING]) {
+                if (msSinceLastPrint >= RMH_MONITOR_MIN_NETWORK_STABALIZE_SEC*1000) {
+                    /* Dump the ping status and restart its timer */
+                    RMHMonitor_Event_PrintPing(app, &now);
+                    RMHMonitor_Event_ArmTimer(app, timerFds[RMH_MONITOR_TIMER_PING], RMH_MONITOR_STATUS_PING_MIN*60*1000);
+                }
+                else {
+                    /* Not stable yet. Try again once it could be */
+                    RMHMonitor_Event_ArmTimer(app, timerFds[RMH_MONITOR_TIMER_PING], RMH_MONITOR_MIN_NETWORK_STABALIZE_SEC*1000 - msSinceLastPrint);
                 }
-                break;
-            case RMH_EVENT_LOW_BANDWIDTH:
-                RMH_PrintMsgT(&cbE->eventTime, "WARNING: Low bandwidth reported\n");
-                break;
-            default:
-                RMH_PrintMsgT(&cbE->eventTime, "WARNING: Unhandled MoCA event %s!\n", RMH_EventToString(cbE->event, printBuff, sizeof(printBuff)));
-                break;
             }
-            /* If we have a request to print the full status, keep the prefix and we'll clear it later. If not clear it now. */
-            if (!printStatus) app->appPrefix=NULL;
+        }
+
+        /* Let the service clients know if anything changed */
+        RMHMonitor_Service_Publish(app);
 
-            /* Clear this handled event off the queue */
-            RMHMonitor_Queue_Dequeue(app);
+        /* Refresh the status in shared memory right away after events, otherwise every 'shmRefreshMs' */
+        if (app->shm && (publishShm || timerFired[RMH_MONITOR_TIMER_SHM])) {
+            RMHMonitor_Shm_Publish(app);
+            RMHMonitor_Event_ArmTimer(app, timerFds[RMH_MONITOR_TIMER_SHM], app->shmRefreshMs);
         }
     }
 
-    ret=0;
-    pthread_exit(&threadRet);
-
 exit_err:
-    ret=1;
+    RMHMonitor_StatusHandle_Close(app);
+    /* Until we reconnect nothing is known about the link */
+    app->linkStatusValid=false;
+    RMHMonitor_Service_Publish(app);
+    for (i=0; i < RMH_MONITOR_NUM_TIMERS; i++) {
+        if (timerFds[i] >= 0) close(timerFds[i]);
+    }
+    if (signalFd >= 0) close(signalFd);
+    if (epollFd >= 0) close(epollFd);
     pthread_exit(&threadRet);
 }
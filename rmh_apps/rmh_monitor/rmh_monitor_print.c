@@ -19,100 +19,477 @@
 
 #include <stdarg.h>
 #include <pthread.h>
+#include <signal.h>
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+#include <limits.h>
 #include <sys/time.h>
+#include <sys/uio.h>
+#include <sys/mman.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
 #include "rmh_monitor.h"
 
 /**
- * Declaring this global so we don't need to come up with 2K on the stack on every print. Could move this to 'app' in the future if we want.
+ * The size of the buffer a message is formatted into before it's split into lines. Each thread which prints has its own.
  */
 #define PRINTBUF_SIZE 2048
-static char printBuff[PRINTBUF_SIZE];
+static __thread char printBuff[PRINTBUF_SIZE];
 
-inline
-void RMH_Write(RMHMonitor *app, const char*buf) {
-    fputs(buf, app->out_file ? app->out_file : stdout);
+/**
+ * Set when the last message this thread print ended with a new line so the next one needs a timestamp and prefix.
+ */
+static __thread bool newLine = true;
+
+/**
+ * The timestamp only changes text once a second. Each thread keeps the text for the last second it print so localtime
+ * is only done once a second rather than on every line.
+ */
+static __thread time_t timeCacheSec = -1;
+static __thread char timeCache[32];
+static __thread int timeCacheLen;
+
+/**
+ * The most records the writer thread hands to a single writev.
+ */
+#define RMH_MONITOR_LOG_MAX_IOV 64
+
+/**
+ * Signals which will have the writer thread flush everything queued before letting them end the process.
+ */
+static const int flushSignals[] = { SIGINT, SIGTERM, SIGHUP };
+
+
+/**
+ * Write all of 'iov' to 'fd', continuing after partial writes. This is used by the writer thread so errors go to
+ * stderr rather than back into the log queue.
+ */
+static
+void RMHMonitor_Log_WriteAll(const int fd, struct iovec *iov, int iovCnt) {
+    ssize_t written;
+
+    while (iovCnt > 0) {
+        written=writev(fd, iov, iovCnt);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            fprintf(stderr, "rmh_monitor: Failed to write log output -- %s\n", strerror(errno));
+            return;
+        }
+        while (iovCnt > 0 && (size_t)written >= iov->iov_len) {
+            written-=iov->iov_len;
+            iov++;
+            iovCnt--;
+        }
+        if (iovCnt > 0) {
+            iov->iov_base=(char *)iov->iov_base + written;
+            iov->iov_len-=written;
+        }
+    }
+}
+
+
+/**
+ * Write every record which is ready to 'outFd'. Only called by the writer thread, or once it has stopped, by whoever
+ * stopped it.
+ */
+static
+void RMHMonitor_Log_Drain(RMHMonitor *app) {
+    RMHMonitor_LogQueue *log=&app->logQueue;
+    struct iovec iov[RMH_MONITOR_LOG_MAX_IOV];
+    RMHMonitor_LogRecord *record;
+    int iovCnt;
+    int i;
+
+    do {
+        /* Gather as many ready records as we can into one writev */
+        for (iovCnt=0; iovCnt < RMH_MONITOR_LOG_MAX_IOV; iovCnt++) {
+            record=&log->records[(log->tail+iovCnt) & (RMH_MONITOR_LOG_QUEUE_SIZE-1)];
+            if (__atomic_load_n(&record->turn, __ATOMIC_ACQUIRE) != log->tail+iovCnt+1) break;
+            iov[iovCnt].iov_base=record->text;
+            iov[iovCnt].iov_len=record->len;
+        }
+        if (iovCnt == 0) break;
+
+        RMHMonitor_Log_WriteAll(log->outFd, iov, iovCnt);
+
+        /* Now the text is written the records can be reused */
+        for (i=0; i < iovCnt; i++) {
+            record=&log->records[log->tail & (RMH_MONITOR_LOG_QUEUE_SIZE-1)];
+            __atomic_store_n(&record->turn, log->tail+RMH_MONITOR_LOG_QUEUE_SIZE, __ATOMIC_RELEASE);
+            __atomic_store_n(&log->tail, log->tail+1, __ATOMIC_RELEASE);
+        }
+    } while (iovCnt == RMH_MONITOR_LOG_MAX_IOV);
+}
+
+
+/**
+ * Wake the writer thread.
+ */
+static inline
+void RMHMonitor_Log_Notify(RMHMonitor_LogQueue *log) {
+    const uint64_t one=1;
+    if (write(log->notifyFd, &one, sizeof(one)) != sizeof(one)) {
+        /* Only fails if the counter is about to overflow, in which case the writer thread is already being woken */
+    }
+}
+
+
+/**
+ * One of the flush signals arrived. The first asks the app to stop and it exits through main, which writes the log and
+ * removes the status service and shared memory. If another arrives before that's done, write everything queued and
+ * let the signal take its default action.
+ */
+static
+void RMHMonitor_Log_HandleSignal(RMHMonitor *app) {
+    RMHMonitor_LogQueue *log=&app->logQueue;
+    struct signalfd_siginfo sigInfo;
+    sigset_t sigSet;
+
+    if (read(log->signalFd, &sigInfo, sizeof(sigInfo)) != sizeof(sigInfo)) {
+        return;
+    }
+
+    if (!__atomic_load_n(&app->stopRequested, __ATOMIC_SEQ_CST)) {
+        RMHMonitor_RequestStop(app);
+        return;
+    }
+
+    RMHMonitor_Log_Drain(app);
+
+    /* The process won't get to stop the status service or the shared memory status so remove them here */
+    if (app->service.running) {
+        unlink(app->service.socketPath);
+    }
+    if (app->shm) {
+        shm_unlink(app->shmName);
+    }
+
+    signal(sigInfo.ssi_signo, SIG_DFL);
+    sigemptyset(&sigSet);
+    sigaddset(&sigSet, sigInfo.ssi_signo);
+    pthread_sigmask(SIG_UNBLOCK, &sigSet, NULL);
+    raise(sigInfo.ssi_signo);
+}
+
+
+/**
+ * Sleep until the writer thread is woken or 'timeoutMs' has passed. A timeout of -1 waits forever.
+ */
+static
+void RMHMonitor_Log_Wait(RMHMonitor *app, const int timeoutMs) {
+    RMHMonitor_LogQueue *log=&app->logQueue;
+    struct pollfd pfd[2];
+    uint64_t count;
+
+    pfd[0].fd=log->notifyFd;
+    pfd[0].events=POLLIN;
+    pfd[1].fd=log->signalFd;
+    pfd[1].events=POLLIN;
+    if (poll(pfd, 2, timeoutMs) > 0) {
+        if (pfd[1].revents & POLLIN) {
+            RMHMonitor_Log_HandleSignal(app);
+        }
+        if ((pfd[0].revents & POLLIN) && read(log->notifyFd, &count, sizeof(count)) != sizeof(count)) {
+            /* Nothing to do. The queue itself says what needs writing */
+        }
+    }
+}
+
+
+/**
+ * The log writer thread. It sleeps until a record is queued and then waits up to 'logFlushMs' for more to collect
+ * before writing them all together. A full queue, a flush request or stopping cuts the wait short.
+ */
+static
+void *RMHMonitor_Log_Thread(void *context) {
+    RMHMonitor *app=(RMHMonitor *)context;
+    RMHMonitor_LogQueue *log=&app->logQueue;
+    RMHMonitor_LogRecord *record;
+
+    while (true) {
+        /* Let the next print know it needs to wake us, then make sure nothing arrived before it could see that */
+        __atomic_store_n(&log->writerIdle, true, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        record=&log->records[log->tail & (RMH_MONITOR_LOG_QUEUE_SIZE-1)];
+        if (__atomic_load_n(&record->turn, __ATOMIC_ACQUIRE) != log->tail+1) {
+            if (!__atomic_load_n(&log->running, __ATOMIC_ACQUIRE)) break;
+            RMHMonitor_Log_Wait(app, -1);
+        }
+        __atomic_store_n(&log->writerIdle, false, __ATOMIC_RELAXED);
+
+        /* Give the rest of the batch a chance to arrive */
+        if (app->logFlushMs && __atomic_load_n(&log->running, __ATOMIC_ACQUIRE) &&
+            !__atomic_load_n(&log->flushRequested, __ATOMIC_ACQUIRE)) {
+            RMHMonitor_Log_Wait(app, app->logFlushMs);
+        }
+        __atomic_store_n(&log->flushRequested, false, __ATOMIC_RELAXED);
+        RMHMonitor_Log_Drain(app);
+    }
+
+    return NULL;
+}
+
+
+/**
+ * Start the log writer thread. Until this is called, and after RMHMonitor_Log_Stop, output is written right away by the
+ * thread printing it. This must be called before any other threads are created so they all inherit the blocked flush
+ * signals and leave them to the writer thread.
+ */
+RMH_Result RMHMonitor_Log_Start(RMHMonitor *app) {
+    RMHMonitor_LogQueue *log=&app->logQueue;
+    sigset_t sigSet;
+    sigset_t oldSigSet;
+    uint32_t i;
+
+    memset(log, 0, sizeof(*log));
+    for (i=0; i < RMH_MONITOR_LOG_QUEUE_SIZE; i++) {
+        log->records[i].turn=i;
+    }
+    log->outFd=app->out_file ? fileno(app->out_file) : STDOUT_FILENO;
+    log->signalFd=-1;
+    log->notifyFd=eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (log->notifyFd < 0) {
+        RMH_PrintErr("Failed to create the log queue eventfd -- %s!\n", strerror(errno));
+        return RMH_FAILURE;
+    }
+
+    sigemptyset(&sigSet);
+    for (i=0; i < sizeof(flushSignals)/sizeof(flushSignals[0]); i++) {
+        sigaddset(&sigSet, flushSignals[i]);
+    }
+    pthread_sigmask(SIG_BLOCK, &sigSet, &oldSigSet);
+    log->signalFd=signalfd(-1, &sigSet, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (log->signalFd < 0) {
+        RMH_PrintErr("Failed to create the log signalfd -- %s!\n", strerror(errno));
+        goto exit_err;
+    }
+
+    log->running=true;
+    if (pthread_create(&log->writerThread, NULL, RMHMonitor_Log_Thread, app) != 0) {
+        log->running=false;
+        RMH_PrintErr("Failed creating the log writer thread!\n");
+        goto exit_err;
+    }
+    return RMH_SUCCESS;
+
+exit_err:
+    pthread_sigmask(SIG_SETMASK, &oldSigSet, NULL);
+    if (log->signalFd >= 0) close(log->signalFd);
+    close(log->notifyFd);
+    log->signalFd=-1;
+    log->notifyFd=-1;
+    return RMH_FAILURE;
+}
+
+
+/**
+ * Stop the log writer thread once it has written everything queued. Anything print after this is written right away.
+ */
+void RMHMonitor_Log_Stop(RMHMonitor *app) {
+    RMHMonitor_LogQueue *log=&app->logQueue;
+
+    if (!log->running) {
+        return;
+    }
+    __atomic_store_n(&log->running, false, __ATOMIC_RELEASE);
+    RMHMonitor_Log_Notify(log);
+    pthread_join(log->writerThread, NULL);
+
+    /* Catch anything queued by a print which started before the thread was told to stop */
+    RMHMonitor_Log_Drain(app);
+
+    close(log->signalFd);
+    close(log->notifyFd);
+    log->signalFd=-1;
+    log->notifyFd=-1;
+}
+
+
+/**
+ * Claim the next free record in the log queue. If the queue is full this waits for the writer thread to make room.
+ */
+static
+RMHMonitor_LogRecord *RMHMonitor_Log_Claim(RMHMonitor_LogQueue *log, uint64_t *pos) {
+    RMHMonitor_LogRecord *record;
+    uint64_t turn;
+
+    *pos=__atomic_load_n(&log->head, __ATOMIC_RELAXED);
+    while (true) {
+        record=&log->records[*pos & (RMH_MONITOR_LOG_QUEUE_SIZE-1)];
+        turn=__atomic_load_n(&record->turn, __ATOMIC_ACQUIRE);
+        if (turn == *pos) {
+            /* The record is free. Claim it unless another thread got there first, in which case 'pos' is updated */
+            if (__atomic_compare_exchange_n(&log->head, pos, *pos+1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                record->len=0;
+                return record;
+            }
+        }
+        else if (turn < *pos) {
+            /* Full. Unlike events, log output is never dropped so wait for the writer to catch up */
+            __atomic_add_fetch(&log->numStalls, 1, __ATOMIC_RELAXED);
+            __atomic_store_n(&log->flushRequested, true, __ATOMIC_RELEASE);
+            RMHMonitor_Log_Notify(log);
+            usleep(1000);
+            *pos=__atomic_load_n(&log->head, __ATOMIC_RELAXED);
+        }
+        else {
+            *pos=__atomic_load_n(&log->head, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+
+/**
+ * Hand a filled record to the writer thread. If the writer is idle this is the first record of a batch so wake it.
+ * Otherwise the writer is only woken early when the queue is getting full.
+ */
+static
+void RMHMonitor_Log_Commit(RMHMonitor_LogQueue *log, RMHMonitor_LogRecord *record, const uint64_t pos) {
+    __atomic_store_n(&record->turn, pos+1, __ATOMIC_RELEASE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_exchange_n(&log->writerIdle, false, __ATOMIC_RELAXED) ||
+        pos-__atomic_load_n(&log->tail, __ATOMIC_RELAXED) == RMH_MONITOR_LOG_QUEUE_SIZE/2) {
+        RMHMonitor_Log_Notify(log);
+    }
+}
+
+
+/**
+ * The record text is collected here before being handed off. When the writer thread isn't running 'record' is on the
+ * stack of the printing thread and is written as soon as it's full.
+ */
+typedef struct RMHMonitor_LogWriter {
+    RMHMonitor_LogQueue *log;
+    RMHMonitor_LogRecord *record;
+    RMHMonitor_LogRecord localRecord;
+    uint64_t pos;
+} RMHMonitor_LogWriter;
+
+static
+void RMHMonitor_Log_WriterFlush(RMHMonitor_LogWriter *writer) {
+    struct iovec iov;
+
+    if (writer->record == NULL || writer->record->len == 0) {
+        return;
+    }
+    if (writer->record == &writer->localRecord) {
+        iov.iov_base=writer->record->text;
+        iov.iov_len=writer->record->len;
+        RMHMonitor_Log_WriteAll(writer->log->outFd, &iov, 1);
+        writer->record->len=0;
+    }
+    else {
+        RMHMonitor_Log_Commit(writer->log, writer->record, writer->pos);
+        writer->record=NULL;
+    }
+}
+
+static
+void RMHMonitor_Log_Append(RMHMonitor_LogWriter *writer, const char *text, size_t len) {
+    size_t copyLen;
+
+    while (len > 0) {
+        if (writer->record == NULL) {
+            writer->record=RMHMonitor_Log_Claim(writer->log, &writer->pos);
+        }
+        copyLen=RMH_MONITOR_LOG_RECORD_SIZE-writer->record->len;
+        if (copyLen > len) copyLen=len;
+        memcpy(&writer->record->text[writer->record->len], text, copyLen);
+        writer->record->len+=copyLen;
+        text+=copyLen;
+        len-=copyLen;
+        if (writer->record->len == RMH_MONITOR_LOG_RECORD_SIZE) {
+            RMHMonitor_Log_WriterFlush(writer);
+        }
+    }
 }
 
+
 /**
- * This is the main print function in this program. It will attempt to write 'fmt' string to stdout. It will also account for
- * new lines and print the time and appPrefix before each line
+ * Append the timestamp for 'time' in the form 'YYYY.MM.DD HH:MM:SS:mmm '.
+ */
+static
+void RMHMonitor_Log_AppendTime(RMHMonitor_LogWriter *writer, const struct timeval *time) {
+    char msBuf[8];
+    struct tm tm_info;
+
+    if (time->tv_sec != timeCacheSec) {
+        localtime_r(&time->tv_sec, &tm_info);
+        timeCacheLen=snprintf(timeCache, sizeof(timeCache), "%02d.%02d.%02d %02d:%02d:%02d:", tm_info.tm_year + 1900, tm_info.tm_mon + 1, tm_info.tm_mday, tm_info.tm_hour, tm_info.tm_min, tm_info.tm_sec);
+        timeCacheSec=time->tv_sec;
+    }
+    RMHMonitor_Log_Append(writer, timeCache, timeCacheLen);
+    msBuf[0]='0' + (time->tv_usec/100000)%10;
+    msBuf[1]='0' + (time->tv_usec/10000)%10;
+    msBuf[2]='0' + (time->tv_usec/1000)%10;
+    msBuf[3]=' ';
+    RMHMonitor_Log_Append(writer, msBuf, 4);
+}
+
+
+/**
+ * This is the main print function in this program. It formats 'fmt' and adds the time and appPrefix before each line.
+ * The result is queued for the log writer thread, or written right away if it's not running.
  */
 void RMH_Print_Raw(RMHMonitor *app, struct timeval *time, const char*fmt, ...) {
-    struct tm* tm_info;
-    char *printString=printBuff;
+    RMHMonitor_LogWriter writer;
+    const char *printString=printBuff;
+    const char *lineEnd;
     int printSize;
     va_list ap;
-    static bool newLine = true;
-    int i = 0;
 
     /* First construct the line to print and get the size */
     va_start(ap, fmt);
-    printSize = vsnprintf(printString, PRINTBUF_SIZE, fmt, ap);
+    printSize = vsnprintf(printBuff, PRINTBUF_SIZE, fmt, ap);
     va_end(ap);
 
+    writer.log=&app->logQueue;
+    if (__atomic_load_n(&writer.log->running, __ATOMIC_ACQUIRE)) {
+        writer.record=NULL;
+    }
+    else {
+        writer.log->outFd=app->out_file ? fileno(app->out_file) : STDOUT_FILENO;
+        writer.localRecord.len=0;
+        writer.record=&writer.localRecord;
+    }
+
     /* Make sure we have something valid to print */
     if (printSize > 0) {
-        char timeBuf[64];
-
-        /* We have something to print, check if we need to also be printing a timestamp */
-        if (app->printTimestamp) {
-            /* Timestamp is needed, convert the timestamp we were passed to a readable string */
-            tm_info = localtime(&time->tv_sec);
-            snprintf(timeBuf, sizeof(timeBuf), "%02d.%02d.%02d %02d:%02d:%02d:%03ld ", tm_info->tm_year + 1900, tm_info->tm_mon + 1, tm_info->tm_mday, tm_info->tm_hour, tm_info->tm_min, tm_info->tm_sec, time->tv_usec/1000);
-        }
-
-#if 0
-        /* If there is a specificed prefix add it to this timeBuf. Then we need only worry about a single prefix */
-        if (app->appPrefix && sizeof(timeBuf) > strlen(app->appPrefix) + strlen(timeBuf)) {
-            strcat(timeBuf, app->appPrefix);
-        }
-#endif
-
-        /* Walk through the entire string we were given. Only way to check for new lines */
-        while(printString[i] != '\0') {
+        /* Walk through the string one line at a time */
+        while(*printString != '\0') {
             if (newLine) {
                 /* This is a new line, start by printing the timestamp and prefix */
-                if (app->printTimestamp) RMH_Write(app, timeBuf);
-                if (app->appPrefix) RMH_Write(app, app->appPrefix);
+                if (app->printTimestamp) RMHMonitor_Log_AppendTime(&writer, time);
+                if (app->appPrefix) RMHMonitor_Log_Append(&writer, app->appPrefix, strlen(app->appPrefix));
                 newLine=false;
             }
 
-            if (printString[i] == '\n') {
-                /* We found a new line. Replace the next character with a temporary terminator and
-                   print the string out. After printing, put the replaced character back where we
-                   found it. Note, if this is the last line we'll just be replacing \0 with another
-                   \0 so it should be safe */
-                char tmp=printString[i+1];
-                printString[i+1]='\0';
-                RMH_Write(app, printString);
-                printString[i+1]=tmp;
-
-                /* Move the start of the string forward to after the newline and set the newline flag */
-                printString=&printString[i+1];
+            lineEnd=strchr(printString, '\n');
+            if (lineEnd) {
+                /* Print through the new line and move to the start of the next line */
+                RMHMonitor_Log_Append(&writer, printString, lineEnd-printString+1);
+                printString=lineEnd+1;
                 newLine=true;
-                i=0;
             }
             else {
-                /* Not a newline, move to the next character */
-                i++;
+                /* The rest of the string is part of a line which will be finished by a later print */
+                RMHMonitor_Log_Append(&writer, printString, strlen(printString));
+                break;
             }
         }
 
-        /* We've found the end of the string. If there some string remaining, print it */
-        if (i > 0)
-            RMH_Write(app, printString);
-
-        /* If we were limited by our buffer size inform the user. We still need to reset newline here since it's static */
+        /* If we were limited by our buffer size inform the user. We still need to reset newline here since it's per thread */
         if (printSize >= PRINTBUF_SIZE) {
-            RMH_Write(app, "\nLog message truncated\n");
+            RMHMonitor_Log_Append(&writer, "\nLog message truncated\n", strlen("\nLog message truncated\n"));
             newLine=true;
         }
     }
     else if (printSize < 0 ) {
-        /* This should never happen. But if it does we still need to reset newline here since it's static  */
-        RMH_Write(app, "\nInternal print error\n");
+        /* This should never happen. But if it does we still need to reset newline here since it's per thread  */
+        RMHMonitor_Log_Append(&writer, "\nInternal print error\n", strlen("\nInternal print error\n"));
         newLine=true;
     }
 
-    fflush(stdout);
-}
\ No newline at end of file
+    RMHMonitor_Log_WriterFlush(&writer);
+}
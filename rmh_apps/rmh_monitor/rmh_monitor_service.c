@@ -0,0 +1,393 @@
+/*
+ * If not stated otherwise in this file or this component's Licenses.txt file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2016 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include <pthread.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/time.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "rmh_monitor.h"
+
+/*******************************************************************************************************************
+*
+* Status Service
+*
+*    Other processes can read the state the monitor keeps from events, rather than each polling the driver, by
+*    connecting to a UNIX socket. A client sends one line with a command:
+*
+*       get         The current status is sent as one line of JSON and the connection is closed
+*       subscribe   The current status is sent, followed by a new line of JSON each time it changes
+*
+*    The stats come from the snapshot JSON formatter. A reading JSON can't hold, such as a NaN power or SNR, is
+*    sent as null so every line can be parsed as strict JSON.
+*
+*    The status is built on the event thread by RMHMonitor_Service_Publish and handed to the service thread, which
+*    is the only thread touching the sockets.
+*******************************************************************************************************************/
+
+/**
+ * The most clients which can be connected at once.
+ */
+#define RMH_MONITOR_SERVICE_MAX_CLIENTS 16
+
+/**
+ * The longest command a client can send.
+ */
+#define RMH_MONITOR_SERVICE_MAX_COMMAND 32
+
+/* Identifies the listening socket and the publish eventfd in epoll. Clients are identified by their index */
+#define RMH_MONITOR_SERVICE_EPOLL_LISTEN RMH_MONITOR_SERVICE_MAX_CLIENTS
+#define RMH_MONITOR_SERVICE_EPOLL_NOTIFY (RMH_MONITOR_SERVICE_MAX_CLIENTS+1)
+
+/**
+ * One connected client. Only used by the service thread.
+ */
+typedef struct RMHMonitor_ServiceClient {
+    int fd;                                         /* The client socket or -1 if this entry is free */
+    bool subscribed;                                /* Set once the client asked to be sent every change */
+    char command[RMH_MONITOR_SERVICE_MAX_COMMAND];  /* The command received so far */
+    size_t commandLen;
+} RMHMonitor_ServiceClient;
+
+
+/**
+ * Build the status from what the event thread knows and hand it to the service thread. Subscribers are only sent it
+ * if something changed. Must only be called from the event thread.
+ */
+void RMHMonitor_Service_Publish(RMHMonitor *app) {
+    RMHMonitor_Service *service=&app->service;
+    RMHMonitor_NetworkStatus *ns=&app->netStatus;
+    static char msg[RMH_MONITOR_SERVICE_MSG_SIZE];
+    const size_t msgSize=sizeof(msg)-1;
+    char macStr[24];
+    size_t len=0;
+    bool first=true;
+    uint32_t i;
+    const uint64_t one=1;
+
+    if (!service->running) {
+        return;
+    }
+
+    len=RMHMonitor_Append(msg, msgSize, len, "{\"link\":\"%s\"", app->linkStatusValid ? RMH_LinkStatusToString(app->linkStatus) : "UNKNOWN");
+    if (app->linkStatusValid && app->linkStatus == RMH_LINK_STATUS_UP) {
+        len=RMHMonitor_Append(msg, msgSize, len, ",\"selfNodeId\":%u", ns->selfNodeId);
+        if (ns->ncNodeIdValid) {
+            len=RMHMonitor_Append(msg, msgSize, len, ",\"ncNodeId\":%u", ns->ncNodeId);
+        }
+        if (ns->networkMoCAVerValid) {
+            len=RMHMonitor_Append(msg, msgSize, len, ",\"networkMoCAVersion\":\"%s\"", RMH_MoCAVersionToString(ns->networkMoCAVer));
+        }
+        len=RMHMonitor_Append(msg, msgSize, len, ",\"nodes\":[");
+        for (i=0; i < RMH_MAX_MOCA_NODES; i++) {
+            if (ns->nodes[i].joined) {
+                len=RMHMonitor_Append(msg, msgSize, len, "%s{\"nodeId\":%u,\"mac\":\"%s\",\"mocaVersion\":\"%s\",\"preferredNC\":%s}",
+                                              first ? "" : ",", i, RMH_MacToString(ns->nodes[i].mac, macStr, sizeof(macStr)),
+                                              RMH_MoCAVersionToString(ns->nodes[i].mocaVersion), ns->nodes[i].preferredNC ? "true" : "false");
+                first=false;
+            }
+        }
+        len=RMHMonitor_Append(msg, msgSize, len, "]");
+    }
+    len=RMHMonitor_Append(msg, msgSize, len, ",");
+    len=RMHMonitor_Snapshot_PrintStatsJSON(app, msg, msgSize, len);
+    len=RMHMonitor_Append(msg, msgSize, len, "}");
+    if (len >= msgSize) {
+        RMH_PrintWrn("The service status was truncated\n");
+        return;
+    }
+    msg[len++]='\n';
+
+    /* Only pass it on if something changed */
+    pthread_mutex_lock(&service->lock);
+    if (len != service->publishedLen || memcmp(msg, service->published, len) != 0) {
+        memcpy(service->published, msg, len);
+        service->publishedLen=len;
+        service->sequence++;
+        if (write(service->notifyFd, &one, sizeof(one)) != sizeof(one)) {
+            /* Only fails if the counter is about to overflow, in which case the service thread is already being woken */
+        }
+    }
+    pthread_mutex_unlock(&service->lock);
+}
+
+
+/**
+ * Close a client and free its entry.
+ */
+static
+void RMHMonitor_Service_CloseClient(RMHMonitor_ServiceClient *client) {
+    close(client->fd);
+    client->fd=-1;
+}
+
+
+/**
+ * Send the whole status to a client. The status is small enough to fit in the socket buffer, so a client which can't
+ * take it right away has fallen behind and is dropped rather than holding up everyone else.
+ */
+static
+bool RMHMonitor_Service_Send(RMHMonitor_ServiceClient *client, const char *msg, const size_t msgLen) {
+    ssize_t sent;
+
+    do {
+        sent=send(client->fd, msg, msgLen, MSG_NOSIGNAL | MSG_DONTWAIT);
+    } while (sent < 0 && errno == EINTR);
+    if (sent != (ssize_t)msgLen) {
+        RMHMonitor_Service_CloseClient(client);
+        return false;
+    }
+    return true;
+}
+
+
+/**
+ * Read what a client sent and act on the command once a full line is received.
+ */
+static
+void RMHMonitor_Service_ReadClient(RMHMonitor_ServiceClient *client, const char *msg, const size_t msgLen) {
+    ssize_t received;
+    char *lineEnd;
+
+    received=recv(client->fd, &client->command[client->commandLen], sizeof(client->command)-client->commandLen-1, MSG_DONTWAIT);
+    if (received < 0 && (errno == EINTR || errno == EAGAIN)) {
+        return;
+    }
+    if (received <= 0 || client->subscribed) {
+        /* Closed, failed or a subscriber sending more than the one command */
+        RMHMonitor_Service_CloseClient(client);
+        return;
+    }
+    client->commandLen+=received;
+    client->command[client->commandLen]='\0';
+
+    lineEnd=strchr(client->command, '\n');
+    if (!lineEnd) {
+        if (client->commandLen == sizeof(client->command)-1) {
+            RMHMonitor_Service_CloseClient(client);
+        }
+        return;
+    }
+    if (lineEnd > client->command && lineEnd[-1] == '\r') lineEnd--;
+    *lineEnd='\0';
+
+    if (strcmp(client->command, "get") == 0) {
+        if (RMHMonitor_Service_Send(client, msg, msgLen)) {
+            RMHMonitor_Service_CloseClient(client);
+        }
+    }
+    else if (strcmp(client->command, "subscribe") == 0) {
+        client->subscribed=true;
+        RMHMonitor_Service_Send(client, msg, msgLen);
+    }
+    else {
+        static const char error[]="{\"error\":\"Unknown command. Use 'get' or 'subscribe'\"}\n";
+        if (RMHMonitor_Service_Send(client, error, strlen(error))) {
+            RMHMonitor_Service_CloseClient(client);
+        }
+    }
+}
+
+
+/**
+ * The service thread. It waits on the listening socket, the clients and for a new status to be published.
+ */
+static
+void *RMHMonitor_Service_Thread(void *context) {
+    RMHMonitor *app=(RMHMonitor *)context;
+    RMHMonitor_Service *service=&app->service;
+    RMHMonitor_ServiceClient clients[RMH_MONITOR_SERVICE_MAX_CLIENTS];
+    struct epoll_event epollEvents[RMH_MONITOR_SERVICE_MAX_CLIENTS+2];
+    struct epoll_event epollEvent;
+    static char msg[RMH_MONITOR_SERVICE_MSG_SIZE];
+    size_t msgLen=0;
+    uint64_t msgSequence=0;
+    bool msgNew;
+    uint64_t count;
+    int epollFd;
+    int numReady;
+    int fd;
+    int i, j;
+
+    for (i=0; i < RMH_MONITOR_SERVICE_MAX_CLIENTS; i++) {
+        clients[i].fd=-1;
+    }
+
+    epollFd=epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd < 0) {
+        RMH_PrintErr("Failed to create the service epoll -- %s!\n", strerror(errno));
+        return NULL;
+    }
+    memset(&epollEvent, 0, sizeof(epollEvent));
+    epollEvent.events=EPOLLIN;
+    epollEvent.data.u32=RMH_MONITOR_SERVICE_EPOLL_LISTEN;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, service->listenFd, &epollEvent);
+    epollEvent.data.u32=RMH_MONITOR_SERVICE_EPOLL_NOTIFY;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, service->notifyFd, &epollEvent);
+
+    while (__atomic_load_n(&service->running, __ATOMIC_ACQUIRE)) {
+        numReady=epoll_wait(epollFd, epollEvents, sizeof(epollEvents)/sizeof(epollEvents[0]), -1);
+        if (numReady < 0) {
+            if (errno == EINTR) continue;
+            RMH_PrintErr("Failed in the service epoll_wait -- %s!\n", strerror(errno));
+            break;
+        }
+
+        /* Pick up the latest status before handling anything so every client gets the same one */
+        pthread_mutex_lock(&service->lock);
+        msgNew=(service->sequence != msgSequence);
+        if (msgNew) {
+            memcpy(msg, service->published, service->publishedLen);
+            msgLen=service->publishedLen;
+            msgSequence=service->sequence;
+        }
+        pthread_mutex_unlock(&service->lock);
+
+        for (i=0; i < numReady; i++) {
+            if (epollEvents[i].data.u32 == RMH_MONITOR_SERVICE_EPOLL_NOTIFY) {
+                if (read(service->notifyFd, &count, sizeof(count)) != sizeof(count)) {
+                    /* Nothing to do. The sequence says if there's something new */
+                }
+            }
+            else if (epollEvents[i].data.u32 == RMH_MONITOR_SERVICE_EPOLL_LISTEN) {
+                fd=accept(service->listenFd, NULL, NULL);
+                if (fd < 0) continue;
+                fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+                fcntl(fd, F_SETFD, FD_CLOEXEC);
+                for (j=0; j < RMH_MONITOR_SERVICE_MAX_CLIENTS && clients[j].fd >= 0; j++);
+                if (j == RMH_MONITOR_SERVICE_MAX_CLIENTS) {
+                    RMH_PrintWrn("The status service already has %u clients. Refusing another\n", RMH_MONITOR_SERVICE_MAX_CLIENTS);
+                    close(fd);
+                    continue;
+                }
+                memset(&clients[j], 0, sizeof(clients[j]));
+                clients[j].fd=fd;
+                epollEvent.data.u32=j;
+                if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &epollEvent) != 0) {
+                    RMHMonitor_Service_CloseClient(&clients[j]);
+                }
+            }
+            else if (clients[epollEvents[i].data.u32].fd >= 0) {
+                /* Closing the socket removes it from epoll */
+                RMHMonitor_Service_ReadClient(&clients[epollEvents[i].data.u32], msg, msgLen);
+            }
+        }
+
+        /* Send anything new to the subscribers */
+        if (msgNew && msgLen) {
+            for (i=0; i < RMH_MONITOR_SERVICE_MAX_CLIENTS; i++) {
+                if (clients[i].fd >= 0 && clients[i].subscribed) {
+                    RMHMonitor_Service_Send(&clients[i], msg, msgLen);
+                }
+            }
+        }
+    }
+
+    for (i=0; i < RMH_MONITOR_SERVICE_MAX_CLIENTS; i++) {
+        if (clients[i].fd >= 0) {
+            RMHMonitor_Service_CloseClient(&clients[i]);
+        }
+    }
+    close(epollFd);
+    return NULL;
+}
+
+
+/**
+ * Start serving the status on 'app->service.socketPath'. Any file already at that path is replaced.
+ */
+RMH_Result RMHMonitor_Service_Start(RMHMonitor *app) {
+    RMHMonitor_Service *service=&app->service;
+    struct sockaddr_un addr;
+
+    service->listenFd=-1;
+    service->notifyFd=-1;
+    if (!service->socketPath || service->socketPath[0] == '\0') {
+        return RMH_SUCCESS;
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family=AF_UNIX;
+    if (strlen(service->socketPath) >= sizeof(addr.sun_path)) {
+        RMH_PrintErr("The service socket path '%s' is too long!\n", service->socketPath);
+        return RMH_FAILURE;
+    }
+    strcpy(addr.sun_path, service->socketPath);
+
+    service->notifyFd=eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    service->listenFd=socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (service->notifyFd < 0 || service->listenFd < 0) {
+        RMH_PrintErr("Failed to create the service socket -- %s!\n", strerror(errno));
+        goto exit_err;
+    }
+    unlink(service->socketPath);
+    if (bind(service->listenFd, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+        listen(service->listenFd, RMH_MONITOR_SERVICE_MAX_CLIENTS) != 0) {
+        RMH_PrintErr("Failed to listen on '%s' -- %s!\n", service->socketPath, strerror(errno));
+        goto exit_err;
+    }
+
+    pthread_mutex_init(&service->lock, NULL);
+    service->publishedLen=0;
+    service->sequence=0;
+    service->running=true;
+    if (pthread_create(&service->thread, NULL, RMHMonitor_Service_Thread, app) != 0) {
+        RMH_PrintErr("Failed creating the service thread!\n");
+        service->running=false;
+        pthread_mutex_destroy(&service->lock);
+        unlink(service->socketPath);
+        goto exit_err;
+    }
+    return RMH_SUCCESS;
+
+exit_err:
+    if (service->listenFd >= 0) close(service->listenFd);
+    if (service->notifyFd >= 0) close(service->notifyFd);
+    service->listenFd=-1;
+    service->notifyFd=-1;
+    return RMH_FAILURE;
+}
+
+
+/**
+ * Stop the service, disconnecting all clients and removing the socket.
+ */
+void RMHMonitor_Service_Stop(RMHMonitor *app) {
+    RMHMonitor_Service *service=&app->service;
+    const uint64_t one=1;
+
+    if (!service->running) {
+        return;
+    }
+    __atomic_store_n(&service->running, false, __ATOMIC_RELEASE);
+    if (write(service->notifyFd, &one, sizeof(one)) != sizeof(one)) {
+        /* The thread is already being woken */
+    }
+    pthread_join(service->thread, NULL);
+    pthread_mutex_destroy(&service->lock);
+    close(service->listenFd);
+    close(service->notifyFd);
+    service->listenFd=-1;
+    service->notifyFd=-1;
+    unlink(service->socketPath);
+}
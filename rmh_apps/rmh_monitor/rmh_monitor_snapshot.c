@@ -0,0 +1,709 @@
+/*
+ * If not stated otherwise in this file or this component's Licenses.txt file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2016 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include <math.h>
+#include <pthread.h>
+#include <sys/time.h>
+#include "rmh_monitor.h"
+
+/*******************************************************************************************************************
+*
+* Status Snapshots
+*
+*    A snapshot holds the same values as the status dumps from RMH_Log_PrintStatus, RMH_Log_PrintStats and
+*    RMH_Log_PrintFlows, read one API at a time so they can be compared. Comparing against the previous snapshot
+*    lets the monitor print only what changed. Subcarrier modulation is not part of a snapshot. It's only in the
+*    full baseline dumps.
+*******************************************************************************************************************/
+
+/**
+ * The fields captured for the local device. They're read whenever MoCA is enabled.
+ */
+#define RMH_MONITOR_SELF_FIELDS(FIELD) \
+    FIELD(BOOL,         RMH_Self_GetEnabled) \
+    FIELD(STRING,       RMH_Interface_GetName) \
+    FIELD(MAC,          RMH_Interface_GetMac) \
+    FIELD(BOOL,         RMH_Interface_GetEnabled) \
+    FIELD(STRING,       RMH_Self_GetSoftwareVersion) \
+    FIELD(MOCAVERSION,  RMH_Self_GetHighestSupportedMoCAVersion) \
+    FIELD(BOOL,         RMH_Self_GetPreferredNCEnabled) \
+    FIELD(UINT32,       RMH_Self_GetLOF) \
+    FIELD(BOOL,         RMH_Power_GetTxPowerControlEnabled) \
+    FIELD(BOOL,         RMH_Power_GetTxBeaconPowerReductionEnabled) \
+    FIELD(UINT32,       RMH_Power_GetTxBeaconPowerReduction) \
+    FIELD(TABOO,        RMH_Self_GetTabooChannels) \
+    FIELD(UINT32_HEX,   RMH_Self_GetFrequencyMask) \
+    FIELD(BOOL,         RMH_Self_GetQAM256Enabled) \
+    FIELD(BOOL,         RMH_Self_GetTurboEnabled) \
+    FIELD(BOOL,         RMH_Self_GetBondingEnabled) \
+    FIELD(BOOL,         RMH_Self_GetPrivacyEnabled) \
+    FIELD(STRING,       RMH_Self_GetPrivacyMACManagementKey) \
+    FIELD(LOGLEVEL,     RMH_Log_GetDriverLevel) \
+    FIELD(STRING,       RMH_Log_GetDriverFilename) \
+    FIELD(POWERMODE,    RMH_Power_GetMode)
+
+/**
+ * The fields captured for the network and the local stats. They're only read while the link is up.
+ */
+#define RMH_MONITOR_NETWORK_FIELDS(FIELD) \
+    FIELD(UINT32,       RMH_Network_GetNumNodes) \
+    FIELD(UINT32,       RMH_Network_GetNodeId) \
+    FIELD(UINT32,       RMH_Network_GetNCNodeId) \
+    FIELD(MAC,          RMH_Network_GetNCMac) \
+    FIELD(UINT32,       RMH_Network_GetBackupNCNodeId) \
+    FIELD(MOCAVERSION,  RMH_Network_GetMoCAVersion) \
+    FIELD(BOOL,         RMH_Network_GetMixedMode) \
+    FIELD(UINT32,       RMH_Network_GetRFChannelFreq) \
+    FIELD(UINT32,       RMH_Network_GetResetCount) \
+    FIELD(COUNTER,      RMH_Stats_GetTxTotalPackets) \
+    FIELD(COUNTER,      RMH_Stats_GetTxUnicastPackets) \
+    FIELD(COUNTER,      RMH_Stats_GetTxBroadcastPackets) \
+    FIELD(COUNTER,      RMH_Stats_GetTxMulticastPackets) \
+    FIELD(COUNTER,      RMH_Stats_GetTxReservationRequestPackets) \
+    FIELD(COUNTER,      RMH_Stats_GetTxMapPackets) \
+    FIELD(COUNTER,      RMH_Stats_GetTxLinkControlPackets) \
+    FIELD(COUNTER,      RMH_Stats_GetTxBeacons) \
+    FIELD(COUNTER,      RMH_Stats_GetTxDroppedPackets) \
+    FIELD(COUNTER,      RMH_Stats_GetTxTotalErrors) \
+    FIELD(COUNTER,      RMH_Stats_GetTxTotalAggregatedPackets) \
+    FIELD(COUNTER,      RMH_Stats_GetTxTotalBytes) \
+    FIELD(COUNTER,      RMH_Stats_GetRxTotalBytes) \
+    FIELD(COUNTER,      RMH_Stats_GetRxTotalPackets) \
+    FIELD(COUNTER,      RMH_Stats_GetRxUnicastPackets) \
+    FIELD(COUNTER,      RMH_Stats_GetRxBroadcastPackets) \
+    FIELD(COUNTER,      RMH_Stats_GetRxMulticastPackets) \
+    FIELD(COUNTER,      RMH_Stats_GetRxReservationRequestPackets) \
+    FIELD(COUNTER,      RMH_Stats_GetRxMapPackets) \
+    FIELD(COUNTER,      RMH_Stats_GetRxLinkControlPackets) \
+    FIELD(COUNTER,      RMH_Stats_GetRxBeacons) \
+    FIELD(COUNTER,      RMH_Stats_GetRxUnknownProtocolPackets) \
+    FIELD(COUNTER,      RMH_Stats_GetRxDroppedPackets) \
+    FIELD(COUNTER,      RMH_Stats_GetRxTotalErrors) \
+    FIELD(COUNTER,      RMH_Stats_GetRxCRCErrors) \
+    FIELD(COUNTER,      RMH_Stats_GetRxTimeoutErrors) \
+    FIELD(COUNTER,      RMH_Stats_GetRxTotalAggregatedPackets) \
+    FIELD(COUNTER,      RMH_Stats_GetAdmissionAttempts) \
+    FIELD(COUNTER,      RMH_Stats_GetAdmissionSucceeded) \
+    FIELD(COUNTER,      RMH_Stats_GetAdmissionFailures) \
+    FIELD(COUNTER,      RMH_Stats_GetAdmissionsDeniedAsNC) \
+    FIELD(COUNTER,      RMH_Stats_GetAdmissionsFailedNoResponse) \
+    FIELD(COUNTER,      RMH_Stats_GetAdmissionsFailedChannelUnusable) \
+    FIELD(COUNTER,      RMH_Stats_GetAdmissionsFailedT2Timeout) \
+    FIELD(COUNTER,      RMH_Stats_GetAdmissionsFailedResyncLoss) \
+    FIELD(COUNTER,      RMH_Stats_GetAdmissionsFailedPrivacyFullBlacklist)
+
+/**
+ * The fields captured for each remote node.
+ */
+#define RMH_MONITOR_NODE_FIELDS(FIELD) \
+    FIELD(MAC,          RMH_RemoteNode_GetMac) \
+    FIELD(MOCAVERSION,  RMH_RemoteNode_GetHighestSupportedMoCAVersion) \
+    FIELD(BOOL,         RMH_RemoteNode_GetPreferredNC) \
+    FIELD(COUNTER,      RMH_RemoteNode_GetRxPackets) \
+    FIELD(COUNTER,      RMH_RemoteNode_GetTxPackets) \
+    FIELD(UINT32,       RMH_RemoteNode_GetTxUnicastPhyRate) \
+    FIELD(UINT32,       RMH_RemoteNode_GetTxPowerReduction) \
+    FIELD(FLOAT,        RMH_RemoteNode_GetTxUnicastPower) \
+    FIELD(COUNTER,      RMH_RemoteNode_GetRxTotalErrors) \
+    FIELD(FLOAT,        RMH_RemoteNode_GetRxUnicastPower) \
+    FIELD(FLOAT,        RMH_RemoteNode_GetRxSNR)
+
+/**
+ * Per node fields which are read for all nodes with one call to an RMH_NodeList_Uint32_t API.
+ */
+#define RMH_MONITOR_NODE_LIST_FIELDS(FIELD) \
+    FIELD(COUNTER,      RMH_Stats_GetRxCorrectedErrors) \
+    FIELD(COUNTER,      RMH_Stats_GetRxUncorrectedErrors)
+
+/**
+ * The fields captured for each ingress PQoS flow.
+ */
+#define RMH_MONITOR_FLOW_FIELDS(FIELD) \
+    FIELD(MAC,          RMH_PQoSFlow_GetIngressMac) \
+    FIELD(MAC,          RMH_PQoSFlow_GetEgressMac) \
+    FIELD(MAC,          RMH_PQoSFlow_GetDestination) \
+    FIELD(UINT32,       RMH_PQoSFlow_GetLeaseTime) \
+    FIELD(UINT32,       RMH_PQoSFlow_GetPeakDataRate) \
+    FIELD(UINT32,       RMH_PQoSFlow_GetBurstSize) \
+    FIELD(UINT32,       RMH_PQoSFlow_GetFlowTag) \
+    FIELD(UINT32,       RMH_PQoSFlow_GetPacketSize) \
+    FIELD(UINT32,       RMH_PQoSFlow_GetMaxLatency) \
+    FIELD(UINT32,       RMH_PQoSFlow_GetShortTermAvgRatio) \
+    FIELD(UINT32,       RMH_PQoSFlow_GetMaxRetry) \
+    FIELD(UINT32,       RMH_PQoSFlow_GetFlowPer) \
+    FIELD(UINT32,       RMH_PQoSFlow_GetIngressClassificationRule) \
+    FIELD(UINT32,       RMH_PQoSFlow_GetVLANTag) \
+    FIELD(COUNTER,      RMH_PQoSFlow_GetTotalTxPackets) \
+    FIELD(UINT32,       RMH_PQoSFlow_GetDSCPMoCA) \
+    FIELD(UINT32,       RMH_PQoSFlow_GetDFID)
+
+/**
+ * The most ingress flows kept in a snapshot.
+ */
+#define RMH_MONITOR_SNAPSHOT_MAX_FLOWS 32
+
+/* Build an enum of the indexes of each list */
+#define RMH_MONITOR_FIELD_INDEX(KIND, API) RMH_MONITOR_FIELD__##API,
+typedef enum { RMH_MONITOR_SELF_FIELDS(RMH_MONITOR_FIELD_INDEX)         RMH_MONITOR_NUM_SELF_FIELDS }       RMHMonitor_SelfField;
+typedef enum { RMH_MONITOR_NETWORK_FIELDS(RMH_MONITOR_FIELD_INDEX)      RMH_MONITOR_NUM_NETWORK_FIELDS }    RMHMonitor_NetworkField;
+typedef enum { RMH_MONITOR_NODE_FIELDS(RMH_MONITOR_FIELD_INDEX)
+               RMH_MONITOR_NODE_LIST_FIELDS(RMH_MONITOR_FIELD_INDEX)    RMH_MONITOR_NUM_NODE_FIELDS }       RMHMonitor_NodeField;
+typedef enum { RMH_MONITOR_FLOW_FIELDS(RMH_MONITOR_FIELD_INDEX)         RMH_MONITOR_NUM_FLOW_FIELDS }       RMHMonitor_FlowField;
+
+/**
+ * How a value is stored, compared and print.
+ */
+typedef enum RMHMonitor_ValueKind {
+    RMH_MONITOR_VALUE_BOOL,
+    RMH_MONITOR_VALUE_UINT32,
+    RMH_MONITOR_VALUE_UINT32_HEX,
+    RMH_MONITOR_VALUE_COUNTER,                      /* A uint32 which only counts up. Changes are print as a delta */
+    RMH_MONITOR_VALUE_FLOAT,
+    RMH_MONITOR_VALUE_STRING,
+    RMH_MONITOR_VALUE_MAC,
+    RMH_MONITOR_VALUE_MOCAVERSION,
+    RMH_MONITOR_VALUE_POWERMODE,
+    RMH_MONITOR_VALUE_LOGLEVEL,
+    RMH_MONITOR_VALUE_TABOO
+} RMHMonitor_ValueKind;
+
+/**
+ * The name and kind of each field of a list.
+ */
+typedef struct RMHMonitor_FieldInfo {
+    const char *name;
+    RMHMonitor_ValueKind kind;
+} RMHMonitor_FieldInfo;
+
+#define RMH_MONITOR_FIELD_INFO(KIND, API) { #API, RMH_MONITOR_VALUE_##KIND },
+static const RMHMonitor_FieldInfo selfFieldInfo[] = { RMH_MONITOR_SELF_FIELDS(RMH_MONITOR_FIELD_INFO) };
+static const RMHMonitor_FieldInfo networkFieldInfo[] = { RMH_MONITOR_NETWORK_FIELDS(RMH_MONITOR_FIELD_INFO) };
+static const RMHMonitor_FieldInfo nodeFieldInfo[] = { RMH_MONITOR_NODE_FIELDS(RMH_MONITOR_FIELD_INFO) RMH_MONITOR_NODE_LIST_FIELDS(RMH_MONITOR_FIELD_INFO) };
+static const RMHMonitor_FieldInfo flowFieldInfo[] = { RMH_MONITOR_FLOW_FIELDS(RMH_MONITOR_FIELD_INFO) };
+
+/**
+ * One captured value along with the result of the API which read it.
+ */
+typedef struct RMHMonitor_Value {
+    RMH_Result ret;
+    union {
+        bool boolValue;
+        uint32_t uint32Value;
+        float floatValue;
+        char stringValue[64];
+        RMH_MacAddress_t macValue;
+        struct {
+            uint32_t start;
+            uint32_t mask;
+        } tabooValue;
+    } v;
+} RMHMonitor_Value;
+
+/**
+ * A structured copy of the status of the device and network at one point in time.
+ */
+struct RMHMonitor_Snapshot {
+    struct timeval time;                                                /* When the snapshot was captured */
+    bool enabled;                                                       /* Set if MoCA was enabled. Nothing else is captured if not */
+    bool linkUp;                                                        /* Set if the link was up. Only 'self' is captured if not */
+    RMHMonitor_Value self[RMH_MONITOR_NUM_SELF_FIELDS];
+    RMHMonitor_Value network[RMH_MONITOR_NUM_NETWORK_FIELDS];
+    RMH_NodeList_Uint32_t nodes;                                        /* The remote nodes which were present */
+    RMHMonitor_Value node[RMH_MAX_MOCA_NODES][RMH_MONITOR_NUM_NODE_FIELDS];
+    RMH_Result phyRatesRet;
+    RMH_NodeMesh_Uint32_t phyRates;
+    uint32_t numFlows;
+    RMH_MacAddress_t flowIds[RMH_MONITOR_SNAPSHOT_MAX_FLOWS];
+    RMHMonitor_Value flow[RMH_MONITOR_SNAPSHOT_MAX_FLOWS][RMH_MONITOR_NUM_FLOW_FIELDS];
+};
+
+
+/*******************************************************************************************************************
+* Capture
+*******************************************************************************************************************/
+
+/* Read one value. The leading API parameters are passed after 'API' */
+#define RMH_MONITOR_CAPTURE_BOOL(VAL, API, ...)         (VAL)->ret=API(__VA_ARGS__, &(VAL)->v.boolValue);
+#define RMH_MONITOR_CAPTURE_UINT32(VAL, API, ...)       (VAL)->ret=API(__VA_ARGS__, &(VAL)->v.uint32Value);
+#define RMH_MONITOR_CAPTURE_UINT32_HEX(VAL, API, ...)   (VAL)->ret=API(__VA_ARGS__, &(VAL)->v.uint32Value);
+#define RMH_MONITOR_CAPTURE_COUNTER(VAL, API, ...)      (VAL)->ret=API(__VA_ARGS__, &(VAL)->v.uint32Value);
+#define RMH_MONITOR_CAPTURE_FLOAT(VAL, API, ...)        (VAL)->ret=API(__VA_ARGS__, &(VAL)->v.floatValue);
+#define RMH_MONITOR_CAPTURE_STRING(VAL, API, ...)       (VAL)->ret=API(__VA_ARGS__, (VAL)->v.stringValue, sizeof((VAL)->v.stringValue));
+#define RMH_MONITOR_CAPTURE_MAC(VAL, API, ...)          (VAL)->ret=API(__VA_ARGS__, &(VAL)->v.macValue);
+#define RMH_MONITOR_CAPTURE_TABOO(VAL, API, ...)        (VAL)->ret=API(__VA_ARGS__, &(VAL)->v.tabooValue.start, &(VAL)->v.tabooValue.mask);
+#define RMH_MONITOR_CAPTURE_ENUM(VAL, TYPE, API, ...)   { TYPE response; (VAL)->ret=API(__VA_ARGS__, &response); (VAL)->v.uint32Value=response; }
+#define RMH_MONITOR_CAPTURE_MOCAVERSION(VAL, API, ...)  RMH_MONITOR_CAPTURE_ENUM(VAL, RMH_MoCAVersion, API, __VA_ARGS__)
+#define RMH_MONITOR_CAPTURE_POWERMODE(VAL, API, ...)    RMH_MONITOR_CAPTURE_ENUM(VAL, RMH_PowerMode, API, __VA_ARGS__)
+#define RMH_MONITOR_CAPTURE_LOGLEVEL(VAL, API, ...)     RMH_MONITOR_CAPTURE_ENUM(VAL, RMH_LogLevel, API, __VA_ARGS__)
+
+#define RMH_MONITOR_CAPTURE_SELF(KIND, API)             RMH_MONITOR_CAPTURE_##KIND(&snapshot->self[RMH_MONITOR_FIELD__##API], API, handle)
+#define RMH_MONITOR_CAPTURE_NETWORK(KIND, API)          RMH_MONITOR_CAPTURE_##KIND(&snapshot->network[RMH_MONITOR_FIELD__##API], API, handle)
+#define RMH_MONITOR_CAPTURE_NODE(KIND, API)             RMH_MONITOR_CAPTURE_##KIND(&snapshot->node[nodeId][RMH_MONITOR_FIELD__##API], API, handle, nodeId)
+#define RMH_MONITOR_CAPTURE_FLOW(KIND, API)             RMH_MONITOR_CAPTURE_##KIND(&snapshot->flow[i][RMH_MONITOR_FIELD__##API], API, handle, snapshot->flowIds[i])
+#define RMH_MONITOR_CAPTURE_NODE_LIST(KIND, API) { \
+    RMH_NodeList_Uint32_t nodeList; \
+    RMH_Result ret=API(handle, &nodeList); \
+    for (nodeId=0; nodeId < RMH_MAX_MOCA_NODES; nodeId++) { \
+        RMHMonitor_Value *val=&snapshot->node[nodeId][RMH_MONITOR_FIELD__##API]; \
+        val->ret=(ret != RMH_SUCCESS) ? ret : nodeList.nodePresent[nodeId] ? RMH_SUCCESS : RMH_INVALID_ID; \
+        val->v.uint32Value=nodeList.nodeValue[nodeId]; \
+    } \
+}
+
+
+/**
+ * Read the current status into 'snapshot' using 'handle'.
+ */
+static
+void RMHMonitor_Snapshot_Capture(const RMH_Handle handle, RMHMonitor_Snapshot *snapshot, const struct timeval *time) {
+    RMH_LinkStatus linkStatus;
+    size_t numFlowIds;
+    uint32_t numIngressFlows;
+    uint32_t nodeId;
+    uint32_t i;
+
+    memset(snapshot, 0, sizeof(*snapshot));
+    snapshot->time=*time;
+    if (RMH_Self_GetEnabled(handle, &snapshot->enabled) != RMH_SUCCESS || !snapshot->enabled) {
+        snapshot->enabled=false;
+        return;
+    }
+    RMH_MONITOR_SELF_FIELDS(RMH_MONITOR_CAPTURE_SELF);
+
+    snapshot->linkUp=(RMH_Self_GetLinkStatus(handle, &linkStatus) == RMH_SUCCESS && linkStatus == RMH_LINK_STATUS_UP);
+    if (!snapshot->linkUp) {
+        return;
+    }
+    RMH_MONITOR_NETWORK_FIELDS(RMH_MONITOR_CAPTURE_NETWORK);
+
+    if (RMH_Network_GetRemoteNodeIds(handle, &snapshot->nodes) == RMH_SUCCESS) {
+        for (nodeId=0; nodeId < RMH_MAX_MOCA_NODES; nodeId++) {
+            if (snapshot->nodes.nodePresent[nodeId]) {
+                RMH_MONITOR_NODE_FIELDS(RMH_MONITOR_CAPTURE_NODE);
+            }
+        }
+        RMH_MONITOR_NODE_LIST_FIELDS(RMH_MONITOR_CAPTURE_NODE_LIST);
+    }
+    else {
+        memset(&snapshot->nodes, 0, sizeof(snapshot->nodes));
+    }
+
+    snapshot->phyRatesRet=RMH_Network_GetTxUnicastPhyRate(handle, &snapshot->phyRates);
+
+    if (RMH_PQoS_GetNumIngressFlows(handle, &numIngressFlows) == RMH_SUCCESS && numIngressFlows &&
+        RMH_PQoS_GetIngressFlowIds(handle, snapshot->flowIds, RMH_MONITOR_SNAPSHOT_MAX_FLOWS, &numFlowIds) == RMH_SUCCESS) {
+        snapshot->numFlows=numFlowIds;
+        for (i=0; i < snapshot->numFlows; i++) {
+            RMH_MONITOR_FLOW_FIELDS(RMH_MONITOR_CAPTURE_FLOW);
+        }
+    }
+}
+
+
+/*******************************************************************************************************************
+* Compare and print
+*******************************************************************************************************************/
+
+/**
+ * Convert 'val' to a string the same way RMH_Log_PrintStatus would print it.
+ */
+static
+const char *RMHMonitor_Snapshot_ValueToString(const RMHMonitor_ValueKind kind, const RMHMonitor_Value *val, char *buf, const size_t bufSize) {
+    if (val->ret != RMH_SUCCESS) {
+        return RMH_ResultToString(val->ret);
+    }
+
+    switch (kind) {
+    case RMH_MONITOR_VALUE_BOOL:        snprintf(buf, bufSize, "%s", val->v.boolValue ? "TRUE" : "FALSE"); break;
+    case RMH_MONITOR_VALUE_UINT32:
+    case RMH_MONITOR_VALUE_COUNTER:     snprintf(buf, bufSize, "%u", val->v.uint32Value); break;
+    case RMH_MONITOR_VALUE_UINT32_HEX:  snprintf(buf, bufSize, "0x%08x", val->v.uint32Value); break;
+    case RMH_MONITOR_VALUE_FLOAT:       snprintf(buf, bufSize, "%.02f", val->v.floatValue); break;
+    case RMH_MONITOR_VALUE_STRING:      snprintf(buf, bufSize, "%s", val->v.stringValue); break;
+    case RMH_MONITOR_VALUE_MAC:         RMH_MacToString(val->v.macValue, buf, bufSize); break;
+    case RMH_MONITOR_VALUE_MOCAVERSION: snprintf(buf, bufSize, "%s", RMH_MoCAVersionToString(val->v.uint32Value)); break;
+    case RMH_MONITOR_VALUE_POWERMODE:   RMH_PowerModeToString(val->v.uint32Value, buf, bufSize); break;
+    case RMH_MONITOR_VALUE_LOGLEVEL:    RMH_LogLevelToString(val->v.uint32Value, buf, bufSize); break;
+    case RMH_MONITOR_VALUE_TABOO:       snprintf(buf, bufSize, "Start:%u Channel Mask:0x%08x", val->v.tabooValue.start, val->v.tabooValue.mask); break;
+    }
+    return buf;
+}
+
+
+/**
+ * Returns true if 'a' and 'b' hold the same value.
+ */
+static
+bool RMHMonitor_Snapshot_ValueEqual(const RMHMonitor_ValueKind kind, const RMHMonitor_Value *a, const RMHMonitor_Value *b) {
+    if (a->ret != b->ret) return false;
+    if (a->ret != RMH_SUCCESS) return true;
+
+    switch (kind) {
+    case RMH_MONITOR_VALUE_BOOL:        return a->v.boolValue == b->v.boolValue;
+    case RMH_MONITOR_VALUE_FLOAT:       return a->v.floatValue == b->v.floatValue || (isnan(a->v.floatValue) && isnan(b->v.floatValue));
+    case RMH_MONITOR_VALUE_STRING:      return strcmp(a->v.stringValue, b->v.stringValue) == 0;
+    case RMH_MONITOR_VALUE_MAC:         return memcmp(a->v.macValue, b->v.macValue, sizeof(a->v.macValue)) == 0;
+    case RMH_MONITOR_VALUE_TABOO:       return a->v.tabooValue.start == b->v.tabooValue.start && a->v.tabooValue.mask == b->v.tabooValue.mask;
+    default:                            return a->v.uint32Value == b->v.uint32Value;
+    }
+}
+
+
+/**
+ * Print every field of a list. Used for things which weren't in the previous snapshot.
+ */
+static
+void RMHMonitor_Snapshot_PrintValues(RMHMonitor *app, const RMHMonitor_FieldInfo *info, const uint32_t numFields, const RMHMonitor_Value *cur) {
+    char valStr[128];
+    uint32_t i;
+
+    for (i=0; i < numFields; i++) {
+        RMH_PrintMsg("%-50s: %s\n", info[i].name, RMHMonitor_Snapshot_ValueToString(info[i].kind, &cur[i], valStr, sizeof(valStr)));
+    }
+}
+
+
+/**
+ * Returns true if a counter which went from 'prev' to 'cur' was cleared rather than wrapped. It's taken to be cleared
+ * when 'resetSeen', and otherwise when treating it as a wrap would mean it moved by more than half its range.
+ */
+static inline
+bool RMHMonitor_Snapshot_CounterCleared(const uint32_t prev, const uint32_t cur, const bool resetSeen) {
+    return cur < prev && (resetSeen || (uint32_t)(cur-prev) > UINT32_MAX/2);
+}
+
+
+/**
+ * Print the fields of a list which are different in 'cur' than 'prev'. If anything is print 'header' is print first.
+ * Counters are print with how much they went up, or what they were if they were cleared. 'resetSeen' is set if the
+ * counters are known to have been cleared since 'prev', for example by a MoCA reset. Returns the number of fields print.
+ */
+static
+uint32_t RMHMonitor_Snapshot_PrintChanges(RMHMonitor *app, const char *header, const RMHMonitor_FieldInfo *info, const uint32_t numFields,
+                                          const RMHMonitor_Value *prev, const RMHMonitor_Value *cur, const bool resetSeen) {
+    char valStr[128];
+    char prevStr[128];
+    uint32_t numChanges=0;
+    uint32_t i;
+
+    for (i=0; i < numFields; i++) {
+        if (RMHMonitor_Snapshot_ValueEqual(info[i].kind, &prev[i], &cur[i])) {
+            continue;
+        }
+        if (numChanges++ == 0 && header) {
+            RMH_PrintMsg("%s", header);
+        }
+        RMHMonitor_Snapshot_ValueToString(info[i].kind, &cur[i], valStr, sizeof(valStr));
+        if (info[i].kind == RMH_MONITOR_VALUE_COUNTER && prev[i].ret == RMH_SUCCESS && cur[i].ret == RMH_SUCCESS) {
+            if (RMHMonitor_Snapshot_CounterCleared(prev[i].v.uint32Value, cur[i].v.uint32Value, resetSeen)) {
+                RMH_PrintMsg("%-50s: %s (reset, was %u)\n", info[i].name, valStr, prev[i].v.uint32Value);
+            }
+            else {
+                RMH_PrintMsg("%-50s: %s (+%u)\n", info[i].name, valStr, cur[i].v.uint32Value-prev[i].v.uint32Value);
+            }
+        }
+        else {
+            RMH_PrintMsg("%-50s: %s (was %s)\n", info[i].name, valStr, RMHMonitor_Snapshot_ValueToString(info[i].kind, &prev[i], prevStr, sizeof(prevStr)));
+        }
+    }
+    return numChanges;
+}
+
+
+/**
+ * Print the PHY rates between nodes which changed.
+ */
+static
+uint32_t RMHMonitor_Snapshot_PrintPhyRateChanges(RMHMonitor *app, const RMHMonitor_Snapshot *prev, const RMHMonitor_Snapshot *cur) {
+    uint32_t numChanges=0;
+    uint32_t i, j;
+
+    if (cur->phyRatesRet != RMH_SUCCESS) {
+        if (prev->phyRatesRet != cur->phyRatesRet) {
+            RMH_PrintMsg("\n= PHY Rates =========\n");
+            RMH_PrintMsg("%s\n", RMH_ResultToString(cur->phyRatesRet));
+            numChanges++;
+        }
+        return numChanges;
+    }
+
+    for (i=0; i < RMH_MAX_MOCA_NODES; i++) {
+        if (!cur->phyRates.nodePresent[i]) continue;
+        for (j=0; j < RMH_MAX_MOCA_NODES; j++) {
+            if (i == j || !cur->phyRates.nodePresent[j]) continue;
+            if (prev->phyRatesRet == RMH_SUCCESS && prev->phyRates.nodePresent[i] && prev->phyRates.nodePresent[j] &&
+                prev->phyRates.nodeValue[i].nodeValue[j] == cur->phyRates.nodeValue[i].nodeValue[j]) {
+                continue;
+            }
+            if (numChanges++ == 0) {
+                RMH_PrintMsg("\n= PHY Rates =========\n");
+            }
+            if (prev->phyRatesRet == RMH_SUCCESS && prev->phyRates.nodePresent[i] && prev->phyRates.nodePresent[j]) {
+                RMH_PrintMsg("%02u->%02u: %04u (was %04u)\n", i, j, cur->phyRates.nodeValue[i].nodeValue[j], prev->phyRates.nodeValue[i].nodeValue[j]);
+            }
+            else {
+                RMH_PrintMsg("%02u->%02u: %04u\n", i, j, cur->phyRates.nodeValue[i].nodeValue[j]);
+            }
+        }
+    }
+    return numChanges;
+}
+
+
+/**
+ * Print the flows which were added, removed or changed.
+ */
+static
+uint32_t RMHMonitor_Snapshot_PrintFlowChanges(RMHMonitor *app, const RMHMonitor_Snapshot *prev, const RMHMonitor_Snapshot *cur, const bool resetSeen) {
+    char macStr[24];
+    char header[128];
+    uint32_t numChanges=0;
+    uint32_t i, j;
+
+    for (i=0; i < cur->numFlows; i++) {
+        RMH_MacToString(cur->flowIds[i], macStr, sizeof(macStr));
+        for (j=0; j < prev->numFlows; j++) {
+            if (memcmp(prev->flowIds[j], cur->flowIds[i], sizeof(cur->flowIds[i])) == 0) break;
+        }
+        if (j == prev->numFlows) {
+            RMH_PrintMsg("\n= Flow %s added =======\n", macStr);
+            RMHMonitor_Snapshot_PrintValues(app, flowFieldInfo, RMH_MONITOR_NUM_FLOW_FIELDS, cur->flow[i]);
+            numChanges++;
+        }
+        else {
+            snprintf(header, sizeof(header), "\n= Flow %s =======\n", macStr);
+            numChanges+=RMHMonitor_Snapshot_PrintChanges(app, header, flowFieldInfo, RMH_MONITOR_NUM_FLOW_FIELDS, prev->flow[j], cur->flow[i], resetSeen);
+        }
+    }
+
+    for (j=0; j < prev->numFlows; j++) {
+        for (i=0; i < cur->numFlows; i++) {
+            if (memcmp(prev->flowIds[j], cur->flowIds[i], sizeof(cur->flowIds[i])) == 0) break;
+        }
+        if (i == cur->numFlows) {
+            RMH_PrintMsg("\n= Flow %s removed =======\n", RMH_MacToString(prev->flowIds[j], macStr, sizeof(macStr)));
+            numChanges++;
+        }
+    }
+    return numChanges;
+}
+
+
+/**
+ * Print everything that's different in 'cur' compared to 'prev'.
+ */
+static
+void RMHMonitor_Snapshot_PrintDelta(RMHMonitor *app, const RMHMonitor_Snapshot *prev, const RMHMonitor_Snapshot *cur) {
+    static const RMHMonitor_Snapshot empty;
+    char header[128];
+    uint32_t numChanges=0;
+    uint32_t elapsed=cur->time.tv_sec-prev->time.tv_sec;
+    uint32_t nodeId;
+    bool resetSeen;
+
+    RMH_PrintMsg("==============================================================================================================================\n");
+    RMH_PrintMsg("= Status Changes In The Last %02uh:%02um:%02us ======\n", elapsed/3600, (elapsed%3600)/60, elapsed%60);
+    if (!cur->enabled) {
+        RMH_PrintMsg("*** MoCA not enabled! ***\n");
+        goto exit;
+    }
+
+    /* If MoCA was just enabled everything is new */
+    if (!prev->enabled) {
+        RMHMonitor_Snapshot_PrintValues(app, selfFieldInfo, RMH_MONITOR_NUM_SELF_FIELDS, cur->self);
+        numChanges++;
+    }
+    else {
+        numChanges+=RMHMonitor_Snapshot_PrintChanges(app, NULL, selfFieldInfo, RMH_MONITOR_NUM_SELF_FIELDS, prev->self, cur->self, false);
+    }
+
+    if (!cur->linkUp) {
+        RMH_PrintMsg("*** MoCA link is down! ***\n");
+        goto exit;
+    }
+
+    /* A change of the MoCA reset count means the SoC cleared its counters */
+    resetSeen=(prev->linkUp && prev->network[RMH_MONITOR_FIELD__RMH_Network_GetResetCount].ret == RMH_SUCCESS &&
+               cur->network[RMH_MONITOR_FIELD__RMH_Network_GetResetCount].ret == RMH_SUCCESS &&
+               prev->network[RMH_MONITOR_FIELD__RMH_Network_GetResetCount].v.uint32Value != cur->network[RMH_MONITOR_FIELD__RMH_Network_GetResetCount].v.uint32Value);
+
+    /* The same goes for the network if the link just came up. Every node is then new as well */
+    if (!prev->linkUp) {
+        RMH_PrintMsg("\n= Network Status ======\n");
+        RMHMonitor_Snapshot_PrintValues(app, networkFieldInfo, RMH_MONITOR_NUM_NETWORK_FIELDS, cur->network);
+        numChanges++;
+        prev=&empty;
+    }
+    else {
+        numChanges+=RMHMonitor_Snapshot_PrintChanges(app, "\n= Network Status ======\n", networkFieldInfo, RMH_MONITOR_NUM_NETWORK_FIELDS, prev->network, cur->network, resetSeen);
+    }
+
+    for (nodeId=0; nodeId < RMH_MAX_MOCA_NODES; nodeId++) {
+        if (cur->nodes.nodePresent[nodeId] && !prev->nodes.nodePresent[nodeId]) {
+            RMH_PrintMsg("\n= Remote Node ID %02u joined =======\n", nodeId);
+            RMHMonitor_Snapshot_PrintValues(app, nodeFieldInfo, RMH_MONITOR_NUM_NODE_FIELDS, cur->node[nodeId]);
+            numChanges++;
+        }
+        else if (!cur->nodes.nodePresent[nodeId] && prev->nodes.nodePresent[nodeId]) {
+            RMH_PrintMsg("\n= Remote Node ID %02u left =======\n", nodeId);
+            numChanges++;
+        }
+        else if (cur->nodes.nodePresent[nodeId]) {
+            snprintf(header, sizeof(header), "\n= Remote Node ID %02u =======\n", nodeId);
+            numChanges+=RMHMonitor_Snapshot_PrintChanges(app, header, nodeFieldInfo, RMH_MONITOR_NUM_NODE_FIELDS, prev->node[nodeId], cur->node[nodeId], resetSeen);
+        }
+    }
+
+    /* 'empty' has no PHY rates or flows so they're all print as new */
+    numChanges+=RMHMonitor_Snapshot_PrintPhyRateChanges(app, prev, cur);
+    numChanges+=RMHMonitor_Snapshot_PrintFlowChanges(app, prev, cur, resetSeen);
+
+    if (numChanges == 0) {
+        RMH_PrintMsg("No changes\n");
+    }
+
+exit:
+    RMH_PrintMsg("==============================================================================================================================\n");
+}
+
+
+/*******************************************************************************************************************
+* JSON
+*******************************************************************************************************************/
+
+/**
+ * Append the numeric values of a list which were read successfully as JSON members. The name is the part of the API
+ * after 'Get' so 'RMH_Stats_GetTxTotalPackets' is 'TxTotalPackets'. JSON has no NaN or infinity so those are null.
+ */
+static
+size_t RMHMonitor_Snapshot_AppendValuesJSON(char *buf, const size_t bufSize, size_t len, const RMHMonitor_FieldInfo *info,
+                                            const uint32_t numFields, const RMHMonitor_Value *cur, const bool countersOnly) {
+    const char *name;
+    bool first=true;
+    uint32_t i;
+
+    for (i=0; i < numFields; i++) {
+        if (cur[i].ret != RMH_SUCCESS) continue;
+        if (info[i].kind != RMH_MONITOR_VALUE_COUNTER && (countersOnly || (info[i].kind != RMH_MONITOR_VALUE_UINT32 && info[i].kind != RMH_MONITOR_VALUE_FLOAT))) continue;
+
+        name=strstr(info[i].name, "_Get");
+        name=name ? name+4 : info[i].name;
+        if (info[i].kind == RMH_MONITOR_VALUE_FLOAT && !isfinite(cur[i].v.floatValue)) {
+            len=RMHMonitor_Append(buf, bufSize, len, "%s\"%s\":null", first ? "" : ",", name);
+        }
+        else if (info[i].kind == RMH_MONITOR_VALUE_FLOAT) {
+            len=RMHMonitor_Append(buf, bufSize, len, "%s\"%s\":%.02f", first ? "" : ",", name, cur[i].v.floatValue);
+        }
+        else {
+            len=RMHMonitor_Append(buf, bufSize, len, "%s\"%s\":%u", first ? "" : ",", name, cur[i].v.uint32Value);
+        }
+        first=false;
+    }
+    return len;
+}
+
+
+/*******************************************************************************************************************
+* Public
+*******************************************************************************************************************/
+
+/**
+ * Allocate the snapshots. They're too large to keep on the stack of the event thread.
+ */
+RMH_Result RMHMonitor_Snapshot_Init(RMHMonitor *app) {
+    app->snapshot=calloc(1, sizeof(RMHMonitor_Snapshot));
+    app->lastSnapshot=calloc(1, sizeof(RMHMonitor_Snapshot));
+    app->lastSnapshotValid=false;
+    if (!app->snapshot || !app->lastSnapshot) {
+        RMH_PrintErr("Failed to allocate the status snapshots!\n");
+        RMHMonitor_Snapshot_Destroy(app);
+        return RMH_FAILURE;
+    }
+    return RMH_SUCCESS;
+}
+
+void RMHMonitor_Snapshot_Destroy(RMHMonitor *app) {
+    free(app->snapshot);
+    free(app->lastSnapshot);
+    app->snapshot=NULL;
+    app->lastSnapshot=NULL;
+    app->lastSnapshotValid=false;
+}
+
+
+/**
+ * Capture the current status with 'handle' and keep it as the snapshot the next delta is compared to.
+ */
+void RMHMonitor_Snapshot_Update(RMHMonitor *app, const RMH_Handle handle, const struct timeval *time) {
+    if (!app->lastSnapshot) {
+        return;
+    }
+    RMHMonitor_Snapshot_Capture(handle, app->lastSnapshot, time);
+    app->lastSnapshotValid=true;
+}
+
+
+/**
+ * Capture the current status with 'handle' and print only what's changed since the last snapshot. Returns
+ * RMH_FAILURE if there's no snapshot to compare to, in which case a full status should be print instead.
+ */
+RMH_Result RMHMonitor_Snapshot_PrintChanged(RMHMonitor *app, const RMH_Handle handle, const struct timeval *time) {
+    RMHMonitor_Snapshot *swap;
+
+    if (!app->snapshot || !app->lastSnapshot || !app->lastSnapshotValid) {
+        return RMH_FAILURE;
+    }
+
+    RMHMonitor_Snapshot_Capture(handle, app->snapshot, time);
+    RMHMonitor_Snapshot_PrintDelta(app, app->lastSnapshot, app->snapshot);
+
+    /* The new snapshot is what the next one is compared to */
+    swap=app->lastSnapshot;
+    app->lastSnapshot=app->snapshot;
+    app->snapshot=swap;
+    return RMH_SUCCESS;
+}
+
+
+/**
+ * Append the stats from the last snapshot to 'buf' as a JSON member named 'stats'. It's null until a snapshot is
+ * captured or while the link was down. Returns the new length, which is 'bufSize' if it didn't fit.
+ */
+size_t RMHMonitor_Snapshot_PrintStatsJSON(RMHMonitor *app, char *buf, const size_t bufSize, size_t len) {
+    const RMHMonitor_Snapshot *snapshot=app->lastSnapshot;
+    bool first=true;
+    uint32_t nodeId;
+
+    if (!snapshot || !app->lastSnapshotValid || !snapshot->linkUp) {
+        return RMHMonitor_Append(buf, bufSize, len, "\"stats\":null");
+    }
+
+    len=RMHMonitor_Append(buf, bufSize, len, "\"stats\":{\"time\":%ld.%06ld,\"network\":{", snapshot->time.tv_sec, snapshot->time.tv_usec);
+    len=RMHMonitor_Snapshot_AppendValuesJSON(buf, bufSize, len, networkFieldInfo, RMH_MONITOR_NUM_NETWORK_FIELDS, snapshot->network, true);
+    len=RMHMonitor_Append(buf, bufSize, len, "},\"nodes\":{");
+    for (nodeId=0; nodeId < RMH_MAX_MOCA_NODES; nodeId++) {
+        if (snapshot->nodes.nodePresent[nodeId]) {
+            len=RMHMonitor_Append(buf, bufSize, len, "%s\"%u\":{", first ? "" : ",", nodeId);
+            len=RMHMonitor_Snapshot_AppendValuesJSON(buf, bufSize, len, nodeFieldInfo, RMH_MONITOR_NUM_NODE_FIELDS, snapshot->node[nodeId], false);
+            len=RMHMonitor_Append(buf, bufSize, len, "}");
+            first=false;
+        }
+    }
+    return RMHMonitor_Append(buf, bufSize, len, "}}");
+}
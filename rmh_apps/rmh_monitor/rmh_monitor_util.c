@@ -17,139 +17,284 @@
  * limitations under the License.
 */
 
-#include <signal.h>
+#include <stdarg.h>
 #include <pthread.h>
 #include <sys/time.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
 #include <errno.h>
 #include "rmh_monitor.h"
 
-RMHMonitor_hSemaphore RMHMonitor_Semaphore_Create() {
-    RMHMonitor_hSemaphore eventHandle;
+/**
+ * The event queue is a bounded multi-producer ring. Callbacks come from the SoC callback thread and from the thread RMH
+ * uses to watch the interface, so a producer claims a position by moving 'head' with a compare and swap. The 'turn' of
+ * each slot tells the producer the slot has been read and tells the event thread the event has been written. Only the
+ * event thread reads so 'tail' needs no protection.
+*/
+RMH_Result RMHMonitor_Queue_Init(RMHMonitor *app) {
+    RMHMonitor_EventQueue *queue=&app->eventQueue;
+    uint32_t i;
+
+    memset(queue, 0, sizeof(*queue));
+    for (i=0; i < RMH_MONITOR_EVENT_QUEUE_SIZE; i++) {
+        queue->slots[i].turn=i;
+    }
+    queue->notifyFd=eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (queue->notifyFd < 0) {
+        RMH_PrintErr("Failed to create the event queue eventfd -- %s!\n", strerror(errno));
+        return RMH_FAILURE;
+    }
+    return RMH_SUCCESS;
+}
+
+void RMHMonitor_Queue_Destroy(RMHMonitor *app) {
+    if (app->eventQueue.notifyFd >= 0) {
+        close(app->eventQueue.notifyFd);
+        app->eventQueue.notifyFd=-1;
+    }
+}
+
+
+/**
+ * This function will post to the event queue which will then be read by the event thread. It's called from the RMH
+ * callback so it must never allocate, print or wait. If the queue is full the event is dropped and counted.
+*/
+void RMHMonitor_Queue_Enqueue(RMHMonitor *app, const enum RMH_Event event, const struct RMH_EventData *eventData) {
+    RMHMonitor_EventQueue *queue=&app->eventQueue;
+    RMHMonitor_EventSlot *slot;
+    uint64_t pos;
+    uint64_t turn;
+    const uint64_t one=1;
+
+    pos=__atomic_load_n(&queue->head, __ATOMIC_RELAXED);
+    while (true) {
+        slot=&queue->slots[pos & (RMH_MONITOR_EVENT_QUEUE_SIZE-1)];
+        turn=__atomic_load_n(&slot->turn, __ATOMIC_ACQUIRE);
+        if (turn == pos) {
+            /* The slot is free. Claim it unless another callback got there first, in which case 'pos' is updated */
+            if (__atomic_compare_exchange_n(&queue->head, &pos, pos+1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        }
+        else if (turn < pos) {
+            /* The slot still holds an event from the last time around. The queue is full */
+            __atomic_add_fetch(&queue->numDropped, 1, __ATOMIC_RELAXED);
+            if (!__atomic_exchange_n(&queue->full, true, __ATOMIC_RELAXED)) {
+                __atomic_add_fetch(&queue->numOverflows, 1, __ATOMIC_RELAXED);
+            }
+            return;
+        }
+        else {
+            pos=__atomic_load_n(&queue->head, __ATOMIC_RELAXED);
+        }
+    }
 
-    eventHandle=malloc(sizeof(*eventHandle));
-    if (!eventHandle) return NULL;
-    memset(eventHandle, 0, sizeof(*eventHandle));
+    /* Enqueue the event and the time it occurred */
+    gettimeofday(&slot->cbE.eventTime, NULL);
+    slot->cbE.event = event;
+    slot->cbE.eventData = *eventData;
+    slot->cbE.sequence = pos;
+    __atomic_store_n(&slot->turn, pos+1, __ATOMIC_RELEASE);
 
-    if (pthread_mutex_init(&eventHandle->lock, NULL) != 0) {
-        free(eventHandle);
-        return NULL;
+    if (write(queue->notifyFd, &one, sizeof(one)) != sizeof(one)) {
+        /* Only fails if the counter is about to overflow, in which case the event thread is already being woken */
     }
-    if (pthread_cond_init(&eventHandle->cond, NULL) != 0) {
-        pthread_mutex_destroy (&eventHandle->lock);
-        free(eventHandle);
-        return NULL;
+}
+
+
+/**
+ * This function will copy the oldest event from the event queue into 'cbE' and remove it. Returns false if the queue is empty.
+*/
+bool RMHMonitor_Queue_Dequeue(RMHMonitor *app, RMHMonitor_CallbackEvent *cbE) {
+    RMHMonitor_EventQueue *queue=&app->eventQueue;
+    RMHMonitor_EventSlot *slot=&queue->slots[queue->tail & (RMH_MONITOR_EVENT_QUEUE_SIZE-1)];
+    char printBuff[128];
+
+    if (__atomic_load_n(&slot->turn, __ATOMIC_ACQUIRE) != queue->tail+1) {
+        return false;
     }
-    eventHandle->signal = false;
-    return eventHandle;
+    *cbE=slot->cbE;
+    __atomic_store_n(&slot->turn, queue->tail+RMH_MONITOR_EVENT_QUEUE_SIZE, __ATOMIC_RELEASE);
+    queue->tail++;
+    __atomic_store_n(&queue->full, false, __ATOMIC_RELAXED);
+    RMH_PrintDbg("%s[%u] DEQUEUED event '%s' #%llu\n", __FUNCTION__, __LINE__, RMH_EventToString(cbE->event, printBuff, sizeof(printBuff)/sizeof(printBuff[0])), (unsigned long long)cbE->sequence);
+    return true;
 }
 
-void RMHMonitor_Semaphore_Destroy(RMHMonitor_hSemaphore eventHandle) {
-    if (eventHandle) {
-        pthread_mutex_destroy (&eventHandle->lock);
-        pthread_cond_destroy (&eventHandle->cond);
-        free(eventHandle);
+
+/**
+ * Returns the eventfd which becomes readable when an event is queued. It's meant to be waited on by the event thread.
+*/
+int RMHMonitor_Queue_GetNotifyFd(RMHMonitor *app) {
+    return app->eventQueue.notifyFd;
+}
+
+
+/**
+ * Clear the eventfd after a wakeup. This must be done before the queue is drained so an event queued while draining
+ * will wake the thread again. Events are found by looking at the queue, not by counting wakeups.
+*/
+void RMHMonitor_Queue_ResetNotify(RMHMonitor *app) {
+    uint64_t count;
+    if (read(app->eventQueue.notifyFd, &count, sizeof(count)) != sizeof(count) && errno != EAGAIN) {
+        RMH_PrintErr("Failed to reset the event queue notification -- %s!\n", strerror(errno));
     }
 }
 
-RMH_Result RMHMonitor_Semaphore_Reset(RMHMonitor_hSemaphore eventHandle) {
-    pthread_mutex_lock(&eventHandle->lock);
-    eventHandle->signal = false ;
-    pthread_mutex_unlock(&eventHandle->lock);
-    return RMH_SUCCESS;
+
+/**
+ * Returns the total number of events dropped because the queue was full, and in 'numOverflows' how many times that happened.
+*/
+uint64_t RMHMonitor_Queue_GetDropped(RMHMonitor *app, uint64_t *numOverflows) {
+    if (numOverflows) {
+        *numOverflows=__atomic_load_n(&app->eventQueue.numOverflows, __ATOMIC_RELAXED);
+    }
+    return __atomic_load_n(&app->eventQueue.numDropped, __ATOMIC_RELAXED);
 }
 
-RMH_Result RMHMonitor_Semaphore_Signal(RMHMonitor_hSemaphore eventHandle) {
-    pthread_mutex_lock(&eventHandle->lock);
-    eventHandle->signal = true;
-    pthread_cond_signal(&eventHandle->cond);
-    pthread_mutex_unlock(&eventHandle->lock);
+
+/**
+ * Open the status handle. It needs its own session as handles otherwise share the SoC handle of 'app->rmh'.
+ */
+static
+RMH_Result RMHMonitor_StatusHandle_Open(RMHMonitor *app) {
+    RMHMonitor_StatusHandle *status=&app->statusHandle;
+
+    status->rmh=RMH_InitializeEx(RMHMonitor_RMHCallback, app, RMH_INIT_FLAG_PRIVATE_SESSION);
+    if (!status->rmh) {
+        RMH_PrintErr("Failed to open the status handle!\n");
+        return RMH_FAILURE;
+    }
+    if (RMH_Log_SetAPILevel(status->rmh, RMH_LOG_DEFAULT ) != RMH_SUCCESS) {
+        RMH_PrintErr("Failed to set the log level on the status handle!\n");
+        RMHMonitor_StatusHandle_Close(app);
+        return RMH_FAILURE;
+    }
+    if (RMH_SetEventCallbacks(status->rmh, RMH_EVENT_API_PRINT) != RMH_SUCCESS) {
+        RMH_PrintErr("Failed setting callback events on the status handle!\n");
+        RMHMonitor_StatusHandle_Close(app);
+        return RMH_FAILURE;
+    }
+    status->numOpens++;
     return RMH_SUCCESS;
 }
 
-RMH_Result RMHMonitor_Semaphore_WaitTimeout(RMHMonitor_hSemaphore eventHandle, const int timeoutMsec) {
-   struct timeval now;
-   struct timespec timeout;
-   RMH_Result result=RMH_FAILURE;
-
-    pthread_mutex_lock(&eventHandle->lock);
-    if (eventHandle->signal) {
-        result=RMH_SUCCESS;
-        eventHandle->signal = false;
-        goto exit;
-    }
-    do {
-        gettimeofday(&now, NULL);
-        timeout.tv_nsec = now.tv_usec * 1000 + (timeoutMsec%1000)*1000000;
-        timeout.tv_sec = now.tv_sec + (timeoutMsec/1000);
-        if (timeout.tv_nsec >= 1000000000) {
-            timeout.tv_nsec -=  1000000000;
-            timeout.tv_sec ++;
-        }
 
-        int rc = pthread_cond_timedwait(&eventHandle->cond, &eventHandle->lock, &timeout);
-        if (eventHandle->signal) {
-            /* even if we timed out, if the signal was set, we succeed. this allows magnum to
-            be resilient to large OS scheduler delays */
-            result = RMH_SUCCESS;
-            break;
-        }
-        if (rc==ETIMEDOUT) {
-            result = RMH_TIMEOUT;
-            goto exit;
-        }
-        else if(rc==EINTR) {
-            continue;
+/**
+ * Returns the handle to use to read the status. We've seen the MoCA driver have issues using handles that have sat
+ * inactive for some time (30+ minutes), so rather than using 'app->rmh' a second handle is kept open. Before it's
+ * handed out it's checked with RMH_ValidateHandle, and if that fails or it's been idle longer than
+ * RMH_MONITOR_STATUS_HANDLE_IDLE_MIN it's reopened. How often that's needed is counted so the driver issue can be
+ * measured. If the handle can't be opened 'app->rmh' is returned.
+ */
+RMH_Handle RMHMonitor_StatusHandle_Get(RMHMonitor *app) {
+    RMHMonitor_StatusHandle *status=&app->statusHandle;
+    struct timespec timeNow;
+    long long idleSec;
+    RMH_Result ret;
+
+    clock_gettime(CLOCK_MONOTONIC, &timeNow);
+    if (status->rmh) {
+        idleSec=timeNow.tv_sec-status->lastUsed.tv_sec;
+        if (idleSec >= RMH_MONITOR_STATUS_HANDLE_IDLE_MIN*60) {
+            status->numIdleReopens++;
+            RMH_PrintDbg("The status handle was idle for %lld seconds. Reopening [Opens:%u Probe failures:%u Idle:%u]\n", idleSec,
+                            status->numOpens, status->numProbeFailures, status->numIdleReopens);
+            RMHMonitor_StatusHandle_Close(app);
         }
-        if (rc!=0) {
-            result = RMH_FAILURE;
-            goto exit;
+        else {
+            ret=RMH_ValidateHandle(status->rmh);
+            if (ret != RMH_SUCCESS && ret != RMH_UNIMPLEMENTED && ret != RMH_NOT_SUPPORTED) {
+                status->numProbeFailures++;
+                RMH_PrintWrn("The status handle is no longer valid -- %s. Reopening [Opens:%u Probe failures:%u Idle:%u]\n", RMH_ResultToString(ret),
+                                status->numOpens, status->numProbeFailures, status->numIdleReopens);
+                RMHMonitor_StatusHandle_Close(app);
+            }
         }
-    } while(!eventHandle->signal);  /* we might have been wokenup and then event has been cleared */
+    }
 
-    eventHandle->signal = false;
-exit:
-    pthread_mutex_unlock(&eventHandle->lock);
-    return result;
+    if (!status->rmh && RMHMonitor_StatusHandle_Open(app) != RMH_SUCCESS) {
+        return app->rmh;
+    }
+    status->lastUsed=timeNow;
+    return status->rmh;
 }
 
 
 /**
- * This function will post to the event queue which will then be read by the event thread
-*/
-void RMHMonitor_Queue_Enqueue(RMHMonitor *app, const enum RMH_Event event, const struct RMH_EventData *eventData) {
-    RMHMonitor_CallbackEvent *cbE = malloc(sizeof(RMHMonitor_CallbackEvent));
-    char printBuff[128];
+ * Close the status handle if it's open.
+ */
+void RMHMonitor_StatusHandle_Close(RMHMonitor *app) {
+    if (app->statusHandle.rmh) {
+        RMH_Destroy(app->statusHandle.rmh);
+        app->statusHandle.rmh=NULL;
+    }
+}
+
 
-    if (cbE) {
-        /* Enqueue the event and the time it occurred */
-        gettimeofday(&cbE->eventTime, NULL);
-        cbE->event = event;
-        cbE->eventData = *eventData;
+/**
+ * Create the shared memory object the status is published in. Does nothing if 'app->shmName' is empty.
+ */
+RMH_Result RMHMonitor_Shm_Start(RMHMonitor *app) {
+    RMH_Result ret;
 
-        /* Lock the queue before we modify it */
-        pthread_mutex_lock(&app->eventQueueProtect);
-        TAILQ_INSERT_HEAD(&app->eventQueue, cbE, entries);
-        RMH_PrintDbg("%s[%u] ENQUEUED event '%s' in %p\n", __FUNCTION__, __LINE__, RMH_EventToString(cbE->event, printBuff, sizeof(printBuff)/sizeof(printBuff[0])), cbE);
-        pthread_mutex_unlock(&app->eventQueueProtect);
-        RMHMonitor_Semaphore_Signal(app->eventNotify);
+    if (!app->shmName || app->shmName[0] == '\0') {
+        return RMH_SUCCESS;
     }
+    ret=RMH_Shm_Create(app->shmName, &app->shm);
+    if (ret != RMH_SUCCESS) {
+        RMH_PrintErr("Failed to create the shared memory status '%s' -- %s!\n", app->shmName, RMH_ResultToString(ret));
+        app->shm=NULL;
+        return ret;
+    }
+    return RMH_SUCCESS;
 }
 
 
 /**
- * This function will remove the oldest event from the event queue.
-*/
-void RMHMonitor_Queue_Dequeue(RMHMonitor *app) {
-    RMHMonitor_CallbackEvent *cbE;
-    char printBuff[128];
+ * Remove the shared memory object if it was created.
+ */
+void RMHMonitor_Shm_Stop(RMHMonitor *app) {
+    if (app->shm) {
+        RMH_Shm_Close(app->shm);
+        app->shm=NULL;
+    }
+}
+
 
-    /* Remove the tail of the queue. Lock the queue before we modify it */
-    pthread_mutex_lock(&app->eventQueueProtect);
-    cbE=app->eventQueue.tqh_first;
-    if (cbE) {
-        TAILQ_REMOVE(&app->eventQueue, app->eventQueue.tqh_first, entries);
-        RMH_PrintDbg("%s[%u] DEQUEUED event '%s' in %p\n", __FUNCTION__, __LINE__, RMH_EventToString(cbE->event, printBuff, sizeof(printBuff)/sizeof(printBuff[0])), cbE);
-        free(cbE);
+/**
+ * Read the network status and the counters with the status handle and publish them in shared memory. Must only be
+ * called from the event thread.
+ */
+void RMHMonitor_Shm_Publish(RMHMonitor *app) {
+    static RMH_ShmStatus status;
+    RMH_Handle rmh;
+
+    if (!app->shm) {
+        return;
+    }
+    rmh=RMHMonitor_StatusHandle_Get(app);
+    status.snapshotResult=RMH_Network_GetSnapshot(rmh, &status.snapshot);
+    status.statsResult=RMH_Stats_GetExtended(rmh, &status.stats);
+    RMH_Shm_Publish(app->shm, &status);
+}
+
+
+/**
+ * Append to 'buf' like snprintf, but never past 'bufSize'. Returns the new length.
+ */
+size_t RMHMonitor_Append(char *buf, const size_t bufSize, size_t len, const char *fmt, ...) {
+    va_list ap;
+    int ret;
+
+    if (len >= bufSize) {
+        return len;
+    }
+    va_start(ap, fmt);
+    ret=vsnprintf(&buf[len], bufSize-len, fmt, ap);
+    va_end(ap);
+    if (ret > 0) {
+        len+=ret;
     }
-    pthread_mutex_unlock(&app->eventQueueProtect);
+    return len > bufSize ? bufSize : len;
 }
@@ -58,7 +58,7 @@
         <span class="apiSectionHeader">PARAMETERS:</span><BR> \
         <div class="apiParameters">RMH_PARAMETERS_TO_HTML(PARAMS_LIST)</div><BR> \
         <span class="apiSectionHeader">TAGS:</span><BR> \
-        <span class="apiSectionBody">TAGS_STR</span><BR> \
+        <span class="apiSectionBody">__RMH_TAGS_STRING(TAGS_STR)</span><BR> \
         <BR><a href="#top">Back to top</a> \
     </div>
 
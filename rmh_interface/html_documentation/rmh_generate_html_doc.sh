@@ -201,7 +201,9 @@ EOF
 ###############################################################################################
 
         # Generate HTML table of contents
-        gcc -E -P "${SOURCE_DIR}/rmh_interface/html_documentation/rmh_generate_html_apis.h" -I"${SOURCE_DIR}/rmh_interface" -I"${SOURCE_DIR}/rmh_lib"
+        # Tags are expanded to one string per tag name. Join them into one
+        gcc -E -P "${SOURCE_DIR}/rmh_interface/html_documentation/rmh_generate_html_apis.h" -I"${SOURCE_DIR}/rmh_interface" -I"${SOURCE_DIR}/rmh_lib" | \
+                                  sed -e 's/" ", " "/, /g'
 
 ###############################################################################################
 
@@ -20,6 +20,8 @@
 #ifndef RDK_MOCA_HAL_H
 #define RDK_MOCA_HAL_H
 
+#include "rmh_type.h"
+
 /***************************************************************************************************************************
 RMH_API_IMPLEMENTATION_SOC_ONLY:
 
@@ -97,7 +99,14 @@ RMH_API_IMPLEMENTATION_NO_WRAP:
 #endif
 
 
-#include "rmh_type.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 #include "rmh_api.h"
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif /*RDK_MOCA_HAL_H*/
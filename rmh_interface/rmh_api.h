@@ -34,10 +34,6 @@
  * @ingroup MOCAHAL
  */
 
-#ifdef __cplusplus
-extern "C" {
-#endif
-
 
 RMH_API_IMPLEMENTATION_GENERIC_THEN_SOC(
 /********************************************************************************************************************/
@@ -65,13 +61,52 @@ PARAMETERS(
 FALSE,
 
 /* Tags */
-"Core"
+RMH_TAGS(Core)
 /********************************************************************************************************************/
 )
 
 
 
-RMH_API_IMPLEMENTATION_SOC_THEN_GENERIC(
+RMH_API_IMPLEMENTATION_GENERIC_ONLY(
+/********************************************************************************************************************/
+/* API Declaration */
+RMH_Handle RMH_InitializeEx(const RMH_EventCallback eventCB, void * userContext, const uint32_t flags),
+
+/* API Name */
+RMH_InitializeEx,
+
+/* Description */
+"Same as RMH_Initialize but takes a bitmask of RMH_InitFlag to change how the instance behaves. With "
+"RMH_INIT_FLAG_THREAD_SAFE any number of threads may call APIs on the returned handle at the same time. The state of "
+"each call is then kept per thread and calls into the SoC library are serialized unless the SoC library declares "
+"RMH_SOC_CAP_THREAD_SAFE. All handles in a process share one SoC library instance unless created with "
+"RMH_INIT_FLAG_PRIVATE_SESSION. Calls into it from all of those handles are made one at a time unless the SoC library "
+"declares RMH_SOC_CAP_THREAD_SAFE, so a process which needs to call the SoC from many threads in parallel should give "
+"each thread a handle with RMH_INIT_FLAG_PRIVATE_SESSION.",
+
+/* Parameters */
+PARAMETERS(
+    INPUT_PARAM(eventCB,            const RMH_EventCallback,
+        "A pointer to a function which will handle any callbacks from the RMH MoCA library. A value of NULL is permitted if you do not wish to receive callbacks"),
+
+    INPUT_PARAM(userContext,        void*,
+        "A pointer to some data that will be passed back with each callback. A value of NULL is permitted if the client requires no context during callbacks"),
+
+    INPUT_PARAM(flags,              const uint32_t,
+        "A bitmask of RMH_InitFlag. A value of 0 is the same as RMH_Initialize")
+),
+
+/* Wrap API */
+FALSE,
+
+/* Tags */
+RMH_TAGS(Core)
+/********************************************************************************************************************/
+)
+
+
+
+RMH_API_IMPLEMENTATION_GENERIC_ONLY(
 /********************************************************************************************************************/
 /* API Declaration */
 RMH_Result RMH_Destroy(RMH_Handle handle),
@@ -89,10 +124,10 @@ PARAMETERS(
 ),
 
 /* Wrap API */
-TRUE,
+FALSE,
 
 /* Tags */
-"Core"
+RMH_TAGS(Core)
 /********************************************************************************************************************/
 )
 
@@ -119,13 +154,13 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Core"
+RMH_TAGS(Core)
 /********************************************************************************************************************/
 )
 
 
 
-RMH_API_IMPLEMENTATION_GENERIC_THEN_SOC(
+RMH_API_IMPLEMENTATION_GENERIC_ONLY(
 /********************************************************************************************************************/
 /* API Declaration */
 RMH_Result RMH_SetEventCallbacks(RMH_Handle handle, const uint32_t value),
@@ -137,7 +172,10 @@ RMH_SetEventCallbacks,
 "Set the list of callbacks you which to receive. For each callback a call will be made to <eventCB> which is provided "
 "in the call to <RMH_Initialize>. By default all callbacks are disabled. Any subsequent calls to this API will "
 "overwrite previous calls. For example, if you originally set value to 'RMH_API_PRINT' and later set to "
-"'LINK_STATUS_CHANGED | MOCA_VERSION_CHANGED' you will stop receiving callbacks for 'RMH_API_PRINT'.",
+"'LINK_STATUS_CHANGED | MOCA_VERSION_CHANGED' you will stop receiving callbacks for 'RMH_API_PRINT'. "
+"Callbacks may be made from inside another RMH call of the same thread, for example when the SoC raises an event "
+"before it returns. It's safe to make RMH calls from a callback but they must not wait on another thread which is "
+"itself making RMH calls.",
 
 /* Parameters */
 PARAMETERS(
@@ -149,7 +187,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Core"
+RMH_TAGS(Core)
 /********************************************************************************************************************/
 )
 
@@ -176,7 +214,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Core"
+RMH_TAGS(Core)
 /********************************************************************************************************************/
 )
 
@@ -203,7 +241,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Core"
+RMH_TAGS(Core)
 /********************************************************************************************************************/
 )
 
@@ -219,11 +257,12 @@ RMH_Result RMH_GetUnimplementedAPIs(const RMH_Handle handle, RMH_APIList** apiLi
 RMH_GetUnimplementedAPIs,
 
 /* Description */
-"Return a list of all RMH APIs which are unimplemented by the SoC library.",
+"Return a list of all RMH APIs which are unimplemented by the SoC library loaded for <handle>. The list remains valid "
+"until the handle is destroyed.",
 
 /* Parameters */
 PARAMETERS(
-    INPUT_PARAM(handle,         const RMH_Handle,       "The RMH handle as returned by RMH_Initialize. NULL is valid for this API."),
+    INPUT_PARAM(handle,         const RMH_Handle,       "The RMH handle as returned by RMH_Initialize"),
     OUTPUT_PARAM(apiList,       RMH_APIList**,          "Output list of APIs")
 ),
 
@@ -231,7 +270,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Core"
+RMH_TAGS(Core)
 /********************************************************************************************************************/
 )
 
@@ -258,7 +297,527 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Core"
+RMH_TAGS(Core)
+/********************************************************************************************************************/
+)
+
+
+
+RMH_API_IMPLEMENTATION_GENERIC_ONLY(
+/********************************************************************************************************************/
+/* API Declaration */
+RMH_Result RMH_GetAPIById(const RMH_Handle handle, const RMH_APIId apiId, const RMH_API** api),
+
+/* API Name */
+RMH_GetAPIById,
+
+/* Description */
+"Return the description of the RMH API identified by <apiId>. This is a constant time lookup.",
+
+/* Parameters */
+PARAMETERS(
+    INPUT_PARAM(handle,         const RMH_Handle,       "The RMH handle as returned by RMH_Initialize. NULL is valid for this API."),
+    INPUT_PARAM(apiId,          const RMH_APIId,        "The ID of the API. This is the API name prefixed with 'RMH_API_ID__'"),
+    OUTPUT_PARAM(api,           const RMH_API**,        "The description of the API")
+),
+
+/* Wrap API */
+FALSE,
+
+/* Tags */
+RMH_TAGS(Core)
+/********************************************************************************************************************/
+)
+
+
+
+RMH_API_IMPLEMENTATION_GENERIC_ONLY(
+/********************************************************************************************************************/
+/* API Declaration */
+RMH_Result RMH_GetAPIByName(const RMH_Handle handle, const char* apiName, const RMH_API** api),
+
+/* API Name */
+RMH_GetAPIByName,
+
+/* Description */
+"Return the description of the RMH API named <apiName>. The name is not case sensitive.",
+
+/* Parameters */
+PARAMETERS(
+    INPUT_PARAM(handle,         const RMH_Handle,       "The RMH handle as returned by RMH_Initialize. NULL is valid for this API."),
+    INPUT_PARAM(apiName,        const char*,            "The name of the API"),
+    OUTPUT_PARAM(api,           const RMH_API**,        "The description of the API")
+),
+
+/* Wrap API */
+FALSE,
+
+/* Tags */
+RMH_TAGS(Core)
+/********************************************************************************************************************/
+)
+
+
+
+RMH_API_IMPLEMENTATION_GENERIC_ONLY(
+/********************************************************************************************************************/
+/* API Declaration */
+RMH_Result RMH_Instrumentation_GetStats(const RMH_Handle handle, const RMH_APIId apiId, RMH_APIStats* response),
+
+/* API Name */
+RMH_Instrumentation_GetStats,
+
+/* Description */
+"Return the number of calls, the results and the latency histogram of the API <apiId>. These are collected for every "
+"wrapped API across all handles in this process since it started or since RMH_Instrumentation_Reset was last called.",
+
+/* Parameters */
+PARAMETERS(
+    INPUT_PARAM(handle,         const RMH_Handle,       "The RMH handle as returned by RMH_Initialize. NULL is valid for this API."),
+    INPUT_PARAM(apiId,          const RMH_APIId,        "The ID of the API. This is the API name prefixed with 'RMH_API_ID__'"),
+    OUTPUT_PARAM(response,      RMH_APIStats*,          "The statistics collected for the API")
+),
+
+/* Wrap API */
+FALSE,
+
+/* Tags */
+RMH_TAGS(Core)
+/********************************************************************************************************************/
+)
+
+
+
+RMH_API_IMPLEMENTATION_GENERIC_ONLY(
+/********************************************************************************************************************/
+/* API Declaration */
+RMH_Result RMH_Instrumentation_Reset(const RMH_Handle handle),
+
+/* API Name */
+RMH_Instrumentation_Reset,
+
+/* Description */
+"Clear the statistics collected for all APIs in this process",
+
+/* Parameters */
+PARAMETERS(
+    INPUT_PARAM(handle,         const RMH_Handle,       "The RMH handle as returned by RMH_Initialize. NULL is valid for this API.")
+),
+
+/* Wrap API */
+FALSE,
+
+/* Tags */
+RMH_TAGS(Core)
+/********************************************************************************************************************/
+)
+
+
+
+RMH_API_IMPLEMENTATION_GENERIC_ONLY(
+/********************************************************************************************************************/
+/* API Declaration */
+RMH_Result RMH_Trace_SetEnabled(const RMH_Handle handle, const bool value),
+
+/* API Name */
+RMH_Trace_SetEnabled,
+
+/* Description */
+"Enable or disable recording of every wrapped API call into the binary trace buffer of this process. Each record holds "
+"the API, nesting depth, start time, duration, result and thread. Tracing can also be enabled by setting the "
+"environment variable RMH_TRACE before the first call to RMH_Initialize. If RMH_TRACE is the full path of a file the "
+"trace buffer is kept in that file so it can be read from another process with RMH_Trace_Dump.",
+
+/* Parameters */
+PARAMETERS(
+    INPUT_PARAM(handle,         const RMH_Handle,       "The RMH handle as returned by RMH_Initialize. NULL is valid for this API."),
+    INPUT_PARAM(value,          const bool,             "Set 'true' to start recording, 'false' to stop")
+),
+
+/* Wrap API */
+FALSE,
+
+/* Tags */
+RMH_TAGS(Log)
+/********************************************************************************************************************/
+)
+
+
+
+RMH_API_IMPLEMENTATION_GENERIC_ONLY(
+/********************************************************************************************************************/
+/* API Declaration */
+RMH_Result RMH_Trace_GetEnabled(const RMH_Handle handle, bool* response),
+
+/* API Name */
+RMH_Trace_GetEnabled,
+
+/* Description */
+"Return if API calls are being recorded into the binary trace buffer of this process",
+
+/* Parameters */
+PARAMETERS(
+    INPUT_PARAM(handle,         const RMH_Handle,       "The RMH handle as returned by RMH_Initialize. NULL is valid for this API."),
+    OUTPUT_PARAM(response,      bool*,                  "Set 'true' if tracing is enabled")
+),
+
+/* Wrap API */
+FALSE,
+
+/* Tags */
+RMH_TAGS(Log)
+/********************************************************************************************************************/
+)
+
+
+
+RMH_API_IMPLEMENTATION_GENERIC_ONLY(
+/********************************************************************************************************************/
+/* API Declaration */
+RMH_Result RMH_Trace_Dump(const RMH_Handle handle, const char* filename, RMH_TraceRecord* responseArray, const size_t responseArraySize, size_t* responseArrayUsed),
+
+/* API Name */
+RMH_Trace_Dump,
+
+/* Description */
+"Copy the most recent records from a binary trace buffer, oldest first. This does not clear the buffer.",
+
+/* Parameters */
+PARAMETERS(
+    INPUT_PARAM(handle,             const RMH_Handle,       "The RMH handle as returned by RMH_Initialize. NULL is valid for this API."),
+    INPUT_PARAM(filename,           const char*,            "The trace file set in RMH_TRACE by another process. Pass NULL to read the trace buffer of this process"),
+    OUTPUT_PARAM(responseArray,     RMH_TraceRecord*,       "An array where the trace records should be written"),
+    INPUT_PARAM(responseArraySize,  const size_t,           "The size of <responseArray>"),
+    OUTPUT_PARAM(responseArrayUsed, size_t*,                "The number of entries in the response array which have valid data")
+),
+
+/* Wrap API */
+FALSE,
+
+/* Tags */
+RMH_TAGS(Log)
+/********************************************************************************************************************/
+)
+
+
+
+RMH_API_IMPLEMENTATION_GENERIC_ONLY(
+/********************************************************************************************************************/
+/* API Declaration */
+RMH_Result RMH_Cache_SetEnabled(const RMH_Handle handle, const bool value),
+
+/* API Name */
+RMH_Cache_SetEnabled,
+
+/* Description */
+"Enable or disable the cache of this handle. When enabled, getters whose values rarely change, such as "
+"<RMH_Interface_GetName>, <RMH_Interface_GetMac>, <RMH_Self_GetSoftwareVersion> and <RMH_RemoteNode_GetMac>, are answered "
+"from memory after the first successful call. Cached values are dropped when the SoC reports an event which could change "
+"them, such as a node joining or leaving, a change of link status or a MoCA reset. Values of remote nodes are also "
+"dropped after a minute. The cache is disabled by default. Disabling it drops everything cached.",
+
+/* Parameters */
+PARAMETERS(
+    INPUT_PARAM(handle,         const RMH_Handle,       "The RMH handle as returned by RMH_Initialize"),
+    INPUT_PARAM(value,          const bool,             "Set 'true' to enable the cache, 'false' to disable it")
+),
+
+/* Wrap API */
+FALSE,
+
+/* Tags */
+RMH_TAGS(Core)
+/********************************************************************************************************************/
+)
+
+
+
+RMH_API_IMPLEMENTATION_GENERIC_ONLY(
+/********************************************************************************************************************/
+/* API Declaration */
+RMH_Result RMH_Cache_GetEnabled(const RMH_Handle handle, bool* response),
+
+/* API Name */
+RMH_Cache_GetEnabled,
+
+/* Description */
+"Return if the cache of this handle is enabled",
+
+/* Parameters */
+PARAMETERS(
+    INPUT_PARAM(handle,         const RMH_Handle,       "The RMH handle as returned by RMH_Initialize"),
+    OUTPUT_PARAM(response,      bool*,                  "Set 'true' if the cache is enabled")
+),
+
+/* Wrap API */
+FALSE,
+
+/* Tags */
+RMH_TAGS(Core)
+/********************************************************************************************************************/
+)
+
+
+
+RMH_API_IMPLEMENTATION_GENERIC_ONLY(
+/********************************************************************************************************************/
+/* API Declaration */
+RMH_Result RMH_Cache_Flush(const RMH_Handle handle),
+
+/* API Name */
+RMH_Cache_Flush,
+
+/* Description */
+"Drop every value in the cache of this handle so the next call to each cached API goes to the SoC",
+
+/* Parameters */
+PARAMETERS(
+    INPUT_PARAM(handle,         const RMH_Handle,       "The RMH handle as returned by RMH_Initialize")
+),
+
+/* Wrap API */
+FALSE,
+
+/* Tags */
+RMH_TAGS(Core)
+/********************************************************************************************************************/
+)
+
+
+
+RMH_API_IMPLEMENTATION_GENERIC_ONLY(
+/********************************************************************************************************************/
+/* API Declaration */
+RMH_Result RMH_Cache_GetStats(const RMH_Handle handle, const RMH_APIId apiId, RMH_CacheStats* response),
+
+/* API Name */
+RMH_Cache_GetStats,
+
+/* Description */
+"Return the number of cache hits, misses and invalidations of the API <apiId> on this handle. Returns "
+"RMH_NOT_SUPPORTED if the API is never cached.",
+
+/* Parameters */
+PARAMETERS(
+    INPUT_PARAM(handle,         const RMH_Handle,       "The RMH handle as returned by RMH_Initialize"),
+    INPUT_PARAM(apiId,          const RMH_APIId,        "The ID of the API. This is the API name prefixed with 'RMH_API_ID__'"),
+    OUTPUT_PARAM(response,      RMH_CacheStats*,        "The cache statistics of the API")
+),
+
+/* Wrap API */
+FALSE,
+
+/* Tags */
+RMH_TAGS(Core)
+/********************************************************************************************************************/
+)
+
+
+
+RMH_API_IMPLEMENTATION_GENERIC_ONLY(
+/********************************************************************************************************************/
+/* API Declaration */
+RMH_Result RMH_ExecuteBatch(const RMH_Handle handle, const RMH_BatchOp* ops, const size_t numOps),
+
+/* API Name */
+RMH_ExecuteBatch,
+
+/* Description */
+"Run a list of getters in a single call. Each op names the API, its node ID if it takes one and where to store the "
+"output and result. Getters only implemented by the SoC are called directly, skipping the per API logging, timing and "
+"instrumentation, so a batch costs little more than the SoC calls themselves. A SoC library may also answer the whole "
+"batch at once. Only getters returning one value, one string or one value of a node may be batched, other ops get "
+"RMH_INVALID_ID. Returns RMH_SUCCESS once every op has its result",
+
+/* Parameters */
+PARAMETERS(
+    INPUT_PARAM(handle,         const RMH_Handle,       "The RMH handle as returned by RMH_Initialize"),
+    INPUT_PARAM(ops,            const RMH_BatchOp*,     "The ops to run, in order"),
+    INPUT_PARAM(numOps,         const size_t,           "The number of entries in <ops>")
+),
+
+/* Wrap API */
+TRUE,
+
+/* Tags */
+RMH_TAGS(Core)
+/********************************************************************************************************************/
+)
+
+
+
+RMH_API_IMPLEMENTATION_GENERIC_ONLY(
+/********************************************************************************************************************/
+/* API Declaration */
+RMH_Result RMH_RFC_Get(const char* name, RMH_RFCValue* response),
+
+/* API Name */
+RMH_RFC_Get,
+
+/* Description */
+"Read an RFC parameter used by RMH, like <RMH_RFC_PREFERRED_NC_ENABLE>. Every RMH parameter is read from RFC the first "
+"time any is needed and kept in memory for the whole process. They're read again in the background when "
+"/etc/rfc.properties changes or after a few minutes, and the previous values are returned until that's done. The value "
+"is parsed to the type RMH expects and its age says how long ago it was read. Returns "
+"RMH_FAILURE if the parameter isn't set or has a value which can't be parsed and RMH_INVALID_ID if it's not one RMH uses.",
+
+/* Parameters */
+PARAMETERS(
+    INPUT_PARAM(name,           const char*,            "The full name of the RFC parameter"),
+    OUTPUT_PARAM(response,      RMH_RFCValue*,          "The value of the parameter")
+),
+
+/* Wrap API */
+FALSE,
+
+/* Tags */
+RMH_TAGS(Core)
+/********************************************************************************************************************/
+)
+
+
+
+RMH_API_IMPLEMENTATION_GENERIC_ONLY(
+/********************************************************************************************************************/
+/* API Declaration */
+RMH_Result RMH_Shm_Open(const char* name, RMH_ShmHandle* response),
+
+/* API Name */
+RMH_Shm_Open,
+
+/* Description */
+"Map the status published by another process with <RMH_Shm_Publish> read only. This is usually rmh_monitor started "
+"with '--shm <RMH_SHM_DEFAULT_NAME>'. Once open, <RMH_Shm_Read> gets the status with no system calls and no locks so it may be called "
+"as often as needed. Returns RMH_FAILURE if nothing is published under <name> and RMH_INVALID_INTERNAL_STATE if it was "
+"published by a version of RMH with a different <RMH_ShmStatus>",
+
+/* Parameters */
+PARAMETERS(
+    INPUT_PARAM(name,           const char*,            "The name of the shared memory object. NULL for <RMH_SHM_DEFAULT_NAME>"),
+    OUTPUT_PARAM(response,      RMH_ShmHandle*,         "The handle to pass to <RMH_Shm_Read> and <RMH_Shm_Close>")
+),
+
+/* Wrap API */
+FALSE,
+
+/* Tags */
+RMH_TAGS(Status)
+/********************************************************************************************************************/
+)
+
+
+
+RMH_API_IMPLEMENTATION_GENERIC_ONLY(
+/********************************************************************************************************************/
+/* API Declaration */
+RMH_Result RMH_Shm_Read(const RMH_ShmHandle shm, RMH_ShmStatus* response),
+
+/* API Name */
+RMH_Shm_Read,
+
+/* Description */
+"Copy the latest published status. The copy is always consistent, if the status is published while it's being copied "
+"it's copied again. Compare <sequence> with the last read to know if anything was published since and <timestampMs> with "
+"CLOCK_MONOTONIC to know how old it is. Should the publisher stop the last status it published is still returned, so "
+"reopen with <RMH_Shm_Open> if it's too old. Returns RMH_FAILURE if nothing was published yet and RMH_TIMEOUT if the "
+"status was being published every time it was copied",
+
+/* Parameters */
+PARAMETERS(
+    INPUT_PARAM(shm,            const RMH_ShmHandle,    "The handle returned by <RMH_Shm_Open>"),
+    OUTPUT_PARAM(response,      RMH_ShmStatus*,         "The published status")
+),
+
+/* Wrap API */
+FALSE,
+
+/* Tags */
+RMH_TAGS(Status)
+/********************************************************************************************************************/
+)
+
+
+
+RMH_API_IMPLEMENTATION_GENERIC_ONLY(
+/********************************************************************************************************************/
+/* API Declaration */
+RMH_Result RMH_Shm_Create(const char* name, RMH_ShmHandle* response),
+
+/* API Name */
+RMH_Shm_Create,
+
+/* Description */
+"Create the shared memory object for <RMH_Shm_Publish> which any process can map with <RMH_Shm_Open>. An object "
+"already under <name> is replaced, processes which still have it open keep reading the status last published there. "
+"Only one process should publish under a name",
+
+/* Parameters */
+PARAMETERS(
+    INPUT_PARAM(name,           const char*,            "The name of the shared memory object. NULL for <RMH_SHM_DEFAULT_NAME>"),
+    OUTPUT_PARAM(response,      RMH_ShmHandle*,         "The handle to pass to <RMH_Shm_Publish> and <RMH_Shm_Close>")
+),
+
+/* Wrap API */
+FALSE,
+
+/* Tags */
+RMH_TAGS(Status)
+/********************************************************************************************************************/
+)
+
+
+
+RMH_API_IMPLEMENTATION_GENERIC_ONLY(
+/********************************************************************************************************************/
+/* API Declaration */
+RMH_Result RMH_Shm_Publish(const RMH_ShmHandle shm, const RMH_ShmStatus* status),
+
+/* API Name */
+RMH_Shm_Publish,
+
+/* Description */
+"Publish a new status for readers of the shared memory object. The status is guarded by a sequence lock so this never "
+"waits on a reader. <sequence>, <timestampMs> and <publisherPid> are set in the published copy. Must only be called by "
+"one thread at a time",
+
+/* Parameters */
+PARAMETERS(
+    INPUT_PARAM(shm,            const RMH_ShmHandle,    "The handle returned by <RMH_Shm_Create>"),
+    INPUT_PARAM(status,         const RMH_ShmStatus*,   "The status to publish")
+),
+
+/* Wrap API */
+FALSE,
+
+/* Tags */
+RMH_TAGS(Status)
+/********************************************************************************************************************/
+)
+
+
+
+RMH_API_IMPLEMENTATION_GENERIC_ONLY(
+/********************************************************************************************************************/
+/* API Declaration */
+RMH_Result RMH_Shm_Close(const RMH_ShmHandle shm),
+
+/* API Name */
+RMH_Shm_Close,
+
+/* Description */
+"Unmap the status and free the handle. If the handle was returned by <RMH_Shm_Create> the shared memory object is "
+"also removed",
+
+/* Parameters */
+PARAMETERS(
+    INPUT_PARAM(shm,            const RMH_ShmHandle,    "The handle returned by <RMH_Shm_Open> or <RMH_Shm_Create>")
+),
+
+/* Wrap API */
+FALSE,
+
+/* Tags */
+RMH_TAGS(Status)
 /********************************************************************************************************************/
 )
 
@@ -284,7 +843,7 @@ PARAMETERS(
 FALSE,
 
 /* Tags */
-"Core"
+RMH_TAGS(Core)
 /********************************************************************************************************************/
 )
 
@@ -310,7 +869,7 @@ PARAMETERS(
 FALSE,
 
 /* Tags */
-"Core,Link"
+RMH_TAGS(Core, Link)
 /********************************************************************************************************************/
 )
 
@@ -336,7 +895,7 @@ PARAMETERS(
 FALSE,
 
 /* Tags */
-"Core"
+RMH_TAGS(Core)
 /********************************************************************************************************************/
 )
 
@@ -362,7 +921,7 @@ PARAMETERS(
 FALSE,
 
 /* Tags */
-"Core"
+RMH_TAGS(Core)
 /********************************************************************************************************************/
 )
 
@@ -388,7 +947,7 @@ PARAMETERS(
 FALSE,
 
 /* Tags */
-"Core"
+RMH_TAGS(Core)
 /********************************************************************************************************************/
 )
 
@@ -414,7 +973,33 @@ PARAMETERS(
 FALSE,
 
 /* Tags */
-"Core"
+RMH_TAGS(Core)
+/********************************************************************************************************************/
+)
+
+
+
+RMH_API_IMPLEMENTATION_GENERIC_ONLY(
+/********************************************************************************************************************/
+/* API Declaration */
+const char* const RMH_StatsCounterToString(const RMH_StatsCounter value),
+
+/* API Name */
+RMH_StatsCounterToString,
+
+/* Description */
+"Convert <RMH_StatsCounter> to a string",
+
+/* Parameters */
+PARAMETERS(
+    INPUT_PARAM(value,            const RMH_StatsCounter,   "Value to be printed as a string")
+),
+
+/* Wrap API */
+FALSE,
+
+/* Tags */
+RMH_TAGS(Core)
 /********************************************************************************************************************/
 )
 
@@ -440,7 +1025,7 @@ PARAMETERS(
 FALSE,
 
 /* Tags */
-"Core,Version"
+RMH_TAGS(Core, Version)
 /********************************************************************************************************************/
 )
 
@@ -468,7 +1053,7 @@ PARAMETERS(
 FALSE,
 
 /* Tags */
-"Core,Power"
+RMH_TAGS(Core, Power)
 /********************************************************************************************************************/
 )
 
@@ -494,7 +1079,7 @@ PARAMETERS(
 FALSE,
 
 /* Tags */
-"Core"
+RMH_TAGS(Core)
 /********************************************************************************************************************/
 )
 
@@ -522,7 +1107,7 @@ PARAMETERS(
 FALSE,
 
 /* Tags */
-"Core,log"
+RMH_TAGS(Core, Log)
 /********************************************************************************************************************/
 )
 
@@ -550,7 +1135,7 @@ PARAMETERS(
 FALSE,
 
 /* Tags */
-"Core"
+RMH_TAGS(Core)
 /********************************************************************************************************************/
 )
 
@@ -578,7 +1163,7 @@ PARAMETERS(
 FALSE,
 
 /* Tags */
-"Core,mac"
+RMH_TAGS(Core, Mac)
 /********************************************************************************************************************/
 )
 
@@ -604,7 +1189,7 @@ PARAMETERS(
 FALSE,
 
 /* Tags */
-"Core"
+RMH_TAGS(Core)
 /********************************************************************************************************************/
 )
 
@@ -630,7 +1215,7 @@ PARAMETERS(
 FALSE,
 
 /* Tags */
-"Core"
+RMH_TAGS(Core)
 /********************************************************************************************************************/
 )
 
@@ -659,13 +1244,13 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Self,Status"
+RMH_TAGS(Self, Status)
 /********************************************************************************************************************/
 )
 
 
 
-RMH_API_IMPLEMENTATION_SOC_ONLY(
+RMH_API_IMPLEMENTATION_SOC_THEN_GENERIC(
 /********************************************************************************************************************/
 /* API Declaration */
 RMH_Result RMH_Self_SetEnabled(const RMH_Handle handle, const bool value),
@@ -688,7 +1273,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Configuration [Set]"
+RMH_TAGS(ConfigurationSet)
 /********************************************************************************************************************/
 )
 
@@ -717,7 +1302,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Configuration [Get],Link"
+RMH_TAGS(ConfigurationGet, Link)
 /********************************************************************************************************************/
 )
 
@@ -744,7 +1329,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Configuration [Get],Frequency"
+RMH_TAGS(ConfigurationGet, Frequency)
 /********************************************************************************************************************/
 )
 
@@ -772,7 +1357,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Configuration [Set],Frequency"
+RMH_TAGS(ConfigurationSet, Frequency)
 /********************************************************************************************************************/
 )
 
@@ -801,7 +1386,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Configuration [Get],Frequency"
+RMH_TAGS(ConfigurationGet, Frequency)
 /********************************************************************************************************************/
 )
 
@@ -830,7 +1415,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Configuration [Set],Frequency"
+RMH_TAGS(ConfigurationSet, Frequency)
 /********************************************************************************************************************/
 )
 
@@ -858,7 +1443,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Configuration [Get],NC"
+RMH_TAGS(ConfigurationGet, NC)
 /********************************************************************************************************************/
 )
 
@@ -889,7 +1474,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Configuration [Set],NC"
+RMH_TAGS(ConfigurationSet, NC)
 /********************************************************************************************************************/
 )
 
@@ -916,7 +1501,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Configuration [Get],NC"
+RMH_TAGS(ConfigurationGet, NC)
 /********************************************************************************************************************/
 )
 
@@ -943,7 +1528,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Configuration [Set],NC"
+RMH_TAGS(ConfigurationSet, NC)
 /********************************************************************************************************************/
 )
 
@@ -970,7 +1555,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Configuration [Get],NC"
+RMH_TAGS(ConfigurationGet, NC)
 /********************************************************************************************************************/
 )
 
@@ -997,7 +1582,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Configuration [Set],NC"
+RMH_TAGS(ConfigurationSet, NC)
 /********************************************************************************************************************/
 )
 
@@ -1025,7 +1610,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Configuration [Get],Version"
+RMH_TAGS(ConfigurationGet, Version)
 /********************************************************************************************************************/
 )
 
@@ -1052,7 +1637,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Configuration [Get],Version"
+RMH_TAGS(ConfigurationGet, Version)
 /********************************************************************************************************************/
 )
 
@@ -1090,7 +1675,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Configuration [Get],Frequency"
+RMH_TAGS(ConfigurationGet, Frequency)
 /********************************************************************************************************************/
 )
 
@@ -1128,7 +1713,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Configuration [Set],Frequency"
+RMH_TAGS(ConfigurationSet, Frequency)
 /********************************************************************************************************************/
 )
 
@@ -1155,7 +1740,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Configuration [Get]"
+RMH_TAGS(ConfigurationGet)
 /********************************************************************************************************************/
 )
 
@@ -1182,7 +1767,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Configuration [Set]"
+RMH_TAGS(ConfigurationSet)
 /********************************************************************************************************************/
 )
 
@@ -1209,7 +1794,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Configuration [Get]"
+RMH_TAGS(ConfigurationGet)
 /********************************************************************************************************************/
 )
 
@@ -1236,7 +1821,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Configuration [Set]"
+RMH_TAGS(ConfigurationSet)
 /********************************************************************************************************************/
 )
 
@@ -1263,7 +1848,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Configuration [Get]"
+RMH_TAGS(ConfigurationGet)
 /********************************************************************************************************************/
 )
 
@@ -1291,7 +1876,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Configuration [Set]"
+RMH_TAGS(ConfigurationSet)
 /********************************************************************************************************************/
 )
 
@@ -1318,7 +1903,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Configuration [Get],Phy"
+RMH_TAGS(ConfigurationGet, Phy)
 /********************************************************************************************************************/
 )
 
@@ -1346,7 +1931,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Configuration [Set],Power"
+RMH_TAGS(ConfigurationSet, Power)
 /********************************************************************************************************************/
 )
 
@@ -1373,7 +1958,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Configuration [Get],Power"
+RMH_TAGS(ConfigurationGet, Power)
 /********************************************************************************************************************/
 )
 
@@ -1403,7 +1988,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Configuration [Get],Frequency"
+RMH_TAGS(ConfigurationGet, Frequency)
 /********************************************************************************************************************/
 )
 
@@ -1439,7 +2024,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Configuration [Get],Frequency"
+RMH_TAGS(ConfigurationGet, Frequency)
 /********************************************************************************************************************/
 )
 
@@ -1466,7 +2051,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Self,QAM"
+RMH_TAGS(Self, QAM)
 /********************************************************************************************************************/
 )
 
@@ -1494,7 +2079,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Configuration [Set],QAM"
+RMH_TAGS(ConfigurationSet, QAM)
 /********************************************************************************************************************/
 )
 
@@ -1521,7 +2106,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Self,QAM,Phy"
+RMH_TAGS(Self, QAM, Phy)
 /********************************************************************************************************************/
 )
 
@@ -1548,7 +2133,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Configuration [Set],QAM,Phy"
+RMH_TAGS(ConfigurationSet, QAM, Phy)
 /********************************************************************************************************************/
 )
 
@@ -1576,7 +2161,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Self,QAM,Phy"
+RMH_TAGS(Self, QAM, Phy)
 /********************************************************************************************************************/
 )
 
@@ -1603,7 +2188,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Configuration [Set],QAM,Phy"
+RMH_TAGS(ConfigurationSet, QAM, Phy)
 /********************************************************************************************************************/
 )
 
@@ -1629,7 +2214,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Self,QAM,Phy"
+RMH_TAGS(Self, QAM, Phy)
 /********************************************************************************************************************/
 )
 
@@ -1656,7 +2241,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Configuration [Set],QAM,Phy"
+RMH_TAGS(ConfigurationSet, QAM, Phy)
 /********************************************************************************************************************/
 )
 
@@ -1683,7 +2268,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Self,Turbo"
+RMH_TAGS(Self, Turbo)
 /********************************************************************************************************************/
 )
 
@@ -1710,7 +2295,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Configuration [Set],Turbo"
+RMH_TAGS(ConfigurationSet, Turbo)
 /********************************************************************************************************************/
 )
 
@@ -1737,35 +2322,65 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Self,Bonding"
+RMH_TAGS(Self, Bonding)
+/********************************************************************************************************************/
+)
+
+
+
+RMH_API_IMPLEMENTATION_SOC_ONLY(
+/********************************************************************************************************************/
+/* API Declaration */
+
+RMH_Result RMH_Self_SetBondingEnabled(const RMH_Handle handle, const bool value),
+
+/* API Name */
+RMH_Self_SetBondingEnabled,
+
+/* Description */
+"Enable or disable bonding mode on this device",
+
+/* Parameters */
+PARAMETERS(
+    INPUT_PARAM(handle,         const RMH_Handle,       "The RMH handle as returned by RMH_Initialize"),
+    INPUT_PARAM(value,          const bool,             "Pass 'true' to enable bonding on this device. Otherwise pass to 'false'.")
+),
+
+/* Wrap API */
+TRUE,
+
+/* Tags */
+RMH_TAGS(ConfigurationSet, Bonding)
 /********************************************************************************************************************/
 )
 
 
 
-RMH_API_IMPLEMENTATION_SOC_ONLY(
+RMH_API_IMPLEMENTATION_GENERIC_ONLY(
 /********************************************************************************************************************/
 /* API Declaration */
-
-RMH_Result RMH_Self_SetBondingEnabled(const RMH_Handle handle, const bool value),
+RMH_Result RMH_Self_GetLinkStatus(const RMH_Handle handle, RMH_LinkStatus* status),
 
 /* API Name */
-RMH_Self_SetBondingEnabled,
+RMH_Self_GetLinkStatus,
 
 /* Description */
-"Enable or disable bonding mode on this device",
+"Current operational status of the MoCA interface [mocaIfStatus]. This API combines all known information about the MoCA device, "
+"including the driver, MoCA link, interface status, ect. to determine if the link is functional. >RMH_LINK_STATUS_UP> "
+"indicates MoCA is ready for use. The status is kept up to date from MoCA events so it's normally read from memory. Use "
+"<RMH_Self_RefreshLinkStatus> to read it from the device.",
 
 /* Parameters */
 PARAMETERS(
     INPUT_PARAM(handle,         const RMH_Handle,       "The RMH handle as returned by RMH_Initialize"),
-    INPUT_PARAM(value,          const bool,             "Pass 'true' to enable bonding on this device. Otherwise pass to 'false'.")
+    OUTPUT_PARAM(status,        RMH_LinkStatus*,        "The current link state of MoCA")
 ),
 
 /* Wrap API */
 TRUE,
 
 /* Tags */
-"Configuration [Set],Bonding"
+RMH_TAGS(ConfigurationGet, Link)
 /********************************************************************************************************************/
 )
 
@@ -1774,15 +2389,14 @@ TRUE,
 RMH_API_IMPLEMENTATION_GENERIC_ONLY(
 /********************************************************************************************************************/
 /* API Declaration */
-RMH_Result RMH_Self_GetLinkStatus(const RMH_Handle handle, RMH_LinkStatus* status),
+RMH_Result RMH_Self_RefreshLinkStatus(const RMH_Handle handle, RMH_LinkStatus* status),
 
 /* API Name */
-RMH_Self_GetLinkStatus,
+RMH_Self_RefreshLinkStatus,
 
 /* Description */
-"Current operational status of the MoCA interface [mocaIfStatus]. This API combines all known information about the MoCA device, "
-"including the driver, MoCA link, interface status, ect. to determine if the link is functional. >RMH_LINK_STATUS_UP> "
-"indicates MoCA is ready for use.",
+"Same as <RMH_Self_GetLinkStatus> but the status is always read from the device. The status kept in memory is updated "
+"with what's read.",
 
 /* Parameters */
 PARAMETERS(
@@ -1794,7 +2408,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Configuration [Get],Link"
+RMH_TAGS(ConfigurationGet, Link)
 /********************************************************************************************************************/
 )
 
@@ -1821,7 +2435,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Configuration [Get],Self,Privacy"
+RMH_TAGS(ConfigurationGet, Self, Privacy)
 /********************************************************************************************************************/
 )
 
@@ -1849,7 +2463,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Configuration [Set],Self,Privacy"
+RMH_TAGS(ConfigurationSet, Self, Privacy)
 /********************************************************************************************************************/
 )
 
@@ -1877,7 +2491,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Self,Privacy"
+RMH_TAGS(Self, Privacy)
 /********************************************************************************************************************/
 )
 
@@ -1905,7 +2519,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Configuration [Set],Privacy"
+RMH_TAGS(ConfigurationSet, Privacy)
 /********************************************************************************************************************/
 )
 
@@ -1933,7 +2547,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Self,Privacy"
+RMH_TAGS(Self, Privacy)
 /********************************************************************************************************************/
 )
 
@@ -1966,7 +2580,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Self,Taboo,Frequency"
+RMH_TAGS(Self, Taboo, Frequency)
 /********************************************************************************************************************/
 )
 
@@ -1998,13 +2612,13 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Configuration [Set],Taboo"
+RMH_TAGS(ConfigurationSet, Taboo)
 /********************************************************************************************************************/
 )
 
 
 
-RMH_API_IMPLEMENTATION_SOC_ONLY(
+RMH_API_IMPLEMENTATION_SOC_THEN_GENERIC(
 /********************************************************************************************************************/
 /* API Declaration */
 RMH_Result RMH_Self_RestoreDefaultSettings(const RMH_Handle handle),
@@ -2024,7 +2638,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Configuration [Set]"
+RMH_TAGS(ConfigurationSet)
 /********************************************************************************************************************/
 )
 
@@ -2050,7 +2664,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Configuration [Set]"
+RMH_TAGS(ConfigurationSet)
 /********************************************************************************************************************/
 )
 
@@ -2077,7 +2691,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Configuration [Get]"
+RMH_TAGS(ConfigurationGet)
 /********************************************************************************************************************/
 )
 
@@ -2105,7 +2719,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Network,Remote Node"
+RMH_TAGS(Network, RemoteNode)
 /********************************************************************************************************************/
 )
 
@@ -2121,7 +2735,8 @@ RMH_Interface_GetEnabled,
 
 /* Description */
 "Check if the MoCA interface is enabled at the kernel level. Do not confuse with <RMH_Self_GetEnabled> which checks if "
-"the MoCA driver is active",
+"the MoCA driver is active. The state is kept up to date from RTNETLINK so this doesn't call into the kernel. Ask for "
+"<RMH_EVENT_INTERFACE_STATUS_CHANGED> to be told when it changes.",
 
 /* Parameters */
 PARAMETERS(
@@ -2134,7 +2749,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Configuration [Get],Interface"
+RMH_TAGS(ConfigurationGet, Interface)
 /********************************************************************************************************************/
 )
 
@@ -2162,7 +2777,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Configuration [Set],Interface"
+RMH_TAGS(ConfigurationSet, Interface)
 /********************************************************************************************************************/
 )
 
@@ -2190,7 +2805,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Configuration [Get],Interface"
+RMH_TAGS(ConfigurationGet, Interface)
 /********************************************************************************************************************/
 )
 
@@ -2217,7 +2832,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Configuration [Get],Interface,mac"
+RMH_TAGS(ConfigurationGet, Interface, Mac)
 /********************************************************************************************************************/
 )
 
@@ -2244,7 +2859,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Configuration [Set],Interface,mac"
+RMH_TAGS(ConfigurationSet, Interface, Mac)
 /********************************************************************************************************************/
 )
 
@@ -2271,7 +2886,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Configuration [Get],Power"
+RMH_TAGS(ConfigurationGet, Power)
 /********************************************************************************************************************/
 )
 
@@ -2298,7 +2913,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Configuration [Get],Power"
+RMH_TAGS(ConfigurationGet, Power)
 /********************************************************************************************************************/
 )
 
@@ -2325,7 +2940,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Configuration [Get],Power"
+RMH_TAGS(ConfigurationGet, Power)
 /********************************************************************************************************************/
 )
 
@@ -2352,7 +2967,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Configuration [Set],Power"
+RMH_TAGS(ConfigurationSet, Power)
 /********************************************************************************************************************/
 )
 
@@ -2380,7 +2995,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Configuration [Get],Power"
+RMH_TAGS(ConfigurationGet, Power)
 /********************************************************************************************************************/
 )
 
@@ -2407,7 +3022,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Configuration [Set],Power"
+RMH_TAGS(ConfigurationSet, Power)
 /********************************************************************************************************************/
 )
 
@@ -2434,7 +3049,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Configuration [Get],Power"
+RMH_TAGS(ConfigurationGet, Power)
 /********************************************************************************************************************/
 )
 
@@ -2461,7 +3076,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Configuration [Set],Power"
+RMH_TAGS(ConfigurationSet, Power)
 /********************************************************************************************************************/
 )
 
@@ -2488,7 +3103,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Self,Power"
+RMH_TAGS(Self, Power)
 /********************************************************************************************************************/
 )
 
@@ -2515,7 +3130,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Configuration [Set],Power"
+RMH_TAGS(ConfigurationSet, Power)
 /********************************************************************************************************************/
 )
 
@@ -2542,7 +3157,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Network"
+RMH_TAGS(Network)
 /********************************************************************************************************************/
 )
 
@@ -2569,7 +3184,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Network"
+RMH_TAGS(Network)
 /********************************************************************************************************************/
 )
 
@@ -2596,7 +3211,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Network"
+RMH_TAGS(Network)
 /********************************************************************************************************************/
 )
 
@@ -2623,7 +3238,34 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Network,Remote Node"
+RMH_TAGS(Network, RemoteNode)
+/********************************************************************************************************************/
+)
+
+
+
+RMH_API_IMPLEMENTATION_GENERIC_ONLY(
+/********************************************************************************************************************/
+/* API Declaration */
+RMH_Result RMH_Network_GetSnapshot(const RMH_Handle handle, RMH_NetworkSnapshot* response),
+
+/* API Name */
+RMH_Network_GetSnapshot,
+
+/* Description */
+"Return the status of the self node, the network and every remote node in a single call. A SoC library which can read all of these at once may implement this natively, otherwise it is composed from the individual APIs. Only fields whose bit is set in <selfValid>, <networkValid> or the <valid> of a node hold a value. Network and remote node fields are only read when the MoCA link is up",
+
+/* Parameters */
+PARAMETERS(
+    INPUT_PARAM(handle,         const RMH_Handle,       "The RMH handle as returned by RMH_Initialize"),
+    OUTPUT_PARAM(response,      RMH_NetworkSnapshot*,   "The status of the self node, the network and the first <numRemoteNodes> entries of <remoteNodes>")
+),
+
+/* Wrap API */
+TRUE,
+
+/* Tags */
+RMH_TAGS(Network, RemoteNode)
 /********************************************************************************************************************/
 )
 
@@ -2650,7 +3292,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Network"
+RMH_TAGS(Network)
 /********************************************************************************************************************/
 )
 
@@ -2677,7 +3319,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Network,NC"
+RMH_TAGS(Network, NC)
 /********************************************************************************************************************/
 )
 
@@ -2704,7 +3346,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Network,NC"
+RMH_TAGS(Network, NC)
 /********************************************************************************************************************/
 )
 
@@ -2731,7 +3373,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Network,NC,mac"
+RMH_TAGS(Network, NC, Mac)
 /********************************************************************************************************************/
 )
 
@@ -2758,7 +3400,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Network,Link"
+RMH_TAGS(Network, Link)
 /********************************************************************************************************************/
 )
 
@@ -2785,7 +3427,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Network,Link,"
+RMH_TAGS(Network, Link)
 /********************************************************************************************************************/
 )
 
@@ -2812,7 +3454,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Network,Link,"
+RMH_TAGS(Network, Link)
 /********************************************************************************************************************/
 )
 
@@ -2839,7 +3481,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Network"
+RMH_TAGS(Network)
 /********************************************************************************************************************/
 )
 
@@ -2866,7 +3508,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Network,Frequency"
+RMH_TAGS(Network, Frequency)
 /********************************************************************************************************************/
 )
 
@@ -2893,7 +3535,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Network,Frequency"
+RMH_TAGS(Network, Frequency)
 /********************************************************************************************************************/
 )
 
@@ -2920,7 +3562,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Network,Frequency"
+RMH_TAGS(Network, Frequency)
 /********************************************************************************************************************/
 )
 
@@ -2947,7 +3589,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Network,Version"
+RMH_TAGS(Network, Version)
 /********************************************************************************************************************/
 )
 
@@ -2974,7 +3616,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Configuration [Get],Phy"
+RMH_TAGS(ConfigurationGet, Phy)
 /********************************************************************************************************************/
 )
 
@@ -3001,7 +3643,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Configuration [Get],Phy"
+RMH_TAGS(ConfigurationGet, Phy)
 /********************************************************************************************************************/
 )
 
@@ -3028,7 +3670,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Network,Phy"
+RMH_TAGS(Network, Phy)
 /********************************************************************************************************************/
 )
 
@@ -3055,7 +3697,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Network,Power"
+RMH_TAGS(Network, Power)
 /********************************************************************************************************************/
 )
 
@@ -3087,7 +3729,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Network,Taboo,Frequency"
+RMH_TAGS(Network, Taboo, Frequency)
 /********************************************************************************************************************/
 )
 
@@ -3116,7 +3758,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Network,Phy"
+RMH_TAGS(Network, Phy)
 /********************************************************************************************************************/
 )
 
@@ -3146,7 +3788,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Network,Phy"
+RMH_TAGS(Network, Phy)
 /********************************************************************************************************************/
 )
 
@@ -3176,7 +3818,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Network,Phy"
+RMH_TAGS(Network, Phy)
 /********************************************************************************************************************/
 )
 
@@ -3203,7 +3845,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Network"
+RMH_TAGS(Network)
 /********************************************************************************************************************/
 )
 
@@ -3230,7 +3872,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Network"
+RMH_TAGS(Network)
 /********************************************************************************************************************/
 )
 
@@ -3258,7 +3900,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Remote Node"
+RMH_TAGS(RemoteNode)
 /********************************************************************************************************************/
 )
 
@@ -3286,7 +3928,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Remote Node"
+RMH_TAGS(RemoteNode)
 /********************************************************************************************************************/
 )
 
@@ -3314,7 +3956,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Remote Node,mac"
+RMH_TAGS(RemoteNode, Mac)
 /********************************************************************************************************************/
 )
 
@@ -3342,7 +3984,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Remote Node,NC"
+RMH_TAGS(RemoteNode, NC)
 /********************************************************************************************************************/
 )
 
@@ -3370,7 +4012,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Remote Node,Version"
+RMH_TAGS(RemoteNode, Version)
 /********************************************************************************************************************/
 )
 
@@ -3399,7 +4041,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Remote Node,Version"
+RMH_TAGS(RemoteNode, Version)
 /********************************************************************************************************************/
 )
 
@@ -3427,7 +4069,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Remote Node"
+RMH_TAGS(RemoteNode)
 /********************************************************************************************************************/
 )
 
@@ -3455,7 +4097,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Remote Node"
+RMH_TAGS(RemoteNode)
 /********************************************************************************************************************/
 )
 
@@ -3483,7 +4125,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Remote Node"
+RMH_TAGS(RemoteNode)
 /********************************************************************************************************************/
 )
 
@@ -3510,7 +4152,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Remote Node,Bonding"
+RMH_TAGS(RemoteNode, Bonding)
 /********************************************************************************************************************/
 )
 
@@ -3538,7 +4180,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Remote Node,Phy"
+RMH_TAGS(RemoteNode, Phy)
 /********************************************************************************************************************/
 )
 
@@ -3566,7 +4208,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Remote Node,Phy"
+RMH_TAGS(RemoteNode, Phy)
 /********************************************************************************************************************/
 )
 
@@ -3594,7 +4236,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Remote Node,Power"
+RMH_TAGS(RemoteNode, Power)
 /********************************************************************************************************************/
 )
 
@@ -3622,7 +4264,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Remote Node,Power"
+RMH_TAGS(RemoteNode, Power)
 /********************************************************************************************************************/
 )
 
@@ -3650,7 +4292,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Remote Node,Power"
+RMH_TAGS(RemoteNode, Power)
 /********************************************************************************************************************/
 )
 
@@ -3678,7 +4320,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Remote Node"
+RMH_TAGS(RemoteNode)
 /********************************************************************************************************************/
 )
 
@@ -3706,7 +4348,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Remote Node"
+RMH_TAGS(RemoteNode)
 /********************************************************************************************************************/
 )
 
@@ -3734,7 +4376,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Remote Node"
+RMH_TAGS(RemoteNode)
 /********************************************************************************************************************/
 )
 
@@ -3762,7 +4404,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Remote Node"
+RMH_TAGS(RemoteNode)
 /********************************************************************************************************************/
 )
 
@@ -3790,7 +4432,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Remote Node"
+RMH_TAGS(RemoteNode)
 /********************************************************************************************************************/
 )
 
@@ -3818,7 +4460,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Remote Node,Phy"
+RMH_TAGS(RemoteNode, Phy)
 /********************************************************************************************************************/
 )
 
@@ -3846,7 +4488,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Remote Node,Power"
+RMH_TAGS(RemoteNode, Power)
 /********************************************************************************************************************/
 )
 
@@ -3874,7 +4516,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Remote Node,Power"
+RMH_TAGS(RemoteNode, Power)
 /********************************************************************************************************************/
 )
 
@@ -3902,7 +4544,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Remote Node"
+RMH_TAGS(RemoteNode)
 /********************************************************************************************************************/
 )
 
@@ -3931,7 +4573,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Network,Remote Node"
+RMH_TAGS(Network, RemoteNode)
 /********************************************************************************************************************/
 )
 
@@ -3962,7 +4604,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Remote Node,Phy"
+RMH_TAGS(RemoteNode, Phy)
 /********************************************************************************************************************/
 )
 
@@ -3993,7 +4635,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Remote Node,Phy"
+RMH_TAGS(RemoteNode, Phy)
 /********************************************************************************************************************/
 )
 
@@ -4024,7 +4666,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Remote Node,Phy"
+RMH_TAGS(RemoteNode, Phy)
 /********************************************************************************************************************/
 )
 
@@ -4055,7 +4697,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Remote Node,Phy"
+RMH_TAGS(RemoteNode, Phy)
 /********************************************************************************************************************/
 )
 
@@ -4086,7 +4728,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Remote Node,Phy"
+RMH_TAGS(RemoteNode, Phy)
 /********************************************************************************************************************/
 )
 
@@ -4117,7 +4759,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Remote Node,Phy"
+RMH_TAGS(RemoteNode, Phy)
 /********************************************************************************************************************/
 )
 
@@ -4145,7 +4787,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Remote Node"
+RMH_TAGS(RemoteNode)
 /********************************************************************************************************************/
 )
 
@@ -4173,7 +4815,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Remote Node"
+RMH_TAGS(RemoteNode)
 /********************************************************************************************************************/
 )
 
@@ -4201,7 +4843,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Remote Node"
+RMH_TAGS(RemoteNode)
 /********************************************************************************************************************/
 )
 
@@ -4229,7 +4871,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Remote Node"
+RMH_TAGS(RemoteNode)
 /********************************************************************************************************************/
 )
 
@@ -4257,7 +4899,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Remote Node"
+RMH_TAGS(RemoteNode)
 /********************************************************************************************************************/
 )
 
@@ -4285,7 +4927,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Remote Node"
+RMH_TAGS(RemoteNode)
 /********************************************************************************************************************/
 )
 
@@ -4313,7 +4955,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Remote Node"
+RMH_TAGS(RemoteNode)
 /********************************************************************************************************************/
 )
 
@@ -4341,7 +4983,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Remote Node"
+RMH_TAGS(RemoteNode)
 /********************************************************************************************************************/
 )
 
@@ -4368,7 +5010,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"PQoS"
+RMH_TAGS(PQoS)
 /********************************************************************************************************************/
 )
 
@@ -4395,7 +5037,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"PQoS"
+RMH_TAGS(PQoS)
 /********************************************************************************************************************/
 )
 
@@ -4422,7 +5064,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"PQoS"
+RMH_TAGS(PQoS)
 /********************************************************************************************************************/
 )
 
@@ -4449,7 +5091,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"PQoS"
+RMH_TAGS(PQoS)
 /********************************************************************************************************************/
 )
 
@@ -4477,7 +5119,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"PQoS"
+RMH_TAGS(PQoS)
 /********************************************************************************************************************/
 )
 
@@ -4506,7 +5148,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"PQoS"
+RMH_TAGS(PQoS)
 /********************************************************************************************************************/
 )
 
@@ -4534,7 +5176,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"PQoS"
+RMH_TAGS(PQoS)
 /********************************************************************************************************************/
 )
 
@@ -4562,7 +5204,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"PQoS"
+RMH_TAGS(PQoS)
 /********************************************************************************************************************/
 )
 
@@ -4590,7 +5232,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"PQoS"
+RMH_TAGS(PQoS)
 /********************************************************************************************************************/
 )
 
@@ -4618,7 +5260,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"PQoS"
+RMH_TAGS(PQoS)
 /********************************************************************************************************************/
 )
 
@@ -4646,7 +5288,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"PQoS"
+RMH_TAGS(PQoS)
 /********************************************************************************************************************/
 )
 
@@ -4674,7 +5316,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"PQoS"
+RMH_TAGS(PQoS)
 /********************************************************************************************************************/
 )
 
@@ -4705,7 +5347,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"PQoS"
+RMH_TAGS(PQoS)
 /********************************************************************************************************************/
 )
 
@@ -4733,7 +5375,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"PQoS"
+RMH_TAGS(PQoS)
 /********************************************************************************************************************/
 )
 
@@ -4762,7 +5404,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"PQoS"
+RMH_TAGS(PQoS)
 /********************************************************************************************************************/
 )
 
@@ -4791,7 +5433,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"PQoS"
+RMH_TAGS(PQoS)
 /********************************************************************************************************************/
 )
 
@@ -4819,7 +5461,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"PQoS"
+RMH_TAGS(PQoS)
 /********************************************************************************************************************/
 )
 
@@ -4848,7 +5490,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"PQoS"
+RMH_TAGS(PQoS)
 /********************************************************************************************************************/
 )
 
@@ -4876,7 +5518,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"PQoS"
+RMH_TAGS(PQoS)
 /********************************************************************************************************************/
 )
 
@@ -4905,7 +5547,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"PQoS"
+RMH_TAGS(PQoS)
 /********************************************************************************************************************/
 )
 
@@ -4933,7 +5575,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"PQoS"
+RMH_TAGS(PQoS)
 /********************************************************************************************************************/
 )
 
@@ -4961,7 +5603,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"PQoS"
+RMH_TAGS(PQoS)
 /********************************************************************************************************************/
 )
 
@@ -4989,7 +5631,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"PQoS"
+RMH_TAGS(PQoS)
 /********************************************************************************************************************/
 )
 
@@ -5017,7 +5659,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"PQoS"
+RMH_TAGS(PQoS)
 /********************************************************************************************************************/
 )
 
@@ -5043,7 +5685,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"PQoS"
+RMH_TAGS(PQoS)
 /********************************************************************************************************************/
 )
 
@@ -5070,7 +5712,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"PQoS"
+RMH_TAGS(PQoS)
 /********************************************************************************************************************/
 )
 
@@ -5098,7 +5740,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Stats"
+RMH_TAGS(Stats)
 /********************************************************************************************************************/
 )
 
@@ -5126,7 +5768,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Stats"
+RMH_TAGS(Stats)
 /********************************************************************************************************************/
 )
 
@@ -5154,7 +5796,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Stats"
+RMH_TAGS(Stats)
 /********************************************************************************************************************/
 )
 
@@ -5182,7 +5824,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Stats,NC"
+RMH_TAGS(Stats, NC)
 /********************************************************************************************************************/
 )
 
@@ -5210,7 +5852,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Stats"
+RMH_TAGS(Stats)
 /********************************************************************************************************************/
 )
 
@@ -5238,7 +5880,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Stats"
+RMH_TAGS(Stats)
 /********************************************************************************************************************/
 )
 
@@ -5266,7 +5908,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Stats"
+RMH_TAGS(Stats)
 /********************************************************************************************************************/
 )
 
@@ -5294,7 +5936,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Stats"
+RMH_TAGS(Stats)
 /********************************************************************************************************************/
 )
 
@@ -5322,7 +5964,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Stats"
+RMH_TAGS(Stats)
 /********************************************************************************************************************/
 )
 
@@ -5350,7 +5992,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Stats"
+RMH_TAGS(Stats)
 /********************************************************************************************************************/
 )
 
@@ -5378,7 +6020,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Stats"
+RMH_TAGS(Stats)
 /********************************************************************************************************************/
 )
 
@@ -5406,7 +6048,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Stats"
+RMH_TAGS(Stats)
 /********************************************************************************************************************/
 )
 
@@ -5434,7 +6076,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Stats"
+RMH_TAGS(Stats)
 /********************************************************************************************************************/
 )
 
@@ -5462,7 +6104,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Stats"
+RMH_TAGS(Stats)
 /********************************************************************************************************************/
 )
 
@@ -5490,7 +6132,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Stats"
+RMH_TAGS(Stats)
 /********************************************************************************************************************/
 )
 
@@ -5518,7 +6160,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Stats"
+RMH_TAGS(Stats)
 /********************************************************************************************************************/
 )
 
@@ -5546,7 +6188,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Stats"
+RMH_TAGS(Stats)
 /********************************************************************************************************************/
 )
 
@@ -5574,7 +6216,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Stats"
+RMH_TAGS(Stats)
 /********************************************************************************************************************/
 )
 
@@ -5602,7 +6244,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Stats"
+RMH_TAGS(Stats)
 /********************************************************************************************************************/
 )
 
@@ -5630,7 +6272,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Stats"
+RMH_TAGS(Stats)
 /********************************************************************************************************************/
 )
 
@@ -5658,7 +6300,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Stats"
+RMH_TAGS(Stats)
 /********************************************************************************************************************/
 )
 
@@ -5686,7 +6328,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Stats"
+RMH_TAGS(Stats)
 /********************************************************************************************************************/
 )
 
@@ -5714,7 +6356,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Stats"
+RMH_TAGS(Stats)
 /********************************************************************************************************************/
 )
 
@@ -5742,7 +6384,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Stats"
+RMH_TAGS(Stats)
 /********************************************************************************************************************/
 )
 
@@ -5770,7 +6412,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Stats"
+RMH_TAGS(Stats)
 /********************************************************************************************************************/
 )
 
@@ -5798,7 +6440,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Stats"
+RMH_TAGS(Stats)
 /********************************************************************************************************************/
 )
 
@@ -5826,7 +6468,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Stats"
+RMH_TAGS(Stats)
 /********************************************************************************************************************/
 )
 
@@ -5854,7 +6496,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Stats"
+RMH_TAGS(Stats)
 /********************************************************************************************************************/
 )
 
@@ -5882,7 +6524,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Stats"
+RMH_TAGS(Stats)
 /********************************************************************************************************************/
 )
 
@@ -5910,7 +6552,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Stats"
+RMH_TAGS(Stats)
 /********************************************************************************************************************/
 )
 
@@ -5938,7 +6580,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Stats"
+RMH_TAGS(Stats)
 /********************************************************************************************************************/
 )
 
@@ -5966,7 +6608,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Stats"
+RMH_TAGS(Stats)
 /********************************************************************************************************************/
 )
 
@@ -5994,7 +6636,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Stats"
+RMH_TAGS(Stats)
 /********************************************************************************************************************/
 )
 
@@ -6022,7 +6664,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Stats"
+RMH_TAGS(Stats)
 /********************************************************************************************************************/
 )
 
@@ -6050,7 +6692,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Stats"
+RMH_TAGS(Stats)
 /********************************************************************************************************************/
 )
 
@@ -6078,7 +6720,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Stats"
+RMH_TAGS(Stats)
 /********************************************************************************************************************/
 )
 
@@ -6108,7 +6750,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Stats"
+RMH_TAGS(Stats)
 /********************************************************************************************************************/
 )
 
@@ -6140,7 +6782,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Stats"
+RMH_TAGS(Stats)
 /********************************************************************************************************************/
 )
 
@@ -6169,7 +6811,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Stats"
+RMH_TAGS(Stats)
 /********************************************************************************************************************/
 )
 
@@ -6198,13 +6840,13 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Stats"
+RMH_TAGS(Stats)
 /********************************************************************************************************************/
 )
 
 
 
-RMH_API_IMPLEMENTATION_SOC_ONLY(
+RMH_API_IMPLEMENTATION_SOC_THEN_GENERIC(
 /********************************************************************************************************************/
 /* API Declaration */
 RMH_Result RMH_Stats_Reset(const RMH_Handle handle),
@@ -6213,7 +6855,8 @@ RMH_Result RMH_Stats_Reset(const RMH_Handle handle),
 RMH_Stats_Reset,
 
 /* Description */
-"Reset MoCA statistics counters back to zero.",
+"Reset MoCA statistics counters back to zero. The totals returned by <RMH_Stats_GetExtended> are not reset, they "
+"continue to count up from where they were.",
 
 /* Parameters */
 PARAMETERS(
@@ -6224,7 +6867,93 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Stats"
+RMH_TAGS(Stats)
+/********************************************************************************************************************/
+)
+
+
+RMH_API_IMPLEMENTATION_GENERIC_ONLY(
+/********************************************************************************************************************/
+/* API Declaration */
+RMH_Result RMH_Stats_GetExtended(const RMH_Handle handle, RMH_StatsExtended* response),
+
+/* API Name */
+RMH_Stats_GetExtended,
+
+/* Description */
+"Sample the MoCA statistics counters and return them as 64 bit totals along with the rate of each per second. The "
+"32 bit counters of the SoC are accumulated by the handle so the totals keep counting up when a counter wraps, when "
+"the counters are cleared by <RMH_Stats_Reset> and when the MoCA link is reset. The rates are measured between this "
+"sample and one taken about <RMH_Stats_GetRateWindow> milliseconds earlier so the first call only returns totals. "
+"To keep the rates accurate call this at least once every few seconds. Counters which could not be read are not set "
+"in <valid> and keep the total of the last time they were.",
+
+/* Parameters */
+PARAMETERS(
+    INPUT_PARAM(handle,         const RMH_Handle,       "The RMH handle as returned by RMH_Initialize"),
+    OUTPUT_PARAM(response,      RMH_StatsExtended*,     "The totals and rates of the statistics counters")
+),
+
+/* Wrap API */
+TRUE,
+
+/* Tags */
+RMH_TAGS(Stats)
+/********************************************************************************************************************/
+)
+
+
+
+RMH_API_IMPLEMENTATION_GENERIC_ONLY(
+/********************************************************************************************************************/
+/* API Declaration */
+RMH_Result RMH_Stats_SetRateWindow(const RMH_Handle handle, const uint32_t value),
+
+/* API Name */
+RMH_Stats_SetRateWindow,
+
+/* Description */
+"Set the number of milliseconds the rates returned by <RMH_Stats_GetExtended> are measured over. A longer window "
+"gives steadier rates, a shorter one follows changes in traffic sooner. The default is 10000.",
+
+/* Parameters */
+PARAMETERS(
+    INPUT_PARAM(handle,         const RMH_Handle,       "The RMH handle as returned by RMH_Initialize"),
+    INPUT_PARAM(value,          const uint32_t,         "The rate window in milliseconds. Must be at least 100")
+),
+
+/* Wrap API */
+TRUE,
+
+/* Tags */
+RMH_TAGS(Stats)
+/********************************************************************************************************************/
+)
+
+
+
+RMH_API_IMPLEMENTATION_GENERIC_ONLY(
+/********************************************************************************************************************/
+/* API Declaration */
+RMH_Result RMH_Stats_GetRateWindow(const RMH_Handle handle, uint32_t* response),
+
+/* API Name */
+RMH_Stats_GetRateWindow,
+
+/* Description */
+"Return the number of milliseconds the rates returned by <RMH_Stats_GetExtended> are measured over.",
+
+/* Parameters */
+PARAMETERS(
+    INPUT_PARAM(handle,         const RMH_Handle,       "The RMH handle as returned by RMH_Initialize"),
+    OUTPUT_PARAM(response,      uint32_t*,              "The rate window in milliseconds")
+),
+
+/* Wrap API */
+TRUE,
+
+/* Tags */
+RMH_TAGS(Stats)
 /********************************************************************************************************************/
 )
 
@@ -6252,7 +6981,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Log"
+RMH_TAGS(Log)
 /********************************************************************************************************************/
 )
 
@@ -6281,7 +7010,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Log"
+RMH_TAGS(Log)
 /********************************************************************************************************************/
 )
 
@@ -6310,7 +7039,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Log"
+RMH_TAGS(Log)
 /********************************************************************************************************************/
 )
 
@@ -6339,7 +7068,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Log"
+RMH_TAGS(Log)
 /********************************************************************************************************************/
 )
 
@@ -6367,7 +7096,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Log"
+RMH_TAGS(Log)
 /********************************************************************************************************************/
 )
 
@@ -6396,7 +7125,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Log"
+RMH_TAGS(Log)
 /********************************************************************************************************************/
 )
 
@@ -6428,7 +7157,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"log"
+RMH_TAGS(Log)
 /********************************************************************************************************************/
 )
 
@@ -6458,7 +7187,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Status"
+RMH_TAGS(Status)
 /********************************************************************************************************************/
 )
 
@@ -6488,7 +7217,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Stats,Status"
+RMH_TAGS(Stats, Status)
 /********************************************************************************************************************/
 )
 
@@ -6518,7 +7247,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"PQoS,Status"
+RMH_TAGS(PQoS, Status)
 /********************************************************************************************************************/
 )
 
@@ -6547,7 +7276,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"Status"
+RMH_TAGS(Status)
 /********************************************************************************************************************/
 )
 
@@ -6577,7 +7306,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"ACA"
+RMH_TAGS(ACA)
 /********************************************************************************************************************/
 )
 
@@ -6604,7 +7333,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"ACA"
+RMH_TAGS(ACA)
 /********************************************************************************************************************/
 )
 
@@ -6631,7 +7360,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"ACA"
+RMH_TAGS(ACA)
 /********************************************************************************************************************/
 )
 
@@ -6658,7 +7387,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"ACA"
+RMH_TAGS(ACA)
 /********************************************************************************************************************/
 )
 
@@ -6685,7 +7414,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"ACA"
+RMH_TAGS(ACA)
 /********************************************************************************************************************/
 )
 
@@ -6712,7 +7441,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"ACA"
+RMH_TAGS(ACA)
 /********************************************************************************************************************/
 )
 
@@ -6739,7 +7468,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"ACA"
+RMH_TAGS(ACA)
 /********************************************************************************************************************/
 )
 
@@ -6769,7 +7498,7 @@ PARAMETERS(
 TRUE,
 
 /* Tags */
-"ACA"
+RMH_TAGS(ACA)
 /********************************************************************************************************************/
 )
 
@@ -6785,6 +7514,8 @@ TRUE,
  * This handle will be used in all future communication with the RMH library.
  * This function will fail if the MoCA driver is not properly installed or is not able to operate.
  * Multiple simultaneous instances of RMH_Initialize are supported in single and multiprocess environments.
+ * They share one SoC library instance, so calls into it from all of them are made one at a time unless the SoC library
+ * declares RMH_SOC_CAP_THREAD_SAFE. See RMH_InitializeEx.
  *
  * @param[in] eventCB      A pointer to a function which will handle any callbacks from the RMH MoCA library
  *                         A value of NULL is permitted if you do not wish to receive callbacks.
@@ -6793,6 +7524,26 @@ TRUE,
  */
 RMH_Handle RMH_Initialize(const RMH_EventCallback eventCB, void * userContext);
 
+/**
+ * @brief Initialize the RMH library with options and return a handle to the instance.
+ *
+ * Same as RMH_Initialize but takes a bitmask of RMH_InitFlag. With RMH_INIT_FLAG_THREAD_SAFE any number of threads
+ * may call APIs on the returned handle at the same time. The state of each call is then kept per thread and calls into
+ * the SoC library are serialized unless the SoC library declares RMH_SOC_CAP_THREAD_SAFE.
+ *
+ * All handles in a process share one SoC library instance which is released when the last of them is destroyed, so
+ * only the first handle pays for loading and initializing the SoC library. Calls into it from all of those handles are
+ * made one at a time unless the SoC library declares RMH_SOC_CAP_THREAD_SAFE. With RMH_INIT_FLAG_PRIVATE_SESSION the
+ * handle gets a SoC library instance of its own instead, whose calls are only serialized with RMH_INIT_FLAG_THREAD_SAFE.
+ *
+ * @param[in] eventCB      A pointer to a function which will handle any callbacks from the RMH MoCA library
+ *                         A value of NULL is permitted if you do not wish to receive callbacks.
+ * @param[in] userContext  A pointer to some data that will be passed back with each callback.
+ *                         A value of NULL is permitted if the client requires no context during callbacks.
+ * @param[in] flags        A bitmask of RMH_InitFlag. A value of 0 is the same as RMH_Initialize.
+ */
+RMH_Handle RMH_InitializeEx(const RMH_EventCallback eventCB, void * userContext, const uint32_t flags);
+
 /**
  * @brief Destroy the instance of RMH library which was created by RMH_Initialize.
  *
@@ -6808,6 +7559,9 @@ RMH_Result RMH_Destroy(RMH_Handle handle);
  * Any subsequent calls to this API will overwrite previous calls.
  * For example, if you originally set value to 'RMH_API_PRINT' and later set to LINK_STATUS_CHANGED | MOCA_VERSION_CHANGED'
  * you will stop receiving callbacks for 'RMH_API_PRINT'.
+ * Callbacks may be made from inside another RMH call of the same thread, for example when the SoC raises an event
+ * before it returns. It's safe to make RMH calls from a callback but they must not wait on another thread which is
+ * itself making RMH calls.
  *
  * @param[in] handle  The RMH handle as returned by RMH_Initialize.
  * @param[in] value   A bitmask list of RMH_Event indicating the callbacks to be received.
@@ -6831,9 +7585,11 @@ RMH_Result RMH_GetEventCallbacks(RMH_Handle handle, uint32_t* response);
 RMH_Result RMH_GetAllAPIs(const RMH_Handle handle, RMH_APIList** apiList);
 
 /**
- * @brief Return a list of all RMH APIs which are unimplemented by the SoC library.
+ * @brief Return a list of all RMH APIs which are unimplemented by the SoC library loaded for handle.
  *
- * @param[in]  handle     The RMH handle as returned by RMH_Initialize. NULL is valid for this API.
+ * The list remains valid until the handle is destroyed.
+ *
+ * @param[in]  handle     The RMH handle as returned by RMH_Initialize.
  * @param[out] apiList    Output list of APIs.
  */
 RMH_Result RMH_GetUnimplementedAPIs(const RMH_Handle handle, RMH_APIList** apiList);
@@ -6846,6 +7602,204 @@ RMH_Result RMH_GetUnimplementedAPIs(const RMH_Handle handle, RMH_APIList** apiLi
  */
 RMH_Result RMH_GetAPITags(const RMH_Handle handle, RMH_APITagList** apiTags);
 
+/**
+ * @brief Return the description of the RMH API identified by apiId. This is a constant time lookup.
+ *
+ * @param[in]  handle     The RMH handle as returned by RMH_Initialize. NULL is valid for this API.
+ * @param[in]  apiId      The ID of the API. This is the API name prefixed with 'RMH_API_ID__'.
+ * @param[out] api        The description of the API.
+ */
+RMH_Result RMH_GetAPIById(const RMH_Handle handle, const RMH_APIId apiId, const RMH_API** api);
+
+/**
+ * @brief Return the description of the RMH API named apiName. The name is not case sensitive.
+ *
+ * @param[in]  handle     The RMH handle as returned by RMH_Initialize. NULL is valid for this API.
+ * @param[in]  apiName    The name of the API.
+ * @param[out] api        The description of the API.
+ */
+RMH_Result RMH_GetAPIByName(const RMH_Handle handle, const char* apiName, const RMH_API** api);
+
+/**
+ * @brief Return the number of calls, the results and the latency histogram of the API apiId.
+ *
+ * These are collected for every wrapped API across all handles in this process since it started or since
+ * RMH_Instrumentation_Reset was last called.
+ *
+ * @param[in]  handle     The RMH handle as returned by RMH_Initialize. NULL is valid for this API.
+ * @param[in]  apiId      The ID of the API. This is the API name prefixed with 'RMH_API_ID__'.
+ * @param[out] response   The statistics collected for the API.
+ */
+RMH_Result RMH_Instrumentation_GetStats(const RMH_Handle handle, const RMH_APIId apiId, RMH_APIStats* response);
+
+/**
+ * @brief Clear the statistics collected for all APIs in this process.
+ *
+ * @param[in]  handle     The RMH handle as returned by RMH_Initialize. NULL is valid for this API.
+ */
+RMH_Result RMH_Instrumentation_Reset(const RMH_Handle handle);
+
+/**
+ * @brief Enable or disable recording of every wrapped API call into the binary trace buffer of this process.
+ *
+ * Each record holds the API, nesting depth, start time, duration, result and thread. Tracing can also be enabled by
+ * setting the environment variable RMH_TRACE before the first call to RMH_Initialize. If RMH_TRACE is the full path of
+ * a file the trace buffer is kept in that file so it can be read from another process with RMH_Trace_Dump.
+ *
+ * @param[in]  handle     The RMH handle as returned by RMH_Initialize. NULL is valid for this API.
+ * @param[in]  value      Set 'true' to start recording, 'false' to stop.
+ */
+RMH_Result RMH_Trace_SetEnabled(const RMH_Handle handle, const bool value);
+
+/**
+ * @brief Return if API calls are being recorded into the binary trace buffer of this process.
+ *
+ * @param[in]  handle     The RMH handle as returned by RMH_Initialize. NULL is valid for this API.
+ * @param[out] response   Set 'true' if tracing is enabled.
+ */
+RMH_Result RMH_Trace_GetEnabled(const RMH_Handle handle, bool* response);
+
+/**
+ * @brief Copy the most recent records from a binary trace buffer, oldest first. This does not clear the buffer.
+ *
+ * @param[in]  handle             The RMH handle as returned by RMH_Initialize. NULL is valid for this API.
+ * @param[in]  filename           The trace file set in RMH_TRACE by another process. Pass NULL to read the trace
+ *                                buffer of this process.
+ * @param[out] responseArray      An array where the trace records should be written.
+ * @param[in]  responseArraySize  The size of responseArray.
+ * @param[out] responseArrayUsed  The number of entries in the response array which have valid data.
+ */
+RMH_Result RMH_Trace_Dump(const RMH_Handle handle, const char* filename, RMH_TraceRecord* responseArray, const size_t responseArraySize, size_t* responseArrayUsed);
+
+/**
+ * @brief Enable or disable the cache of this handle.
+ *
+ * When enabled, getters whose values rarely change, such as RMH_Interface_GetName, RMH_Interface_GetMac,
+ * RMH_Self_GetSoftwareVersion and RMH_RemoteNode_GetMac, are answered from memory after the first successful call.
+ * Cached values are dropped when the SoC reports an event which could change them, such as a node joining or leaving,
+ * a change of link status or a MoCA reset. Values of remote nodes are also dropped after a minute. The cache is
+ * disabled by default. Disabling it drops everything cached.
+ *
+ * @param[in]  handle     The RMH handle as returned by RMH_Initialize.
+ * @param[in]  value      Set 'true' to enable the cache, 'false' to disable it.
+ */
+RMH_Result RMH_Cache_SetEnabled(const RMH_Handle handle, const bool value);
+
+/**
+ * @brief Return if the cache of this handle is enabled.
+ *
+ * @param[in]  handle     The RMH handle as returned by RMH_Initialize.
+ * @param[out] response   Set 'true' if the cache is enabled.
+ */
+RMH_Result RMH_Cache_GetEnabled(const RMH_Handle handle, bool* response);
+
+/**
+ * @brief Drop every value in the cache of this handle so the next call to each cached API goes to the SoC.
+ *
+ * @param[in]  handle     The RMH handle as returned by RMH_Initialize.
+ */
+RMH_Result RMH_Cache_Flush(const RMH_Handle handle);
+
+/**
+ * @brief Return the number of cache hits, misses and invalidations of an API on this handle.
+ *
+ * Returns RMH_NOT_SUPPORTED if the API is never cached.
+ *
+ * @param[in]  handle     The RMH handle as returned by RMH_Initialize.
+ * @param[in]  apiId      The ID of the API. This is the API name prefixed with 'RMH_API_ID__'.
+ * @param[out] response   The cache statistics of the API.
+ */
+RMH_Result RMH_Cache_GetStats(const RMH_Handle handle, const RMH_APIId apiId, RMH_CacheStats* response);
+
+/**
+ * @brief Run a list of getters in a single call.
+ *
+ * Each op names the API, its node ID if it takes one and where to store the output and result. Getters only
+ * implemented by the SoC are called directly, skipping the per API logging, timing and instrumentation, so a batch
+ * costs little more than the SoC calls themselves. A SoC library may also answer the whole batch at once. Only getters
+ * returning one value, one string or one value of a node may be batched, other ops get RMH_INVALID_ID.
+ * Returns RMH_SUCCESS once every op has its result.
+ *
+ * @param[in]  handle     The RMH handle as returned by RMH_Initialize.
+ * @param[in]  ops        The ops to run, in order.
+ * @param[in]  numOps     The number of entries in ops.
+ */
+RMH_Result RMH_ExecuteBatch(const RMH_Handle handle, const RMH_BatchOp* ops, const size_t numOps);
+
+/**
+ * @brief Read an RFC parameter used by RMH.
+ *
+ * Every RMH parameter, like RMH_RFC_PREFERRED_NC_ENABLE, is read from RFC the first time any is needed and kept in
+ * memory for the whole process. They're read again in the background when /etc/rfc.properties changes or after a few
+ * minutes, and the previous values are returned until that's done. The value is parsed to the type RMH expects and its
+ * age says how long ago it was read.
+ * Returns RMH_FAILURE if the parameter isn't set or has a value which can't be parsed and RMH_INVALID_ID if it's not one
+ * RMH uses.
+ *
+ * @param[in]  name       The full name of the RFC parameter.
+ * @param[out] response   The value of the parameter.
+ */
+RMH_Result RMH_RFC_Get(const char* name, RMH_RFCValue* response);
+
+/**
+ * @brief Map the status published by another process with RMH_Shm_Publish read only.
+ *
+ * This is usually rmh_monitor started with '--shm RMH_SHM_DEFAULT_NAME'. Once open, RMH_Shm_Read gets the status with
+ * no system calls and no locks so it may be called as often as needed.
+ * Returns RMH_FAILURE if nothing is published under name and RMH_INVALID_INTERNAL_STATE if it was published by a
+ * version of RMH with a different RMH_ShmStatus.
+ *
+ * @param[in]  name       The name of the shared memory object. NULL for RMH_SHM_DEFAULT_NAME.
+ * @param[out] response   The handle to pass to RMH_Shm_Read and RMH_Shm_Close.
+ */
+RMH_Result RMH_Shm_Open(const char* name, RMH_ShmHandle* response);
+
+/**
+ * @brief Copy the latest published status.
+ *
+ * The copy is always consistent, if the status is published while it's being copied it's copied again. Compare
+ * sequence with the last read to know if anything was published since and timestampMs with CLOCK_MONOTONIC to know how
+ * old it is. Should the publisher stop the last status it published is still returned, so reopen with RMH_Shm_Open if
+ * it's too old.
+ * Returns RMH_FAILURE if nothing was published yet and RMH_TIMEOUT if the status was being published every time it was
+ * copied.
+ *
+ * @param[in]  shm        The handle returned by RMH_Shm_Open.
+ * @param[out] response   The published status.
+ */
+RMH_Result RMH_Shm_Read(const RMH_ShmHandle shm, RMH_ShmStatus* response);
+
+/**
+ * @brief Create the shared memory object for RMH_Shm_Publish.
+ *
+ * Any process can map it with RMH_Shm_Open. An object already under name is replaced, processes which still have it
+ * open keep reading the status last published there. Only one process should publish under a name.
+ *
+ * @param[in]  name       The name of the shared memory object. NULL for RMH_SHM_DEFAULT_NAME.
+ * @param[out] response   The handle to pass to RMH_Shm_Publish and RMH_Shm_Close.
+ */
+RMH_Result RMH_Shm_Create(const char* name, RMH_ShmHandle* response);
+
+/**
+ * @brief Publish a new status for readers of the shared memory object.
+ *
+ * The status is guarded by a sequence lock so this never waits on a reader. sequence, timestampMs and publisherPid are
+ * set in the published copy. Must only be called by one thread at a time.
+ *
+ * @param[in]  shm        The handle returned by RMH_Shm_Create.
+ * @param[in]  status     The status to publish.
+ */
+RMH_Result RMH_Shm_Publish(const RMH_ShmHandle shm, const RMH_ShmStatus* status);
+
+/**
+ * @brief Unmap the status and free the handle.
+ *
+ * If the handle was returned by RMH_Shm_Create the shared memory object is also removed.
+ *
+ * @param[in]  shm        The handle returned by RMH_Shm_Open or RMH_Shm_Create.
+ */
+RMH_Result RMH_Shm_Close(const RMH_ShmHandle shm);
+
 /**
  * @brief Convert RMH_Result to a string.
  *
@@ -6888,6 +7842,13 @@ const char* const RMH_SubcarrierProfileToString(const RMH_SubcarrierProfile valu
  */
 const char* const RMH_PERModeToString(const RMH_PERMode value);
 
+/**
+ * @brief Convert RMH_StatsCounter to a string.
+ *
+ * @param[in]  value  Value to be printed as a string.
+ */
+const char* const RMH_StatsCounterToString(const RMH_StatsCounter value);
+
 /**
  * @brief Convert RMH_MoCAVersion to a string.
  *
@@ -6971,6 +7932,9 @@ const char* const RMH_ACAStatusToString(const RMH_ACAStatus value);
  *
  * @param[in]   handle          The RMH handle as returned by RMH_Initialize.
  * @param[out]  response        Set to true if the MoCA interface is enabled at the kernel level. Otherwise set to false.
+ *
+ * @note The state is kept up to date from RTNETLINK so this doesn't call into the kernel. Ask for
+ * RMH_EVENT_INTERFACE_STATUS_CHANGED to be told when it changes.
  */
 RMH_Result RMH_Interface_GetEnabled(const RMH_Handle handle, bool *response);
 
@@ -7000,9 +7964,23 @@ RMH_Result RMH_Self_SetEnabledRDK(const RMH_Handle handle);
  *
  * @param[in]   handle   The RMH handle as returned by RMH_Initialize.
  * @param[out]  status   The current link state of MoCA.
+ *
+ * @note The status is kept up to date from MoCA events so this doesn't normally call into the SoC. Use
+ * RMH_Self_RefreshLinkStatus to read it from the device.
  */
 RMH_Result RMH_Self_GetLinkStatus(const RMH_Handle handle, RMH_LinkStatus* status);
 
+/**
+ * @brief Read the current operational status of the MoCA interface from the device.
+ *
+ * Same as RMH_Self_GetLinkStatus but the status is always read from the device. The status kept in memory is updated
+ * with what's read.
+ *
+ * @param[in]   handle   The RMH handle as returned by RMH_Initialize.
+ * @param[out]  status   The current link state of MoCA.
+ */
+RMH_Result RMH_Self_RefreshLinkStatus(const RMH_Handle handle, RMH_LinkStatus* status);
+
 /**
  * @brief Return a list of the associated ID for every node on the network.
  *
@@ -7731,6 +8709,18 @@ RMH_Result RMH_Network_GetNodeIds(const RMH_Handle handle, RMH_NodeList_Uint32_t
  */
 RMH_Result RMH_Network_GetRemoteNodeIds(const RMH_Handle handle, RMH_NodeList_Uint32_t* response);
 
+/**
+ * @brief Return the status of the self node, the network and every remote node in a single call.
+ *
+ * A SoC library which can read all of these at once may implement this natively. Otherwise it is composed from the
+ * individual APIs. Only fields whose bit is set in selfValid, networkValid or the valid of a node hold a value. Network
+ * and remote node fields are only read when the MoCA link is up.
+ *
+ * @param[in]  handle     The RMH handle as returned by RMH_Initialize.
+ * @param[out] response   The status of the self node, the network and the first numRemoteNodes entries of remoteNodes.
+ */
+RMH_Result RMH_Network_GetSnapshot(const RMH_Handle handle, RMH_NetworkSnapshot* response);
+
 /**
  * @brief Return the node ID of the network coordinator. [mocaIfNC]
  *
@@ -8870,9 +9860,41 @@ RMH_Result RMH_Stats_GetRxUncorrectedErrors(const RMH_Handle handle, RMH_NodeLis
  * @brief Reset MoCA statistics counters back to zero.
  *
  * @param[in]  handle           The RMH handle as returned by RMH_Initialize.
+ *
+ * @note The totals returned by RMH_Stats_GetExtended are not reset.
  */
 RMH_Result RMH_Stats_Reset(const RMH_Handle handle);
 
+/**
+ * @brief Sample the MoCA statistics counters and return them as 64 bit totals along with the rate of each per second.
+ *
+ * The 32 bit counters of the SoC are accumulated by the handle so the totals keep counting up when a counter wraps,
+ * when the counters are cleared by RMH_Stats_Reset and when the MoCA link is reset. The rates are measured between
+ * this sample and one taken about RMH_Stats_GetRateWindow milliseconds earlier so the first call only returns totals.
+ *
+ * @param[in]   handle           The RMH handle as returned by RMH_Initialize.
+ * @param[out]  response         The totals and rates of the statistics counters.
+ *
+ * @note Counters which could not be read are not set in valid and keep the total of the last time they were.
+ */
+RMH_Result RMH_Stats_GetExtended(const RMH_Handle handle, RMH_StatsExtended* response);
+
+/**
+ * @brief Set the number of milliseconds the rates returned by RMH_Stats_GetExtended are measured over.
+ *
+ * @param[in]  handle           The RMH handle as returned by RMH_Initialize.
+ * @param[in]  value            The rate window in milliseconds. Must be at least 100. The default is 10000.
+ */
+RMH_Result RMH_Stats_SetRateWindow(const RMH_Handle handle, const uint32_t value);
+
+/**
+ * @brief Return the number of milliseconds the rates returned by RMH_Stats_GetExtended are measured over.
+ *
+ * @param[in]   handle           The RMH handle as returned by RMH_Initialize.
+ * @param[out]  response         The rate window in milliseconds.
+ */
+RMH_Result RMH_Stats_GetRateWindow(const RMH_Handle handle, uint32_t* response);
+
 /**
  * @brief Return a bitmask of RMH_LogLevel which indicates the currently enabled RMH log types in the RMH library.
  *
@@ -9036,8 +10058,4 @@ RMH_Result RMH_ACA_GetPowerProfile(const RMH_Handle handle, uint8_t* responseArr
 
 #endif
 
-#ifdef __cplusplus
-}
-#endif
-
 #endif /* RMH_API_H */
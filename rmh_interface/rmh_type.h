@@ -31,6 +31,7 @@ extern "C" {
 #define RMH_MAX_NUM_APIS 1024
 #define RMH_MAX_NUM_TAGS 32
 #define RMH_MAX_MOCA_NODES 16
+#define RMH_MAX_TRACE_RECORDS 4096
 typedef struct RMH* RMH_Handle;
 typedef uint8_t RMH_MacAddress_t[6];
 
@@ -48,6 +49,7 @@ typedef uint8_t RMH_MacAddress_t[6];
     AS(RMH_NOT_SUPPORTED,                           9) \
     AS(RMH_UNIMPLEMENTED,                           10)
 typedef enum RMH_Result { ENUM_RMH_Result } RMH_Result;
+#define RMH_NUM_RESULTS (RMH_UNIMPLEMENTED+1)
 
 #define ENUM_RMH_PowerMode \
     AS(RMH_POWER_MODE_M0_ACTIVE,                    1u << 0) \
@@ -126,7 +128,8 @@ typedef enum RMH_LogLevel { ENUM_RMH_LogLevel } RMH_LogLevel;
     AS(RMH_EVENT_NC_ID_CHANGED,                     1u << 7) \
     AS(RMH_EVENT_API_PRINT,                         1u << 8) \
     AS(RMH_EVENT_DRIVER_PRINT,                      1u << 9) \
-    AS(RMH_EVENT_MOCA_RESET,                        1u << 10)
+    AS(RMH_EVENT_MOCA_RESET,                        1u << 10) \
+    AS(RMH_EVENT_INTERFACE_STATUS_CHANGED,          1u << 11)
 typedef enum RMH_Event { ENUM_RMH_Event } RMH_Event;
 
 #define ENUM_RMH_Band \
@@ -154,6 +157,17 @@ typedef enum RMH_ACAType { ENUM_RMH_ACAType } RMH_ACAType;
     AS(RMH_ACA_STATUS_FAILURE_NO_EVM_PROBE,         5)
 typedef enum RMH_ACAStatus { ENUM_RMH_ACAStatus } RMH_ACAStatus;
 
+#define ENUM_RMH_InitFlag \
+    AS(RMH_INIT_FLAG_THREAD_SAFE,                   1u << 0) \
+    AS(RMH_INIT_FLAG_PRIVATE_SESSION,               1u << 1)
+typedef enum RMH_InitFlag { ENUM_RMH_InitFlag } RMH_InitFlag;
+
+/* A SoC library declares what it supports by exporting 'const uint32_t RMH_SoCCapabilities', a bitmask of these */
+#define RMH_SOC_CAPABILITIES_SYMBOL "RMH_SoCCapabilities"
+#define ENUM_RMH_SoCCapability \
+    AS(RMH_SOC_CAP_THREAD_SAFE,                     1u << 0)
+typedef enum RMH_SoCCapability { ENUM_RMH_SoCCapability } RMH_SoCCapability;
+
 typedef struct RMH_EventData {
     union {
         struct {
@@ -188,6 +202,9 @@ typedef struct RMH_EventData {
             RMH_LogLevel logLevel;
             const char *logMsg;
         } RMH_EVENT_DRIVER_PRINT;
+        struct {
+            bool enabled;
+        } RMH_EVENT_INTERFACE_STATUS_CHANGED;
     };
 } RMH_EventData;
 typedef void (*RMH_EventCallback)(const enum RMH_Event event, const struct RMH_EventData *eventData, void* userContext);
@@ -207,6 +224,167 @@ typedef struct RMH_NodeMesh_Uint32_t {
     RMH_NodeList_Uint32_t nodeValue[RMH_MAX_MOCA_NODES];
 } RMH_NodeMesh_Uint32_t;
 
+/* Bits of RMH_NetworkSnapshot.selfValid. A field of the snapshot only holds a value if its bit is set */
+#define ENUM_RMH_SelfSnapshotField \
+    AS(RMH_SELF_SNAPSHOT_ENABLED,                   1u << 0) \
+    AS(RMH_SELF_SNAPSHOT_LINK_STATUS,               1u << 1) \
+    AS(RMH_SELF_SNAPSHOT_MAC,                       1u << 2) \
+    AS(RMH_SELF_SNAPSHOT_INTERFACE_ENABLED,         1u << 3) \
+    AS(RMH_SELF_SNAPSHOT_HIGHEST_MOCA_VERSION,      1u << 4) \
+    AS(RMH_SELF_SNAPSHOT_PREFERRED_NC_ENABLED,      1u << 5) \
+    AS(RMH_SELF_SNAPSHOT_LOF,                       1u << 6)
+typedef enum RMH_SelfSnapshotField { ENUM_RMH_SelfSnapshotField } RMH_SelfSnapshotField;
+
+/* Bits of RMH_NetworkSnapshot.networkValid */
+#define ENUM_RMH_NetworkSnapshotField \
+    AS(RMH_NETWORK_SNAPSHOT_NUM_NODES,              1u << 0) \
+    AS(RMH_NETWORK_SNAPSHOT_NODE_ID,                1u << 1) \
+    AS(RMH_NETWORK_SNAPSHOT_NC_NODE_ID,             1u << 2) \
+    AS(RMH_NETWORK_SNAPSHOT_NC_MAC,                 1u << 3) \
+    AS(RMH_NETWORK_SNAPSHOT_BACKUP_NC_NODE_ID,      1u << 4) \
+    AS(RMH_NETWORK_SNAPSHOT_LINK_UPTIME,            1u << 5) \
+    AS(RMH_NETWORK_SNAPSHOT_MOCA_VERSION,           1u << 6) \
+    AS(RMH_NETWORK_SNAPSHOT_MIXED_MODE,             1u << 7) \
+    AS(RMH_NETWORK_SNAPSHOT_RF_CHANNEL_FREQ,        1u << 8) \
+    AS(RMH_NETWORK_SNAPSHOT_TX_TOTAL_PACKETS,       1u << 9) \
+    AS(RMH_NETWORK_SNAPSHOT_RX_TOTAL_PACKETS,       1u << 10) \
+    AS(RMH_NETWORK_SNAPSHOT_TX_TOTAL_ERRORS,        1u << 11) \
+    AS(RMH_NETWORK_SNAPSHOT_RX_TOTAL_ERRORS,        1u << 12) \
+    AS(RMH_NETWORK_SNAPSHOT_TX_DROPPED_PACKETS,     1u << 13) \
+    AS(RMH_NETWORK_SNAPSHOT_RX_DROPPED_PACKETS,     1u << 14) \
+    AS(RMH_NETWORK_SNAPSHOT_REMOTE_NODES,           1u << 15)
+typedef enum RMH_NetworkSnapshotField { ENUM_RMH_NetworkSnapshotField } RMH_NetworkSnapshotField;
+
+/* Bits of RMH_NodeSnapshot.valid */
+#define ENUM_RMH_NodeSnapshotField \
+    AS(RMH_NODE_SNAPSHOT_MAC,                       1u << 0) \
+    AS(RMH_NODE_SNAPSHOT_HIGHEST_MOCA_VERSION,      1u << 1) \
+    AS(RMH_NODE_SNAPSHOT_PREFERRED_NC,              1u << 2) \
+    AS(RMH_NODE_SNAPSHOT_RX_PACKETS,                1u << 3) \
+    AS(RMH_NODE_SNAPSHOT_TX_PACKETS,                1u << 4) \
+    AS(RMH_NODE_SNAPSHOT_TX_UNICAST_PHY_RATE,       1u << 5) \
+    AS(RMH_NODE_SNAPSHOT_TX_POWER_REDUCTION,        1u << 6) \
+    AS(RMH_NODE_SNAPSHOT_TX_UNICAST_POWER,          1u << 7) \
+    AS(RMH_NODE_SNAPSHOT_RX_TOTAL_ERRORS,           1u << 8) \
+    AS(RMH_NODE_SNAPSHOT_RX_UNICAST_POWER,          1u << 9) \
+    AS(RMH_NODE_SNAPSHOT_RX_SNR,                    1u << 10)
+typedef enum RMH_NodeSnapshotField { ENUM_RMH_NodeSnapshotField } RMH_NodeSnapshotField;
+
+typedef struct RMH_NodeSnapshot {
+    uint32_t nodeId;
+    uint32_t valid;                                             /* Bitmask of RMH_NodeSnapshotField */
+    RMH_MacAddress_t mac;
+    bool preferredNC;
+    RMH_MoCAVersion highestSupportedMoCAVersion;
+    uint32_t rxPackets;
+    uint32_t txPackets;
+    uint32_t rxTotalErrors;
+    uint32_t txUnicastPhyRate;                                  /* Mbps */
+    uint32_t txPowerReduction;                                  /* dB */
+    float txUnicastPower;                                       /* dBm */
+    float rxUnicastPower;                                       /* dBm */
+    float rxSNR;                                                /* dB */
+} RMH_NodeSnapshot;
+
+typedef struct RMH_NetworkSnapshot {
+    uint32_t selfValid;                                         /* Bitmask of RMH_SelfSnapshotField */
+    bool selfEnabled;
+    bool interfaceEnabled;
+    bool preferredNCEnabled;
+    RMH_MacAddress_t mac;
+    RMH_LinkStatus linkStatus;
+    RMH_MoCAVersion highestSupportedMoCAVersion;
+    uint32_t lof;                                               /* MHz */
+
+    uint32_t networkValid;                                      /* Bitmask of RMH_NetworkSnapshotField */
+    uint32_t numNodes;                                          /* Nodes in the network, including the self node */
+    uint32_t nodeId;
+    uint32_t ncNodeId;
+    uint32_t backupNCNodeId;
+    RMH_MacAddress_t ncMac;
+    bool mixedMode;
+    RMH_MoCAVersion mocaVersion;
+    uint32_t linkUptime;                                        /* Seconds */
+    uint32_t rfChannelFreq;                                     /* MHz */
+    uint32_t txTotalPackets;
+    uint32_t rxTotalPackets;
+    uint32_t txTotalErrors;
+    uint32_t rxTotalErrors;
+    uint32_t txDroppedPackets;
+    uint32_t rxDroppedPackets;
+
+    uint32_t numRemoteNodes;                                    /* Only the first numRemoteNodes of remoteNodes are filled */
+    RMH_NodeSnapshot remoteNodes[RMH_MAX_MOCA_NODES];
+} RMH_NetworkSnapshot;
+
+/* Counters of RMH_StatsExtended. Each is an index into total[] and rate[] */
+#define ENUM_RMH_StatsCounter \
+    AS(RMH_STATS_TX_TOTAL_BYTES,                    0) \
+    AS(RMH_STATS_RX_TOTAL_BYTES,                    1) \
+    AS(RMH_STATS_TX_TOTAL_PACKETS,                  2) \
+    AS(RMH_STATS_RX_TOTAL_PACKETS,                  3) \
+    AS(RMH_STATS_TX_UNICAST_PACKETS,                4) \
+    AS(RMH_STATS_RX_UNICAST_PACKETS,                5) \
+    AS(RMH_STATS_TX_BROADCAST_PACKETS,              6) \
+    AS(RMH_STATS_RX_BROADCAST_PACKETS,              7) \
+    AS(RMH_STATS_TX_MULTICAST_PACKETS,              8) \
+    AS(RMH_STATS_RX_MULTICAST_PACKETS,              9) \
+    AS(RMH_STATS_TX_DROPPED_PACKETS,                10) \
+    AS(RMH_STATS_RX_DROPPED_PACKETS,                11) \
+    AS(RMH_STATS_TX_TOTAL_ERRORS,                   12) \
+    AS(RMH_STATS_RX_TOTAL_ERRORS,                   13) \
+    AS(RMH_STATS_RX_CRC_ERRORS,                     14)
+typedef enum RMH_StatsCounter { ENUM_RMH_StatsCounter } RMH_StatsCounter;
+#define RMH_STATS_NUM_COUNTERS (RMH_STATS_RX_CRC_ERRORS+1)
+
+typedef struct RMH_StatsExtended {
+    uint64_t timestampMs;                                       /* CLOCK_MONOTONIC time the counters were sampled */
+    uint32_t rateWindowMs;                                      /* Time the rates were measured over. 0 until there are two samples */
+    uint32_t numCounterResets;                                  /* Times the counters were seen to go back to zero */
+    uint32_t valid;                                             /* Bitmask of (1u << RMH_StatsCounter) read in this sample */
+    uint64_t total[RMH_STATS_NUM_COUNTERS];                     /* Monotonic across wraps and resets of the 32 bit counters */
+    double rate[RMH_STATS_NUM_COUNTERS];                        /* Per second. Bits per second for the byte counters */
+
+    bool nodePresent[RMH_MAX_MOCA_NODES];                       /* Remote nodes read in this sample */
+    uint64_t nodeRxPackets[RMH_MAX_MOCA_NODES];
+    uint64_t nodeTxPackets[RMH_MAX_MOCA_NODES];
+    double nodeRxPacketsPerSec[RMH_MAX_MOCA_NODES];
+    double nodeTxPacketsPerSec[RMH_MAX_MOCA_NODES];
+} RMH_StatsExtended;
+
+/* The status a process publishes in shared memory with RMH_Shm_Publish for any other to read with RMH_Shm_Read */
+#define RMH_SHM_DEFAULT_NAME                            "/rmh_status"
+typedef struct RMH_Shm* RMH_ShmHandle;
+
+typedef struct RMH_ShmStatus {
+    uint64_t sequence;                                          /* Times the status was published. Set by RMH_Shm_Publish */
+    uint64_t timestampMs;                                       /* CLOCK_MONOTONIC time it was published. Set by RMH_Shm_Publish */
+    uint32_t publisherPid;                                      /* The process which published it. Set by RMH_Shm_Publish */
+    RMH_Result snapshotResult;                                  /* The result of reading snapshot */
+    RMH_NetworkSnapshot snapshot;                               /* Link status, node table, NC and MoCA version */
+    RMH_Result statsResult;                                     /* The result of reading stats */
+    RMH_StatsExtended stats;                                    /* The latest counters */
+} RMH_ShmStatus;
+
+/* RFC parameters read by RMH. Any other name passed to RMH_RFC_Get is rejected */
+#define RMH_RFC_PREFERRED_NC_ENABLE                     "Device.DeviceInfo.X_RDKCENTRAL-COM_RFC.Feature.PNC.Enable"
+#define RMH_RFC_LOGGING_ENABLE                          "Device.DeviceInfo.X_RDKCENTRAL-COM_RFC.Feature.RMHLogging.Enable"
+
+typedef enum RMH_RFCType {
+    RMH_RFC_TYPE_BOOL,
+    RMH_RFC_TYPE_INT,
+    RMH_RFC_TYPE_STRING
+} RMH_RFCType;
+
+#define RMH_MAX_RFC_VALUE_LEN 256
+typedef struct RMH_RFCValue {
+    RMH_RFCType type;
+    bool boolValue;                                             /* Set if type is RMH_RFC_TYPE_BOOL */
+    int32_t intValue;                                           /* Set if type is RMH_RFC_TYPE_INT */
+    char stringValue[RMH_MAX_RFC_VALUE_LEN];                    /* The value as read from RFC, whatever the type */
+    uint32_t ageMs;                                             /* Time since the value was read from RFC */
+} RMH_RFCValue;
+
 typedef enum RMH_APIParamDirection {
     RMH_INPUT_PARAM,
     RMH_OUTPUT_PARAM,
@@ -219,6 +397,62 @@ typedef struct RMHGeneric_Param {
     const char *desc;
 } RMHGeneric_Param;
 
+/**********************************************************************************************************************
+RMH_APITag groups APIs by what they do. Every API in rmh_api.h lists its tags with RMH_TAGS() using the name following
+'RMH_API_TAG__', so a new tag only needs to be added here and given a display name in librmh_wrap.h. Tags are in the
+order of their display names so lists of them don't need sorting. RMH_API_TAG_MASK() is the bit of a tag in
+RMH_API.tagMask.
+**********************************************************************************************************************/
+#define ENUM_RMH_APITag \
+    AS(RMH_API_TAG__ACA,                            0) \
+    AS(RMH_API_TAG__Bonding,                        1) \
+    AS(RMH_API_TAG__ConfigurationGet,               2) \
+    AS(RMH_API_TAG__ConfigurationSet,               3) \
+    AS(RMH_API_TAG__Core,                           4) \
+    AS(RMH_API_TAG__Frequency,                      5) \
+    AS(RMH_API_TAG__Interface,                      6) \
+    AS(RMH_API_TAG__Link,                           7) \
+    AS(RMH_API_TAG__Log,                            8) \
+    AS(RMH_API_TAG__Mac,                            9) \
+    AS(RMH_API_TAG__NC,                             10) \
+    AS(RMH_API_TAG__Network,                        11) \
+    AS(RMH_API_TAG__Phy,                            12) \
+    AS(RMH_API_TAG__Power,                          13) \
+    AS(RMH_API_TAG__PQoS,                           14) \
+    AS(RMH_API_TAG__Privacy,                        15) \
+    AS(RMH_API_TAG__QAM,                            16) \
+    AS(RMH_API_TAG__RemoteNode,                     17) \
+    AS(RMH_API_TAG__Self,                           18) \
+    AS(RMH_API_TAG__Stats,                          19) \
+    AS(RMH_API_TAG__Status,                         20) \
+    AS(RMH_API_TAG__Taboo,                          21) \
+    AS(RMH_API_TAG__Turbo,                          22) \
+    AS(RMH_API_TAG__Version,                        23)
+typedef enum RMH_APITag { ENUM_RMH_APITag } RMH_APITag;
+#define RMH_NUM_API_TAGS (RMH_API_TAG__Version+1)
+#define RMH_API_TAG_MASK(TAG) (1u << (TAG))
+
+/**********************************************************************************************************************
+RMH_APIId is a unique ID for every API in rmh_api.h. IDs follow the order of rmh_api.h and are generated directly from
+it so adding an API there is all that's needed. The ID for an API is its name prefixed with 'RMH_API_ID__'. For example
+RMH_API_ID__RMH_Self_GetEnabled. RMH_NUM_APIS is the total number of APIs.
+**********************************************************************************************************************/
+#define RMH_API_IMPLEMENTATION_SOC_ONLY(DECLARATION, API_NAME, ...)            RMH_API_ID__##API_NAME,
+#define RMH_API_IMPLEMENTATION_GENERIC_ONLY(DECLARATION, API_NAME, ...)         RMH_API_ID__##API_NAME,
+#define RMH_API_IMPLEMENTATION_SOC_THEN_GENERIC(DECLARATION, API_NAME, ...)     RMH_API_ID__##API_NAME,
+#define RMH_API_IMPLEMENTATION_GENERIC_THEN_SOC(DECLARATION, API_NAME, ...)     RMH_API_ID__##API_NAME,
+#define RMH_API_IMPLEMENTATION_NO_WRAP(DECLARATION, API_NAME, ...)              RMH_API_ID__##API_NAME,
+typedef enum RMH_APIId {
+#include "rmh_api.h"
+    RMH_NUM_APIS
+} RMH_APIId;
+#undef RMH_API_H
+#undef RMH_API_IMPLEMENTATION_SOC_ONLY
+#undef RMH_API_IMPLEMENTATION_GENERIC_ONLY
+#undef RMH_API_IMPLEMENTATION_SOC_THEN_GENERIC
+#undef RMH_API_IMPLEMENTATION_GENERIC_THEN_SOC
+#undef RMH_API_IMPLEMENTATION_NO_WRAP
+
 typedef struct RMH_API {
     const char *apiName;
     const bool socApiExpected;
@@ -229,17 +463,65 @@ typedef struct RMH_API {
     const char *tags;
     const uint32_t apiNumParams;
     const RMHGeneric_Param* apiParams;
+    const RMH_APIId apiId;
+    const uint32_t tagMask;                                     /* RMH_API_TAG_MASK() of every tag of the API */
 } RMH_API;
 
+#define RMH_INSTRUMENTATION_NUM_BUCKETS 32
+typedef struct RMH_APIStats {
+    RMH_APIId apiId;
+    uint64_t numCalls;                                          /* Total number of times the API was called */
+    uint64_t numResults[RMH_NUM_RESULTS];                       /* Number of calls which returned each RMH_Result */
+    uint64_t numUntimedCalls;                                   /* Calls nested too deep to be timed. Not included in any of the times */
+    uint64_t totalTimeUs;                                       /* Sum of the time spent in all calls */
+    uint64_t totalSelfTimeUs;                                   /* Sum of the time spent in all calls excluding time spent in other RMH APIs they called */
+    uint64_t minTimeUs;                                         /* Fastest call */
+    uint64_t maxTimeUs;                                         /* Slowest call */
+    uint64_t p50TimeUs;                                         /* Upper bound of the histogram bucket holding the median call */
+    uint64_t p99TimeUs;                                         /* Upper bound of the histogram bucket holding the 99th percentile call */
+    uint64_t histogram[RMH_INSTRUMENTATION_NUM_BUCKETS];        /* Bucket 0 counts calls under 1us. Bucket N counts calls from 2^(N-1)us to 2^N us */
+} RMH_APIStats;
+
+typedef struct RMH_TraceRecord {
+    uint64_t timestampNs;                                       /* CLOCK_MONOTONIC time when the API was called */
+    uint64_t durationNs;                                        /* Time spent in the API */
+    uint32_t threadId;                                          /* Kernel thread ID of the caller */
+    uint32_t depth;                                             /* 1 for a direct call, 2 for an API called by that API and so on */
+    RMH_APIId apiId;
+    RMH_Result result;
+} RMH_TraceRecord;
+
+typedef struct RMH_CacheStats {
+    RMH_APIId apiId;
+    uint64_t numHits;                                           /* Calls answered from the cache */
+    uint64_t numMisses;                                         /* Calls which had to go to the SoC */
+    uint64_t numInvalidations;                                  /* Cached values dropped because of an event, a flush or their TTL */
+} RMH_CacheStats;
+
+typedef struct RMH_BatchOp {
+    RMH_APIId apiId;
+    uint32_t nodeId;                                            /* Input of APIs which take a node ID. Ignored by others */
+    void *response;                                             /* Where the API writes its output */
+    size_t responseSize;                                        /* Size of response for APIs returning a string. Ignored by others */
+    RMH_Result *result;                                         /* Where the result of the op is written */
+} RMH_BatchOp;
+
 typedef struct RMH_APIList {
     char apiListName[32];
     uint32_t apiListSize;
     RMH_API *apiList[RMH_MAX_NUM_APIS];
 } RMH_APIList;
 
+typedef struct RMH_APITagInfo {
+    RMH_APITag tagId;
+    const char *tagName;
+    uint32_t apiListSize;
+    RMH_API * const *apiList;                                   /* The APIs with this tag, sorted by name */
+} RMH_APITagInfo;
+
 typedef struct RMH_APITagList {
-    uint32_t tagListSize;
-    RMH_APIList tagList[RMH_MAX_NUM_TAGS];
+    uint32_t tagListSize;                                       /* Always RMH_NUM_API_TAGS */
+    RMH_APITagInfo tagList[RMH_NUM_API_TAGS];                   /* Indexed by RMH_APITag */
 } RMH_APITagList;
 
 #ifdef __cplusplus
@@ -32,3 +32,11 @@
 /* Reinclude API header to use the redefined macros to setup necessary functions and structs */
 #undef RMH_API_H
 #include "rmh_api.h"
+
+/* The session calls these in the SoC itself rather than through an API wrapper so they aren't declared above */
+RMH_Result SoC_IMPL__RMH_Destroy(RMH_Handle handle);
+RMH_Result SoC_IMPL__RMH_SetEventCallbacks(RMH_Handle handle, const uint32_t value);
+
+/* Optional native implementations of generic APIs. The generic implementation is used when the SoC doesn't export them */
+RMH_Result SoC_IMPL__RMH_Network_GetSnapshot(const RMH_Handle handle, RMH_NetworkSnapshot* response);
+RMH_Result SoC_IMPL__RMH_ExecuteBatch(const RMH_Handle handle, const RMH_BatchOp* ops, const size_t numOps);
@@ -27,6 +27,7 @@
 #include <time.h>
 #include <string.h>
 #include <dlfcn.h>
+#include <pthread.h>
 #include "rmh_type.h"
 
 void RMH_Print(const RMH_Handle handle, const RMH_LogLevel level, const char *filename, const uint32_t lineNumber, const char *format, ...);
@@ -34,7 +35,7 @@ void RMH_Print(const RMH_Handle handle, const RMH_LogLevel level, const char *fi
 #define RMH_PrintWrn(fmt, ...)      if (!handle || (handle->logLevelBitMask & RMH_LOG_WARNING) == RMH_LOG_WARNING)  { RMH_Print(handle, RMH_LOG_WARNING, __FUNCTION__, __LINE__, "WARNING: " fmt, ##__VA_ARGS__); }
 #define RMH_PrintMsg(fmt, ...)      if (!handle || (handle->logLevelBitMask & RMH_LOG_MESSAGE) == RMH_LOG_MESSAGE)  { RMH_Print(handle, RMH_LOG_MESSAGE, __FUNCTION__, __LINE__, fmt, ##__VA_ARGS__); }
 #define RMH_PrintDbg(fmt, ...)      if (!handle || (handle->logLevelBitMask & RMH_LOG_DEBUG) == RMH_LOG_DEBUG)      { RMH_Print(handle, RMH_LOG_DEBUG, __FUNCTION__, __LINE__, fmt, ##__VA_ARGS__); }
-#define RMH_PrintTrace(fmt, ...)    if ((handle->logLevelBitMask & RMH_LOG_TRACE) == RMH_LOG_TRACE)                 { RMH_Print(handle, RMH_LOG_TRACE, __FUNCTION__, __LINE__, "[0x%p|0x%p]%.*s" fmt, handle, handle->handle, handle->apiDepth, "\t\t\t\t\t\t\t\t\t", ##__VA_ARGS__); }
+#define RMH_PrintTrace(fmt, ...)    if ((handle->logLevelBitMask & RMH_LOG_TRACE) == RMH_LOG_TRACE)                 { RMH_Print(handle, RMH_LOG_TRACE, __FUNCTION__, __LINE__, "[0x%p|0x%p]%.*s" fmt, handle, handle->handle, pRMH_CallState(handle)->apiDepth, "\t\t\t\t\t\t\t\t\t", ##__VA_ARGS__); }
 
 #define BRMH_RETURN_IF(expr, ret) { if (expr) { RMH_PrintErr("'" #expr "' is true!\n"); return ret; } }
 #define BRMH_RETURN_IF_FAILED(cmd) { \
@@ -51,20 +52,155 @@ void RMH_Print(const RMH_Handle handle, const RMH_LogLevel level, const char *fi
 #define RMH_MAX_PRINT_LINE_SIZE 2048
 
 extern RMH_APIList hRMHGeneric_APIList;
-extern RMH_APIList hRMHGeneric_SoCUnimplementedAPIList;
 extern RMH_APITagList hRMHGeneric_APITags;
+extern const RMH_API hRMHGeneric_APITable[RMH_NUM_APIS];
+extern bool hRMHGeneric_TraceEnabled;
 
-typedef struct RMH {
-    RMH_Handle handle;
-    void* soclib;
+typedef RMH_Result (*RMH_SoCAPI)();
+
+#define RMH_MAX_API_DEPTH 16
+typedef struct RMH_APITimingFrame {
+    struct timespec startTime;
+    uint64_t childTimeNs;                   /* Time spent in wrapped APIs called by this API */
+} RMH_APITimingFrame;
+
+/* State of the API call in progress. Kept in the handle unless it was created with RMH_INIT_FLAG_THREAD_SAFE */
+typedef struct RMH_CallState {
+    uint32_t apiDepth;
+    RMH_APITimingFrame apiTiming[RMH_MAX_API_DEPTH];
     FILE *localLogToFile;
-    struct timeval startTime;
+    char printBuf[RMH_MAX_PRINT_LINE_SIZE];
+} RMH_CallState;
+
+typedef enum RMH_LinkTracking {
+    RMH_LINK_TRACKING_OFF,
+    RMH_LINK_TRACKING_STARTING,             /* Asking the SoC for the events. Nothing read now may be kept */
+    RMH_LINK_TRACKING_ON,
+    RMH_LINK_TRACKING_UNAVAILABLE           /* The SoC can't send the events so the link status is read every time */
+} RMH_LinkTracking;
+
+/* What the SoC last said about the link, kept up to date by its events. The interface part comes from the netlink tracker */
+typedef struct RMH_LinkState {
+    pthread_mutex_t lock;
+    RMH_LinkTracking tracking;
+    bool valid;
+    uint64_t generation;                    /* Incremented on every change so a read from the SoC can't overwrite a newer state */
+    bool selfEnabled;
+    bool linkUp;
+} RMH_LinkState;
+
+#define RMH_LINK_STATUS_EVENTS (RMH_EVENT_LINK_STATUS_CHANGED | RMH_EVENT_MOCA_RESET)
+
+/* A SoC library and the SoC handle created from it. Handles share one unless created with RMH_INIT_FLAG_PRIVATE_SESSION */
+typedef struct RMH_Session {
+    uint32_t refCount;                      /* Protected by the shared session lock. Only used for the shared session */
+    bool shared;
+    void* soclib;
+    RMH_Handle socHandle;
+    RMH_Result (*socDestroy)(RMH_Handle);
+    RMH_Result (*socSetEventCallbacks)(RMH_Handle, const uint32_t);
+    bool socLockRequired;                   /* Shared or thread safe, so calls into the SoC may come from many threads, and the SoC isn't thread safe */
+    pthread_mutex_t socLock;                /* Recursive so an event callback raised inside a SoC call can call the SoC */
+    pthread_mutex_t eventLock;              /* Serializes updates of the events the SoC is asked to send */
+    pthread_rwlock_t handlesLock;           /* Protects the list of handles events are delivered to */
+    struct RMH *handles;
+    uint32_t numHandles;                    /* Protected by handlesLock */
+    pthread_mutex_t deliveryLock;           /* Protects numDeliveries */
+    pthread_cond_t deliveryDone;            /* Signaled when numDeliveries drops to 0 */
+    uint32_t numDeliveries;                 /* Events being passed to the callbacks of the handles */
+    RMH_SoCAPI socAPI[RMH_NUM_APIS];        /* SoC APIs resolved when the library was opened. NULL if not implemented */
+    RMH_APIList unimplementedAPIs;          /* SoC APIs expected but not found in 'socAPI'. Built once when the session is opened */
+    struct RMH_Netlink *netlink;            /* Tracks the state of the MoCA interface. Started on first use */
+    uint64_t netlinkRetryMs;                /* Starting it failed. The kernel is asked instead until this CLOCK_MONOTONIC time */
+    RMH_LinkState linkState;                /* Answers RMH_Self_GetLinkStatus without calling into the SoC */
+} RMH_Session;
+
+typedef struct RMH {
+    RMH_Handle handle;                      /* The SoC handle of the session */
+    RMH_Session *session;
+    struct RMH *nextInSession;
     RMH_EventCallback eventCB;
-    char* printBuf;
     RMH_LogLevel logLevelBitMask;
     RMH_Event eventNotifyBitMask;
     void* eventCBUserContext;
-    uint32_t apiDepth;
+    uint32_t flags;                         /* RMH_InitFlag passed to RMH_InitializeEx */
+    RMH_CallState callState;                /* Use pRMH_CallState() rather than accessing this directly */
+    bool cacheEnabled;
+    struct RMH_Cache *cache;                /* Allocated the first time the cache is enabled */
+    struct RMH_StatsAccumulator *stats;     /* Allocated the first time RMH_Stats_GetExtended or RMH_Stats_SetRateWindow is called */
+    const RMH_SoCAPI *socAPI;               /* The SoC API table of the session */
 } RMH;
 
+extern __thread RMH_CallState hRMHGeneric_ThreadCallState;
+
+/* Thread safe handles keep call state per thread. A thread only has one stack of calls no matter the handle */
+static inline
+RMH_CallState* pRMH_CallState(const RMH_Handle handle) {
+    return (handle->flags & RMH_INIT_FLAG_THREAD_SAFE) ? &hRMHGeneric_ThreadCallState : &handle->callState;
+}
+
+/* SoC calls are serialized for a session shared between handles, whose handles may be used from different threads, or
+   used by a thread safe handle. A private session of a handle which isn't thread safe, or a SoC library which declared
+   RMH_SOC_CAP_THREAD_SAFE, doesn't need it */
+static inline
+void pRMH_APIWRAP_LockSoC(const RMH_Handle handle) {
+    if (handle->session->socLockRequired) {
+        pthread_mutex_lock(&handle->session->socLock);
+    }
+}
+
+static inline
+void pRMH_APIWRAP_UnlockSoC(const RMH_Handle handle) {
+    if (handle->session->socLockRequired) {
+        pthread_mutex_unlock(&handle->session->socLock);
+    }
+}
+
+/* How the inputs and output of a cached or batched getter are passed after the handle */
+typedef enum RMH_CacheShape {
+    RMH_CACHE_SHAPE_STRING,                 /* char* responseBuf, const size_t responseBufSize */
+    RMH_CACHE_SHAPE_VALUE,                  /* TYPE* response */
+    RMH_CACHE_SHAPE_NODE_VALUE              /* const uint32_t nodeId, TYPE* response */
+} RMH_CacheShape;
+
+typedef struct RMH_CachePolicy {
+    bool cached;
+    uint8_t index;                          /* Slot of the API in the cache of a handle */
+    uint8_t shape;                          /* RMH_CacheShape */
+    uint8_t valueSize;                      /* Size of the output unless it's a string */
+    uint32_t ttlMs;                         /* How long a value may be used. 0 to keep it until an event makes it stale */
+    uint32_t invalidateEvents;              /* Bitmask of RMH_Event which make values of this API stale */
+} RMH_CachePolicy;
+
+extern const RMH_CachePolicy hRMHGeneric_CachePolicy[RMH_NUM_APIS];
+extern const uint32_t hRMHGeneric_CacheEvents;
+
+static inline
+bool pRMH_Cache_Enabled(const RMH_Handle handle, const RMH_APIId apiId) {
+    return __atomic_load_n(&handle->cacheEnabled, __ATOMIC_ACQUIRE) && hRMHGeneric_CachePolicy[apiId].cached;
+}
+
+void pRMH_APIWRAP_LoadSoCAPIs(const RMH_Handle handle, RMH_Session *session);
+void pRMH_APIWRAP_ListUnimplementedAPIs(RMH_Session *session);
+bool pRMH_APIWRAP_SoCAPIExpected(const RMH_APIId apiId);
+RMH_Session* pRMH_Session_Acquire(const RMH_Handle handle);
+void pRMH_Session_Release(const RMH_Handle handle);
+RMH_Result pRMH_Session_UpdateEventCallbacks(const RMH_Handle handle);
+void pRMH_Session_DeliverEvent(RMH_Session *session, const RMH_Event event, const RMH_EventData *eventData);
+RMH_Result pRMH_Netlink_Start(const RMH_Handle handle);
+bool pRMH_Netlink_GetEnabled(const RMH_Handle handle, bool *enabled);
+void pRMH_Netlink_Stop(RMH_Session *session);
+void pRMH_LinkStatus_HandleEvent(RMH_Session *session, const RMH_Event event, const RMH_EventData *eventData);
+bool pRMH_Cache_Get(const RMH_APIId apiId, uint64_t *generation, const RMH_Handle handle, ...);
+void pRMH_Cache_Put(const RMH_APIId apiId, const uint64_t generation, const RMH_Handle handle, ...);
+void pRMH_Cache_HandleEvent(const RMH_Handle handle, const RMH_Event event, const RMH_EventData *eventData);
+void pRMH_Cache_Destroy(const RMH_Handle handle);
+void pRMH_Stats_Destroy(const RMH_Handle handle);
+RMH_Result pRMH_RFC_GetBool(const RMH_Handle handle, const char *name, bool *value);
+RMH_APIList* pRMH_APIWRAP_GetAPIList();
+RMH_APITagList* pRMH_APIWRAP_GetAPITags();
+void pRMH_Instrumentation_Record(const RMH_APIId apiId, const RMH_Result result, const bool timed, const uint64_t timeUs, const uint64_t selfTimeUs);
+void pRMH_Trace_InitializeOnce();
+void pRMH_Trace_Record(const RMH_APIId apiId, const uint32_t depth, const struct timespec *startTime, const uint64_t durationNs, const RMH_Result result);
+
 #endif /* LIB_RMH_H */
@@ -21,50 +21,74 @@
 #include "rdk_moca_hal.h"
 
 RMH_Handle RMH_Initialize(const RMH_EventCallback eventCB, void* userContext) {
-    RMH* handle;
+    return RMH_InitializeEx(eventCB, userContext, 0);
+}
+
+RMH_Handle RMH_InitializeEx(const RMH_EventCallback eventCB, void* userContext, const uint32_t flags) {
+    RMH* handle=NULL;
 
+    BRMH_RETURN_IF((flags & ~(RMH_INIT_FLAG_THREAD_SAFE | RMH_INIT_FLAG_PRIVATE_SESSION)) != 0, NULL);
     handle=malloc(sizeof(*handle));
     BRMH_RETURN_IF(handle==NULL, NULL);
     memset(handle, 0, sizeof(*handle));
-    handle->printBuf=malloc(RMH_MAX_PRINT_LINE_SIZE);
     handle->logLevelBitMask=RMH_LOG_ERROR;
-    if (!handle->printBuf) {
-        RMH_PrintErr("Unable to allocate print buf of size %u!\n", RMH_MAX_PRINT_LINE_SIZE);
-        goto error_out;
-    }
     handle->eventCB=eventCB;
     handle->eventCBUserContext=userContext;
-    handle->soclib = dlopen("librdkmocahalsoc.so.0", RTLD_LAZY);
-    if (handle->soclib) {
-        char *dlErr = dlerror(); /* Check error first to clear it out */
-        RMH_Handle (*apiFunc)() = dlsym(handle->soclib, "RMH_Initialize");
-        dlErr = dlerror();
-        if (dlErr) {
-            RMH_PrintTrace("Error 'RMH_Initialize' in dlopen: '%s'. APIs will return RMH_INVALID_INTERNAL_STATE!\n", dlErr);
+    handle->flags=flags;
+    pRMH_Trace_InitializeOnce();
+    if (!pRMH_Session_Acquire(handle)) {
+        free(handle);
+        return NULL;
+    }
+    RMH_PrintTrace("Initialized generic handle:0x%p socHandle:0x%p\n", handle, handle->handle);
+    return (RMH_Handle)handle;
+}
+
+RMH_Result RMH_Destroy(RMH_Handle handle) {
+    BRMH_RETURN_IF(handle==NULL, RMH_INVALID_PARAM);
+    RMH_PrintTrace("Destroying generic handle:0x%p socHandle:0x%p\n", handle, handle->handle);
+    pRMH_Session_Release(handle);
+    pRMH_Cache_Destroy(handle);
+    pRMH_Stats_Destroy(handle);
+    free(handle);
+    return RMH_SUCCESS;
+}
+
+RMH_Result RMH_GetAPIById(const RMH_Handle handle, const RMH_APIId apiId, const RMH_API** api) {
+    BRMH_RETURN_IF(api==NULL, RMH_INVALID_PARAM);
+    BRMH_RETURN_IF(apiId>=RMH_NUM_APIS, RMH_INVALID_ID);
+    *api=&hRMHGeneric_APITable[apiId];
+    return RMH_SUCCESS;
+}
+
+RMH_Result RMH_GetAPIByName(const RMH_Handle handle, const char* apiName, const RMH_API** api) {
+    const RMH_APIList* allAPIs;
+    uint32_t first=0;
+    uint32_t last;
+
+    BRMH_RETURN_IF(api==NULL, RMH_INVALID_PARAM);
+    BRMH_RETURN_IF(apiName==NULL, RMH_INVALID_PARAM);
+
+    /* The list of all APIs is sorted by name so we can do a binary search */
+    allAPIs=pRMH_APIWRAP_GetAPIList();
+    last=allAPIs->apiListSize;
+    while (first < last) {
+        uint32_t middle=first + (last-first)/2;
+        int cmp=strcasecmp(apiName, allAPIs->apiList[middle]->apiName);
+        if (cmp == 0) {
+            *api=allAPIs->apiList[middle];
+            return RMH_SUCCESS;
         }
-        else if (!apiFunc) {
-            RMH_PrintErr("Unable to find 'RMH_Initialize' in SoC library! APIs will return RMH_INVALID_INTERNAL_STATE!\n");
+        else if (cmp < 0) {
+            last=middle;
         }
         else {
-            handle->handle = apiFunc(eventCB, userContext);
-            if (!handle->handle) {
-                RMH_PrintErr("Failed when initializing the SoC MoCA Hal!\n");
-                goto error_out;
-            }
+            first=middle+1;
         }
     }
-    else {
-        RMH_PrintWrn("Failed to open the SoC library 'librdkmocahalsoc.so.0', all MoCA APIs will return RMH_UNIMPLEMENTED!  Please ensure it's properly installed on this system\n");
-    }
-    RMH_PrintTrace("Initialized generic handle:0x%p socHandle:0x%p\n", handle, handle->handle);
-    return (RMH_Handle)handle;
-
-error_out:
-    RMH_Destroy(handle);
-    return NULL;
+    return RMH_FAILURE;
 }
 
-
 #undef AS
 #define AS(x,y) #x,
 __attribute__((visibility("hidden"))) const char * const RMH_ResultStr[] = { ENUM_RMH_Result };
@@ -80,6 +104,7 @@ __attribute__((visibility("hidden"))) const char * const RMH_ACAStatusStr[] = {
 __attribute__((visibility("hidden"))) const char * const RMH_MoCAResetReasonStr[] = { ENUM_RMH_MoCAResetReason };
 __attribute__((visibility("hidden"))) const char * const RMH_SubcarrierProfileStr[] = { ENUM_RMH_SubcarrierProfile };
 __attribute__((visibility("hidden"))) const char * const RMH_PERModeStr[] = { ENUM_RMH_PERMode };
+__attribute__((visibility("hidden"))) const char * const RMH_StatsCounterStr[] = { ENUM_RMH_StatsCounter };
 
 const char* const RMH_ResultToString(const RMH_Result value) {
     return RMH_ResultStr[value];
@@ -117,6 +142,10 @@ const char* const RMH_PERModeToString(const RMH_PERMode value) {
     return RMH_PERModeStr[value];
 }
 
+const char* const RMH_StatsCounterToString(const RMH_StatsCounter value) {
+    return RMH_StatsCounterStr[value];
+}
+
 
 
 const char* const RMH_MoCAVersionToString(const RMH_MoCAVersion value) {
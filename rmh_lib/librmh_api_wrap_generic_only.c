@@ -24,12 +24,10 @@
 #include <string.h>
 #include "librmh.h"
 #include "rdk_moca_hal.h"
-#include "rfcapi.h"
 
 #define RDK_FILE_PATH_VERSION                   "/version.txt"
 #define RDK_FILE_PATH_DEBUG_ENABLE              "/opt/rmh_start_enable_debug"
 #define RDK_FILE_PATH_DEBUG_FOREVER_ENABLE      "/opt/rmh_start_enable_debug_forever"
-#define RDK_RFC_FILE                            "/etc/rfc.properties"
 
 #define LOCAL_MODULATION_PRINT_LINE_SIZE 256
 
@@ -46,7 +44,7 @@ RMH_Result pRMH_IOCTL_Get(const RMH_Handle handle, const char* name, struct ifre
     rc = ioctl(fd, SIOCGIFFLAGS, ifrq);
     if (rc < 0)	{
         RMH_PrintErr("ioctl SIOCGIFFLAGS returned %d!", rc);
-        return RMH_FAILURE;
+        ret=RMH_FAILURE;
     }
 
     close(fd);
@@ -62,74 +60,13 @@ RMH_Result pRMH_IOCTL_Set(const RMH_Handle handle, struct ifreq *ifrq) {
     rc = ioctl(fd, SIOCSIFFLAGS, ifrq);
     if (rc < 0)	{
         RMH_PrintErr("ioctl SIOCSIFFLAGS returned %d!", rc);
-        return RMH_FAILURE;
+        ret=RMH_FAILURE;
     }
 
     close(fd);
     return ret;
 }
 
-static
-RMH_Result pRMH_FindTagList(const RMH_Handle handle, const char * tag, RMH_APIList **apiList) {
-    int i;
-
-    /*Skip whitespace */
-    while( tag[0] != '\0' && tag[0] == ' ' ) tag++;
-
-    if (strlen(tag) > 0) {
-        for(i=0; i != hRMHGeneric_APITags.tagListSize; i++) {
-            if (strcasecmp(tag, hRMHGeneric_APITags.tagList[i].apiListName) == 0) {
-                *apiList=&hRMHGeneric_APITags.tagList[i];
-                return RMH_SUCCESS;
-            }
-        }
-        if (hRMHGeneric_APITags.tagListSize < RMH_MAX_NUM_TAGS) {
-            *apiList=&hRMHGeneric_APITags.tagList[hRMHGeneric_APITags.tagListSize++];
-            (*apiList)->apiListSize=0;
-            strncpy((*apiList)->apiListName, tag, sizeof((*apiList)->apiListName));
-            (*apiList)->apiListName[0]=toupper((*apiList)->apiListName[0]);
-            RMH_PrintDbg("New tag '%s' add. Total tags:%d\n", (*apiList)->apiListName, hRMHGeneric_APITags.tagListSize);
-            return RMH_SUCCESS;
-        }
-        RMH_PrintWrn("Unable to find an existing tag '%s' and no more new tags are available. This will be dropped.\n", tag);
-    }
-    return RMH_FAILURE;
-}
-
-static
-int pRMH_TagCompare(const void* a, const void* b) {
-    const RMH_APIList _a=* (RMH_APIList const *)a;
-    const RMH_APIList _b=* (RMH_APIList const *)b;
-    return strcasecmp(_a.apiListName, _b.apiListName);
-}
-
-RMH_Result pRMH_RFC_GetBool(const RMH_Handle handle, const char*name, bool *value) {
-    RFC_ParamData_t rfcParam;
-    WDMP_STATUS wdmpStatus;
-
-    wdmpStatus = getRFCParameter("RMH", name, &rfcParam);
-    if (wdmpStatus != WDMP_SUCCESS) {
-        if (wdmpStatus != WDMP_ERR_VALUE_IS_EMPTY) {
-            RMH_PrintErr("Failed reading from RFC -- %s -- Returned error '%s' (%u)\n", rfcParam.name, getRFCErrorString(wdmpStatus), wdmpStatus);
-        }
-        return RMH_FAILURE;
-    }
-
-    /* There are cases where RFC type might not be set correctly. To be sure of our value We'll explictly test both values. */
-    if (0 == strcasecmp(rfcParam.value, "TRUE")) {
-        *value=true;
-    }
-    else if (0 == strcasecmp(rfcParam.value, "FALSE")) {
-        *value=false;
-    }
-    else {
-        RMH_PrintErr("Unexpected value reading from RFC -- %s -- Returned '%s' which is type %u. Expecting type WDMP_BOOLEAN(%u)\n", rfcParam.name, rfcParam.value, getRFCErrorString(wdmpStatus), rfcParam.type, WDMP_BOOLEAN);
-        return RMH_FAILURE;
-    }
-
-    return RMH_SUCCESS;
-}
-
 RMH_Result GENERIC_IMPL__RMH_Self_RestoreRDKDefaultSettings(const RMH_Handle handle) {
     bool started;
     bool rfcBool;
@@ -191,7 +128,7 @@ RMH_Result GENERIC_IMPL__RMH_Self_RestoreRDKDefaultSettings(const RMH_Handle han
     BRMH_RETURN_IF_FAILED(RMH_Self_SetTabooChannels(handle, RMH_START_DEFAULT_TABOO_START_CHANNEL, RMH_START_DEFAULT_TABOO_MASK));
 #endif
 
-    if (RMH_SUCCESS == pRMH_RFC_GetBool(handle, "Device.DeviceInfo.X_RDKCENTRAL-COM_RFC.Feature.PNC.Enable", &rfcBool)) {
+    if (RMH_SUCCESS == pRMH_RFC_GetBool(handle, RMH_RFC_PREFERRED_NC_ENABLE, &rfcBool)) {
         /* RFC has an override for this value */
         RMH_PrintMsg("[**RFC OVERRIDE**] Setting RMH_Self_SetPreferredNCEnabled: %s\n", rfcBool ? "TRUE" : "FALSE");
         BRMH_RETURN_IF_FAILED(RMH_Self_SetPreferredNCEnabled(handle, rfcBool));
@@ -353,6 +290,10 @@ RMH_Result GENERIC_IMPL__RMH_Interface_GetEnabled(const RMH_Handle handle, bool
 
     BRMH_RETURN_IF(handle==NULL, RMH_INVALID_PARAM);
     BRMH_RETURN_IF(response==NULL, RMH_INVALID_PARAM);
+    /* Kept up to date by RTNETLINK. Only ask the kernel if that's not available */
+    if (pRMH_Netlink_GetEnabled(handle, response)) {
+        return RMH_SUCCESS;
+    }
     BRMH_RETURN_IF_FAILED(RMH_Interface_GetName(handle, ethName, sizeof(ethName)));
     BRMH_RETURN_IF(pRMH_IOCTL_Get(handle, ethName, &ifrq) != RMH_SUCCESS, RMH_FAILURE);
     if ((ifrq.ifr_flags & IFF_UP) &&
@@ -380,40 +321,12 @@ RMH_Result GENERIC_IMPL__RMH_Interface_SetEnabled(const RMH_Handle handle, const
 
     BRMH_RETURN_IF(pRMH_IOCTL_Set(handle, &ifrq) != RMH_SUCCESS, RMH_FAILURE);
 
-    RMH_Interface_GetEnabled(handle, &selectedValue);
+    /* Ask the kernel as RTNETLINK may not have told us about the change yet */
+    BRMH_RETURN_IF(pRMH_IOCTL_Get(handle, ethName, &ifrq) != RMH_SUCCESS, RMH_FAILURE);
+    selectedValue=(ifrq.ifr_flags & IFF_UP) && (ifrq.ifr_flags & IFF_RUNNING);
     return (selectedValue==value) ? RMH_SUCCESS : RMH_FAILURE;
 }
 
-RMH_Result GENERIC_IMPL__RMH_Self_GetLinkStatus(const RMH_Handle handle, RMH_LinkStatus* response) {
-    bool linkUp;
-    bool selfEnabled;
-    bool ifEnabled;
-
-    BRMH_RETURN_IF(handle==NULL, RMH_INVALID_PARAM);
-    BRMH_RETURN_IF(response==NULL, RMH_INVALID_PARAM);
-
-    BRMH_RETURN_IF_FAILED(RMH_Self_GetEnabled(handle, &selfEnabled));
-    if (!selfEnabled) {
-        *response=RMH_LINK_STATUS_DISABLED;
-        return RMH_SUCCESS;
-    }
-
-    BRMH_RETURN_IF_FAILED(RMH_Self_GetMoCALinkUp(handle, &linkUp));
-    if (!linkUp) {
-        *response=RMH_LINK_STATUS_NO_LINK;
-        return RMH_SUCCESS;
-    }
-
-    BRMH_RETURN_IF_FAILED(RMH_Interface_GetEnabled(handle, &ifEnabled));
-    if (!ifEnabled) {
-        *response=RMH_LINK_STATUS_INTERFACE_DOWN;
-        return RMH_SUCCESS;
-    }
-
-    *response=RMH_LINK_STATUS_UP;
-    return RMH_SUCCESS;
-}
-
 static inline
 uint32_t PrintModulationToString(char *outBuf, uint32_t outBufSize, const bool firstPrint, const RMH_SubcarrierProfile* array, const size_t arraySize, const uint32_t end, int32_t *start, bool *done) {
     int32_t j;
@@ -639,8 +552,8 @@ RMH_Result GENERIC_IMPL__RMH_Log_PrintStatus(const RMH_Handle handle, const char
     int i;
 
     if (filename) {
-        handle->localLogToFile=fopen(filename, "a");
-        if (handle->localLogToFile == NULL) {
+        pRMH_CallState(handle)->localLogToFile=fopen(filename, "a");
+        if (pRMH_CallState(handle)->localLogToFile == NULL) {
             RMH_PrintErr("Failed to open '%s' for writing!\n", filename);
             return RMH_FAILURE;
         }
@@ -729,9 +642,9 @@ RMH_Result GENERIC_IMPL__RMH_Log_PrintStatus(const RMH_Handle handle, const char
         RMH_PrintMsg("*** MoCA not enabled! You may need to run 'rmh start' ***\n");
     }
 
-    if (handle->localLogToFile) {
-        fclose(handle->localLogToFile);
-        handle->localLogToFile=NULL;
+    if (pRMH_CallState(handle)->localLogToFile) {
+        fclose(pRMH_CallState(handle)->localLogToFile);
+        pRMH_CallState(handle)->localLogToFile=NULL;
     }
     return RMH_SUCCESS;
 }
@@ -742,8 +655,8 @@ RMH_Result GENERIC_IMPL__RMH_Log_PrintStats(const RMH_Handle handle, const char*
     RMH_LinkStatus linkStatus;
 
     if (filename) {
-        handle->localLogToFile=fopen(filename, "a");
-        if (handle->localLogToFile == NULL) {
+        pRMH_CallState(handle)->localLogToFile=fopen(filename, "a");
+        if (pRMH_CallState(handle)->localLogToFile == NULL) {
             RMH_PrintErr("Failed to open '%s' for writing!\n", filename);
             return RMH_FAILURE;
         }
@@ -806,9 +719,9 @@ RMH_Stats_GetTxPacketAggregation (const RMH_Handle handle, uint32_t* responseArr
 RMH_Stats_GetRxCorrectedErrors (const RMH_Handle handle, RMH_NodeList_Uint32_t* response);
 RMH_Stats_GetRxUncorrectedErrors (const RMH_Handle handle, RMH_NodeList_Uint32_t* response);*/
 
-    if (handle->localLogToFile) {
-        fclose(handle->localLogToFile);
-        handle->localLogToFile=NULL;
+    if (pRMH_CallState(handle)->localLogToFile) {
+        fclose(pRMH_CallState(handle)->localLogToFile);
+        pRMH_CallState(handle)->localLogToFile=NULL;
     }
     return RMH_SUCCESS;
 }
@@ -825,8 +738,8 @@ RMH_Result GENERIC_IMPL__RMH_Log_PrintFlows(const RMH_Handle handle, const char*
     int i;
 
     if (filename) {
-        handle->localLogToFile=fopen(filename, "a");
-        if (handle->localLogToFile == NULL) {
+        pRMH_CallState(handle)->localLogToFile=fopen(filename, "a");
+        if (pRMH_CallState(handle)->localLogToFile == NULL) {
             RMH_PrintErr("Failed to open '%s' for writing!\n", filename);
             return RMH_FAILURE;
         }
@@ -888,9 +801,9 @@ RMH_Result GENERIC_IMPL__RMH_Log_PrintFlows(const RMH_Handle handle, const char*
             RMH_PrintMsg("*** Flow information not available while MoCA link is down ***\n");
     }
 
-    if (handle->localLogToFile) {
-        fclose(handle->localLogToFile);
-        handle->localLogToFile=NULL;
+    if (pRMH_CallState(handle)->localLogToFile) {
+        fclose(pRMH_CallState(handle)->localLogToFile);
+        pRMH_CallState(handle)->localLogToFile=NULL;
     }
     return RMH_SUCCESS;
 }
@@ -1086,57 +999,18 @@ RMH_Result GENERIC_IMPL__RMH_Log_PrintModulation(const RMH_Handle handle, const
 }
 
 RMH_Result GENERIC_IMPL__RMH_GetAllAPIs(const RMH_Handle handle, RMH_APIList** apiList) {
-    *apiList=&hRMHGeneric_APIList;
+    *apiList=pRMH_APIWRAP_GetAPIList();
     return RMH_SUCCESS;
 }
 
 RMH_Result GENERIC_IMPL__RMH_GetUnimplementedAPIs(const RMH_Handle handle, RMH_APIList** apiList) {
-    if (hRMHGeneric_SoCUnimplementedAPIList.apiListSize == 0) {
-        int i;
-        void* soclib = dlopen("librdkmocahalsoc.so.0", RTLD_LAZY);
-        for(i=0; i != hRMHGeneric_APIList.apiListSize; i++) {
-            RMH_API* api=hRMHGeneric_APIList.apiList[i];
-            if (api->socApiExpected) {
-                if (!soclib || !dlsym(soclib, api->socApiName)) {
-                    hRMHGeneric_SoCUnimplementedAPIList.apiList[hRMHGeneric_SoCUnimplementedAPIList.apiListSize++]=api;
-                }
-            }
-        }
-        if (soclib) {
-            dlclose(soclib);
-        }
-    }
-    *apiList=&hRMHGeneric_SoCUnimplementedAPIList;
+    BRMH_RETURN_IF(handle==NULL || handle->session==NULL, RMH_INVALID_PARAM);
+    *apiList=&handle->session->unimplementedAPIs;
     return RMH_SUCCESS;
 }
 
 RMH_Result GENERIC_IMPL__RMH_GetAPITags(const RMH_Handle handle, RMH_APITagList** apiTagList) {
-    /* If the tag list isn't initialized, do it now */
-    if (hRMHGeneric_APITags.tagListSize == 0) {
-        int i;
-        RMH_APIList* tagList;
-        char* token;
-
-        for(i=0; i != hRMHGeneric_APIList.apiListSize; i++) {
-            RMH_API* api=hRMHGeneric_APIList.apiList[i];
-            char* tags=strdup(api->tags);
-            if (!tags) {
-                RMH_PrintWrn("Unable to copy tag string for '%s'. Skipping\n",  api->apiName);
-                continue;
-            }
-            token = strtok(tags, ",");
-            while(token) {
-                if ((pRMH_FindTagList(handle, token, &tagList) == RMH_SUCCESS) && tagList) {
-                    tagList->apiList[tagList->apiListSize++] = api;
-                    RMH_PrintDbg("Added API '%s' to tag '%s'. Total APIs in this tags:%d\n", api->apiName, tagList->apiListName, tagList->apiListSize);
-                }
-                token = strtok(NULL, ",");
-            }
-            free(tags);
-        }
-        qsort(hRMHGeneric_APITags.tagList, hRMHGeneric_APITags.tagListSize, sizeof(RMH_APIList), pRMH_TagCompare);
-    }
-    *apiTagList=&hRMHGeneric_APITags;
+    *apiTagList=pRMH_APIWRAP_GetAPITags();
     return RMH_SUCCESS;
 }
 
@@ -1204,3 +1078,88 @@ RMH_Result GENERIC_IMPL__RMH_Network_GetAssociatedIds(RMH_Handle handle, RMH_Nod
 
     return RMH_SUCCESS;
 }
+
+#define SNAPSHOT_READ(validMask, bit, apiCall) { if ((apiCall) == RMH_SUCCESS) { validMask |= bit; } }
+
+RMH_Result GENERIC_IMPL__RMH_Network_GetSnapshot(const RMH_Handle handle, RMH_NetworkSnapshot* response) {
+    RMH_Result (*socAPI)(const RMH_Handle, RMH_NetworkSnapshot*)=(void*)handle->socAPI[RMH_API_ID__RMH_Network_GetSnapshot];
+    RMH_NodeList_Uint32_t remoteNodes;
+    RMH_Result ret;
+    uint32_t nodeId;
+
+    BRMH_RETURN_IF(response==NULL, RMH_INVALID_PARAM);
+
+    /* Prefer the SoC reading everything in one round trip. It may still decline by returning RMH_UNIMPLEMENTED */
+    if (socAPI && handle->handle) {
+        memset(response, 0, sizeof(*response));
+        pRMH_APIWRAP_LockSoC(handle);
+        ret=socAPI(handle->handle, response);
+        pRMH_APIWRAP_UnlockSoC(handle);
+        if (ret == RMH_SUCCESS && RMH_Interface_GetEnabled(handle, &response->interfaceEnabled) == RMH_SUCCESS) {
+            /* Only the host knows the state of the interface */
+            response->selfValid |= RMH_SELF_SNAPSHOT_INTERFACE_ENABLED;
+            if ((response->selfValid & RMH_SELF_SNAPSHOT_LINK_STATUS) && response->linkStatus == RMH_LINK_STATUS_UP && !response->interfaceEnabled) {
+                response->linkStatus=RMH_LINK_STATUS_INTERFACE_DOWN;
+            }
+        }
+        if (ret != RMH_UNIMPLEMENTED) {
+            return ret;
+        }
+    }
+
+    memset(response, 0, sizeof(*response));
+    ret=RMH_Self_GetEnabled(handle, &response->selfEnabled);
+    if (ret != RMH_SUCCESS) {
+        return ret;
+    }
+    response->selfValid |= RMH_SELF_SNAPSHOT_ENABLED;
+    SNAPSHOT_READ(response->selfValid, RMH_SELF_SNAPSHOT_LINK_STATUS,               RMH_Self_GetLinkStatus(handle, &response->linkStatus));
+    SNAPSHOT_READ(response->selfValid, RMH_SELF_SNAPSHOT_MAC,                       RMH_Interface_GetMac(handle, &response->mac));
+    SNAPSHOT_READ(response->selfValid, RMH_SELF_SNAPSHOT_INTERFACE_ENABLED,         RMH_Interface_GetEnabled(handle, &response->interfaceEnabled));
+    SNAPSHOT_READ(response->selfValid, RMH_SELF_SNAPSHOT_HIGHEST_MOCA_VERSION,      RMH_Self_GetHighestSupportedMoCAVersion(handle, &response->highestSupportedMoCAVersion));
+    SNAPSHOT_READ(response->selfValid, RMH_SELF_SNAPSHOT_PREFERRED_NC_ENABLED,      RMH_Self_GetPreferredNCEnabled(handle, &response->preferredNCEnabled));
+    SNAPSHOT_READ(response->selfValid, RMH_SELF_SNAPSHOT_LOF,                       RMH_Self_GetLOF(handle, &response->lof));
+
+    if (!response->selfEnabled || !(response->selfValid & RMH_SELF_SNAPSHOT_LINK_STATUS) || response->linkStatus != RMH_LINK_STATUS_UP) {
+        return RMH_SUCCESS;
+    }
+
+    SNAPSHOT_READ(response->networkValid, RMH_NETWORK_SNAPSHOT_NUM_NODES,           RMH_Network_GetNumNodes(handle, &response->numNodes));
+    SNAPSHOT_READ(response->networkValid, RMH_NETWORK_SNAPSHOT_NODE_ID,             RMH_Network_GetNodeId(handle, &response->nodeId));
+    SNAPSHOT_READ(response->networkValid, RMH_NETWORK_SNAPSHOT_NC_NODE_ID,          RMH_Network_GetNCNodeId(handle, &response->ncNodeId));
+    SNAPSHOT_READ(response->networkValid, RMH_NETWORK_SNAPSHOT_NC_MAC,              RMH_Network_GetNCMac(handle, &response->ncMac));
+    SNAPSHOT_READ(response->networkValid, RMH_NETWORK_SNAPSHOT_BACKUP_NC_NODE_ID,   RMH_Network_GetBackupNCNodeId(handle, &response->backupNCNodeId));
+    SNAPSHOT_READ(response->networkValid, RMH_NETWORK_SNAPSHOT_LINK_UPTIME,         RMH_Network_GetLinkUptime(handle, &response->linkUptime));
+    SNAPSHOT_READ(response->networkValid, RMH_NETWORK_SNAPSHOT_MOCA_VERSION,        RMH_Network_GetMoCAVersion(handle, &response->mocaVersion));
+    SNAPSHOT_READ(response->networkValid, RMH_NETWORK_SNAPSHOT_MIXED_MODE,          RMH_Network_GetMixedMode(handle, &response->mixedMode));
+    SNAPSHOT_READ(response->networkValid, RMH_NETWORK_SNAPSHOT_RF_CHANNEL_FREQ,     RMH_Network_GetRFChannelFreq(handle, &response->rfChannelFreq));
+    SNAPSHOT_READ(response->networkValid, RMH_NETWORK_SNAPSHOT_TX_TOTAL_PACKETS,    RMH_Stats_GetTxTotalPackets(handle, &response->txTotalPackets));
+    SNAPSHOT_READ(response->networkValid, RMH_NETWORK_SNAPSHOT_RX_TOTAL_PACKETS,    RMH_Stats_GetRxTotalPackets(handle, &response->rxTotalPackets));
+    SNAPSHOT_READ(response->networkValid, RMH_NETWORK_SNAPSHOT_TX_TOTAL_ERRORS,     RMH_Stats_GetTxTotalErrors(handle, &response->txTotalErrors));
+    SNAPSHOT_READ(response->networkValid, RMH_NETWORK_SNAPSHOT_RX_TOTAL_ERRORS,     RMH_Stats_GetRxTotalErrors(handle, &response->rxTotalErrors));
+    SNAPSHOT_READ(response->networkValid, RMH_NETWORK_SNAPSHOT_TX_DROPPED_PACKETS,  RMH_Stats_GetTxDroppedPackets(handle, &response->txDroppedPackets));
+    SNAPSHOT_READ(response->networkValid, RMH_NETWORK_SNAPSHOT_RX_DROPPED_PACKETS,  RMH_Stats_GetRxDroppedPackets(handle, &response->rxDroppedPackets));
+
+    if (RMH_Network_GetRemoteNodeIds(handle, &remoteNodes) == RMH_SUCCESS) {
+        response->networkValid |= RMH_NETWORK_SNAPSHOT_REMOTE_NODES;
+        for (nodeId = 0; nodeId < RMH_MAX_MOCA_NODES; nodeId++) {
+            if (remoteNodes.nodePresent[nodeId]) {
+                RMH_NodeSnapshot *node=&response->remoteNodes[response->numRemoteNodes++];
+                node->nodeId=nodeId;
+                SNAPSHOT_READ(node->valid, RMH_NODE_SNAPSHOT_MAC,                   RMH_RemoteNode_GetMac(handle, nodeId, &node->mac));
+                SNAPSHOT_READ(node->valid, RMH_NODE_SNAPSHOT_HIGHEST_MOCA_VERSION,  RMH_RemoteNode_GetHighestSupportedMoCAVersion(handle, nodeId, &node->highestSupportedMoCAVersion));
+                SNAPSHOT_READ(node->valid, RMH_NODE_SNAPSHOT_PREFERRED_NC,          RMH_RemoteNode_GetPreferredNC(handle, nodeId, &node->preferredNC));
+                SNAPSHOT_READ(node->valid, RMH_NODE_SNAPSHOT_RX_PACKETS,            RMH_RemoteNode_GetRxPackets(handle, nodeId, &node->rxPackets));
+                SNAPSHOT_READ(node->valid, RMH_NODE_SNAPSHOT_TX_PACKETS,            RMH_RemoteNode_GetTxPackets(handle, nodeId, &node->txPackets));
+                SNAPSHOT_READ(node->valid, RMH_NODE_SNAPSHOT_RX_TOTAL_ERRORS,       RMH_RemoteNode_GetRxTotalErrors(handle, nodeId, &node->rxTotalErrors));
+                SNAPSHOT_READ(node->valid, RMH_NODE_SNAPSHOT_TX_UNICAST_PHY_RATE,   RMH_RemoteNode_GetTxUnicastPhyRate(handle, nodeId, &node->txUnicastPhyRate));
+                SNAPSHOT_READ(node->valid, RMH_NODE_SNAPSHOT_TX_POWER_REDUCTION,    RMH_RemoteNode_GetTxPowerReduction(handle, nodeId, &node->txPowerReduction));
+                SNAPSHOT_READ(node->valid, RMH_NODE_SNAPSHOT_TX_UNICAST_POWER,      RMH_RemoteNode_GetTxUnicastPower(handle, nodeId, &node->txUnicastPower));
+                SNAPSHOT_READ(node->valid, RMH_NODE_SNAPSHOT_RX_UNICAST_POWER,      RMH_RemoteNode_GetRxUnicastPower(handle, nodeId, &node->rxUnicastPower));
+                SNAPSHOT_READ(node->valid, RMH_NODE_SNAPSHOT_RX_SNR,                RMH_RemoteNode_GetRxSNR(handle, nodeId, &node->rxSNR));
+            }
+        }
+    }
+
+    return RMH_SUCCESS;
+}
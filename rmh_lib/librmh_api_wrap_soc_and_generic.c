@@ -20,19 +20,6 @@
 #include "librmh.h"
 #include "rdk_moca_hal.h"
 
-RMH_Result GENERIC_IMPL__RMH_Destroy(const RMH_Handle handle) {
-    if (handle->soclib) {
-        dlclose(handle->soclib);
-    }
-    if (handle->printBuf) {
-        free(handle->printBuf);
-    }
-    if (handle) {
-        free(handle);
-    }
-    return RMH_SUCCESS;
-}
-
 RMH_Result GENERIC_IMPL__RMH_Log_SetAPILevel(const RMH_Handle handle, const RMH_LogLevel value){
     handle->logLevelBitMask=value;
     return RMH_SUCCESS;
@@ -44,8 +31,18 @@ RMH_Result GENERIC_IMPL__RMH_Log_GetAPILevel(const RMH_Handle handle, RMH_LogLev
 }
 
 RMH_Result GENERIC_IMPL__RMH_SetEventCallbacks(const RMH_Handle handle, const uint32_t value) {
+    /* The SoC handle is shared with other handles so it's asked for the events any of them want */
+    if (!handle->session->socSetEventCallbacks) {
+        return RMH_UNIMPLEMENTED;
+    }
+    if (!handle->handle) {
+        return RMH_INVALID_INTERNAL_STATE;
+    }
     handle->eventNotifyBitMask=value;
-    return RMH_SUCCESS;
+    if ((value & RMH_EVENT_INTERFACE_STATUS_CHANGED) && pRMH_Netlink_Start(handle) != RMH_SUCCESS) {
+        RMH_PrintWrn("Unable to track the MoCA interface. RMH_EVENT_INTERFACE_STATUS_CHANGED will not be sent\n");
+    }
+    return pRMH_Session_UpdateEventCallbacks(handle);
 }
 
 RMH_Result GENERIC_IMPL__RMH_GetEventCallbacks(const RMH_Handle handle, uint32_t* response) {
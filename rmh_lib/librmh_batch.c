@@ -0,0 +1,162 @@
+/*
+ * If not stated otherwise in this file or this component's Licenses.txt file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2016 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include <pthread.h>
+#include "librmh.h"
+#include "rdk_moca_hal.h"
+
+/**********************************************************************************************************************
+RMH_ExecuteBatch() runs a list of getters under a single entry of the API wrapper. An op on a getter only implemented by
+the SoC is called straight from the SoC API table of the handle, taking the SoC lock once for each run of such ops, so
+it skips the per API logging, timing, trace and instrumentation. Any other op, and any op on an API cached by the handle,
+is made through the public API as usual.
+
+A SoC library may export SoC_IMPL__RMH_ExecuteBatch to answer the whole batch in one go. It's given every op with its
+result set to RMH_UNIMPLEMENTED and may only answer ops on getters implemented by the SoC alone. Everything it leaves
+RMH_UNIMPLEMENTED, or answers for a getter with a generic part, is then run as above.
+
+Which getters can be batched is worked out once from the parameter list of each API in hRMHGeneric_APITable.
+**********************************************************************************************************************/
+typedef struct RMH_BatchAPI {
+    bool supported;
+    bool socOnly;                           /* Implemented only by the SoC so it may be called directly */
+    RMH_CacheShape shape;
+} RMH_BatchAPI;
+
+static pthread_once_t hRMHGeneric_BatchAPIsOnce = PTHREAD_ONCE_INIT;
+static RMH_BatchAPI hRMHGeneric_BatchAPIs[RMH_NUM_APIS];
+
+/* The public entry point of every API, indexed by RMH_APIId */
+#define __RMH_BATCH_API_FUNC(DECLARATION, API_NAME, ...) [RMH_API_ID__##API_NAME] = (RMH_SoCAPI)API_NAME,
+#undef RMH_API_IMPLEMENTATION_SOC_ONLY
+#undef RMH_API_IMPLEMENTATION_GENERIC_ONLY
+#undef RMH_API_IMPLEMENTATION_SOC_THEN_GENERIC
+#undef RMH_API_IMPLEMENTATION_GENERIC_THEN_SOC
+#undef RMH_API_IMPLEMENTATION_NO_WRAP
+#define RMH_API_IMPLEMENTATION_SOC_ONLY(...)            __RMH_BATCH_API_FUNC(__VA_ARGS__)
+#define RMH_API_IMPLEMENTATION_GENERIC_ONLY(...)        __RMH_BATCH_API_FUNC(__VA_ARGS__)
+#define RMH_API_IMPLEMENTATION_SOC_THEN_GENERIC(...)    __RMH_BATCH_API_FUNC(__VA_ARGS__)
+#define RMH_API_IMPLEMENTATION_GENERIC_THEN_SOC(...)    __RMH_BATCH_API_FUNC(__VA_ARGS__)
+#define RMH_API_IMPLEMENTATION_NO_WRAP(...)             __RMH_BATCH_API_FUNC(__VA_ARGS__)
+static const RMH_SoCAPI hRMHGeneric_APIFunc[RMH_NUM_APIS] = {
+#undef RMH_API_H
+#include "rmh_api.h"
+};
+
+static
+void pRMH_Batch_ClassifyAPIs() {
+    uint32_t i;
+
+    for (i=0; i < RMH_NUM_APIS; i++) {
+        const RMH_API *api=&hRMHGeneric_APITable[i];
+        const RMHGeneric_Param *params=api->apiParams;
+        RMH_BatchAPI *batchAPI=&hRMHGeneric_BatchAPIs[i];
+
+        /* Only getters. Anything else with an output, like RMH_Log_CreateDriverFile, does more than read a value */
+        if (!strstr(api->apiName, "_Get") || !api->apiNumParams || strcmp(params[0].name, "handle") != 0) {
+            continue;
+        }
+        if (api->apiNumParams == 2 && params[1].direction == RMH_OUTPUT_PARAM) {
+            batchAPI->shape=RMH_CACHE_SHAPE_VALUE;
+        }
+        else if (api->apiNumParams == 3 && params[1].direction == RMH_INPUT_PARAM && strcmp(params[1].name, "nodeId") == 0 &&
+                 params[2].direction == RMH_OUTPUT_PARAM) {
+            batchAPI->shape=RMH_CACHE_SHAPE_NODE_VALUE;
+        }
+        else if (api->apiNumParams == 3 && params[1].direction == RMH_OUTPUT_PARAM && strcmp(params[1].type, "char*") == 0 &&
+                 params[2].direction == RMH_INPUT_PARAM && strcmp(params[2].type, "const size_t") == 0) {
+            batchAPI->shape=RMH_CACHE_SHAPE_STRING;
+        }
+        else {
+            continue;
+        }
+        batchAPI->supported=true;
+        batchAPI->socOnly=api->socApiExpected && !api->genericApiExpected;
+    }
+}
+
+static inline
+RMH_Result pRMH_Batch_Call(const RMH_SoCAPI apiFunc, const RMH_Handle apiHandle, const RMH_CacheShape shape, const RMH_BatchOp *op) {
+    switch (shape) {
+        case RMH_CACHE_SHAPE_STRING:
+            return apiFunc(apiHandle, (char *)op->response, op->responseSize);
+        case RMH_CACHE_SHAPE_NODE_VALUE:
+            return apiFunc(apiHandle, op->nodeId, op->response);
+        default:
+            return apiFunc(apiHandle, op->response);
+    }
+}
+
+RMH_Result GENERIC_IMPL__RMH_ExecuteBatch(const RMH_Handle handle, const RMH_BatchOp* ops, const size_t numOps) {
+    RMH_Result (*socBatch)(const RMH_Handle, const RMH_BatchOp*, const size_t)=(void*)handle->socAPI[RMH_API_ID__RMH_ExecuteBatch];
+    bool socLocked=false;
+    size_t i;
+
+    BRMH_RETURN_IF(ops==NULL && numOps, RMH_INVALID_PARAM);
+    for (i=0; i < numOps; i++) {
+        BRMH_RETURN_IF(ops[i].result==NULL, RMH_INVALID_PARAM);
+        *ops[i].result=RMH_UNIMPLEMENTED;
+    }
+    pthread_once(&hRMHGeneric_BatchAPIsOnce, pRMH_Batch_ClassifyAPIs);
+
+    if (socBatch && handle->handle && numOps) {
+        RMH_Result ret;
+        pRMH_APIWRAP_LockSoC(handle);
+        ret=socBatch(handle->handle, ops, numOps);
+        pRMH_APIWRAP_UnlockSoC(handle);
+        if (ret != RMH_SUCCESS && ret != RMH_UNIMPLEMENTED) {
+            RMH_PrintWrn("The SoC failed the batch with %s. Running each op on its own\n", RMH_ResultToString(ret));
+        }
+    }
+
+    for (i=0; i < numOps; i++) {
+        const RMH_BatchOp *op=&ops[i];
+        const RMH_BatchAPI *batchAPI;
+        bool direct;
+
+        if (op->apiId >= RMH_NUM_APIS || !hRMHGeneric_BatchAPIs[op->apiId].supported || op->response == NULL) {
+            *op->result=(op->apiId >= RMH_NUM_APIS || op->response) ? RMH_INVALID_ID : RMH_INVALID_PARAM;
+            continue;
+        }
+        batchAPI=&hRMHGeneric_BatchAPIs[op->apiId];
+        direct=batchAPI->socOnly && !pRMH_Cache_Enabled(handle, op->apiId);
+        if (direct && *op->result != RMH_UNIMPLEMENTED) {
+            continue; /* Answered by the SoC batch */
+        }
+
+        if (direct && handle->socAPI[op->apiId] && handle->handle) {
+            if (!socLocked) {
+                pRMH_APIWRAP_LockSoC(handle);
+                socLocked=true;
+            }
+            *op->result=pRMH_Batch_Call(handle->socAPI[op->apiId], handle->handle, batchAPI->shape, op);
+        }
+        else {
+            if (socLocked) {
+                pRMH_APIWRAP_UnlockSoC(handle);
+                socLocked=false;
+            }
+            *op->result=pRMH_Batch_Call(hRMHGeneric_APIFunc[op->apiId], handle, batchAPI->shape, op);
+        }
+    }
+    if (socLocked) {
+        pRMH_APIWRAP_UnlockSoC(handle);
+    }
+    return RMH_SUCCESS;
+}
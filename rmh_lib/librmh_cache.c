@@ -0,0 +1,322 @@
+/*
+ * If not stated otherwise in this file or this component's Licenses.txt file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2016 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include <stdarg.h>
+#include <pthread.h>
+#include "librmh.h"
+#include "rdk_moca_hal.h"
+
+/**********************************************************************************************************************
+A read through cache of getters whose values only change when the SoC tells us about it. It's enabled per handle with
+RMH_Cache_SetEnabled. The API wrapper asks pRMH_Cache_Get() for a value before calling the SoC and gives the result to
+pRMH_Cache_Put() after a successful call.
+
+Each cached API lists the events which make its values stale. These are delivered to the cache by the session before
+the handle's own callback sees them, so a client reacting to an event always reads fresh values. Values are keyed by
+node ID for RemoteNode APIs. A value may also have a TTL after which it's fetched again, which limits how long a value
+can be stale should the SoC not send an event.
+
+Every invalidation increments the generation of the API. A call which missed the cache remembers the generation it
+saw and its result is only stored if nothing was invalidated while it was in the SoC.
+**********************************************************************************************************************/
+/*        API                                                   Shape                           Output size                 TTL(ms)     Invalidated by */
+#define RMH_CACHED_APIS \
+    RMH_CACHE(RMH_Interface_GetName,                            RMH_CACHE_SHAPE_STRING,         0,                          0,          RMH_EVENT_MOCA_RESET) \
+    RMH_CACHE(RMH_Interface_GetMac,                             RMH_CACHE_SHAPE_VALUE,          sizeof(RMH_MacAddress_t),   0,          RMH_EVENT_MOCA_RESET) \
+    RMH_CACHE(RMH_Self_GetSoftwareVersion,                      RMH_CACHE_SHAPE_STRING,         0,                          0,          RMH_EVENT_MOCA_RESET) \
+    RMH_CACHE(RMH_Self_GetHighestSupportedMoCAVersion,          RMH_CACHE_SHAPE_VALUE,          sizeof(RMH_MoCAVersion),    0,          RMH_EVENT_MOCA_RESET) \
+    RMH_CACHE(RMH_Self_GetSupportedBand,                        RMH_CACHE_SHAPE_VALUE,          sizeof(RMH_Band),           0,          RMH_EVENT_MOCA_RESET) \
+    RMH_CACHE(RMH_RemoteNode_GetMac,                            RMH_CACHE_SHAPE_NODE_VALUE,     sizeof(RMH_MacAddress_t),   60000,      RMH_CACHE_NODE_EVENTS) \
+    RMH_CACHE(RMH_RemoteNode_GetHighestSupportedMoCAVersion,    RMH_CACHE_SHAPE_NODE_VALUE,     sizeof(RMH_MoCAVersion),    60000,      RMH_CACHE_NODE_EVENTS)
+
+#define RMH_CACHE_NODE_EVENTS (RMH_EVENT_NODE_JOINED | RMH_EVENT_NODE_DROPPED | RMH_EVENT_LINK_STATUS_CHANGED | RMH_EVENT_MOCA_RESET)
+#define RMH_CACHE_MAX_VALUE_SIZE 128
+
+#define RMH_CACHE(API_NAME, SHAPE, SIZE, TTL_MS, EVENTS) RMH_CACHE_INDEX__##API_NAME,
+enum { RMH_CACHED_APIS RMH_CACHE_NUM_APIS };
+#undef RMH_CACHE
+
+#define RMH_CACHE(API_NAME, SHAPE, SIZE, TTL_MS, EVENTS) [RMH_API_ID__##API_NAME] = { true, RMH_CACHE_INDEX__##API_NAME, SHAPE, SIZE, TTL_MS, EVENTS },
+__attribute__((visibility("hidden"))) const RMH_CachePolicy hRMHGeneric_CachePolicy[RMH_NUM_APIS] = { RMH_CACHED_APIS };
+#undef RMH_CACHE
+
+#define RMH_CACHE(API_NAME, SHAPE, SIZE, TTL_MS, EVENTS) | (EVENTS)
+__attribute__((visibility("hidden"))) const uint32_t hRMHGeneric_CacheEvents = 0 RMH_CACHED_APIS;
+#undef RMH_CACHE
+
+#define RMH_CACHE(API_NAME, SHAPE, SIZE, TTL_MS, EVENTS) RMH_API_ID__##API_NAME,
+static const RMH_APIId hRMHGeneric_CachedAPIs[RMH_CACHE_NUM_APIS] = { RMH_CACHED_APIS };
+#undef RMH_CACHE
+
+typedef struct RMH_CacheEntry {
+    bool valid;
+    uint64_t expiresNs;                     /* CLOCK_MONOTONIC time the value goes stale. 0 if only an event makes it stale */
+    size_t size;
+    uint8_t value[RMH_CACHE_MAX_VALUE_SIZE];
+} RMH_CacheEntry;
+
+typedef struct RMH_CacheSlot {
+    uint64_t generation;
+    uint64_t numHits;
+    uint64_t numMisses;
+    uint64_t numInvalidations;
+    RMH_CacheEntry entries[RMH_MAX_MOCA_NODES];     /* Only entry 0 is used by APIs which don't take a node ID */
+} RMH_CacheSlot;
+
+typedef struct RMH_Cache {
+    pthread_mutex_t lock;
+    RMH_CacheSlot slots[RMH_CACHE_NUM_APIS];
+} RMH_Cache;
+
+static inline
+uint64_t pRMH_Cache_NowNs() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000000000ull + now.tv_nsec;
+}
+
+/* Pull the node ID and output of the call from the arguments which follow the handle */
+static
+bool pRMH_Cache_GetArgs(const RMH_CachePolicy *policy, va_list args, uint32_t *nodeId, void **response, size_t *responseSize) {
+    *nodeId=0;
+    switch (policy->shape) {
+        case RMH_CACHE_SHAPE_STRING:
+            *response=va_arg(args, char*);
+            *responseSize=va_arg(args, size_t);
+            break;
+        case RMH_CACHE_SHAPE_NODE_VALUE:
+            *nodeId=va_arg(args, uint32_t);
+            /* Fall through */
+        case RMH_CACHE_SHAPE_VALUE:
+            *response=va_arg(args, void*);
+            *responseSize=policy->valueSize;
+            break;
+        default:
+            return false;
+    }
+    /* Leave anything we can't cache to the SoC, which will also report any error */
+    return *response != NULL && *nodeId < RMH_MAX_MOCA_NODES;
+}
+
+static
+void pRMH_Cache_InvalidateSlot(RMH_CacheSlot *slot, const uint32_t firstNode, const uint32_t lastNode) {
+    uint32_t i;
+    for (i=firstNode; i <= lastNode; i++) {
+        if (slot->entries[i].valid) {
+            slot->entries[i].valid=false;
+            slot->numInvalidations++;
+        }
+    }
+    slot->generation++;
+}
+
+__attribute__((visibility("hidden")))
+bool pRMH_Cache_Get(const RMH_APIId apiId, uint64_t *generation, const RMH_Handle handle, ...) {
+    const RMH_CachePolicy *policy=&hRMHGeneric_CachePolicy[apiId];
+    RMH_Cache *cache=handle->cache;
+    RMH_CacheSlot *slot=&cache->slots[policy->index];
+    RMH_CacheEntry *entry;
+    uint32_t nodeId;
+    void *response;
+    size_t responseSize;
+    bool cacheable;
+    bool hit=false;
+    va_list args;
+
+    va_start(args, handle);
+    cacheable=pRMH_Cache_GetArgs(policy, args, &nodeId, &response, &responseSize);
+    va_end(args);
+    if (!cacheable) {
+        return false;
+    }
+
+    pthread_mutex_lock(&cache->lock);
+    entry=&slot->entries[nodeId];
+    if (entry->valid && entry->expiresNs && pRMH_Cache_NowNs() >= entry->expiresNs) {
+        entry->valid=false;
+        slot->numInvalidations++;
+    }
+    if (entry->valid && entry->size <= responseSize) {
+        memcpy(response, entry->value, entry->size);
+        slot->numHits++;
+        hit=true;
+    }
+    else {
+        slot->numMisses++;
+        *generation=slot->generation;
+    }
+    pthread_mutex_unlock(&cache->lock);
+    return hit;
+}
+
+__attribute__((visibility("hidden")))
+void pRMH_Cache_Put(const RMH_APIId apiId, const uint64_t generation, const RMH_Handle handle, ...) {
+    const RMH_CachePolicy *policy=&hRMHGeneric_CachePolicy[apiId];
+    RMH_Cache *cache=handle->cache;
+    RMH_CacheSlot *slot=&cache->slots[policy->index];
+    RMH_CacheEntry *entry;
+    uint32_t nodeId;
+    void *response;
+    size_t responseSize;
+    size_t size;
+    bool cacheable;
+    va_list args;
+
+    va_start(args, handle);
+    cacheable=pRMH_Cache_GetArgs(policy, args, &nodeId, &response, &responseSize);
+    va_end(args);
+    if (!cacheable) {
+        return;
+    }
+    if (policy->shape == RMH_CACHE_SHAPE_STRING) {
+        size=strnlen((const char*)response, responseSize);
+        if (size == responseSize) {
+            return; /* Not terminated, leave it to the SoC to do the same next time */
+        }
+        size++;
+    }
+    else {
+        size=responseSize;
+    }
+    if (size > RMH_CACHE_MAX_VALUE_SIZE) {
+        return;
+    }
+
+    pthread_mutex_lock(&cache->lock);
+    if (slot->generation == generation) {
+        entry=&slot->entries[nodeId];
+        memcpy(entry->value, response, size);
+        entry->size=size;
+        entry->expiresNs=policy->ttlMs ? pRMH_Cache_NowNs() + policy->ttlMs * 1000000ull : 0;
+        entry->valid=true;
+    }
+    pthread_mutex_unlock(&cache->lock);
+}
+
+/* Called by the session for every event from the SoC, whether or not the handle asked for it */
+__attribute__((visibility("hidden")))
+void pRMH_Cache_HandleEvent(const RMH_Handle handle, const RMH_Event event, const RMH_EventData *eventData) {
+    RMH_Cache *cache=handle->cache;
+    uint32_t i;
+
+    if (!(hRMHGeneric_CacheEvents & event)) {
+        return;
+    }
+    pthread_mutex_lock(&cache->lock);
+    for (i=0; i < RMH_CACHE_NUM_APIS; i++) {
+        const RMH_CachePolicy *policy=&hRMHGeneric_CachePolicy[hRMHGeneric_CachedAPIs[i]];
+        if (!(policy->invalidateEvents & event)) {
+            continue;
+        }
+        /* A node joining or leaving only makes the values of that node stale */
+        if (policy->shape == RMH_CACHE_SHAPE_NODE_VALUE && event == RMH_EVENT_NODE_JOINED && eventData->RMH_EVENT_NODE_JOINED.nodeId < RMH_MAX_MOCA_NODES) {
+            pRMH_Cache_InvalidateSlot(&cache->slots[i], eventData->RMH_EVENT_NODE_JOINED.nodeId, eventData->RMH_EVENT_NODE_JOINED.nodeId);
+        }
+        else if (policy->shape == RMH_CACHE_SHAPE_NODE_VALUE && event == RMH_EVENT_NODE_DROPPED && eventData->RMH_EVENT_NODE_DROPPED.nodeId < RMH_MAX_MOCA_NODES) {
+            pRMH_Cache_InvalidateSlot(&cache->slots[i], eventData->RMH_EVENT_NODE_DROPPED.nodeId, eventData->RMH_EVENT_NODE_DROPPED.nodeId);
+        }
+        else {
+            pRMH_Cache_InvalidateSlot(&cache->slots[i], 0, RMH_MAX_MOCA_NODES-1);
+        }
+    }
+    pthread_mutex_unlock(&cache->lock);
+}
+
+__attribute__((visibility("hidden")))
+void pRMH_Cache_Destroy(const RMH_Handle handle) {
+    if (handle->cache) {
+        pthread_mutex_destroy(&handle->cache->lock);
+        free(handle->cache);
+        handle->cache=NULL;
+    }
+}
+
+RMH_Result RMH_Cache_Flush(const RMH_Handle handle) {
+    uint32_t i;
+
+    BRMH_RETURN_IF(handle==NULL, RMH_INVALID_PARAM);
+    if (handle->cache) {
+        pthread_mutex_lock(&handle->cache->lock);
+        for (i=0; i < RMH_CACHE_NUM_APIS; i++) {
+            pRMH_Cache_InvalidateSlot(&handle->cache->slots[i], 0, RMH_MAX_MOCA_NODES-1);
+        }
+        pthread_mutex_unlock(&handle->cache->lock);
+    }
+    return RMH_SUCCESS;
+}
+
+RMH_Result RMH_Cache_SetEnabled(const RMH_Handle handle, const bool value) {
+    RMH_Result ret;
+    uint32_t i;
+
+    BRMH_RETURN_IF(handle==NULL, RMH_INVALID_PARAM);
+    if (value && !handle->cache) {
+        RMH_Cache *cache=calloc(1, sizeof(*cache));
+        BRMH_RETURN_IF(cache==NULL, RMH_FAILURE);
+        if (pthread_mutex_init(&cache->lock, NULL) != 0) {
+            RMH_PrintErr("Unable to create the cache lock!\n");
+            free(cache);
+            return RMH_FAILURE;
+        }
+        for (i=0; i < RMH_CACHE_NUM_APIS; i++) {
+            cache->slots[i].generation=1;
+        }
+        handle->cache=cache;
+    }
+    if (!value) {
+        /* Keep the cache allocated as another thread may still be using it. Just make sure nothing in it is used again */
+        RMH_Cache_Flush(handle);
+    }
+    __atomic_store_n(&handle->cacheEnabled, value, __ATOMIC_RELEASE);
+
+    /* The SoC must now send, or may stop sending, the events which invalidate the cache */
+    ret=pRMH_Session_UpdateEventCallbacks(handle);
+    if (value && ret != RMH_SUCCESS) {
+        RMH_PrintWrn("Unable to request events from the SoC [%s]. Cached values will only expire by their TTL\n", RMH_ResultToString(ret));
+    }
+    return RMH_SUCCESS;
+}
+
+RMH_Result RMH_Cache_GetEnabled(const RMH_Handle handle, bool* response) {
+    BRMH_RETURN_IF(handle==NULL, RMH_INVALID_PARAM);
+    BRMH_RETURN_IF(response==NULL, RMH_INVALID_PARAM);
+    *response=__atomic_load_n(&handle->cacheEnabled, __ATOMIC_RELAXED);
+    return RMH_SUCCESS;
+}
+
+RMH_Result RMH_Cache_GetStats(const RMH_Handle handle, const RMH_APIId apiId, RMH_CacheStats* response) {
+    BRMH_RETURN_IF(handle==NULL, RMH_INVALID_PARAM);
+    BRMH_RETURN_IF(response==NULL, RMH_INVALID_PARAM);
+    BRMH_RETURN_IF(apiId>=RMH_NUM_APIS, RMH_INVALID_ID);
+    if (!hRMHGeneric_CachePolicy[apiId].cached) {
+        return RMH_NOT_SUPPORTED;
+    }
+
+    memset(response, 0, sizeof(*response));
+    response->apiId=apiId;
+    if (handle->cache) {
+        RMH_CacheSlot *slot=&handle->cache->slots[hRMHGeneric_CachePolicy[apiId].index];
+        pthread_mutex_lock(&handle->cache->lock);
+        response->numHits=slot->numHits;
+        response->numMisses=slot->numMisses;
+        response->numInvalidations=slot->numInvalidations;
+        pthread_mutex_unlock(&handle->cache->lock);
+    }
+    return RMH_SUCCESS;
+}
@@ -22,20 +22,21 @@
 #include "rdk_moca_hal.h"
 
 __attribute__((visibility("hidden"))) RMH_APIList hRMHGeneric_APIList;
-__attribute__((visibility("hidden"))) RMH_APIList hRMHGeneric_SoCUnimplementedAPIList;
 __attribute__((visibility("hidden"))) RMH_APITagList hRMHGeneric_APITags;
+__attribute__((visibility("hidden"))) __thread RMH_CallState hRMHGeneric_ThreadCallState;
 
 void RMH_Print(const RMH_Handle handle, const RMH_LogLevel level, const char *filename, const uint32_t lineNumber, const char *format, ...) {
     va_list args;
+    RMH_CallState *callState=handle ? pRMH_CallState(handle) : NULL;
     va_start(args, format);
-    if (handle && handle->localLogToFile) {
-        vfprintf(handle->localLogToFile, format, args);
+    if (callState && callState->localLogToFile) {
+        vfprintf(callState->localLogToFile, format, args);
     }
-    else if (handle && handle->printBuf && handle->eventCB && ((handle->eventNotifyBitMask & RMH_EVENT_API_PRINT) == RMH_EVENT_API_PRINT)) {
+    else if (callState && handle->eventCB && ((handle->eventNotifyBitMask & RMH_EVENT_API_PRINT) == RMH_EVENT_API_PRINT)) {
         RMH_EventData eventData;
-        vsnprintf(handle->printBuf, RMH_MAX_PRINT_LINE_SIZE, format, args);
+        vsnprintf(callState->printBuf, sizeof(callState->printBuf), format, args);
         eventData.RMH_EVENT_API_PRINT.logLevel=level;
-        eventData.RMH_EVENT_API_PRINT.logMsg=(const char *)handle->printBuf;
+        eventData.RMH_EVENT_API_PRINT.logMsg=(const char *)callState->printBuf;
         handle->eventCB(RMH_EVENT_API_PRINT, &eventData, handle->eventCBUserContext);
     }
     else {
@@ -0,0 +1,153 @@
+/*
+ * If not stated otherwise in this file or this component's Licenses.txt file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2016 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include "librmh.h"
+#include "rdk_moca_hal.h"
+
+/**********************************************************************************************************************
+Statistics for every wrapped API. These are shared by all handles in the process and updated by every call so they use
+relaxed atomics only. A reader may see a call counted in numCalls before it appears in the histogram, which is fine for
+the purpose of finding slow APIs.
+
+Calls which weren't timed, because they were nested deeper than RMH_MAX_API_DEPTH, are only counted in numCalls,
+numResults and numUntimedCalls.
+
+minTimeUs is stored as the time plus one so that zero can mean 'no calls yet' without needing to initialize the table.
+**********************************************************************************************************************/
+typedef struct RMHGeneric_APIStats {
+    uint64_t numCalls;
+    uint64_t numResults[RMH_NUM_RESULTS];
+    uint64_t numUntimedCalls;
+    uint64_t totalTimeUs;
+    uint64_t totalSelfTimeUs;
+    uint64_t minTimeUsPlusOne;
+    uint64_t maxTimeUs;
+    uint64_t histogram[RMH_INSTRUMENTATION_NUM_BUCKETS];
+} RMHGeneric_APIStats;
+
+static RMHGeneric_APIStats hRMHGeneric_APIStats[RMH_NUM_APIS];
+
+static inline
+uint32_t pRMH_Instrumentation_GetBucket(const uint64_t timeUs) {
+    uint32_t bucket = (timeUs == 0) ? 0 : 64 - __builtin_clzll(timeUs);
+    return (bucket < RMH_INSTRUMENTATION_NUM_BUCKETS) ? bucket : RMH_INSTRUMENTATION_NUM_BUCKETS-1;
+}
+
+static inline
+uint64_t pRMH_Instrumentation_GetBucketLimit(const uint32_t bucket) {
+    return 1ull << bucket;
+}
+
+__attribute__((visibility("hidden")))
+void pRMH_Instrumentation_Record(const RMH_APIId apiId, const RMH_Result result, const bool timed, const uint64_t timeUs, const uint64_t selfTimeUs) {
+    RMHGeneric_APIStats *stats=&hRMHGeneric_APIStats[apiId];
+    uint64_t cur;
+
+    __atomic_fetch_add(&stats->numCalls, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&stats->numResults[(result < RMH_NUM_RESULTS) ? result : RMH_FAILURE], 1, __ATOMIC_RELAXED);
+    if (!timed) {
+        __atomic_fetch_add(&stats->numUntimedCalls, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    __atomic_fetch_add(&stats->totalTimeUs, timeUs, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&stats->totalSelfTimeUs, selfTimeUs, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&stats->histogram[pRMH_Instrumentation_GetBucket(timeUs)], 1, __ATOMIC_RELAXED);
+
+    cur=__atomic_load_n(&stats->minTimeUsPlusOne, __ATOMIC_RELAXED);
+    while ((cur == 0 || timeUs+1 < cur) &&
+           !__atomic_compare_exchange_n(&stats->minTimeUsPlusOne, &cur, timeUs+1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+    cur=__atomic_load_n(&stats->maxTimeUs, __ATOMIC_RELAXED);
+    while (timeUs > cur &&
+           !__atomic_compare_exchange_n(&stats->maxTimeUs, &cur, timeUs, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+}
+
+static
+uint64_t pRMH_Instrumentation_GetPercentile(const RMH_APIStats *stats, const uint64_t numCalls, const uint32_t percentile) {
+    uint64_t target=(numCalls * percentile + 99) / 100;
+    uint64_t count=0;
+    uint32_t i;
+
+    if (numCalls == 0) {
+        return 0;
+    }
+    for (i=0; i < RMH_INSTRUMENTATION_NUM_BUCKETS; i++) {
+        count += stats->histogram[i];
+        if (count >= target) {
+            /* Don't report a bucket limit higher than the slowest call we actually saw */
+            uint64_t limit=pRMH_Instrumentation_GetBucketLimit(i);
+            return (limit > stats->maxTimeUs) ? stats->maxTimeUs : limit;
+        }
+    }
+    return stats->maxTimeUs;
+}
+
+RMH_Result RMH_Instrumentation_GetStats(const RMH_Handle handle, const RMH_APIId apiId, RMH_APIStats* response) {
+    RMHGeneric_APIStats *stats;
+    uint64_t numInHistogram=0;
+    uint64_t minTimeUsPlusOne;
+    uint32_t i;
+
+    BRMH_RETURN_IF(response==NULL, RMH_INVALID_PARAM);
+    BRMH_RETURN_IF(apiId>=RMH_NUM_APIS, RMH_INVALID_ID);
+
+    stats=&hRMHGeneric_APIStats[apiId];
+    memset(response, 0, sizeof(*response));
+    response->apiId=apiId;
+    response->numCalls=__atomic_load_n(&stats->numCalls, __ATOMIC_RELAXED);
+    for (i=0; i < RMH_NUM_RESULTS; i++) {
+        response->numResults[i]=__atomic_load_n(&stats->numResults[i], __ATOMIC_RELAXED);
+    }
+    response->numUntimedCalls=__atomic_load_n(&stats->numUntimedCalls, __ATOMIC_RELAXED);
+    response->totalTimeUs=__atomic_load_n(&stats->totalTimeUs, __ATOMIC_RELAXED);
+    response->totalSelfTimeUs=__atomic_load_n(&stats->totalSelfTimeUs, __ATOMIC_RELAXED);
+    minTimeUsPlusOne=__atomic_load_n(&stats->minTimeUsPlusOne, __ATOMIC_RELAXED);
+    response->minTimeUs=minTimeUsPlusOne ? minTimeUsPlusOne-1 : 0;
+    response->maxTimeUs=__atomic_load_n(&stats->maxTimeUs, __ATOMIC_RELAXED);
+    for (i=0; i < RMH_INSTRUMENTATION_NUM_BUCKETS; i++) {
+        response->histogram[i]=__atomic_load_n(&stats->histogram[i], __ATOMIC_RELAXED);
+        numInHistogram += response->histogram[i];
+    }
+
+    /* Use the histogram total so the percentiles are consistant with the buckets we just read */
+    response->p50TimeUs=pRMH_Instrumentation_GetPercentile(response, numInHistogram, 50);
+    response->p99TimeUs=pRMH_Instrumentation_GetPercentile(response, numInHistogram, 99);
+    return RMH_SUCCESS;
+}
+
+RMH_Result RMH_Instrumentation_Reset(const RMH_Handle handle) {
+    uint32_t i, j;
+
+    for (i=0; i < RMH_NUM_APIS; i++) {
+        RMHGeneric_APIStats *stats=&hRMHGeneric_APIStats[i];
+        __atomic_store_n(&stats->numCalls, 0, __ATOMIC_RELAXED);
+        for (j=0; j < RMH_NUM_RESULTS; j++) {
+            __atomic_store_n(&stats->numResults[j], 0, __ATOMIC_RELAXED);
+        }
+        __atomic_store_n(&stats->numUntimedCalls, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&stats->totalTimeUs, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&stats->totalSelfTimeUs, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&stats->minTimeUsPlusOne, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&stats->maxTimeUs, 0, __ATOMIC_RELAXED);
+        for (j=0; j < RMH_INSTRUMENTATION_NUM_BUCKETS; j++) {
+            __atomic_store_n(&stats->histogram[j], 0, __ATOMIC_RELAXED);
+        }
+    }
+    return RMH_SUCCESS;
+}
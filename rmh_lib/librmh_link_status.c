@@ -0,0 +1,196 @@
+/*
+ * If not stated otherwise in this file or this component's Licenses.txt file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2016 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include <pthread.h>
+#include "librmh.h"
+#include "rdk_moca_hal.h"
+
+/**********************************************************************************************************************
+RMH_Self_GetLinkStatus() combines whether MoCA is enabled, whether it has a link and whether the interface is up. Reading
+each from the device costs two calls into the SoC, yet it's checked at the top of most of the RMH_Log_Print APIs and on
+every pass of a monitor.
+
+So the session keeps what the SoC last said. The first read asks the SoC for RMH_LINK_STATUS_EVENTS and then reads the
+state from it. From then on RMH_EVENT_LINK_STATUS_CHANGED updates the state, while RMH_EVENT_MOCA_RESET and the setters
+which change it throw it away so the next read goes to the SoC again. The interface part is always taken from the netlink
+tracker, which is a memory read too, so interface notifications are seen as soon as they arrive.
+
+Every change increments the generation of the state. A read from the SoC is only kept if nothing changed while it was
+made, so it can't overwrite what a newer event said. A SoC which can't send events is asked every time.
+**********************************************************************************************************************/
+static
+RMH_LinkTracking pRMH_LinkStatus_StartTracking(const RMH_Handle handle) {
+    RMH_LinkState *linkState=&handle->session->linkState;
+    RMH_LinkTracking tracking;
+    RMH_Result ret;
+
+    pthread_mutex_lock(&linkState->lock);
+    tracking=linkState->tracking;
+    if (tracking == RMH_LINK_TRACKING_OFF) {
+        linkState->tracking=RMH_LINK_TRACKING_STARTING;
+    }
+    pthread_mutex_unlock(&linkState->lock);
+    if (tracking != RMH_LINK_TRACKING_OFF) {
+        return tracking;
+    }
+
+    /* Can't hold the lock here as the SoC may send an event before returning */
+    ret=pRMH_Session_UpdateEventCallbacks(handle);
+    tracking=(ret == RMH_SUCCESS) ? RMH_LINK_TRACKING_ON : RMH_LINK_TRACKING_UNAVAILABLE;
+    if (ret != RMH_SUCCESS) {
+        RMH_PrintDbg("Unable to request link events from the SoC [%s]. The link status will be read every time\n", RMH_ResultToString(ret));
+    }
+    pthread_mutex_lock(&linkState->lock);
+    linkState->tracking=tracking;
+    linkState->generation++;
+    pthread_mutex_unlock(&linkState->lock);
+    return tracking;
+}
+
+static
+void pRMH_LinkStatus_Invalidate(const RMH_Handle handle) {
+    RMH_LinkState *linkState=&handle->session->linkState;
+
+    pthread_mutex_lock(&linkState->lock);
+    linkState->valid=false;
+    linkState->generation++;
+    pthread_mutex_unlock(&linkState->lock);
+}
+
+static
+RMH_Result pRMH_LinkStatus_Combine(const RMH_Handle handle, const bool selfEnabled, const bool linkUp, RMH_LinkStatus* response) {
+    bool ifEnabled;
+
+    if (!selfEnabled) {
+        *response=RMH_LINK_STATUS_DISABLED;
+        return RMH_SUCCESS;
+    }
+    if (!linkUp) {
+        *response=RMH_LINK_STATUS_NO_LINK;
+        return RMH_SUCCESS;
+    }
+    if (!pRMH_Netlink_GetEnabled(handle, &ifEnabled)) {
+        BRMH_RETURN_IF_FAILED(RMH_Interface_GetEnabled(handle, &ifEnabled));
+    }
+    *response=ifEnabled ? RMH_LINK_STATUS_UP : RMH_LINK_STATUS_INTERFACE_DOWN;
+    return RMH_SUCCESS;
+}
+
+/* Called by the session for every event from the SoC, before any handle sees it */
+__attribute__((visibility("hidden")))
+void pRMH_LinkStatus_HandleEvent(RMH_Session *session, const RMH_Event event, const RMH_EventData *eventData) {
+    RMH_LinkState *linkState=&session->linkState;
+
+    if (!(event & RMH_LINK_STATUS_EVENTS)) {
+        return;
+    }
+    pthread_mutex_lock(&linkState->lock);
+    linkState->generation++;
+    linkState->valid=false;
+    if (event == RMH_EVENT_LINK_STATUS_CHANGED && linkState->tracking == RMH_LINK_TRACKING_ON) {
+        switch (eventData->RMH_EVENT_LINK_STATUS_CHANGED.status) {
+            case RMH_LINK_STATUS_DISABLED:
+                linkState->selfEnabled=false;
+                linkState->linkUp=false;
+                linkState->valid=true;
+                break;
+            case RMH_LINK_STATUS_NO_LINK:
+                linkState->selfEnabled=true;
+                linkState->linkUp=false;
+                linkState->valid=true;
+                break;
+            case RMH_LINK_STATUS_UP:
+            case RMH_LINK_STATUS_INTERFACE_DOWN:
+                /* The SoC may not know about the interface. It's read from the netlink tracker anyway */
+                linkState->selfEnabled=true;
+                linkState->linkUp=true;
+                linkState->valid=true;
+                break;
+            default:
+                break;
+        }
+    }
+    pthread_mutex_unlock(&linkState->lock);
+}
+
+RMH_Result GENERIC_IMPL__RMH_Self_RefreshLinkStatus(const RMH_Handle handle, RMH_LinkStatus* response) {
+    RMH_LinkState *linkState;
+    RMH_LinkTracking tracking;
+    uint64_t generation;
+    bool selfEnabled=false;
+    bool linkUp=false;
+
+    BRMH_RETURN_IF(handle==NULL, RMH_INVALID_PARAM);
+    BRMH_RETURN_IF(response==NULL, RMH_INVALID_PARAM);
+
+    /* Events must be on their way before the state is read or a change in between would be missed */
+    linkState=&handle->session->linkState;
+    tracking=pRMH_LinkStatus_StartTracking(handle);
+    pthread_mutex_lock(&linkState->lock);
+    generation=linkState->generation;
+    pthread_mutex_unlock(&linkState->lock);
+
+    BRMH_RETURN_IF_FAILED(RMH_Self_GetEnabled(handle, &selfEnabled));
+    if (selfEnabled) {
+        BRMH_RETURN_IF_FAILED(RMH_Self_GetMoCALinkUp(handle, &linkUp));
+    }
+
+    if (tracking == RMH_LINK_TRACKING_ON) {
+        pthread_mutex_lock(&linkState->lock);
+        if (linkState->generation == generation) {
+            linkState->selfEnabled=selfEnabled;
+            linkState->linkUp=linkUp;
+            linkState->valid=true;
+        }
+        pthread_mutex_unlock(&linkState->lock);
+    }
+    return pRMH_LinkStatus_Combine(handle, selfEnabled, linkUp, response);
+}
+
+RMH_Result GENERIC_IMPL__RMH_Self_GetLinkStatus(const RMH_Handle handle, RMH_LinkStatus* response) {
+    RMH_LinkState *linkState;
+    bool valid;
+    bool selfEnabled;
+    bool linkUp;
+
+    BRMH_RETURN_IF(handle==NULL, RMH_INVALID_PARAM);
+    BRMH_RETURN_IF(response==NULL, RMH_INVALID_PARAM);
+
+    linkState=&handle->session->linkState;
+    pthread_mutex_lock(&linkState->lock);
+    valid=linkState->valid;
+    selfEnabled=linkState->selfEnabled;
+    linkUp=linkState->linkUp;
+    pthread_mutex_unlock(&linkState->lock);
+    if (!valid) {
+        return RMH_Self_RefreshLinkStatus(handle, response);
+    }
+    return pRMH_LinkStatus_Combine(handle, selfEnabled, linkUp, response);
+}
+
+/* The SoC doesn't always send an event when told to change the link so read it again next time */
+RMH_Result GENERIC_IMPL__RMH_Self_SetEnabled(const RMH_Handle handle, const bool value) {
+    pRMH_LinkStatus_Invalidate(handle);
+    return RMH_SUCCESS;
+}
+
+RMH_Result GENERIC_IMPL__RMH_Self_RestoreDefaultSettings(const RMH_Handle handle) {
+    pRMH_LinkStatus_Invalidate(handle);
+    return RMH_SUCCESS;
+}
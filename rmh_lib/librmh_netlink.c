@@ -0,0 +1,307 @@
+/*
+ * If not stated otherwise in this file or this component's Licenses.txt file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2016 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/* Define for pipe2 */
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <net/if.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include "librmh.h"
+#include "rdk_moca_hal.h"
+
+/**********************************************************************************************************************
+Keeps whether the MoCA interface is up and running in memory so RMH_Interface_GetEnabled(), and so every
+RMH_Self_GetLinkStatus(), doesn't need a socket and an ioctl.
+
+The tracker of a session subscribes to RTNETLINK link notifications, reads the current state of every link with one
+RTM_GETLINK dump, then leaves a thread waiting for changes. Links are matched by name so the interface being removed
+and created again is followed. Should the kernel drop notifications because the socket fell behind, the state is read
+again with another dump. Every change is raised to the handles of the session as RMH_EVENT_INTERFACE_STATUS_CHANGED.
+
+It's started the first time a handle reads the interface state or asks for RMH_EVENT_INTERFACE_STATUS_CHANGED, and
+stopped when the session is closed. If it can't be started the interface is read with an ioctl on every call as before
+and starting it is tried again after RMH_NETLINK_RETRY_MS. The ioctl is also used while the interface doesn't exist, so
+that still fails, and for good should the thread lose the socket.
+**********************************************************************************************************************/
+#define RMH_NETLINK_BUFFER_SIZE 8192
+#define RMH_NETLINK_DUMP_TIMEOUT_MS 1000
+#define RMH_NETLINK_RETRY_MS (60*1000)
+
+typedef struct RMH_Netlink {
+    RMH_Session *session;
+    int fd;
+    int stopFds[2];                         /* Written to when the thread should exit */
+    pthread_t thread;
+    uint32_t seq;
+    char ifName[IFNAMSIZ];
+    bool found;                             /* The interface exists */
+    bool enabled;                           /* IFF_UP and IFF_RUNNING are set on the interface */
+    bool seenInDump;                        /* The interface was in the dump being read */
+    bool failed;                            /* The thread stopped on an error. The state is no longer followed */
+} RMH_Netlink;
+
+static inline
+uint64_t pRMH_Netlink_NowMs() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000ull + now.tv_nsec / 1000000;
+}
+
+static
+bool pRMH_Netlink_RequestDump(RMH_Netlink *netlink) {
+    struct {
+        struct nlmsghdr nh;
+        struct ifinfomsg ifi;
+    } req;
+
+    memset(&req, 0, sizeof(req));
+    req.nh.nlmsg_len=NLMSG_LENGTH(sizeof(req.ifi));
+    req.nh.nlmsg_type=RTM_GETLINK;
+    req.nh.nlmsg_flags=NLM_F_REQUEST | NLM_F_DUMP;
+    req.nh.nlmsg_seq=++netlink->seq;
+    req.ifi.ifi_family=AF_UNSPEC;
+    netlink->seenInDump=false;
+    return send(netlink->fd, &req, req.nh.nlmsg_len, 0) == req.nh.nlmsg_len;
+}
+
+static
+void pRMH_Netlink_SetState(RMH_Netlink *netlink, const bool found, const bool enabled, const bool notify) {
+    __atomic_store_n(&netlink->found, found, __ATOMIC_RELEASE);
+    if (__atomic_exchange_n(&netlink->enabled, enabled, __ATOMIC_ACQ_REL) != enabled && notify) {
+        RMH_EventData eventData;
+        eventData.RMH_EVENT_INTERFACE_STATUS_CHANGED.enabled=enabled;
+        pRMH_Session_DeliverEvent(netlink->session, RMH_EVENT_INTERFACE_STATUS_CHANGED, &eventData);
+    }
+}
+
+static
+void pRMH_Netlink_HandleLink(RMH_Netlink *netlink, const struct nlmsghdr *nh, const bool notify) {
+    const struct ifinfomsg *ifi=NLMSG_DATA(nh);
+    const struct rtattr *rta=IFLA_RTA(ifi);
+    int rtaLen=IFLA_PAYLOAD(nh);
+    const bool found=(nh->nlmsg_type == RTM_NEWLINK);
+
+    if (nh->nlmsg_len < NLMSG_LENGTH(sizeof(*ifi))) {
+        return;
+    }
+    for (; RTA_OK(rta, rtaLen); rta=RTA_NEXT(rta, rtaLen)) {
+        if (rta->rta_type == IFLA_IFNAME) {
+            break;
+        }
+    }
+    if (!RTA_OK(rta, rtaLen) || strnlen((const char *)RTA_DATA(rta), RTA_PAYLOAD(rta)) != strlen(netlink->ifName) ||
+        strncmp((const char *)RTA_DATA(rta), netlink->ifName, strlen(netlink->ifName)) != 0) {
+        return;
+    }
+
+    netlink->seenInDump |= found;
+    pRMH_Netlink_SetState(netlink, found, found && (ifi->ifi_flags & IFF_UP) && (ifi->ifi_flags & IFF_RUNNING), notify);
+}
+
+/* Handle everything waiting on the socket. Sets *dumpDone at the end of a dump */
+static
+bool pRMH_Netlink_Read(RMH_Netlink *netlink, const bool notify, bool *dumpDone) {
+    char buf[RMH_NETLINK_BUFFER_SIZE] __attribute__((aligned(NLMSG_ALIGNTO)));
+    const struct nlmsghdr *nh;
+    ssize_t len;
+
+    len=recv(netlink->fd, buf, sizeof(buf), MSG_DONTWAIT);
+    if (len < 0) {
+        if (errno == ENOBUFS) {
+            /* Notifications were lost, read everything again */
+            return pRMH_Netlink_RequestDump(netlink);
+        }
+        return errno == EAGAIN || errno == EINTR;
+    }
+    for (nh=(const struct nlmsghdr *)buf; NLMSG_OK(nh, len); nh=NLMSG_NEXT(nh, len)) {
+        switch (nh->nlmsg_type) {
+            case NLMSG_DONE:
+            case NLMSG_ERROR:
+                if (nh->nlmsg_seq == netlink->seq) {
+                    /* Its removal may have been in the notifications which were lost */
+                    if (!netlink->seenInDump) {
+                        pRMH_Netlink_SetState(netlink, false, false, notify);
+                    }
+                    if (dumpDone) *dumpDone=true;
+                }
+                break;
+            case RTM_NEWLINK:
+            case RTM_DELLINK:
+                pRMH_Netlink_HandleLink(netlink, nh, notify);
+                break;
+            default:
+                break;
+        }
+    }
+    return true;
+}
+
+static
+void* pRMH_Netlink_Thread(void *context) {
+    RMH_Netlink *netlink=(RMH_Netlink *)context;
+    const RMH_Handle handle=NULL;           /* Not tied to one handle of the session. Logged as if it had none */
+    struct pollfd fds[2];
+
+    fds[0].fd=netlink->fd;
+    fds[0].events=POLLIN;
+    fds[1].fd=netlink->stopFds[0];
+    fds[1].events=POLLIN;
+    while (true) {
+        if (poll(fds, 2, -1) < 0 && errno != EINTR) {
+            break;
+        }
+        if (fds[1].revents) {
+            return NULL;
+        }
+        if ((fds[0].revents & (POLLERR | POLLHUP | POLLNVAL)) ||
+            ((fds[0].revents & POLLIN) && !pRMH_Netlink_Read(netlink, true, NULL))) {
+            break;
+        }
+    }
+    RMH_PrintErr("Lost the RTNETLINK socket. The interface will be read with an ioctl and RMH_EVENT_INTERFACE_STATUS_CHANGED will not be sent\n");
+    __atomic_store_n(&netlink->failed, true, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+static
+void pRMH_Netlink_Free(RMH_Netlink *netlink) {
+    if (netlink->fd >= 0) close(netlink->fd);
+    if (netlink->stopFds[0] >= 0) close(netlink->stopFds[0]);
+    if (netlink->stopFds[1] >= 0) close(netlink->stopFds[1]);
+    free(netlink);
+}
+
+static
+RMH_Netlink* pRMH_Netlink_Open(const RMH_Handle handle, const char *ifName) {
+    struct sockaddr_nl addr;
+    RMH_Netlink *netlink;
+    bool dumpDone=false;
+    struct pollfd pfd;
+
+    netlink=calloc(1, sizeof(*netlink));
+    BRMH_RETURN_IF(netlink==NULL, NULL);
+    netlink->session=handle->session;
+    netlink->stopFds[0]=netlink->stopFds[1]=-1;
+    snprintf(netlink->ifName, sizeof(netlink->ifName), "%s", ifName);
+
+    netlink->fd=socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+    memset(&addr, 0, sizeof(addr));
+    addr.nl_family=AF_NETLINK;
+    addr.nl_groups=RTMGRP_LINK;
+    if (netlink->fd < 0 || bind(netlink->fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+        pipe2(netlink->stopFds, O_CLOEXEC) != 0 || !pRMH_Netlink_RequestDump(netlink)) {
+        RMH_PrintWrn("Unable to listen for link changes on RTNETLINK [%s]\n", strerror(errno));
+        pRMH_Netlink_Free(netlink);
+        return NULL;
+    }
+
+    /* Read the current state before returning so the first RMH_Interface_GetEnabled() has it */
+    pfd.fd=netlink->fd;
+    pfd.events=POLLIN;
+    while (!dumpDone) {
+        if (poll(&pfd, 1, RMH_NETLINK_DUMP_TIMEOUT_MS) <= 0 || !pRMH_Netlink_Read(netlink, false, &dumpDone)) {
+            RMH_PrintWrn("No reply to the RTNETLINK link dump\n");
+            pRMH_Netlink_Free(netlink);
+            return NULL;
+        }
+    }
+    if (!netlink->found) {
+        RMH_PrintWrn("The interface '%s' doesn't exist. Reading its state will fail until it does\n", netlink->ifName);
+    }
+
+    if (pthread_create(&netlink->thread, NULL, pRMH_Netlink_Thread, netlink) != 0) {
+        RMH_PrintErr("Unable to start the RTNETLINK thread!\n");
+        pRMH_Netlink_Free(netlink);
+        return NULL;
+    }
+    RMH_PrintTrace("Tracking interface '%s' with RTNETLINK. It's %s\n", netlink->ifName, netlink->enabled ? "enabled" : "disabled");
+    return netlink;
+}
+
+__attribute__((visibility("hidden")))
+RMH_Result pRMH_Netlink_Start(const RMH_Handle handle) {
+    RMH_Session *session=handle->session;
+    RMH_Netlink *netlink;
+    RMH_Netlink *expected=NULL;
+    char ifName[IFNAMSIZ];
+    RMH_Result ret;
+
+    if (__atomic_load_n(&session->netlink, __ATOMIC_ACQUIRE)) {
+        return RMH_SUCCESS;
+    }
+    if (pRMH_Netlink_NowMs() < __atomic_load_n(&session->netlinkRetryMs, __ATOMIC_RELAXED)) {
+        return RMH_NOT_SUPPORTED;
+    }
+    ret=RMH_Interface_GetName(handle, ifName, sizeof(ifName));
+    if (ret != RMH_SUCCESS) {
+        return ret;
+    }
+    netlink=pRMH_Netlink_Open(handle, ifName);
+    if (!netlink) {
+        __atomic_store_n(&session->netlinkRetryMs, pRMH_Netlink_NowMs() + RMH_NETLINK_RETRY_MS, __ATOMIC_RELAXED);
+        return RMH_NOT_SUPPORTED;
+    }
+
+    /* Another handle of the session may have got here first */
+    if (!__atomic_compare_exchange_n(&session->netlink, &expected, netlink, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        if (write(netlink->stopFds[1], "x", 1) == 1) {
+            pthread_join(netlink->thread, NULL);
+        }
+        pRMH_Netlink_Free(netlink);
+    }
+    return RMH_SUCCESS;
+}
+
+/* Returns false if the tracker isn't running or the interface doesn't exist, in which case the caller must ask the kernel */
+__attribute__((visibility("hidden")))
+bool pRMH_Netlink_GetEnabled(const RMH_Handle handle, bool *enabled) {
+    RMH_Netlink *netlink=__atomic_load_n(&handle->session->netlink, __ATOMIC_ACQUIRE);
+
+    if (!netlink && pRMH_Netlink_Start(handle) == RMH_SUCCESS) {
+        netlink=__atomic_load_n(&handle->session->netlink, __ATOMIC_ACQUIRE);
+    }
+    if (!netlink || __atomic_load_n(&netlink->failed, __ATOMIC_ACQUIRE) || !__atomic_load_n(&netlink->found, __ATOMIC_ACQUIRE)) {
+        return false;
+    }
+    *enabled=__atomic_load_n(&netlink->enabled, __ATOMIC_ACQUIRE);
+    return true;
+}
+
+__attribute__((visibility("hidden")))
+void pRMH_Netlink_Stop(RMH_Session *session) {
+    RMH_Netlink *netlink=session->netlink;
+
+    if (netlink) {
+        if (write(netlink->stopFds[1], "x", 1) == 1) {
+            pthread_join(netlink->thread, NULL);
+        }
+        else {
+            pthread_cancel(netlink->thread);
+            pthread_join(netlink->thread, NULL);
+        }
+        pRMH_Netlink_Free(netlink);
+        session->netlink=NULL;
+    }
+}
@@ -0,0 +1,296 @@
+/*
+ * If not stated otherwise in this file or this component's Licenses.txt file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2016 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/inotify.h>
+#include "librmh.h"
+#include "rdk_moca_hal.h"
+#include "rfcapi.h"
+
+/**********************************************************************************************************************
+getRFCParameter() may block on the RFC backend for a long time so RMH doesn't call it for every lookup. Every parameter
+in RMH_RFC_PARAMS is read in one pass the first time any is needed, parsed to its type and kept for the whole process.
+Lookups are then served from memory.
+
+The parameters are read again when RDK_RFC_FILE changes, which is noticed with inotify on its directory so the file
+being replaced is seen too, or once they're RMH_RFC_REFRESH_INTERVAL_MS old. The lookup which notices starts a thread to
+do it and, like every lookup until it's done, returns the values already read. Only the very first read is waited for.
+RFC is never called with the lock held. Should RFC fail while reading them again the previous value is kept and its age
+shows how stale it is.
+**********************************************************************************************************************/
+#define RDK_RFC_FILE_DIR                        "/etc"
+#define RDK_RFC_FILE_NAME                       "rfc.properties"
+#define RDK_RFC_FILE                            RDK_RFC_FILE_DIR "/" RDK_RFC_FILE_NAME
+#define RMH_RFC_REFRESH_INTERVAL_MS             (5*60*1000)
+
+/*      Name                                    Type */
+#define RMH_RFC_PARAMS \
+    RMH_RFC_PARAM(RMH_RFC_PREFERRED_NC_ENABLE,  RMH_RFC_TYPE_BOOL) \
+    RMH_RFC_PARAM(RMH_RFC_LOGGING_ENABLE,       RMH_RFC_TYPE_BOOL)
+
+typedef struct RMH_RFCParam {
+    const char *name;
+    RMH_RFCType type;
+    bool valid;                             /* Set in RFC with a value which could be parsed */
+    uint64_t readNs;                        /* CLOCK_MONOTONIC time the value was read */
+    bool boolValue;
+    int32_t intValue;
+    char stringValue[RMH_MAX_RFC_VALUE_LEN];
+} RMH_RFCParam;
+
+#define RMH_RFC_PARAM(NAME, TYPE) { NAME, TYPE },
+static RMH_RFCParam hRMHGeneric_RFCParams[] = { RMH_RFC_PARAMS };
+#undef RMH_RFC_PARAM
+#define RMH_RFC_NUM_PARAMS (sizeof(hRMHGeneric_RFCParams)/sizeof(hRMHGeneric_RFCParams[0]))
+
+static pthread_mutex_t hRMHGeneric_RFCLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t hRMHGeneric_RFCLoadDone = PTHREAD_COND_INITIALIZER;
+static bool hRMHGeneric_RFCLoaded;
+static bool hRMHGeneric_RFCLoading;            /* Set while a thread reads RFC. Only one does at a time */
+static bool hRMHGeneric_RFCFileChanged;         /* RDK_RFC_FILE changed since the last read started */
+static uint64_t hRMHGeneric_RFCLoadedNs;
+static int hRMHGeneric_RFCWatchFd = -1;
+static bool hRMHGeneric_RFCWatchUnavailable;
+
+static inline
+uint64_t pRMH_RFC_NowNs() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000000000ull + now.tv_nsec;
+}
+
+static
+bool pRMH_RFC_Parse(const RMH_Handle handle, RMH_RFCParam *param, const char *value) {
+    const size_t valueLen=strlen(value);
+    char *end;
+    long intValue;
+
+    if (valueLen >= RMH_MAX_RFC_VALUE_LEN) {
+        RMH_PrintErr("Unexpected value reading from RFC -- %s -- Returned %zu characters. Expecting less than %d\n", param->name, valueLen, RMH_MAX_RFC_VALUE_LEN);
+        return false;
+    }
+
+    switch (param->type) {
+        case RMH_RFC_TYPE_BOOL:
+            /* There are cases where RFC type might not be set correctly. To be sure of our value we'll explictly test both values. */
+            if (strcasecmp(value, "TRUE") == 0) {
+                param->boolValue=true;
+            }
+            else if (strcasecmp(value, "FALSE") == 0) {
+                param->boolValue=false;
+            }
+            else {
+                RMH_PrintErr("Unexpected value reading from RFC -- %s -- Returned '%s'. Expecting TRUE or FALSE\n", param->name, value);
+                return false;
+            }
+            break;
+        case RMH_RFC_TYPE_INT:
+            errno=0;
+            intValue=strtol(value, &end, 0);
+            if (errno || end == value || *end != '\0' || intValue < INT32_MIN || intValue > INT32_MAX) {
+                RMH_PrintErr("Unexpected value reading from RFC -- %s -- Returned '%s'. Expecting an integer\n", param->name, value);
+                return false;
+            }
+            param->intValue=(int32_t)intValue;
+            break;
+        default:
+            break;
+    }
+    memcpy(param->stringValue, value, valueLen+1);
+    return true;
+}
+
+/* Read every parameter from RFC into a copy which replaces them once done. Called without the lock by the one thread
+   which set hRMHGeneric_RFCLoading */
+static
+void pRMH_RFC_Load(const RMH_Handle handle) {
+    RMH_RFCParam params[RMH_RFC_NUM_PARAMS];
+    RFC_ParamData_t rfcParam;
+    WDMP_STATUS wdmpStatus;
+    uint32_t i;
+
+    pthread_mutex_lock(&hRMHGeneric_RFCLock);
+    memcpy(params, hRMHGeneric_RFCParams, sizeof(params));
+    pthread_mutex_unlock(&hRMHGeneric_RFCLock);
+
+    for (i=0; i < RMH_RFC_NUM_PARAMS; i++) {
+        RMH_RFCParam *param=&params[i];
+
+        memset(&rfcParam, 0, sizeof(rfcParam));
+        wdmpStatus = getRFCParameter("RMH", param->name, &rfcParam);
+        if (wdmpStatus == WDMP_ERR_VALUE_IS_EMPTY) {
+            param->valid=false;
+            param->readNs=pRMH_RFC_NowNs();
+        }
+        else if (wdmpStatus != WDMP_SUCCESS) {
+            /* Keep whatever we had, including when it was read. Its age will say it's getting old */
+            RMH_PrintErr("Failed reading from RFC -- %s -- Returned error '%s' (%u)\n", param->name, getRFCErrorString(wdmpStatus), wdmpStatus);
+        }
+        else {
+            param->valid=pRMH_RFC_Parse(handle, param, rfcParam.value);
+            param->readNs=pRMH_RFC_NowNs();
+        }
+    }
+
+    pthread_mutex_lock(&hRMHGeneric_RFCLock);
+    memcpy(hRMHGeneric_RFCParams, params, sizeof(params));
+    hRMHGeneric_RFCLoaded=true;
+    hRMHGeneric_RFCLoadedNs=pRMH_RFC_NowNs();
+    hRMHGeneric_RFCLoading=false;
+    pthread_cond_broadcast(&hRMHGeneric_RFCLoadDone);
+    pthread_mutex_unlock(&hRMHGeneric_RFCLock);
+}
+
+static
+void* pRMH_RFC_LoadThread(void *context) {
+    RMH* handle=NULL;
+    pRMH_RFC_Load(handle);
+    return NULL;
+}
+
+/* Read every parameter again in the background. Returns false if the thread couldn't be started */
+static
+bool pRMH_RFC_StartLoadThread(const RMH_Handle handle) {
+    pthread_attr_t attr;
+    pthread_t thread;
+    int err;
+
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    err=pthread_create(&thread, &attr, pRMH_RFC_LoadThread, NULL);
+    pthread_attr_destroy(&attr);
+    if (err != 0) {
+        RMH_PrintWrn("Unable to start a thread to read RFC [%s]. Reading it now instead\n", strerror(err));
+        return false;
+    }
+    return true;
+}
+
+/* Returns true if RDK_RFC_FILE changed since the last call. Called with the lock held */
+static
+bool pRMH_RFC_FileChanged(const RMH_Handle handle) {
+    char buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    const struct inotify_event *event;
+    bool changed=false;
+    ssize_t len;
+    char *pos;
+
+    if (hRMHGeneric_RFCWatchFd < 0) {
+        if (hRMHGeneric_RFCWatchUnavailable) {
+            return false;
+        }
+        hRMHGeneric_RFCWatchFd=inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (hRMHGeneric_RFCWatchFd < 0 ||
+            inotify_add_watch(hRMHGeneric_RFCWatchFd, RDK_RFC_FILE_DIR, IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE) < 0) {
+            RMH_PrintDbg("Unable to watch '%s' [%s]. RFC will only be read every %u seconds\n", RDK_RFC_FILE, strerror(errno), RMH_RFC_REFRESH_INTERVAL_MS/1000);
+            if (hRMHGeneric_RFCWatchFd >= 0) close(hRMHGeneric_RFCWatchFd);
+            hRMHGeneric_RFCWatchFd=-1;
+            hRMHGeneric_RFCWatchUnavailable=true;
+        }
+        return false;
+    }
+
+    while ((len=read(hRMHGeneric_RFCWatchFd, buf, sizeof(buf))) > 0) {
+        for (pos=buf; pos < buf + len; pos+=sizeof(struct inotify_event) + event->len) {
+            event=(const struct inotify_event *)pos;
+            if ((event->mask & IN_Q_OVERFLOW) || (event->len && strcmp(event->name, RDK_RFC_FILE_NAME) == 0)) {
+                changed=true;
+            }
+        }
+    }
+    return changed;
+}
+
+static
+RMH_Result pRMH_RFC_Lookup(const RMH_Handle handle, const char *name, RMH_RFCValue *response) {
+    RMH_RFCParam *param=NULL;
+    RMH_Result ret=RMH_FAILURE;
+    uint64_t now;
+    uint32_t i;
+
+    for (i=0; i < RMH_RFC_NUM_PARAMS; i++) {
+        if (strcmp(hRMHGeneric_RFCParams[i].name, name) == 0) {
+            param=&hRMHGeneric_RFCParams[i];
+            break;
+        }
+    }
+    if (!param) {
+        return RMH_INVALID_ID;
+    }
+
+    pthread_mutex_lock(&hRMHGeneric_RFCLock);
+    now=pRMH_RFC_NowNs();
+    /* Always check the file so a change made before we were loaded isn't reported again afterwards */
+    if (pRMH_RFC_FileChanged(handle)) {
+        hRMHGeneric_RFCFileChanged=true;
+    }
+    if (!hRMHGeneric_RFCLoading && (hRMHGeneric_RFCFileChanged || !hRMHGeneric_RFCLoaded ||
+        now - hRMHGeneric_RFCLoadedNs >= RMH_RFC_REFRESH_INTERVAL_MS * 1000000ull)) {
+        hRMHGeneric_RFCFileChanged=false;
+        hRMHGeneric_RFCLoading=true;
+        if (!hRMHGeneric_RFCLoaded || !pRMH_RFC_StartLoadThread(handle)) {
+            /* There's nothing to return until the first read is done so that one is waited for */
+            pthread_mutex_unlock(&hRMHGeneric_RFCLock);
+            pRMH_RFC_Load(handle);
+            pthread_mutex_lock(&hRMHGeneric_RFCLock);
+        }
+    }
+    while (!hRMHGeneric_RFCLoaded) {
+        pthread_cond_wait(&hRMHGeneric_RFCLoadDone, &hRMHGeneric_RFCLock);
+    }
+    now=pRMH_RFC_NowNs();
+    if (param->valid) {
+        response->type=param->type;
+        response->boolValue=param->boolValue;
+        response->intValue=param->intValue;
+        snprintf(response->stringValue, sizeof(response->stringValue), "%s", param->stringValue);
+        response->ageMs=(now - param->readNs)/1000000;
+        ret=RMH_SUCCESS;
+    }
+    pthread_mutex_unlock(&hRMHGeneric_RFCLock);
+    return ret;
+}
+
+/* Returns RMH_FAILURE if the parameter isn't set so the caller keeps its default */
+__attribute__((visibility("hidden")))
+RMH_Result pRMH_RFC_GetBool(const RMH_Handle handle, const char *name, bool *value) {
+    RMH_RFCValue rfcValue;
+    RMH_Result ret;
+
+    ret=pRMH_RFC_Lookup(handle, name, &rfcValue);
+    if (ret != RMH_SUCCESS) {
+        return ret;
+    }
+    if (rfcValue.type != RMH_RFC_TYPE_BOOL) {
+        RMH_PrintErr("RFC parameter %s isn't a boolean\n", name);
+        return RMH_INVALID_PARAM;
+    }
+    *value=rfcValue.boolValue;
+    return RMH_SUCCESS;
+}
+
+RMH_Result RMH_RFC_Get(const char* name, RMH_RFCValue* response) {
+    RMH* handle=NULL;
+
+    BRMH_RETURN_IF(name==NULL, RMH_INVALID_PARAM);
+    BRMH_RETURN_IF(response==NULL, RMH_INVALID_PARAM);
+    return pRMH_RFC_Lookup(handle, name, response);
+}
@@ -0,0 +1,329 @@
+/*
+ * If not stated otherwise in this file or this component's Licenses.txt file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2016 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include <pthread.h>
+#include "librmh.h"
+#include "rdk_moca_hal.h"
+
+/**********************************************************************************************************************
+A session is one open SoC library, the SoC handle created from it and the table of SoC APIs resolved from it. Opening
+one costs a dlopen, a few hundred dlsym and the SoC initialization so every handle in the process shares a single
+reference counted session. It's opened by the first RMH_Initialize and closed by the RMH_Destroy of the last handle
+using it. A handle created with RMH_INIT_FLAG_PRIVATE_SESSION gets a session of its own instead.
+
+The SoC only knows of the session so it sends events to pRMH_Session_EventCallback() which passes them on to every
+handle that asked for them. The SoC is asked for the union of the events wanted by all the handles of the session, plus
+those needed to keep the cache of a handle up to date.
+
+The session also keeps the link status, see librmh_link_status.c, so it's given every event first.
+
+RMH_EVENT_INTERFACE_STATUS_CHANGED isn't sent by the SoC. It's raised by the netlink tracker of the session and passed
+on in the same way.
+**********************************************************************************************************************/
+static pthread_mutex_t hRMHGeneric_SharedSessionLock = PTHREAD_MUTEX_INITIALIZER;
+static RMH_Session *hRMHGeneric_SharedSession;
+static __thread RMH_Session *hRMHGeneric_DeliveringSession;  /* Set while this thread runs the callbacks of a session */
+
+typedef struct RMH_SessionEventTarget {
+    RMH_EventCallback eventCB;
+    void* userContext;
+} RMH_SessionEventTarget;
+
+/* Pass an event from the SoC, or raised by the library itself, to every handle of the session. The callbacks are
+   copied under handlesLock but called without it so they are free to make any RMH call, even RMH_Destroy */
+__attribute__((visibility("hidden")))
+void pRMH_Session_DeliverEvent(RMH_Session *session, const RMH_Event event, const RMH_EventData *eventData) {
+    RMH_Session *outerSession=hRMHGeneric_DeliveringSession;
+    uint32_t numTargets=0;
+    uint32_t i;
+    RMH *handle;
+
+    pRMH_LinkStatus_HandleEvent(session, event, eventData);
+    pthread_rwlock_rdlock(&session->handlesLock);
+    {
+        RMH_SessionEventTarget targets[session->numHandles ? session->numHandles : 1];
+
+        for (handle=session->handles; handle; handle=handle->nextInSession) {
+            if (__atomic_load_n(&handle->cacheEnabled, __ATOMIC_ACQUIRE)) {
+                pRMH_Cache_HandleEvent(handle, event, eventData);
+            }
+            if (handle->eventCB && (handle->eventNotifyBitMask & event) == event) {
+                targets[numTargets].eventCB=handle->eventCB;
+                targets[numTargets].userContext=handle->eventCBUserContext;
+                numTargets++;
+            }
+        }
+        if (numTargets == 0) {
+            pthread_rwlock_unlock(&session->handlesLock);
+            return;
+        }
+        pthread_mutex_lock(&session->deliveryLock);
+        session->numDeliveries++;
+        pthread_mutex_unlock(&session->deliveryLock);
+        pthread_rwlock_unlock(&session->handlesLock);
+
+        hRMHGeneric_DeliveringSession=session;
+        for (i=0; i < numTargets; i++) {
+            targets[i].eventCB(event, eventData, targets[i].userContext);
+        }
+        hRMHGeneric_DeliveringSession=outerSession;
+    }
+    pthread_mutex_lock(&session->deliveryLock);
+    if (--session->numDeliveries == 0) {
+        pthread_cond_broadcast(&session->deliveryDone);
+    }
+    pthread_mutex_unlock(&session->deliveryLock);
+}
+
+/* Wait for the callbacks already copied by pRMH_Session_DeliverEvent() to return */
+static
+void pRMH_Session_WaitForDeliveries(RMH_Session *session) {
+    pthread_mutex_lock(&session->deliveryLock);
+    while (session->numDeliveries) {
+        pthread_cond_wait(&session->deliveryDone, &session->deliveryLock);
+    }
+    pthread_mutex_unlock(&session->deliveryLock);
+}
+
+static
+void pRMH_Session_EventCallback(const enum RMH_Event event, const struct RMH_EventData *eventData, void* userContext) {
+    pRMH_Session_DeliverEvent((RMH_Session *)userContext, event, eventData);
+}
+
+static
+void pRMH_Session_Close(RMH_Session *session) {
+    pRMH_Netlink_Stop(session);
+    if (session->socHandle && session->socDestroy) {
+        session->socDestroy(session->socHandle);
+    }
+    /* Nothing raises events any more but some may still be in a callback */
+    pRMH_Session_WaitForDeliveries(session);
+    if (session->soclib) {
+        dlclose(session->soclib);
+    }
+    pthread_cond_destroy(&session->deliveryDone);
+    pthread_mutex_destroy(&session->deliveryLock);
+    pthread_rwlock_destroy(&session->handlesLock);
+    pthread_mutex_destroy(&session->linkState.lock);
+    pthread_mutex_destroy(&session->eventLock);
+    pthread_mutex_destroy(&session->socLock);
+    free(session);
+}
+
+static
+RMH_Session* pRMH_Session_Open(const RMH_Handle handle, const bool shared) {
+    RMH_Session *session=calloc(1, sizeof(*session));
+    pthread_mutexattr_t socLockAttr;
+    int socLockErr;
+
+    BRMH_RETURN_IF(session==NULL, NULL);
+    session->shared=shared;
+
+    /* The SoC may raise an event, or RMH_EVENT_DRIVER_PRINT, before a call returns. The callback then runs on the
+       thread holding socLock and must still be able to make RMH calls */
+    pthread_mutexattr_init(&socLockAttr);
+    pthread_mutexattr_settype(&socLockAttr, PTHREAD_MUTEX_RECURSIVE);
+    socLockErr=pthread_mutex_init(&session->socLock, &socLockAttr);
+    pthread_mutexattr_destroy(&socLockAttr);
+    if (socLockErr != 0 ||
+        pthread_mutex_init(&session->eventLock, NULL) != 0 ||
+        pthread_mutex_init(&session->linkState.lock, NULL) != 0 ||
+        pthread_mutex_init(&session->deliveryLock, NULL) != 0 ||
+        pthread_cond_init(&session->deliveryDone, NULL) != 0 ||
+        pthread_rwlock_init(&session->handlesLock, NULL) != 0) {
+        RMH_PrintErr("Unable to create the session locks!\n");
+        free(session);
+        return NULL;
+    }
+
+    session->soclib = dlopen("librdkmocahalsoc.so.0", RTLD_LAZY);
+    if (session->soclib) {
+        const uint32_t *socCapabilities;
+        char *dlErr = dlerror(); /* Check error first to clear it out */
+        RMH_Handle (*apiFunc)() = dlsym(session->soclib, "RMH_Initialize");
+        dlErr = dlerror();
+        if (dlErr) {
+            RMH_PrintTrace("Error 'RMH_Initialize' in dlopen: '%s'. APIs will return RMH_INVALID_INTERNAL_STATE!\n", dlErr);
+        }
+        else if (!apiFunc) {
+            RMH_PrintErr("Unable to find 'RMH_Initialize' in SoC library! APIs will return RMH_INVALID_INTERNAL_STATE!\n");
+        }
+        else {
+            session->socHandle = apiFunc(pRMH_Session_EventCallback, session);
+            if (!session->socHandle) {
+                RMH_PrintErr("Failed when initializing the SoC MoCA Hal!\n");
+                pRMH_Session_Close(session);
+                return NULL;
+            }
+        }
+        pRMH_APIWRAP_LoadSoCAPIs(handle, session);
+        session->socDestroy=(RMH_Result (*)(RMH_Handle))session->socAPI[RMH_API_ID__RMH_Destroy];
+        session->socSetEventCallbacks=(RMH_Result (*)(RMH_Handle, const uint32_t))session->socAPI[RMH_API_ID__RMH_SetEventCallbacks];
+
+        /* Calls into a shared session can come from any thread. Unless the SoC library says it can be called from many
+           threads at once we must do one call at a time */
+        socCapabilities=dlsym(session->soclib, RMH_SOC_CAPABILITIES_SYMBOL);
+        session->socLockRequired=(shared || (handle->flags & RMH_INIT_FLAG_THREAD_SAFE)) &&
+                                 (!socCapabilities || !(*socCapabilities & RMH_SOC_CAP_THREAD_SAFE));
+    }
+    else {
+        RMH_PrintWrn("Failed to open the SoC library 'librdkmocahalsoc.so.0', all MoCA APIs will return RMH_UNIMPLEMENTED!  Please ensure it's properly installed on this system\n");
+    }
+    pRMH_APIWRAP_ListUnimplementedAPIs(session);
+    RMH_PrintTrace("Opened %s session:0x%p socHandle:0x%p. SoC calls %s serialized\n", shared ? "shared" : "private",
+                                                session, session->socHandle, session->socLockRequired ? "are" : "are not");
+    return session;
+}
+
+/* Ask the SoC for every event wanted by any handle of the session */
+static
+RMH_Result pRMH_Session_SetSoCEventCallbacks(RMH_Session *session) {
+    uint32_t events=0;
+    RMH_Result ret;
+    RMH *sessionHandle;
+
+    if (!session->socSetEventCallbacks) {
+        return RMH_UNIMPLEMENTED;
+    }
+    if (!session->socHandle) {
+        return RMH_INVALID_INTERNAL_STATE;
+    }
+    pthread_mutex_lock(&session->eventLock);
+    pthread_rwlock_rdlock(&session->handlesLock);
+    for (sessionHandle=session->handles; sessionHandle; sessionHandle=sessionHandle->nextInSession) {
+        events |= sessionHandle->eventNotifyBitMask;
+        if (__atomic_load_n(&sessionHandle->cacheEnabled, __ATOMIC_RELAXED)) {
+            events |= hRMHGeneric_CacheEvents;
+        }
+    }
+    if (__atomic_load_n(&session->linkState.tracking, __ATOMIC_RELAXED) != RMH_LINK_TRACKING_OFF) {
+        events |= RMH_LINK_STATUS_EVENTS;
+    }
+    /* Raised by the library, not the SoC */
+    events &= ~RMH_EVENT_INTERFACE_STATUS_CHANGED;
+    pthread_rwlock_unlock(&session->handlesLock);
+    if (session->socLockRequired) {
+        pthread_mutex_lock(&session->socLock);
+    }
+    ret=session->socSetEventCallbacks(session->socHandle, events);
+    if (session->socLockRequired) {
+        pthread_mutex_unlock(&session->socLock);
+    }
+    pthread_mutex_unlock(&session->eventLock);
+    return ret;
+}
+
+__attribute__((visibility("hidden")))
+RMH_Result pRMH_Session_UpdateEventCallbacks(const RMH_Handle handle) {
+    return pRMH_Session_SetSoCEventCallbacks(handle->session);
+}
+
+/* Attach a new handle to the shared session, or a private one if requested, opening it if needed */
+__attribute__((visibility("hidden")))
+RMH_Session* pRMH_Session_Acquire(const RMH_Handle handle) {
+    RMH_Session *session;
+
+    if (handle->flags & RMH_INIT_FLAG_PRIVATE_SESSION) {
+        session=pRMH_Session_Open(handle, false);
+    }
+    else {
+        pthread_mutex_lock(&hRMHGeneric_SharedSessionLock);
+        if (!hRMHGeneric_SharedSession) {
+            hRMHGeneric_SharedSession=pRMH_Session_Open(handle, true);
+        }
+        session=hRMHGeneric_SharedSession;
+        if (session) {
+            session->refCount++;
+        }
+        pthread_mutex_unlock(&hRMHGeneric_SharedSessionLock);
+    }
+    if (!session) {
+        return NULL;
+    }
+
+    handle->session=session;
+    handle->handle=session->socHandle;
+    handle->socAPI=session->socAPI;
+    pthread_rwlock_wrlock(&session->handlesLock);
+    handle->nextInSession=session->handles;
+    session->handles=handle;
+    session->numHandles++;
+    pthread_rwlock_unlock(&session->handlesLock);
+    return session;
+}
+
+static
+void* pRMH_Session_CloseThread(void *context) {
+    pRMH_Session_Close((RMH_Session *)context);
+    return NULL;
+}
+
+/* Detach a handle from its session. The session is closed once no handle uses it. Neither is done while holding
+   hRMHGeneric_SharedSessionLock so a callback of another handle can still call RMH_Initialize or RMH_Destroy */
+__attribute__((visibility("hidden")))
+void pRMH_Session_Release(const RMH_Handle handle) {
+    RMH_Session *session=handle->session;
+    const bool inCallback=(hRMHGeneric_DeliveringSession == session);
+    RMH **sessionHandle;
+    pthread_attr_t attr;
+    pthread_t thread;
+
+    pthread_rwlock_wrlock(&session->handlesLock);
+    for (sessionHandle=&session->handles; *sessionHandle; sessionHandle=&(*sessionHandle)->nextInSession) {
+        if (*sessionHandle == handle) {
+            *sessionHandle=handle->nextInSession;
+            session->numHandles--;
+            break;
+        }
+    }
+    pthread_rwlock_unlock(&session->handlesLock);
+    handle->session=NULL;
+
+    /* The callback of the handle may have been copied just before it was removed. Once this returns it won't be
+       called again. Waiting from inside a callback of the session would never end */
+    if (!inCallback) {
+        pRMH_Session_WaitForDeliveries(session);
+    }
+
+    if (session->shared) {
+        if (handle->eventNotifyBitMask) {
+            /* Stop the SoC sending events only this handle wanted. Our reference keeps the session open while we do */
+            pRMH_Session_SetSoCEventCallbacks(session);
+        }
+        pthread_mutex_lock(&hRMHGeneric_SharedSessionLock);
+        if (--session->refCount != 0) {
+            pthread_mutex_unlock(&hRMHGeneric_SharedSessionLock);
+            return;
+        }
+        hRMHGeneric_SharedSession=NULL;
+        pthread_mutex_unlock(&hRMHGeneric_SharedSessionLock);
+    }
+
+    if (!inCallback) {
+        pRMH_Session_Close(session);
+        return;
+    }
+    /* The thread delivering the event must return to the SoC, or to the netlink tracker, before they are stopped */
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    if (pthread_create(&thread, &attr, pRMH_Session_CloseThread, session) != 0) {
+        RMH_PrintErr("Unable to start a thread to close the session 0x%p. It's left open\n", session);
+    }
+    pthread_attr_destroy(&attr);
+}
@@ -0,0 +1,228 @@
+/*
+ * If not stated otherwise in this file or this component's Licenses.txt file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2016 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "librmh.h"
+#include "rdk_moca_hal.h"
+
+/**********************************************************************************************************************
+One process, usually rmh_monitor, publishes the status in a POSIX shared memory object so any number of others can read
+it without each polling the SoC. The object holds one RMH_ShmPage guarded by a sequence lock. The publisher makes the
+sequence odd, copies in the status and makes it even again. A reader copies the status out between two reads of the
+sequence and keeps the copy only if the sequence was even and didn't change. Readers never write to the page, so they
+map it read only, and the publisher never waits for them.
+
+The header is written before 'magic' so a reader which sees the magic can trust the rest of it. 'statusSize' rejects
+readers built against a different RMH_ShmStatus.
+**********************************************************************************************************************/
+#define RMH_SHM_MAGIC                           0x524d4853
+#define RMH_SHM_VERSION                         1
+#define RMH_SHM_READ_MAX_ATTEMPTS               1000
+
+typedef struct RMH_ShmPage {
+    uint32_t magic;                         /* RMH_SHM_MAGIC once the header is set */
+    uint32_t version;                       /* RMH_SHM_VERSION of the publisher */
+    uint32_t statusSize;                    /* sizeof(RMH_ShmStatus) of the publisher */
+    uint32_t reserved;
+    uint64_t sequence;                      /* Odd while 'status' is being written. Twice the times it was published */
+    RMH_ShmStatus status;
+} RMH_ShmPage;
+
+struct RMH_Shm {
+    RMH_ShmPage *page;
+    bool publisher;                         /* Set if created with RMH_Shm_Create. The object is removed on close */
+    char name[NAME_MAX+1];
+};
+
+static
+RMH_Result pRMH_Shm_Alloc(const char* name, RMH_ShmHandle* response) {
+    RMH_ShmHandle shm;
+
+    if (!response) {
+        return RMH_INVALID_PARAM;
+    }
+    if (!name) {
+        name=RMH_SHM_DEFAULT_NAME;
+    }
+    if (name[0] != '/' || strlen(name) >= sizeof(shm->name)) {
+        return RMH_INVALID_PARAM;
+    }
+
+    shm=calloc(1, sizeof(*shm));
+    if (!shm) {
+        return RMH_FAILURE;
+    }
+    strcpy(shm->name, name);
+    *response=shm;
+    return RMH_SUCCESS;
+}
+
+RMH_Result RMH_Shm_Open(const char* name, RMH_ShmHandle* response) {
+    RMH_ShmHandle shm;
+    struct stat st;
+    void *map;
+    int fd;
+    RMH_Result ret;
+
+    ret=pRMH_Shm_Alloc(name, &shm);
+    if (ret != RMH_SUCCESS) {
+        return ret;
+    }
+
+    fd=shm_open(shm->name, O_RDONLY | O_CLOEXEC, 0);
+    if (fd < 0) {
+        free(shm);
+        return RMH_FAILURE;
+    }
+    if (fstat(fd, &st) != 0 || st.st_size < sizeof(RMH_ShmPage)) {
+        close(fd);
+        free(shm);
+        return RMH_FAILURE;
+    }
+    map=mmap(NULL, sizeof(RMH_ShmPage), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        free(shm);
+        return RMH_FAILURE;
+    }
+    shm->page=map;
+
+    if (__atomic_load_n(&shm->page->magic, __ATOMIC_ACQUIRE) != RMH_SHM_MAGIC) {
+        ret=RMH_FAILURE;
+    }
+    else if (shm->page->version != RMH_SHM_VERSION || shm->page->statusSize != sizeof(RMH_ShmStatus)) {
+        ret=RMH_INVALID_INTERNAL_STATE;
+    }
+    if (ret != RMH_SUCCESS) {
+        RMH_Shm_Close(shm);
+        return ret;
+    }
+
+    *response=shm;
+    return RMH_SUCCESS;
+}
+
+RMH_Result RMH_Shm_Read(const RMH_ShmHandle shm, RMH_ShmStatus* response) {
+    uint64_t before;
+    uint32_t i;
+
+    if (!shm || !response) {
+        return RMH_INVALID_PARAM;
+    }
+
+    for (i=0; i < RMH_SHM_READ_MAX_ATTEMPTS; i++) {
+        before=__atomic_load_n(&shm->page->sequence, __ATOMIC_ACQUIRE);
+        if (before == 0) {
+            return RMH_FAILURE;
+        }
+        if (before & 1) {
+            /* Being published. Let the publisher finish */
+            sched_yield();
+            continue;
+        }
+        memcpy(response, &shm->page->status, sizeof(*response));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&shm->page->sequence, __ATOMIC_RELAXED) == before) {
+            return RMH_SUCCESS;
+        }
+    }
+    return RMH_TIMEOUT;
+}
+
+RMH_Result RMH_Shm_Create(const char* name, RMH_ShmHandle* response) {
+    RMH_ShmHandle shm;
+    void *map;
+    int fd;
+    RMH_Result ret;
+
+    ret=pRMH_Shm_Alloc(name, &shm);
+    if (ret != RMH_SUCCESS) {
+        return ret;
+    }
+
+    /* Replace rather than reuse an existing object. Truncating one which is mapped would crash its readers */
+    shm_unlink(shm->name);
+    fd=shm_open(shm->name, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+    if (fd < 0) {
+        free(shm);
+        return RMH_FAILURE;
+    }
+    if (ftruncate(fd, sizeof(RMH_ShmPage)) != 0) {
+        close(fd);
+        shm_unlink(shm->name);
+        free(shm);
+        return RMH_FAILURE;
+    }
+    map=mmap(NULL, sizeof(RMH_ShmPage), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        shm_unlink(shm->name);
+        free(shm);
+        return RMH_FAILURE;
+    }
+    shm->page=map;
+    shm->publisher=true;
+
+    shm->page->version=RMH_SHM_VERSION;
+    shm->page->statusSize=sizeof(RMH_ShmStatus);
+    __atomic_store_n(&shm->page->magic, RMH_SHM_MAGIC, __ATOMIC_RELEASE);
+
+    *response=shm;
+    return RMH_SUCCESS;
+}
+
+RMH_Result RMH_Shm_Publish(const RMH_ShmHandle shm, const RMH_ShmStatus* status) {
+    RMH_ShmPage *page;
+    struct timespec now;
+    uint64_t sequence;
+
+    if (!shm || !shm->publisher || !status) {
+        return RMH_INVALID_PARAM;
+    }
+    page=shm->page;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    sequence=__atomic_load_n(&page->sequence, __ATOMIC_RELAXED);
+    __atomic_store_n(&page->sequence, sequence+1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memcpy(&page->status, status, sizeof(page->status));
+    page->status.sequence=sequence/2+1;
+    page->status.timestampMs=now.tv_sec*1000ull + now.tv_nsec/1000000;
+    page->status.publisherPid=getpid();
+    __atomic_store_n(&page->sequence, sequence+2, __ATOMIC_RELEASE);
+    return RMH_SUCCESS;
+}
+
+RMH_Result RMH_Shm_Close(const RMH_ShmHandle shm) {
+    if (!shm) {
+        return RMH_INVALID_PARAM;
+    }
+    munmap(shm->page, sizeof(RMH_ShmPage));
+    if (shm->publisher) {
+        shm_unlink(shm->name);
+    }
+    free(shm);
+    return RMH_SUCCESS;
+}
@@ -0,0 +1,392 @@
+/*
+ * If not stated otherwise in this file or this component's Licenses.txt file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2016 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include <pthread.h>
+#include "librmh.h"
+#include "rdk_moca_hal.h"
+
+/**********************************************************************************************************************
+RMH_Stats_GetExtended() turns the 32 bit statistics counters of the SoC into 64 bit totals which only ever count up.
+Each call samples every counter with one RMH_ExecuteBatch() and adds how much each moved since the previous sample of
+the handle to its total.
+
+A counter which went backwards either wrapped or was cleared. It's taken to be cleared when the MoCA reset count
+changed or RMH_Stats_Reset() was called since the last sample, and otherwise when treating it as a wrap would mean it
+moved by more than half its range. A cleared counter moved by its current value. The same goes for a remote node which
+left the network and came back.
+
+Totals are kept in a ring of samples taken every 1/RMH_STATS_SAMPLES_PER_WINDOW of the rate window. Rates are measured
+from the newest sample at least one window old, or the oldest there is, to the sample just taken.
+**********************************************************************************************************************/
+/*        Counter                                   API */
+#define RMH_STATS_COUNTERS \
+    RMH_STATS_COUNTER(RMH_STATS_TX_TOTAL_BYTES,         RMH_Stats_GetTxTotalBytes) \
+    RMH_STATS_COUNTER(RMH_STATS_RX_TOTAL_BYTES,         RMH_Stats_GetRxTotalBytes) \
+    RMH_STATS_COUNTER(RMH_STATS_TX_TOTAL_PACKETS,       RMH_Stats_GetTxTotalPackets) \
+    RMH_STATS_COUNTER(RMH_STATS_RX_TOTAL_PACKETS,       RMH_Stats_GetRxTotalPackets) \
+    RMH_STATS_COUNTER(RMH_STATS_TX_UNICAST_PACKETS,     RMH_Stats_GetTxUnicastPackets) \
+    RMH_STATS_COUNTER(RMH_STATS_RX_UNICAST_PACKETS,     RMH_Stats_GetRxUnicastPackets) \
+    RMH_STATS_COUNTER(RMH_STATS_TX_BROADCAST_PACKETS,   RMH_Stats_GetTxBroadcastPackets) \
+    RMH_STATS_COUNTER(RMH_STATS_RX_BROADCAST_PACKETS,   RMH_Stats_GetRxBroadcastPackets) \
+    RMH_STATS_COUNTER(RMH_STATS_TX_MULTICAST_PACKETS,   RMH_Stats_GetTxMulticastPackets) \
+    RMH_STATS_COUNTER(RMH_STATS_RX_MULTICAST_PACKETS,   RMH_Stats_GetRxMulticastPackets) \
+    RMH_STATS_COUNTER(RMH_STATS_TX_DROPPED_PACKETS,     RMH_Stats_GetTxDroppedPackets) \
+    RMH_STATS_COUNTER(RMH_STATS_RX_DROPPED_PACKETS,     RMH_Stats_GetRxDroppedPackets) \
+    RMH_STATS_COUNTER(RMH_STATS_TX_TOTAL_ERRORS,        RMH_Stats_GetTxTotalErrors) \
+    RMH_STATS_COUNTER(RMH_STATS_RX_TOTAL_ERRORS,        RMH_Stats_GetRxTotalErrors) \
+    RMH_STATS_COUNTER(RMH_STATS_RX_CRC_ERRORS,          RMH_Stats_GetRxCRCErrors)
+
+#define RMH_STATS_COUNTER(COUNTER, API_NAME) [COUNTER] = RMH_API_ID__##API_NAME,
+static const RMH_APIId hRMHGeneric_StatsCounterAPIs[RMH_STATS_NUM_COUNTERS] = { RMH_STATS_COUNTERS };
+#undef RMH_STATS_COUNTER
+
+#define RMH_STATS_BYTE_COUNTERS ((1u << RMH_STATS_TX_TOTAL_BYTES) | (1u << RMH_STATS_RX_TOTAL_BYTES))
+#define RMH_STATS_DEFAULT_RATE_WINDOW_MS 10000
+#define RMH_STATS_MIN_RATE_WINDOW_MS 100
+#define RMH_STATS_SAMPLES_PER_WINDOW 16
+#define RMH_STATS_HISTORY_SIZE (RMH_STATS_SAMPLES_PER_WINDOW*2)
+
+typedef struct RMH_StatsSample {
+    uint64_t timeMs;
+    uint32_t valid;                         /* Bitmask of (1u << RMH_StatsCounter) read in the sample */
+    uint64_t total[RMH_STATS_NUM_COUNTERS];
+    bool nodePresent[RMH_MAX_MOCA_NODES];
+    uint64_t nodeRxPackets[RMH_MAX_MOCA_NODES];
+    uint64_t nodeTxPackets[RMH_MAX_MOCA_NODES];
+} RMH_StatsSample;
+
+typedef struct RMH_StatsAccumulator {
+    pthread_mutex_t lock;
+    uint32_t rateWindowMs;
+    uint32_t numCounterResets;
+    uint32_t resetGeneration;               /* hRMHGeneric_StatsResetGeneration at the last sample */
+    bool resetCountValid;
+    uint32_t resetCount;                    /* RMH_Network_GetResetCount at the last sample */
+    bool lastValid[RMH_STATS_NUM_COUNTERS];
+    uint32_t last[RMH_STATS_NUM_COUNTERS];  /* Value of each counter the last time it was read */
+    bool nodeLastPresent[RMH_MAX_MOCA_NODES];
+    bool nodeSeen[RMH_MAX_MOCA_NODES];
+    uint32_t nodeLastRxPackets[RMH_MAX_MOCA_NODES];
+    uint32_t nodeLastTxPackets[RMH_MAX_MOCA_NODES];
+    RMH_StatsSample current;
+    uint32_t historyHead;                   /* Where the next sample is stored */
+    uint32_t historySize;
+    RMH_StatsSample history[RMH_STATS_HISTORY_SIZE];
+} RMH_StatsAccumulator;
+
+/* Bumped by every successful RMH_Stats_Reset() in the process as it clears the counters seen by every handle */
+static uint32_t hRMHGeneric_StatsResetGeneration;
+
+static inline
+uint64_t pRMH_Stats_NowMs() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000ull + now.tv_nsec / 1000000;
+}
+
+static
+RMH_StatsAccumulator* pRMH_Stats_GetAccumulator(const RMH_Handle handle) {
+    RMH_StatsAccumulator *stats=__atomic_load_n(&handle->stats, __ATOMIC_ACQUIRE);
+    RMH_StatsAccumulator *expected=NULL;
+
+    if (stats) {
+        return stats;
+    }
+    stats=calloc(1, sizeof(*stats));
+    BRMH_RETURN_IF(stats==NULL, NULL);
+    if (pthread_mutex_init(&stats->lock, NULL) != 0) {
+        RMH_PrintErr("Unable to create the stats lock!\n");
+        free(stats);
+        return NULL;
+    }
+    stats->rateWindowMs=RMH_STATS_DEFAULT_RATE_WINDOW_MS;
+    stats->resetGeneration=__atomic_load_n(&hRMHGeneric_StatsResetGeneration, __ATOMIC_ACQUIRE);
+
+    /* Another thread on a thread safe handle may have got here first */
+    if (!__atomic_compare_exchange_n(&handle->stats, &expected, stats, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        pthread_mutex_destroy(&stats->lock);
+        free(stats);
+        return expected;
+    }
+    return stats;
+}
+
+/* How much a counter moved from last to value. Sets *reset if it was cleared rather than wrapped */
+static inline
+uint64_t pRMH_Stats_Delta(const uint32_t last, const uint32_t value, const bool resetExpected, bool *reset) {
+    if (value >= last) {
+        return value - last;
+    }
+    if (resetExpected || (uint32_t)(value - last) > UINT32_MAX/2) {
+        *reset=true;
+        return value;
+    }
+    return (uint32_t)(value - last);
+}
+
+/* Add the counters read into stats->current */
+static
+bool pRMH_Stats_Accumulate(RMH_StatsAccumulator *stats, const uint32_t *values, const RMH_Result *results,
+                           const RMH_NodeList_Uint32_t *nodeRxPackets, const RMH_NodeList_Uint32_t *nodeTxPackets, const bool resetExpected) {
+    RMH_StatsSample *current=&stats->current;
+    bool reset=false;
+    uint32_t i;
+
+    current->valid=0;
+    for (i=0; i < RMH_STATS_NUM_COUNTERS; i++) {
+        if (results[i] != RMH_SUCCESS) {
+            continue;
+        }
+        /* The first read starts the total at the value of the counter */
+        current->total[i] += stats->lastValid[i] ? pRMH_Stats_Delta(stats->last[i], values[i], resetExpected, &reset) : values[i];
+        stats->last[i]=values[i];
+        stats->lastValid[i]=true;
+        current->valid |= (1u << i);
+    }
+
+    for (i=0; i < RMH_MAX_MOCA_NODES; i++) {
+        bool nodeReset=false;
+        current->nodePresent[i]=nodeRxPackets->nodePresent[i] && nodeTxPackets->nodePresent[i];
+        if (!current->nodePresent[i]) {
+            stats->nodeLastPresent[i]=false;
+            continue;
+        }
+        if (stats->nodeSeen[i]) {
+            /* A node which has just joined again may well have had its counters cleared */
+            const bool nodeResetExpected=resetExpected || !stats->nodeLastPresent[i];
+            current->nodeRxPackets[i] += pRMH_Stats_Delta(stats->nodeLastRxPackets[i], nodeRxPackets->nodeValue[i], nodeResetExpected, &nodeReset);
+            current->nodeTxPackets[i] += pRMH_Stats_Delta(stats->nodeLastTxPackets[i], nodeTxPackets->nodeValue[i], nodeResetExpected, &nodeReset);
+        }
+        else {
+            current->nodeRxPackets[i]=nodeRxPackets->nodeValue[i];
+            current->nodeTxPackets[i]=nodeTxPackets->nodeValue[i];
+        }
+        stats->nodeLastRxPackets[i]=nodeRxPackets->nodeValue[i];
+        stats->nodeLastTxPackets[i]=nodeTxPackets->nodeValue[i];
+        stats->nodeLastPresent[i]=true;
+        stats->nodeSeen[i]=true;
+    }
+    return reset;
+}
+
+/* The sample rates are measured from. NULL if there is none */
+static
+const RMH_StatsSample* pRMH_Stats_GetRateBase(const RMH_StatsAccumulator *stats, const uint64_t nowMs) {
+    const RMH_StatsSample *base=NULL;
+    uint32_t i;
+
+    for (i=1; i <= stats->historySize; i++) {
+        base=&stats->history[(stats->historyHead + RMH_STATS_HISTORY_SIZE - i) % RMH_STATS_HISTORY_SIZE];
+        if (nowMs - base->timeMs >= stats->rateWindowMs) {
+            break;
+        }
+    }
+    return (base && base->timeMs < nowMs) ? base : NULL;
+}
+
+static
+void pRMH_Stats_Record(RMH_StatsAccumulator *stats) {
+    if (stats->historySize) {
+        const RMH_StatsSample *newest=&stats->history[(stats->historyHead + RMH_STATS_HISTORY_SIZE - 1) % RMH_STATS_HISTORY_SIZE];
+        if (stats->current.timeMs - newest->timeMs < stats->rateWindowMs/RMH_STATS_SAMPLES_PER_WINDOW) {
+            return;
+        }
+    }
+    stats->history[stats->historyHead]=stats->current;
+    stats->historyHead=(stats->historyHead + 1) % RMH_STATS_HISTORY_SIZE;
+    if (stats->historySize < RMH_STATS_HISTORY_SIZE) {
+        stats->historySize++;
+    }
+}
+
+static
+void pRMH_Stats_Fill(const RMH_StatsAccumulator *stats, const RMH_StatsSample *base, RMH_StatsExtended* response) {
+    const RMH_StatsSample *current=&stats->current;
+    uint32_t i;
+
+    memset(response, 0, sizeof(*response));
+    response->timestampMs=current->timeMs;
+    response->numCounterResets=stats->numCounterResets;
+    response->valid=current->valid;
+    memcpy(response->total, current->total, sizeof(response->total));
+    memcpy(response->nodePresent, current->nodePresent, sizeof(response->nodePresent));
+    memcpy(response->nodeRxPackets, current->nodeRxPackets, sizeof(response->nodeRxPackets));
+    memcpy(response->nodeTxPackets, current->nodeTxPackets, sizeof(response->nodeTxPackets));
+    if (!base) {
+        return;
+    }
+
+    response->rateWindowMs=current->timeMs - base->timeMs;
+    for (i=0; i < RMH_STATS_NUM_COUNTERS; i++) {
+        if (current->valid & base->valid & (1u << i)) {
+            response->rate[i]=(current->total[i] - base->total[i]) * 1000.0 / response->rateWindowMs;
+            if (RMH_STATS_BYTE_COUNTERS & (1u << i)) {
+                response->rate[i] *= 8;
+            }
+        }
+    }
+    for (i=0; i < RMH_MAX_MOCA_NODES; i++) {
+        if (current->nodePresent[i] && base->nodePresent[i]) {
+            response->nodeRxPacketsPerSec[i]=(current->nodeRxPackets[i] - base->nodeRxPackets[i]) * 1000.0 / response->rateWindowMs;
+            response->nodeTxPacketsPerSec[i]=(current->nodeTxPackets[i] - base->nodeTxPackets[i]) * 1000.0 / response->rateWindowMs;
+        }
+    }
+}
+
+/* Read the per node packet counters of every remote node into nodeRxPackets and nodeTxPackets */
+static
+RMH_Result pRMH_Stats_ReadNodes(const RMH_Handle handle, const RMH_NodeList_Uint32_t *nodeIds, RMH_NodeList_Uint32_t *nodeRxPackets, RMH_NodeList_Uint32_t *nodeTxPackets) {
+    RMH_BatchOp ops[RMH_MAX_MOCA_NODES*2];
+    RMH_Result results[RMH_MAX_MOCA_NODES*2];
+    uint32_t numOps=0;
+    RMH_Result ret;
+    uint32_t i;
+
+    memset(ops, 0, sizeof(ops));
+    for (i=0; i < RMH_MAX_MOCA_NODES; i++) {
+        if (nodeIds->nodePresent[i]) {
+            ops[numOps].apiId=RMH_API_ID__RMH_RemoteNode_GetRxPackets;
+            ops[numOps].nodeId=i;
+            ops[numOps].response=&nodeRxPackets->nodeValue[i];
+            ops[numOps].result=&results[numOps];
+            numOps++;
+            ops[numOps].apiId=RMH_API_ID__RMH_RemoteNode_GetTxPackets;
+            ops[numOps].nodeId=i;
+            ops[numOps].response=&nodeTxPackets->nodeValue[i];
+            ops[numOps].result=&results[numOps];
+            numOps++;
+        }
+    }
+    if (!numOps) {
+        return RMH_SUCCESS;
+    }
+
+    ret=RMH_ExecuteBatch(handle, ops, numOps);
+    if (ret == RMH_SUCCESS) {
+        for (i=0; i < numOps; i+=2) {
+            nodeRxPackets->nodePresent[ops[i].nodeId]=(results[i] == RMH_SUCCESS);
+            nodeTxPackets->nodePresent[ops[i].nodeId]=(results[i+1] == RMH_SUCCESS);
+        }
+    }
+    return ret;
+}
+
+RMH_Result GENERIC_IMPL__RMH_Stats_GetExtended(const RMH_Handle handle, RMH_StatsExtended* response) {
+    RMH_StatsAccumulator *stats;
+    RMH_BatchOp ops[RMH_STATS_NUM_COUNTERS+2];
+    RMH_Result results[RMH_STATS_NUM_COUNTERS+2];
+    uint32_t values[RMH_STATS_NUM_COUNTERS];
+    RMH_NodeList_Uint32_t nodeIds;
+    RMH_NodeList_Uint32_t nodeRxPackets;
+    RMH_NodeList_Uint32_t nodeTxPackets;
+    uint32_t resetCount=0;
+    uint32_t resetGeneration;
+    bool resetExpected;
+    RMH_Result ret;
+    uint32_t i;
+
+    BRMH_RETURN_IF(response==NULL, RMH_INVALID_PARAM);
+    stats=pRMH_Stats_GetAccumulator(handle);
+    BRMH_RETURN_IF(stats==NULL, RMH_FAILURE);
+
+    memset(ops, 0, sizeof(ops));
+    for (i=0; i < RMH_STATS_NUM_COUNTERS; i++) {
+        ops[i].apiId=hRMHGeneric_StatsCounterAPIs[i];
+        ops[i].response=&values[i];
+        ops[i].result=&results[i];
+    }
+    ops[RMH_STATS_NUM_COUNTERS].apiId=RMH_API_ID__RMH_Network_GetResetCount;
+    ops[RMH_STATS_NUM_COUNTERS].response=&resetCount;
+    ops[RMH_STATS_NUM_COUNTERS].result=&results[RMH_STATS_NUM_COUNTERS];
+    ops[RMH_STATS_NUM_COUNTERS+1].apiId=RMH_API_ID__RMH_Network_GetRemoteNodeIds;
+    ops[RMH_STATS_NUM_COUNTERS+1].response=&nodeIds;
+    ops[RMH_STATS_NUM_COUNTERS+1].result=&results[RMH_STATS_NUM_COUNTERS+1];
+    memset(&nodeRxPackets, 0, sizeof(nodeRxPackets));
+    memset(&nodeTxPackets, 0, sizeof(nodeTxPackets));
+
+    /* Samples must be added in the order they were taken so only one may be in flight */
+    pthread_mutex_lock(&stats->lock);
+    resetGeneration=__atomic_load_n(&hRMHGeneric_StatsResetGeneration, __ATOMIC_ACQUIRE);
+    ret=RMH_ExecuteBatch(handle, ops, RMH_STATS_NUM_COUNTERS+2);
+    if (ret == RMH_SUCCESS && results[RMH_STATS_NUM_COUNTERS+1] == RMH_SUCCESS) {
+        ret=pRMH_Stats_ReadNodes(handle, &nodeIds, &nodeRxPackets, &nodeTxPackets);
+    }
+    if (ret != RMH_SUCCESS) {
+        pthread_mutex_unlock(&stats->lock);
+        return ret;
+    }
+    stats->current.timeMs=pRMH_Stats_NowMs();
+
+    resetExpected=(resetGeneration != stats->resetGeneration);
+    stats->resetGeneration=resetGeneration;
+    if (results[RMH_STATS_NUM_COUNTERS] == RMH_SUCCESS) {
+        resetExpected |= (stats->resetCountValid && resetCount != stats->resetCount);
+        stats->resetCount=resetCount;
+        stats->resetCountValid=true;
+    }
+
+    if (pRMH_Stats_Accumulate(stats, values, results, &nodeRxPackets, &nodeTxPackets, resetExpected)) {
+        stats->numCounterResets++;
+        RMH_PrintDbg("The statistics counters were reset. Seen %u times\n", stats->numCounterResets);
+    }
+    if (!stats->current.valid) {
+        pthread_mutex_unlock(&stats->lock);
+        RMH_PrintDbg("Unable to read any statistics counter [%s]\n", RMH_ResultToString(results[0]));
+        return results[0];
+    }
+    pRMH_Stats_Fill(stats, pRMH_Stats_GetRateBase(stats, stats->current.timeMs), response);
+    pRMH_Stats_Record(stats);
+    pthread_mutex_unlock(&stats->lock);
+    return RMH_SUCCESS;
+}
+
+RMH_Result GENERIC_IMPL__RMH_Stats_SetRateWindow(const RMH_Handle handle, const uint32_t value) {
+    RMH_StatsAccumulator *stats;
+
+    BRMH_RETURN_IF(value < RMH_STATS_MIN_RATE_WINDOW_MS, RMH_INVALID_PARAM);
+    stats=pRMH_Stats_GetAccumulator(handle);
+    BRMH_RETURN_IF(stats==NULL, RMH_FAILURE);
+    pthread_mutex_lock(&stats->lock);
+    stats->rateWindowMs=value;
+    pthread_mutex_unlock(&stats->lock);
+    return RMH_SUCCESS;
+}
+
+RMH_Result GENERIC_IMPL__RMH_Stats_GetRateWindow(const RMH_Handle handle, uint32_t* response) {
+    RMH_StatsAccumulator *stats=__atomic_load_n(&handle->stats, __ATOMIC_ACQUIRE);
+
+    BRMH_RETURN_IF(response==NULL, RMH_INVALID_PARAM);
+    *response=stats ? __atomic_load_n(&stats->rateWindowMs, __ATOMIC_RELAXED) : RMH_STATS_DEFAULT_RATE_WINDOW_MS;
+    return RMH_SUCCESS;
+}
+
+/* Only called once the SoC has cleared the counters */
+RMH_Result GENERIC_IMPL__RMH_Stats_Reset(const RMH_Handle handle) {
+    __atomic_add_fetch(&hRMHGeneric_StatsResetGeneration, 1, __ATOMIC_RELEASE);
+    return RMH_SUCCESS;
+}
+
+__attribute__((visibility("hidden")))
+void pRMH_Stats_Destroy(const RMH_Handle handle) {
+    if (handle->stats) {
+        pthread_mutex_destroy(&handle->stats->lock);
+        free(handle->stats);
+        handle->stats=NULL;
+    }
+}
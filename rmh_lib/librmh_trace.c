@@ -0,0 +1,209 @@
+/*
+ * If not stated otherwise in this file or this component's Licenses.txt file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2016 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include "librmh.h"
+#include "rdk_moca_hal.h"
+
+/**********************************************************************************************************************
+The trace buffer is a fixed size ring of binary records. Writers claim a slot by atomically incrementing 'head' so any
+number of threads, or processes when the ring is in a shared file, can record without a lock. Each slot carries the
+sequence number (index + 1) of the record it holds. It's cleared while the slot is being written and set once the
+record is complete, so a reader can detect and skip a record that was overwritten while it was being copied.
+
+The ring lives in memory private to the process unless the environment variable RMH_TRACE is set to the full path of a
+file. In that case the ring is mapped from that file so 'rmh trace dump <file>' can decode it from another process.
+**********************************************************************************************************************/
+#define RMH_TRACE_MAGIC                 0x54484d52      /* 'RMHT' */
+#define RMH_TRACE_VERSION               1
+#define RMH_TRACE_NUM_RECORDS           RMH_MAX_TRACE_RECORDS  /* Must be a power of 2 */
+
+typedef struct RMHGeneric_TraceSlot {
+    uint64_t sequence;
+    uint64_t timestampNs;
+    uint64_t durationNs;
+    uint32_t threadId;
+    uint16_t apiId;
+    uint8_t depth;
+    uint8_t result;
+} RMHGeneric_TraceSlot;
+
+typedef struct RMHGeneric_TraceRing {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t numRecords;
+    uint32_t recordSize;
+    uint64_t head;
+    RMHGeneric_TraceSlot slots[RMH_TRACE_NUM_RECORDS];
+} RMHGeneric_TraceRing;
+
+__attribute__((visibility("hidden"))) bool hRMHGeneric_TraceEnabled;
+static RMHGeneric_TraceRing hRMHGeneric_TraceLocalRing = { RMH_TRACE_MAGIC, RMH_TRACE_VERSION, RMH_TRACE_NUM_RECORDS, sizeof(RMHGeneric_TraceSlot) };
+static RMHGeneric_TraceRing *hRMHGeneric_TraceRing = &hRMHGeneric_TraceLocalRing;
+static pthread_once_t hRMHGeneric_TraceInitOnce = PTHREAD_ONCE_INIT;
+static __thread uint32_t hRMHGeneric_TraceThreadId;
+
+static
+RMHGeneric_TraceRing* pRMH_Trace_MapFile(const char *filename, const bool writable) {
+    RMHGeneric_TraceRing *ring;
+    struct stat fileStat;
+    int fd=open(filename, writable ? O_RDWR|O_CREAT|O_CLOEXEC : O_RDONLY|O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return NULL;
+    }
+    if (fstat(fd, &fileStat) != 0 ||
+       (fileStat.st_size < sizeof(RMHGeneric_TraceRing) && (!writable || ftruncate(fd, sizeof(RMHGeneric_TraceRing)) != 0))) {
+        close(fd);
+        return NULL;
+    }
+    ring=mmap(NULL, sizeof(RMHGeneric_TraceRing), writable ? PROT_READ|PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (ring == MAP_FAILED) {
+        return NULL;
+    }
+    if (writable && (ring->magic != RMH_TRACE_MAGIC || ring->version != RMH_TRACE_VERSION ||
+                     ring->numRecords != RMH_TRACE_NUM_RECORDS || ring->recordSize != sizeof(RMHGeneric_TraceSlot))) {
+        /* New or incompatible file. Start a fresh ring */
+        memset(ring, 0, sizeof(*ring));
+        ring->version=RMH_TRACE_VERSION;
+        ring->numRecords=RMH_TRACE_NUM_RECORDS;
+        ring->recordSize=sizeof(RMHGeneric_TraceSlot);
+        __atomic_store_n(&ring->magic, RMH_TRACE_MAGIC, __ATOMIC_RELEASE);
+    }
+    return ring;
+}
+
+static
+void pRMH_Trace_Initialize() {
+    const char *env=getenv("RMH_TRACE");
+    if (env && env[0] != '\0' && strcmp(env, "0") != 0) {
+        if (env[0] == '/') {
+            RMHGeneric_TraceRing *ring=pRMH_Trace_MapFile(env, true);
+            if (ring) {
+                hRMHGeneric_TraceRing=ring;
+            }
+            else {
+                fprintf(stderr, "WARNING: Unable to use '%s' for RMH trace. Tracing to memory only\n", env);
+            }
+        }
+        __atomic_store_n(&hRMHGeneric_TraceEnabled, true, __ATOMIC_RELAXED);
+    }
+}
+
+__attribute__((visibility("hidden")))
+void pRMH_Trace_InitializeOnce() {
+    pthread_once(&hRMHGeneric_TraceInitOnce, pRMH_Trace_Initialize);
+}
+
+__attribute__((visibility("hidden")))
+void pRMH_Trace_Record(const RMH_APIId apiId, const uint32_t depth, const struct timespec *startTime, const uint64_t durationNs, const RMH_Result result) {
+    RMHGeneric_TraceRing *ring=hRMHGeneric_TraceRing;
+    uint64_t index=__atomic_fetch_add(&ring->head, 1, __ATOMIC_RELAXED);
+    RMHGeneric_TraceSlot *slot=&ring->slots[index & (RMH_TRACE_NUM_RECORDS-1)];
+
+    if (hRMHGeneric_TraceThreadId == 0) {
+        hRMHGeneric_TraceThreadId=(uint32_t)syscall(SYS_gettid);
+    }
+
+    __atomic_store_n(&slot->sequence, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    slot->timestampNs=startTime->tv_sec * 1000000000ull + startTime->tv_nsec;
+    slot->durationNs=durationNs;
+    slot->threadId=hRMHGeneric_TraceThreadId;
+    slot->apiId=(uint16_t)apiId;
+    slot->depth=(uint8_t)depth;
+    slot->result=(uint8_t)result;
+    __atomic_store_n(&slot->sequence, index+1, __ATOMIC_RELEASE);
+}
+
+RMH_Result RMH_Trace_SetEnabled(const RMH_Handle handle, const bool value) {
+    pRMH_Trace_InitializeOnce();
+    __atomic_store_n(&hRMHGeneric_TraceEnabled, value, __ATOMIC_RELAXED);
+    return RMH_SUCCESS;
+}
+
+RMH_Result RMH_Trace_GetEnabled(const RMH_Handle handle, bool* response) {
+    BRMH_RETURN_IF(response==NULL, RMH_INVALID_PARAM);
+    pRMH_Trace_InitializeOnce();
+    *response=__atomic_load_n(&hRMHGeneric_TraceEnabled, __ATOMIC_RELAXED);
+    return RMH_SUCCESS;
+}
+
+RMH_Result RMH_Trace_Dump(const RMH_Handle handle, const char* filename, RMH_TraceRecord* responseArray, const size_t responseArraySize, size_t* responseArrayUsed) {
+    RMHGeneric_TraceRing *ring;
+    uint64_t head;
+    uint64_t first;
+    uint64_t index;
+
+    BRMH_RETURN_IF(responseArray==NULL, RMH_INVALID_PARAM);
+    BRMH_RETURN_IF(responseArrayUsed==NULL, RMH_INVALID_PARAM);
+
+    if (filename) {
+        ring=pRMH_Trace_MapFile(filename, false);
+        if (!ring) {
+            RMH_PrintErr("Unable to open trace file '%s'\n", filename);
+            return RMH_FAILURE;
+        }
+        if (__atomic_load_n(&ring->magic, __ATOMIC_ACQUIRE) != RMH_TRACE_MAGIC || ring->version != RMH_TRACE_VERSION ||
+            ring->numRecords != RMH_TRACE_NUM_RECORDS || ring->recordSize != sizeof(RMHGeneric_TraceSlot)) {
+            RMH_PrintErr("'%s' is not a trace file supported by this version of RMH\n", filename);
+            munmap(ring, sizeof(RMHGeneric_TraceRing));
+            return RMH_FAILURE;
+        }
+    }
+    else {
+        pRMH_Trace_InitializeOnce();
+        ring=hRMHGeneric_TraceRing;
+    }
+
+    /* Only the most recent records which fit in both the ring and the response array are returned */
+    head=__atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    first=(head > RMH_TRACE_NUM_RECORDS) ? head - RMH_TRACE_NUM_RECORDS : 0;
+    if (head - first > responseArraySize) {
+        first=head - responseArraySize;
+    }
+
+    *responseArrayUsed=0;
+    for (index=first; index != head; index++) {
+        RMHGeneric_TraceSlot *slot=&ring->slots[index & (RMH_TRACE_NUM_RECORDS-1)];
+        RMH_TraceRecord *record=&responseArray[*responseArrayUsed];
+        if (__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) != index+1) {
+            continue; /* Still being written or already overwritten */
+        }
+        record->timestampNs=slot->timestampNs;
+        record->durationNs=slot->durationNs;
+        record->threadId=slot->threadId;
+        record->depth=slot->depth;
+        record->apiId=slot->apiId;
+        record->result=slot->result;
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&slot->sequence, __ATOMIC_RELAXED) == index+1 && record->apiId < RMH_NUM_APIS) {
+            (*responseArrayUsed)++;
+        }
+    }
+
+    if (ring != hRMHGeneric_TraceRing) {
+        munmap(ring, sizeof(RMHGeneric_TraceRing));
+    }
+    return RMH_SUCCESS;
+}
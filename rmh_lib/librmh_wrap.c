@@ -17,19 +17,16 @@
  * limitations under the License.
 */
 
+#include <pthread.h>
 #include "librmh.h"
 #include "rdk_moca_hal.h"
 
-static
-__attribute__((constructor(200))) void pRMH_APIWRAP_Initialize() {
-    strncpy( hRMHGeneric_APIList.apiListName, "All APIs", sizeof(hRMHGeneric_APIList.apiListName));
-    hRMHGeneric_APIList.apiListSize=0;
+/* Fail the build if RMH_APIList is no longer large enough to hold every API. Increase RMH_MAX_NUM_APIS if this happens */
+typedef char pRMH_APIWRAP_CheckMaxNumAPIs[(RMH_NUM_APIS <= RMH_MAX_NUM_APIS) ? 1 : -1];
 
-    strncpy( hRMHGeneric_SoCUnimplementedAPIList.apiListName, "Unimplemented APIs", sizeof(hRMHGeneric_SoCUnimplementedAPIList.apiListName));
-    hRMHGeneric_SoCUnimplementedAPIList.apiListSize=0;
-    hRMHGeneric_APITags.tagListSize=0;
-}
+static pthread_once_t pRMH_APIWRAP_APIListOnce = PTHREAD_ONCE_INIT;
 
+static
 int pRMH_APIWRAP_Compare(const void* a, const void* b) {
     const RMH_API* _a=* (RMH_API * const *)a;
     const RMH_API* _b=* (RMH_API * const *)b;
@@ -37,75 +34,187 @@ int pRMH_APIWRAP_Compare(const void* a, const void* b) {
 }
 
 static
-__attribute__((constructor(400))) void pRMH_APIWRAP_Finalize() {
+void pRMH_APIWRAP_BuildAPIList() {
+    uint32_t i;
+    strncpy(hRMHGeneric_APIList.apiListName, "All APIs", sizeof(hRMHGeneric_APIList.apiListName));
+    for (i=0; i < RMH_NUM_APIS; i++) {
+        hRMHGeneric_APIList.apiList[i]=(RMH_API *)&hRMHGeneric_APITable[i];
+    }
     /* Sort the list to ensure consistant ordering */
-    qsort(hRMHGeneric_APIList.apiList, hRMHGeneric_APIList.apiListSize, sizeof(RMH_API*), pRMH_APIWRAP_Compare);
+    qsort(hRMHGeneric_APIList.apiList, RMH_NUM_APIS, sizeof(RMH_API*), pRMH_APIWRAP_Compare);
+    hRMHGeneric_APIList.apiListSize=RMH_NUM_APIS;
+}
+
+/* The list of all APIs sorted by name. This is only built the first time it's requested */
+__attribute__((visibility("hidden")))
+RMH_APIList* pRMH_APIWRAP_GetAPIList() {
+    pthread_once(&pRMH_APIWRAP_APIListOnce, pRMH_APIWRAP_BuildAPIList);
+    return &hRMHGeneric_APIList;
 }
 
+static inline
+uint64_t pRMH_APIWRAP_DiffTimeNs(const struct timespec *start, const struct timespec *stop) {
+    return (stop->tv_sec - start->tv_sec) * 1000000000ull + stop->tv_nsec - start->tv_nsec;
+}
+
+/**********************************************************************************************************************
+Generic APIs often call other wrapped APIs. Each level of nesting gets its own frame in the call state's apiTiming,
+indexed by apiDepth, so an inner call can't overwrite the start time of the API which called it. When an API exits it
+adds its time to the frame of its caller. This lets us report both the inclusive time of an API and its self time, which is the
+time not spent in other wrapped APIs.
+
+Calls nested deeper than RMH_MAX_API_DEPTH are not timed and their time is counted as self time of the caller. They're
+only counted as untimed calls so they don't skew the times of the API.
+**********************************************************************************************************************/
 static inline
 void pRMH_APIWRAP_PreAPIExecute(const RMH_Handle handle, const char *api, const bool socEnabled, const bool socBeforeGeneric) {
-    handle->apiDepth++;
+    RMH_CallState *callState=pRMH_CallState(handle);
+    callState->apiDepth++;
     RMH_PrintTrace("+++++ Enter %s [%s] ++++\n", api, !socEnabled ? "Generic Only" :
                                                                     socBeforeGeneric ? "SoC Before Generic" : "SoC After Generic");
-    gettimeofday(&handle->startTime, NULL);
+    if (callState->apiDepth <= RMH_MAX_API_DEPTH) {
+        RMH_APITimingFrame *frame=&callState->apiTiming[callState->apiDepth-1];
+        frame->childTimeNs=0;
+        clock_gettime(CLOCK_MONOTONIC, &frame->startTime);
+    }
 }
 
 static inline
-RMH_Result pRMH_APIWRAP_PostAPIExecute(const RMH_Handle handle, const char *api, const RMH_Result genRet, const RMH_Result socRet) {
-    double elapsedTime;
-    struct timeval stopTime;
+RMH_Result pRMH_APIWRAP_PostAPIExecute(const RMH_Handle handle, const char *api, const RMH_APIId apiId, const RMH_Result genRet, const RMH_Result socRet) {
+    RMH_CallState *callState=pRMH_CallState(handle);
+    uint64_t elapsedTimeNs=0;
+    uint64_t selfTimeNs=0;
+    const bool timed=(callState->apiDepth <= RMH_MAX_API_DEPTH);
     RMH_Result ret = (socRet == RMH_SUCCESS) ? genRet : socRet;
-    gettimeofday(&stopTime, NULL);
-    elapsedTime = (stopTime.tv_sec - handle->startTime.tv_sec) * 1000.0; /* sec to ms */
-    elapsedTime += (stopTime.tv_usec - handle->startTime.tv_usec) / 1000.0; /* us to ms */
-    RMH_PrintTrace("------ Exit  %s [%s] -- [Time: %.02fms] ----\n", api, RMH_ResultToString(ret), elapsedTime);
-    handle->apiDepth--;
+    if (timed) {
+        struct timespec stopTime;
+        RMH_APITimingFrame *frame=&callState->apiTiming[callState->apiDepth-1];
+        clock_gettime(CLOCK_MONOTONIC, &stopTime);
+        elapsedTimeNs = pRMH_APIWRAP_DiffTimeNs(&frame->startTime, &stopTime);
+        selfTimeNs = (elapsedTimeNs > frame->childTimeNs) ? elapsedTimeNs - frame->childTimeNs : 0;
+        if (callState->apiDepth > 1) {
+            callState->apiTiming[callState->apiDepth-2].childTimeNs += elapsedTimeNs;
+        }
+        if (__atomic_load_n(&hRMHGeneric_TraceEnabled, __ATOMIC_RELAXED)) {
+            pRMH_Trace_Record(apiId, callState->apiDepth, &frame->startTime, elapsedTimeNs, ret);
+        }
+    }
+    pRMH_Instrumentation_Record(apiId, ret, timed, elapsedTimeNs/1000, selfTimeNs/1000);
+    RMH_PrintTrace("------ Exit  %s [%s] -- [Time: %.02fms Self: %.02fms] ----\n", api, RMH_ResultToString(ret), elapsedTimeNs/1000000.0, selfTimeNs/1000000.0);
+    callState->apiDepth--;
     return ret;
 }
 
 static inline
-RMH_Result pRMH_APIWRAP_GetSoCAPI(const RMH_Handle handle, const char *apiName, RMH_Result (**apiFunc)()) {
-    RMH_Result ret=RMH_UNIMPLEMENTED;
-    if (handle->soclib) {
-        char *dlErr = dlerror(); /* Check error first to clear it out */
-        *apiFunc=dlsym(handle->soclib, apiName);
-        dlErr = dlerror();
-        if (dlErr) {
-            RMH_PrintTrace("Error for '%s' in dlopen: '%s'\n", apiName, dlErr);
+RMH_Result pRMH_APIWRAP_GetSoCAPI(const RMH_Handle handle, const char *apiName, const RMH_APIId apiId, RMH_Result (**apiFunc)()) {
+    *apiFunc=handle->socAPI[apiId];
+    if (!*apiFunc) {
+        RMH_PrintTrace("Unable to find SoC implementation of '%s'\n", apiName);
+        return RMH_UNIMPLEMENTED;
+    }
+    if (!handle->handle) {
+        RMH_PrintTrace("Located SoC API '%s' at 0x%p but SoC library is not initialized!\n", apiName, *apiFunc);
+        return RMH_INVALID_INTERNAL_STATE;
+    }
+    return RMH_SUCCESS;
+}
+
+/* Generic APIs a SoC library may also implement natively. Their generic implementation calls the SoC one when found */
+static const RMH_APIId hRMHGeneric_SoCOptionalAPIs[] = {
+    RMH_API_ID__RMH_Network_GetSnapshot,
+    RMH_API_ID__RMH_ExecuteBatch
+};
+
+/* APIs the session calls in the SoC library itself rather than through an API wrapper. Every SoC library should
+   implement them so they are reported by RMH_GetUnimplementedAPIs when missing */
+static const RMH_APIId hRMHGeneric_SoCSessionAPIs[] = {
+    RMH_API_ID__RMH_Destroy,
+    RMH_API_ID__RMH_SetEventCallbacks
+};
+
+__attribute__((visibility("hidden")))
+bool pRMH_APIWRAP_SoCAPIExpected(const RMH_APIId apiId) {
+    uint32_t i;
+
+    if (hRMHGeneric_APITable[apiId].socApiExpected) {
+        return true;
+    }
+    for (i=0; i < sizeof(hRMHGeneric_SoCSessionAPIs)/sizeof(hRMHGeneric_SoCSessionAPIs[0]); i++) {
+        if (hRMHGeneric_SoCSessionAPIs[i] == apiId) {
+            return true;
         }
-        else if (*apiFunc) {
-            RMH_PrintTrace("Located SoC API '%s' at 0x%p\n", apiName, *apiFunc);
-            if (handle->handle) {
-                ret = RMH_SUCCESS;
-            } else {
-                RMH_PrintTrace("Located SoC API '%s' at 0x%p but SoC library is not initialized!\n", apiName, *apiFunc);
-                ret = RMH_INVALID_INTERNAL_STATE;
+    }
+    return false;
+}
+
+/**********************************************************************************************************************
+Populate the SoC API table of a session. Only APIs which call into the SoC library, or which it may optionally
+implement, are searched for. All others are left NULL.
+**********************************************************************************************************************/
+__attribute__((visibility("hidden")))
+void pRMH_APIWRAP_LoadSoCAPIs(const RMH_Handle handle, RMH_Session *session) {
+    uint32_t i;
+    uint32_t numFound=0;
+
+    memset(session->socAPI, 0, sizeof(session->socAPI));
+    if (!session->soclib) {
+        return;
+    }
+    for (i=0; i < RMH_NUM_APIS; i++) {
+        if (pRMH_APIWRAP_SoCAPIExpected(i)) {
+            dlerror(); /* Clear any previous error */
+            session->socAPI[i]=(RMH_SoCAPI)dlsym(session->soclib, hRMHGeneric_APITable[i].socApiName);
+            if (dlerror() || !session->socAPI[i]) {
+                session->socAPI[i]=NULL;
+                RMH_PrintTrace("Unable to find SoC implementation '%s'\n", hRMHGeneric_APITable[i].socApiName);
             }
+            else {
+                numFound++;
+            }
+        }
+    }
+    for (i=0; i < sizeof(hRMHGeneric_SoCOptionalAPIs)/sizeof(hRMHGeneric_SoCOptionalAPIs[0]); i++) {
+        const RMH_APIId apiId=hRMHGeneric_SoCOptionalAPIs[i];
+        dlerror(); /* Clear any previous error */
+        session->socAPI[apiId]=(RMH_SoCAPI)dlsym(session->soclib, hRMHGeneric_APITable[apiId].socApiName);
+        if (dlerror() || !session->socAPI[apiId]) {
+            session->socAPI[apiId]=NULL;
         }
         else {
-            RMH_PrintTrace("Unable to find SoC implementation of '%s'\n", apiName);
+            numFound++;
         }
     }
-    return ret;
+    RMH_PrintTrace("Located %u SoC APIs\n", numFound);
 }
 
-static inline
-void pRMH_APIWRAP_RegisterAPI(RMH_API *api) {
-    if (hRMHGeneric_APIList.apiListSize >= RMH_MAX_NUM_APIS) {
-        fprintf(stderr, "ERROR: Unable to expose API %s! Increase the size of RMH_MAX_NUM_APIS\n", api->apiName);
-        return;
+
+/* Fill the list of the SoC APIs of a session which are expected but weren't found. Nothing changes 'socAPI' once the
+   session is open so it's only done then */
+__attribute__((visibility("hidden")))
+void pRMH_APIWRAP_ListUnimplementedAPIs(RMH_Session *session) {
+    RMH_APIList* allAPIs=pRMH_APIWRAP_GetAPIList();
+    RMH_APIList* list=&session->unimplementedAPIs;
+    uint32_t i;
+
+    strncpy(list->apiListName, "Unimplemented APIs", sizeof(list->apiListName));
+    list->apiListSize=0;
+    for(i=0; i != allAPIs->apiListSize; i++) {
+        RMH_API* api=allAPIs->apiList[i];
+        if (pRMH_APIWRAP_SoCAPIExpected(api->apiId) && !session->socAPI[api->apiId]) {
+            list->apiList[list->apiListSize++]=api;
+        }
     }
-    hRMHGeneric_APIList.apiList[hRMHGeneric_APIList.apiListSize++]=api;
 }
 
 
-
 /**********************************************************************************************************************
 The meaning of each of these RMH_API_IMPLEMENTATION macros is listed in rdk_moca_hal_types. For our purpose herem these
 just redirect to __RMH_WRAP_API() if an API wrapper is to be defined. The first three parameters passed to
 __RMH_WRAP_API() indicate how it should call the APIs.
 
 In the case of RMH_API_IMPLEMENTATION_NO_WRAP() no wrapper is requred so it maps directly to __RMH_REGISTER_API().
+
+The API header is then included a second time to fill hRMHGeneric_APITable with the description of each API.
 **********************************************************************************************************************/
 #undef RMH_API_IMPLEMENTATION_SOC_ONLY
 #undef RMH_API_IMPLEMENTATION_GENERIC_ONLY
@@ -129,3 +238,110 @@ In the case of RMH_API_IMPLEMENTATION_NO_WRAP() no wrapper is requred so it maps
 /* Reinclude API header to use the redefined macros to setup necessary functions and structs */
 #undef RMH_API_H
 #include "rmh_api.h"
+
+
+#undef RMH_API_IMPLEMENTATION_SOC_ONLY
+#undef RMH_API_IMPLEMENTATION_GENERIC_ONLY
+#undef RMH_API_IMPLEMENTATION_SOC_THEN_GENERIC
+#undef RMH_API_IMPLEMENTATION_GENERIC_THEN_SOC
+
+#define RMH_API_IMPLEMENTATION_SOC_ONLY(DECLARATION, API_NAME, DESCRIPTION_STR, PARAMS_LIST, WRAP_API, TAGS_STR) \
+    __RMH_API_DEFINITION_WRAP_##WRAP_API(DECLARATION, API_NAME, DESCRIPTION_STR, PARAMS_LIST, TAGS_STR, false, true)
+
+#define RMH_API_IMPLEMENTATION_GENERIC_ONLY(DECLARATION, API_NAME, DESCRIPTION_STR, PARAMS_LIST, WRAP_API, TAGS_STR) \
+    __RMH_API_DEFINITION_WRAP_##WRAP_API(DECLARATION, API_NAME, DESCRIPTION_STR, PARAMS_LIST, TAGS_STR, true, false)
+
+#define RMH_API_IMPLEMENTATION_SOC_THEN_GENERIC(DECLARATION, API_NAME, DESCRIPTION_STR, PARAMS_LIST, WRAP_API, TAGS_STR) \
+    __RMH_API_DEFINITION_WRAP_##WRAP_API(DECLARATION, API_NAME, DESCRIPTION_STR, PARAMS_LIST, TAGS_STR, true, true)
+
+#define RMH_API_IMPLEMENTATION_GENERIC_THEN_SOC(DECLARATION, API_NAME, DESCRIPTION_STR, PARAMS_LIST, WRAP_API, TAGS_STR) \
+    __RMH_API_DEFINITION_WRAP_##WRAP_API(DECLARATION, API_NAME, DESCRIPTION_STR, PARAMS_LIST, TAGS_STR, true, true)
+
+__attribute__((visibility("hidden"))) const RMH_API hRMHGeneric_APITable[RMH_NUM_APIS] = {
+#undef RMH_API_H
+#include "rmh_api.h"
+};
+
+
+/**********************************************************************************************************************
+The APIs of every tag are kept in hRMHGeneric_APITagIndex. Its size is the total number of tags in rmh_api.h, counted
+when it's included a third time below, and the RMH_APITagInfo of each tag points at its own part of it. It's filled from
+the tag masks of the sorted list of all APIs the first time it's requested so no strings need to be parsed.
+**********************************************************************************************************************/
+#undef RMH_API_IMPLEMENTATION_SOC_ONLY
+#undef RMH_API_IMPLEMENTATION_GENERIC_ONLY
+#undef RMH_API_IMPLEMENTATION_SOC_THEN_GENERIC
+#undef RMH_API_IMPLEMENTATION_GENERIC_THEN_SOC
+
+#define RMH_API_IMPLEMENTATION_SOC_ONLY(DECLARATION, API_NAME, DESCRIPTION_STR, PARAMS_LIST, WRAP_API, TAGS_STR)          + __RMH_TAGS_COUNT(TAGS_STR)
+#define RMH_API_IMPLEMENTATION_GENERIC_ONLY(DECLARATION, API_NAME, DESCRIPTION_STR, PARAMS_LIST, WRAP_API, TAGS_STR)       + __RMH_TAGS_COUNT(TAGS_STR)
+#define RMH_API_IMPLEMENTATION_SOC_THEN_GENERIC(DECLARATION, API_NAME, DESCRIPTION_STR, PARAMS_LIST, WRAP_API, TAGS_STR)   + __RMH_TAGS_COUNT(TAGS_STR)
+#define RMH_API_IMPLEMENTATION_GENERIC_THEN_SOC(DECLARATION, API_NAME, DESCRIPTION_STR, PARAMS_LIST, WRAP_API, TAGS_STR)   + __RMH_TAGS_COUNT(TAGS_STR)
+
+enum { RMH_NUM_API_TAG_ENTRIES = 0
+#undef RMH_API_H
+#include "rmh_api.h"
+};
+
+/* Fail the build if a tag no longer fits in RMH_API.tagMask */
+typedef char pRMH_APIWRAP_CheckMaxNumTags[(RMH_NUM_API_TAGS <= RMH_MAX_NUM_TAGS && RMH_MAX_NUM_TAGS <= 32) ? 1 : -1];
+
+static const char * const hRMHGeneric_APITagNames[RMH_NUM_API_TAGS] = {
+    [RMH_API_TAG__ACA]                  = RMH_API_TAG_NAME__ACA,
+    [RMH_API_TAG__Bonding]              = RMH_API_TAG_NAME__Bonding,
+    [RMH_API_TAG__ConfigurationGet]     = RMH_API_TAG_NAME__ConfigurationGet,
+    [RMH_API_TAG__ConfigurationSet]     = RMH_API_TAG_NAME__ConfigurationSet,
+    [RMH_API_TAG__Core]                 = RMH_API_TAG_NAME__Core,
+    [RMH_API_TAG__Frequency]            = RMH_API_TAG_NAME__Frequency,
+    [RMH_API_TAG__Interface]            = RMH_API_TAG_NAME__Interface,
+    [RMH_API_TAG__Link]                 = RMH_API_TAG_NAME__Link,
+    [RMH_API_TAG__Log]                  = RMH_API_TAG_NAME__Log,
+    [RMH_API_TAG__Mac]                  = RMH_API_TAG_NAME__Mac,
+    [RMH_API_TAG__NC]                   = RMH_API_TAG_NAME__NC,
+    [RMH_API_TAG__Network]              = RMH_API_TAG_NAME__Network,
+    [RMH_API_TAG__Phy]                  = RMH_API_TAG_NAME__Phy,
+    [RMH_API_TAG__Power]                = RMH_API_TAG_NAME__Power,
+    [RMH_API_TAG__PQoS]                 = RMH_API_TAG_NAME__PQoS,
+    [RMH_API_TAG__Privacy]              = RMH_API_TAG_NAME__Privacy,
+    [RMH_API_TAG__QAM]                  = RMH_API_TAG_NAME__QAM,
+    [RMH_API_TAG__RemoteNode]           = RMH_API_TAG_NAME__RemoteNode,
+    [RMH_API_TAG__Self]                 = RMH_API_TAG_NAME__Self,
+    [RMH_API_TAG__Stats]                = RMH_API_TAG_NAME__Stats,
+    [RMH_API_TAG__Status]               = RMH_API_TAG_NAME__Status,
+    [RMH_API_TAG__Taboo]                = RMH_API_TAG_NAME__Taboo,
+    [RMH_API_TAG__Turbo]                = RMH_API_TAG_NAME__Turbo,
+    [RMH_API_TAG__Version]              = RMH_API_TAG_NAME__Version,
+};
+
+static RMH_API *hRMHGeneric_APITagIndex[RMH_NUM_API_TAG_ENTRIES];
+static pthread_once_t pRMH_APIWRAP_APITagsOnce = PTHREAD_ONCE_INIT;
+
+static
+void pRMH_APIWRAP_BuildAPITags() {
+    RMH_APIList* allAPIs=pRMH_APIWRAP_GetAPIList();
+    uint32_t used=0;
+    uint32_t tag;
+    uint32_t i;
+
+    for (tag=0; tag < RMH_NUM_API_TAGS; tag++) {
+        RMH_APITagInfo *tagInfo=&hRMHGeneric_APITags.tagList[tag];
+        tagInfo->tagId=(RMH_APITag)tag;
+        tagInfo->tagName=hRMHGeneric_APITagNames[tag];
+        tagInfo->apiList=&hRMHGeneric_APITagIndex[used];
+        tagInfo->apiListSize=0;
+        for (i=0; i != allAPIs->apiListSize && used < RMH_NUM_API_TAG_ENTRIES; i++) {
+            if (allAPIs->apiList[i]->tagMask & RMH_API_TAG_MASK(tag)) {
+                hRMHGeneric_APITagIndex[used++]=allAPIs->apiList[i];
+                tagInfo->apiListSize++;
+            }
+        }
+    }
+    hRMHGeneric_APITags.tagListSize=RMH_NUM_API_TAGS;
+}
+
+/* The APIs of every tag, indexed by RMH_APITag. This is only built the first time it's requested */
+__attribute__((visibility("hidden")))
+RMH_APITagList* pRMH_APIWRAP_GetAPITags() {
+    pthread_once(&pRMH_APIWRAP_APITagsOnce, pRMH_APIWRAP_BuildAPITags);
+    return &hRMHGeneric_APITags;
+}
@@ -24,11 +24,12 @@
 This API wrap uses a bit of preprocessor abuse but in the end I think it's worth it. These macros allow us to:
 
 1. Wrap every RMH API to allow for
-    A. Dynamically check SoC library for existance of the API and return UNIMPLEMENTED if it's not found
+    A. Check the SoC API table of the handle for existance of the API and return UNIMPLEMENTED if it's not found
     B. Enter/Exit/Return code logging
-    C. Timing APIs
-2. Generate a struct containing all APIs so when a new one is added it need only be added to the header file and it
-   will automatically appears in the rmh test app
+    C. Timing APIs and recording per API call counts, results and latency for RMH_Instrumentation_GetStats()
+    D. Answering slow changing getters from the cache of the handle
+2. Generate a constant table containing all APIs, indexed by RMH_APIId, so when a new one is added it need only be added
+   to the header file and it will automatically appears in the rmh test app
 3. Time the API to discover where it might be running slow
 **********************************************************************************************************************/
 
@@ -91,6 +92,69 @@ result of __EXE_NUM_PARAMS_X(). In our example, the final output would be:
 #define __EXE_NUM_PARAMS_X(COMMAND, ...) __GET_EXE_MACRO(__VA_ARGS__, __EXE_NUM_PARAMS_8, __EXE_NUM_PARAMS_7, __EXE_NUM_PARAMS_6, __EXE_NUM_PARAMS_5, __EXE_NUM_PARAMS_4, __EXE_NUM_PARAMS_3, __EXE_NUM_PARAMS_2, __EXE_NUM_PARAMS_1)(COMMAND, __VA_ARGS__)
 
 
+/**********************************************************************************************************************
+This group of macros operates on the tags of the API.
+
+Tags are given in rmh_api.h as RMH_TAGS(Tag1, Tag2, ...) where each tag is the name of an RMH_APITag without its
+'RMH_API_TAG__' prefix. RMH_TAGS is not defined in the library so the list reaches these macros untouched. They paste it
+onto a prefix to turn it into a call of one of the __RMH_TAGS_* macros:
+
+    __RMH_TAGS_MASK(RMH_TAGS(Core, Link))       -> (0 | RMH_API_TAG_MASK(RMH_API_TAG__Core) | RMH_API_TAG_MASK(RMH_API_TAG__Link))
+    __RMH_TAGS_COUNT(RMH_TAGS(Core, Link))      -> (0 +1 +1)
+    __RMH_TAGS_STRING(RMH_TAGS(Core, Link))     -> RMH_API_TAG_NAME__Core ", " RMH_API_TAG_NAME__Link -> "Core, Link"
+
+The string uses the display name of each tag, so RMH_TAGS(ConfigurationGet) is shown as "Configuration [Get]". A tag
+which isn't in ENUM_RMH_APITag fails the build. An API may have up to four tags.
+**********************************************************************************************************************/
+/* The name of each tag shown to users in RMH_API.tags, RMH_APITagInfo.tagName and the HTML documentation */
+#define RMH_API_TAG_NAME__ACA                            "ACA"
+#define RMH_API_TAG_NAME__Bonding                        "Bonding"
+#define RMH_API_TAG_NAME__ConfigurationGet               "Configuration [Get]"
+#define RMH_API_TAG_NAME__ConfigurationSet               "Configuration [Set]"
+#define RMH_API_TAG_NAME__Core                           "Core"
+#define RMH_API_TAG_NAME__Frequency                      "Frequency"
+#define RMH_API_TAG_NAME__Interface                      "Interface"
+#define RMH_API_TAG_NAME__Link                           "Link"
+#define RMH_API_TAG_NAME__Log                            "Log"
+#define RMH_API_TAG_NAME__Mac                            "Mac"
+#define RMH_API_TAG_NAME__NC                             "NC"
+#define RMH_API_TAG_NAME__Network                        "Network"
+#define RMH_API_TAG_NAME__Phy                            "Phy"
+#define RMH_API_TAG_NAME__Power                          "Power"
+#define RMH_API_TAG_NAME__PQoS                           "PQoS"
+#define RMH_API_TAG_NAME__Privacy                        "Privacy"
+#define RMH_API_TAG_NAME__QAM                            "QAM"
+#define RMH_API_TAG_NAME__RemoteNode                     "Remote Node"
+#define RMH_API_TAG_NAME__Self                           "Self"
+#define RMH_API_TAG_NAME__Stats                          "Stats"
+#define RMH_API_TAG_NAME__Status                         "Status"
+#define RMH_API_TAG_NAME__Taboo                          "Taboo"
+#define RMH_API_TAG_NAME__Turbo                          "Turbo"
+#define RMH_API_TAG_NAME__Version                        "Version"
+
+#define __COMMAND_MAKE_TAG_MASK(TAG) | RMH_API_TAG_MASK(RMH_API_TAG__##TAG)
+#define __COMMAND_MAKE_TAG_COUNT(TAG) +1
+
+#define __EXE_NUM_TAGS_1(COMMAND, TAG)      COMMAND(TAG)
+#define __EXE_NUM_TAGS_2(COMMAND, TAG, ...) COMMAND(TAG) __EXE_NUM_TAGS_1(COMMAND, __VA_ARGS__)
+#define __EXE_NUM_TAGS_3(COMMAND, TAG, ...) COMMAND(TAG) __EXE_NUM_TAGS_2(COMMAND, __VA_ARGS__)
+#define __EXE_NUM_TAGS_4(COMMAND, TAG, ...) COMMAND(TAG) __EXE_NUM_TAGS_3(COMMAND, __VA_ARGS__)
+#define __EXE_NUM_TAGS_X(COMMAND, ...) __GET_EXE_MACRO(__VA_ARGS__, __EXE_NUM_TAGS_TOO_MANY, __EXE_NUM_TAGS_TOO_MANY, __EXE_NUM_TAGS_TOO_MANY, __EXE_NUM_TAGS_TOO_MANY, __EXE_NUM_TAGS_4, __EXE_NUM_TAGS_3, __EXE_NUM_TAGS_2, __EXE_NUM_TAGS_1)(COMMAND, __VA_ARGS__)
+
+#define __JOIN_TAG_NAMES_1(TAG)             RMH_API_TAG_NAME__##TAG
+#define __JOIN_TAG_NAMES_2(TAG, ...)        RMH_API_TAG_NAME__##TAG ", " __JOIN_TAG_NAMES_1(__VA_ARGS__)
+#define __JOIN_TAG_NAMES_3(TAG, ...)        RMH_API_TAG_NAME__##TAG ", " __JOIN_TAG_NAMES_2(__VA_ARGS__)
+#define __JOIN_TAG_NAMES_4(TAG, ...)        RMH_API_TAG_NAME__##TAG ", " __JOIN_TAG_NAMES_3(__VA_ARGS__)
+#define __JOIN_TAG_NAMES_X(...) __GET_EXE_MACRO(__VA_ARGS__, __EXE_NUM_TAGS_TOO_MANY, __EXE_NUM_TAGS_TOO_MANY, __EXE_NUM_TAGS_TOO_MANY, __EXE_NUM_TAGS_TOO_MANY, __JOIN_TAG_NAMES_4, __JOIN_TAG_NAMES_3, __JOIN_TAG_NAMES_2, __JOIN_TAG_NAMES_1)(__VA_ARGS__)
+
+#define __RMH_TAGS_MASK_RMH_TAGS(...) (0 __EXE_NUM_TAGS_X(__COMMAND_MAKE_TAG_MASK, __VA_ARGS__))
+#define __RMH_TAGS_COUNT_RMH_TAGS(...) (0 __EXE_NUM_TAGS_X(__COMMAND_MAKE_TAG_COUNT, __VA_ARGS__))
+#define __RMH_TAGS_STRING_RMH_TAGS(...) __JOIN_TAG_NAMES_X(__VA_ARGS__)
+#define __RMH_TAGS_MASK(TAGS_STR) __RMH_TAGS_MASK_##TAGS_STR
+#define __RMH_TAGS_COUNT(TAGS_STR) __RMH_TAGS_COUNT_##TAGS_STR
+#define __RMH_TAGS_STRING(TAGS_STR) __RMH_TAGS_STRING_##TAGS_STR
+
+
 /**********************************************************************************************************************
 This macro "wraps" an API. It will:
 1. Define a function specific to wrapping this API
@@ -101,6 +165,10 @@ This macro "wraps" an API. It will:
    GENERIC_API_NAME, SOC_API_ENABLED, and SOC_BEFORE_GENERIC. If an api fails, further api calls will not be made.
 4. We use pRMH_APIWRAP_PreAPIExecute(), pRMH_APIWRAP_GetSoCAPI() and pRMH_APIWRAP_PostAPIExecute() to do as much basic
    possibile outside of the macro. The param lists prevent us from doing everything in functions.
+5. Calls into the SoC are made between pRMH_APIWRAP_LockSoC() and pRMH_APIWRAP_UnlockSoC() so a thread safe handle
+   can serialize them when the SoC library requires it.
+6. When the handle has its cache enabled an API listed in librmh_cache.c is first looked up with pRMH_Cache_Get(). On a
+   hit neither the generic nor the SoC API is called. On a miss a successful result is stored with pRMH_Cache_Put().
 ******************************************/
 #define __RMH_API_WRAP_TRUE(DECLARATION, API_NAME, DESCRIPTION_STR, PARAMS_LIST, TAGS_STR, GENERIC_ENABLED, SOC_ENABLED, SOC_BEFORE_GENERIC) \
     RMH_Result GENERIC_IMPL__##API_NAME (__EXE_NUM_PARAMS_X(__COMMAND_MAKE_TYPE_LIST, __GET_ARGS(PARAMS_LIST))); \
@@ -109,21 +177,33 @@ This macro "wraps" an API. It will:
         RMH_Result socRet = RMH_SUCCESS; \
         RMH_Result genRet = RMH_SUCCESS; \
         RMH_Result (*socAPI)() = NULL; \
+        uint64_t cacheGeneration = 0; \
         while(0) { API_NAME( __EXE_NUM_PARAMS_X(__COMMAND_MAKE_VARIABLE_LIST, __GET_ARGS(PARAMS_LIST)) ); } \
         pRMH_APIWRAP_PreAPIExecute(handle, #API_NAME, SOC_ENABLED, SOC_BEFORE_GENERIC); \
+        if (pRMH_Cache_Enabled(handle, RMH_API_ID__##API_NAME) && \
+            pRMH_Cache_Get(RMH_API_ID__##API_NAME, &cacheGeneration, __EXE_NUM_PARAMS_X(__COMMAND_MAKE_VARIABLE_LIST, __GET_ARGS(PARAMS_LIST)))) { \
+            return pRMH_APIWRAP_PostAPIExecute(handle, #API_NAME, RMH_API_ID__##API_NAME, RMH_SUCCESS, RMH_SUCCESS); \
+        } \
         if (SOC_ENABLED) { \
-            socRet = pRMH_APIWRAP_GetSoCAPI(handle, "SoC_IMPL__"#API_NAME, &socAPI); \
+            socRet = pRMH_APIWRAP_GetSoCAPI(handle, #API_NAME, RMH_API_ID__##API_NAME, &socAPI); \
         } \
         if (socRet == RMH_SUCCESS && SOC_ENABLED && SOC_BEFORE_GENERIC) { \
+            pRMH_APIWRAP_LockSoC(handle); \
             socRet = socAPI(handle-> __EXE_NUM_PARAMS_X(__COMMAND_MAKE_VARIABLE_LIST, __GET_ARGS(PARAMS_LIST))); \
+            pRMH_APIWRAP_UnlockSoC(handle); \
         } \
         if (GENERIC_ENABLED && (!SOC_BEFORE_GENERIC || (SOC_BEFORE_GENERIC && socRet == RMH_SUCCESS))) { \
             genRet = (!SOC_ENABLED || socAPI) ? GENERIC_IMPL__##API_NAME(__EXE_NUM_PARAMS_X(__COMMAND_MAKE_VARIABLE_LIST, __GET_ARGS(PARAMS_LIST))) : RMH_UNIMPLEMENTED; \
         } \
         if (socRet == RMH_SUCCESS && SOC_ENABLED && !SOC_BEFORE_GENERIC && genRet == RMH_SUCCESS) { \
+            pRMH_APIWRAP_LockSoC(handle); \
             socRet = socAPI(handle-> __EXE_NUM_PARAMS_X(__COMMAND_MAKE_VARIABLE_LIST, __GET_ARGS(PARAMS_LIST))); \
+            pRMH_APIWRAP_UnlockSoC(handle); \
+        } \
+        if (cacheGeneration && socRet == RMH_SUCCESS && genRet == RMH_SUCCESS) { \
+            pRMH_Cache_Put(RMH_API_ID__##API_NAME, cacheGeneration, __EXE_NUM_PARAMS_X(__COMMAND_MAKE_VARIABLE_LIST, __GET_ARGS(PARAMS_LIST))); \
         } \
-        return pRMH_APIWRAP_PostAPIExecute(handle, #API_NAME, genRet, socRet); \
+        return pRMH_APIWRAP_PostAPIExecute(handle, #API_NAME, RMH_API_ID__##API_NAME, genRet, socRet); \
     } \
     __RMH_REGISTER_API(DECLARATION, API_NAME, DESCRIPTION_STR, PARAMS_LIST, TAGS_STR, GENERIC_ENABLED, SOC_ENABLED, SOC_BEFORE_GENERIC, SoC_IMPL__##API_NAME, GENERIC_IMPL__##API_NAME);
 
@@ -143,13 +223,20 @@ This macro "registers" an API which allows anyone who links this library to get
 
 1. Create a structure describing the parameters. It uses __EXE_NUM_PARAMS_X() macro to construct this. This is
    pRMH_PARAMS_##API_NAME
-2. Create a structure describing the API itself. This is pRMH_API_##API_NAME
-3. Register the API in the global context by creating a constructor function. This is
-   pRMH_APIWRAP_RegisterAPI_##API_NAME
+2. The structure describing the API itself is created by __RMH_API_DEFINITION() when rmh_api.h is included a second
+   time. This will become the entry for RMH_API_ID__##API_NAME in hRMHGeneric_APITable.
+3. __RMH_API_DEFINITION() also turns the tags of the API into the string and the mask of RMH_API.
 **********************************************************************************************************************/
 #define __RMH_REGISTER_API(DECLARATION, API_NAME, DESCRIPTION_STR, PARAMS_LIST, TAGS_STR, GENERIC_ENABLED, SOC_ENABLED, SOC_BEFORE_GENERIC, SOC_API_NAME, GEN_API_NAME) \
-    static RMHGeneric_Param pRMH_PARAMS_##API_NAME[] = { __EXE_NUM_PARAMS_X(__COMMAND_MAKE_API_STRUCT, __GET_ARGS(PARAMS_LIST)) }; \
-    static RMH_API pRMH_API_##API_NAME = { #API_NAME, SOC_ENABLED, GENERIC_ENABLED, #SOC_API_NAME, #DECLARATION, DESCRIPTION_STR, TAGS_STR, sizeof(pRMH_PARAMS_##API_NAME)/sizeof(pRMH_PARAMS_##API_NAME[0]), pRMH_PARAMS_##API_NAME }; \
-    __attribute__((constructor(300))) static void pRMH_APIWRAP_RegisterAPI_##API_NAME() { pRMH_APIWRAP_RegisterAPI(&pRMH_API_##API_NAME); } \
+    static const RMHGeneric_Param pRMH_PARAMS_##API_NAME[] = { __EXE_NUM_PARAMS_X(__COMMAND_MAKE_API_STRUCT, __GET_ARGS(PARAMS_LIST)) };
+
+#define __RMH_API_DEFINITION(DECLARATION, API_NAME, DESCRIPTION_STR, PARAMS_LIST, TAGS_STR, GENERIC_ENABLED, SOC_ENABLED, SOC_API_NAME) \
+    [RMH_API_ID__##API_NAME] = { #API_NAME, SOC_ENABLED, GENERIC_ENABLED, #SOC_API_NAME, #DECLARATION, DESCRIPTION_STR, __RMH_TAGS_STRING(TAGS_STR), sizeof(pRMH_PARAMS_##API_NAME)/sizeof(pRMH_PARAMS_##API_NAME[0]), pRMH_PARAMS_##API_NAME, RMH_API_ID__##API_NAME, __RMH_TAGS_MASK(TAGS_STR) },
+
+#define __RMH_API_DEFINITION_WRAP_TRUE(DECLARATION, API_NAME, DESCRIPTION_STR, PARAMS_LIST, TAGS_STR, GENERIC_ENABLED, SOC_ENABLED) \
+    __RMH_API_DEFINITION(DECLARATION, API_NAME, DESCRIPTION_STR, PARAMS_LIST, TAGS_STR, GENERIC_ENABLED, SOC_ENABLED, SoC_IMPL__##API_NAME)
+
+#define __RMH_API_DEFINITION_WRAP_FALSE(DECLARATION, API_NAME, DESCRIPTION_STR, PARAMS_LIST, TAGS_STR, GENERIC_ENABLED, SOC_ENABLED) \
+    __RMH_API_DEFINITION(DECLARATION, API_NAME, DESCRIPTION_STR, PARAMS_LIST, TAGS_STR, GENERIC_ENABLED, false, SoC_IMPL__##API_NAME)
 
 #endif /* LIB_RMH_API_WRAP_H */
@@ -0,0 +1,697 @@
+/*
+ * If not stated otherwise in this file or this component's Licenses.txt file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2016 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include <ctype.h>
+#include <errno.h>
+#include <strings.h>
+#include "rmh_soc_sim.h"
+
+/* Name of every API indexed by RMH_APIId so the config file can refer to APIs by name */
+#define RMH_API_IMPLEMENTATION_SOC_ONLY(DECLARATION, API_NAME, ...)            [RMH_API_ID__##API_NAME] = #API_NAME,
+#define RMH_API_IMPLEMENTATION_GENERIC_ONLY(DECLARATION, API_NAME, ...)         [RMH_API_ID__##API_NAME] = #API_NAME,
+#define RMH_API_IMPLEMENTATION_SOC_THEN_GENERIC(DECLARATION, API_NAME, ...)     [RMH_API_ID__##API_NAME] = #API_NAME,
+#define RMH_API_IMPLEMENTATION_GENERIC_THEN_SOC(DECLARATION, API_NAME, ...)     [RMH_API_ID__##API_NAME] = #API_NAME,
+#define RMH_API_IMPLEMENTATION_NO_WRAP(DECLARATION, API_NAME, ...)              [RMH_API_ID__##API_NAME] = #API_NAME,
+static const char * const hRMHSim_APINames[RMH_NUM_APIS] = {
+#undef RMH_API_H
+#include "rmh_api.h"
+};
+#undef RMH_API_IMPLEMENTATION_SOC_ONLY
+#undef RMH_API_IMPLEMENTATION_GENERIC_ONLY
+#undef RMH_API_IMPLEMENTATION_SOC_THEN_GENERIC
+#undef RMH_API_IMPLEMENTATION_GENERIC_THEN_SOC
+#undef RMH_API_IMPLEMENTATION_NO_WRAP
+
+#undef AS
+#define AS(x,y) { #x, x },
+static const struct { const char *name; RMH_Result value; } hRMHSim_Results[] = { ENUM_RMH_Result };
+#undef AS
+#define AS(x,y) x=(y),
+
+
+
+/**********************************************************************************************************************
+Entry points used by the generic library
+**********************************************************************************************************************/
+/* Every simulated API holds the handle lock so any number of threads may call in at once */
+const uint32_t RMH_SoCCapabilities = RMH_SOC_CAP_THREAD_SAFE;
+
+RMH_Handle RMH_Initialize(const RMH_EventCallback eventCB, void* userContext) {
+    pthread_condattr_t condAttr;
+    const char *config;
+    RMH* handle;
+
+    handle=calloc(1, sizeof(*handle));
+    if (!handle) {
+        RMHSIM_Print("Unable to allocate simulator handle!\n");
+        return NULL;
+    }
+    pthread_mutex_init(&handle->lock, NULL);
+    pthread_condattr_init(&condAttr);
+    pthread_condattr_setclock(&condAttr, CLOCK_MONOTONIC);
+    pthread_cond_init(&handle->eventThreadCond, &condAttr);
+    pthread_condattr_destroy(&condAttr);
+    handle->eventCB=eventCB;
+    handle->eventCBUserContext=userContext;
+
+    pRMHSim_SetDefaults(handle);
+    config=getenv(RMHSIM_CONFIG_ENV);
+    if (config && config[0] != '\0') {
+        pRMHSim_LoadConfig(handle, config);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &handle->linkUpTime);
+    handle->countersUpdated=handle->linkUpTime;
+    pRMHSim_StartEvents(handle);
+    return handle;
+}
+
+RMH_Result SoC_IMPL__RMH_Destroy(const RMH_Handle handle) {
+    if (!handle) {
+        return RMH_INVALID_PARAM;
+    }
+    pRMHSim_StopEvents(handle);
+    pthread_cond_destroy(&handle->eventThreadCond);
+    pthread_mutex_destroy(&handle->lock);
+    free(handle);
+    return RMH_SUCCESS;
+}
+
+__attribute__((visibility("hidden")))
+bool pRMHSim_Enter(RMH *handle, const RMH_APIId apiId, RMH_Result *forcedRet) {
+    uint32_t latencyUs=handle->apiLatencyUs[apiId];
+    if (latencyUs) {
+        struct timespec delay = { latencyUs / 1000000, (latencyUs % 1000000) * 1000 };
+        while (nanosleep(&delay, &delay) != 0 && errno == EINTR);
+    }
+    if (handle->apiResultForced[apiId]) {
+        *forcedRet=handle->apiResult[apiId];
+        return true;
+    }
+    pthread_mutex_lock(&handle->lock);
+    pRMHSim_UpdateCounters(handle);
+    return false;
+}
+
+__attribute__((visibility("hidden")))
+RMH_Result pRMHSim_Exit(RMH *handle, const RMH_Result ret) {
+    pthread_mutex_unlock(&handle->lock);
+    return ret;
+}
+
+
+
+/**********************************************************************************************************************
+Network state
+**********************************************************************************************************************/
+static
+uint64_t pRMHSim_DiffMs(const struct timespec *start, const struct timespec *stop) {
+    return (uint64_t)(stop->tv_sec - start->tv_sec) * 1000 + (stop->tv_nsec - start->tv_nsec) / 1000000;
+}
+
+static
+void pRMHSim_SetNodeDefaults(RMH *handle, const uint32_t nodeId) {
+    RMHSim_Node *node=&handle->nodes[nodeId];
+    uint32_t i;
+
+    node->mac[0]=0x00; node->mac[1]=0x10; node->mac[2]=0x18;
+    node->mac[3]=0xde; node->mac[4]=0xad; node->mac[5]=(uint8_t)nodeId;
+    node->highestVersion=RMH_MOCA_VERSION_20;
+    node->preferredNC=(nodeId == 0);
+    node->qam256Capable=true;
+    node->bondingCapable=false;
+    node->maxPacketAggregation=20;
+    node->maxFrameSize=10240;
+    node->txPowerReduction=0;
+    node->rxPower=-20.0 - nodeId;
+    node->snr=34.0 - nodeId;
+    node->maxConstellation[0]=node->maxConstellation[1]=node->maxConstellation[2]=node->maxConstellation[3]=10;
+    node->modulation=RMH_MOCA_SUBCARRIER_PROFILE_QAM_1024;
+    node->rxPacketRate=1000;
+    node->txPacketRate=1000;
+    for (i=0; i < RMH_MAX_MOCA_NODES; i++) {
+        /* Give each link a slightly different rate so meshes are easy to read */
+        node->phyRate[i]=(i == nodeId) ? 0 : 800 + ((nodeId * 7 + i * 13) % 10) * 10;
+    }
+}
+
+static
+void pRMHSim_SetFlowDefaults(RMH *handle, const uint32_t flowIndex) {
+    RMHSim_Flow *flow=&handle->flows[flowIndex];
+    uint32_t egressNodeId=1 + (flowIndex % (RMH_MAX_MOCA_NODES-1));
+
+    memset(flow, 0, sizeof(*flow));
+    flow->flowId[0]=0x01; flow->flowId[1]=0x00; flow->flowId[2]=0x5e;
+    flow->flowId[3]=0x01; flow->flowId[4]=0x00; flow->flowId[5]=(uint8_t)flowIndex;
+    memcpy(flow->ingressMac, handle->mac, sizeof(flow->ingressMac));
+    memcpy(flow->egressMac, handle->nodes[egressNodeId].mac, sizeof(flow->egressMac));
+    flow->egressNodeId=egressNodeId;
+    flow->peakDataRate=20000;
+    flow->burstSize=2;
+    flow->leaseTime=0;
+    flow->flowTag=flowIndex;
+    flow->maxLatency=10;
+    flow->shortTermAvgRatio=50;
+    flow->maxRetry=2;
+    flow->vlanTag=0xfff;
+    flow->flowPer=1;
+    flow->ingressClassificationRule=2;
+    flow->packetSize=1316;
+    flow->dscpMoCA=0;
+    flow->dfid=flowIndex+1;
+    clock_gettime(CLOCK_MONOTONIC, &flow->created);
+}
+
+/* Settings of the local node. These are what RMH_Self_RestoreDefaultSettings puts back */
+__attribute__((visibility("hidden")))
+void pRMHSim_SetSelfDefaults(RMH *handle) {
+    handle->enabled=true;
+    handle->linkUp=true;
+    handle->preferredNCEnabled=true;
+    handle->qam256Enabled=true;
+    handle->txPowerControlEnabled=true;
+    strcpy(handle->softwareVersion, "RMH SoC Simulator 1.0");
+    strcpy(handle->privacyPassword, "99999999988888888");
+    strcpy(handle->driverLogFilename, "/tmp/rmh_soc_sim.log");
+    handle->highestVersion=RMH_MOCA_VERSION_20;
+    handle->band=RMH_BAND_D;
+    handle->powerMode=RMH_POWER_MODE_M0_ACTIVE;
+    handle->standbyMode=RMH_POWER_MODE_M1_IDLE;
+    handle->driverLogLevel=RMH_LOG_ERROR;
+    handle->lastResetReason=RMH_MOCA_RESET_REASON_NO_RESET_OCCURRED;
+    handle->lof=1150;
+    handle->frequencyMask=0x1fe00000;
+    handle->primaryChannelOffset=-25;
+    handle->secondaryChannelOffset=125;
+    handle->maxPacketAggregation=20;
+    handle->maxFrameSize=10240;
+    handle->lowBandwidthLimit=50;
+    handle->txPowerLimit=7;
+    handle->qam256TargetPhyRate=235;
+    handle->primaryChannelTargetPhyRate=235;
+    handle->secondaryChannelTargetPhyRate=235;
+    handle->tabooStart=41;
+    handle->tabooMask=0x003ffc00;
+}
+
+__attribute__((visibility("hidden")))
+void pRMHSim_SetDefaults(RMH *handle) {
+    uint32_t i;
+
+    pRMHSim_SetSelfDefaults(handle);
+    /* An interface every host has so the link can come up without a config file */
+    strcpy(handle->interfaceName, "lo");
+    handle->selfNodeId=0;
+    handle->ncNodeId=0;
+    handle->backupNCNodeId=1;
+    handle->rfChannelFreq=1150;
+    handle->secondaryChannelFreq=1250;
+    for (i=0; i < RMH_MAX_MOCA_NODES; i++) {
+        pRMHSim_SetNodeDefaults(handle, i);
+        handle->nodes[i].present=(i < 4);
+    }
+    memcpy(handle->mac, handle->nodes[handle->selfNodeId].mac, sizeof(handle->mac));
+    handle->numFlows=2;
+    for (i=0; i < RMHSIM_MAX_FLOWS; i++) {
+        pRMHSim_SetFlowDefaults(handle, i);
+    }
+
+    handle->acaStatus=RMH_ACA_STATUS_NOT_REQUESTED;
+}
+
+__attribute__((visibility("hidden")))
+uint32_t pRMHSim_NumNodes(const RMH *handle) {
+    uint32_t i;
+    uint32_t numNodes=0;
+    for (i=0; i < RMH_MAX_MOCA_NODES; i++) {
+        if (handle->nodes[i].present) numNodes++;
+    }
+    return numNodes;
+}
+
+__attribute__((visibility("hidden")))
+int32_t pRMHSim_FindFlow(const RMH *handle, const RMH_MacAddress_t flowId) {
+    uint32_t i;
+    for (i=0; i < handle->numFlows; i++) {
+        if (memcmp(handle->flows[i].flowId, flowId, sizeof(RMH_MacAddress_t)) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**********************************************************************************************************************
+Counters are driven by the packet rates of each node. Rather than accumulating rate * delta, which would lose the
+fraction on every call, each counter advances by the difference of rate * time at the end and start of the interval.
+Only time the link is up counts.
+**********************************************************************************************************************/
+static inline
+uint64_t pRMHSim_Advance(const uint64_t ratePerSec, const uint64_t fromMs, const uint64_t toMs) {
+    return (ratePerSec * toMs) / 1000 - (ratePerSec * fromMs) / 1000;
+}
+
+__attribute__((visibility("hidden")))
+void pRMHSim_UpdateCounters(RMH *handle) {
+    RMHSim_Counters *c=&handle->counters;
+    struct timespec now;
+    uint64_t fromMs, toMs, packets;
+    uint32_t i;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if (!handle->enabled || !handle->linkUp) {
+        handle->countersUpdated=now;
+        return;
+    }
+
+    fromMs=pRMHSim_DiffMs(&handle->linkUpTime, &handle->countersUpdated);
+    toMs=pRMHSim_DiffMs(&handle->linkUpTime, &now);
+    if (toMs <= fromMs) {
+        return;
+    }
+
+    for (i=0; i < RMH_MAX_MOCA_NODES; i++) {
+        const RMHSim_Node *node=&handle->nodes[i];
+        if (!node->present || i == handle->selfNodeId) continue;
+        packets=pRMHSim_Advance(node->rxPacketRate, fromMs, toMs);
+        c->rxNodePackets[i] += packets;
+        c->rxUnicastPackets += packets;
+        c->rxBytes += packets * 1024;
+        if (node->snr < 30.0) {
+            c->rxCorrectedErrors[i] += pRMHSim_Advance(node->rxPacketRate / 100, fromMs, toMs);
+        }
+        if (node->snr < 20.0) {
+            c->rxUncorrectedErrors[i] += pRMHSim_Advance(node->rxPacketRate / 1000, fromMs, toMs);
+        }
+        packets=pRMHSim_Advance(node->txPacketRate, fromMs, toMs);
+        c->txNodePackets[i] += packets;
+        c->txUnicastPackets += packets;
+        c->txBytes += packets * 1024;
+    }
+    for (i=0; i < handle->numFlows; i++) {
+        const RMHSim_Flow *flow=&handle->flows[i];
+        c->flowTxPackets[i] += pRMHSim_Advance(flow->packetSize ? (uint64_t)flow->peakDataRate * 1000 / 8 / flow->packetSize : 0, fromMs, toMs);
+    }
+
+    /* A MAP every millisecond, a beacon every 10ms and some broadcast and control traffic */
+    c->txBroadcastPackets += pRMHSim_Advance(10, fromMs, toMs);
+    c->rxBroadcastPackets += pRMHSim_Advance(10 * (pRMHSim_NumNodes(handle)-1), fromMs, toMs);
+    c->txMulticastPackets += pRMHSim_Advance(5, fromMs, toMs);
+    c->rxMulticastPackets += pRMHSim_Advance(5, fromMs, toMs);
+    c->txLinkControlPackets += pRMHSim_Advance(2, fromMs, toMs);
+    c->rxLinkControlPackets += pRMHSim_Advance(2, fromMs, toMs);
+    c->txReservationRequestPackets += pRMHSim_Advance(100, fromMs, toMs);
+    c->rxReservationRequestPackets += pRMHSim_Advance(100 * (pRMHSim_NumNodes(handle)-1), fromMs, toMs);
+    if (handle->selfNodeId == handle->ncNodeId) {
+        c->txMapPackets += pRMHSim_Advance(1000, fromMs, toMs);
+        c->txBeacons += pRMHSim_Advance(100, fromMs, toMs);
+    }
+    else {
+        c->rxMapPackets += pRMHSim_Advance(1000, fromMs, toMs);
+        c->rxBeacons += pRMHSim_Advance(100, fromMs, toMs);
+    }
+    handle->countersUpdated=now;
+}
+
+
+
+/**********************************************************************************************************************
+Config file
+**********************************************************************************************************************/
+static
+bool pRMHSim_ParseAPI(const char *str, RMH_APIId *apiId) {
+    uint32_t i;
+    for (i=0; i < RMH_NUM_APIS; i++) {
+        if (hRMHSim_APINames[i] && strcasecmp(hRMHSim_APINames[i], str) == 0) {
+            *apiId=i;
+            return true;
+        }
+    }
+    return false;
+}
+
+static
+bool pRMHSim_ParseResult(const char *str, RMH_Result *result) {
+    char *end;
+    uint32_t i;
+    for (i=0; i < sizeof(hRMHSim_Results)/sizeof(hRMHSim_Results[0]); i++) {
+        if (strcasecmp(hRMHSim_Results[i].name, str) == 0) {
+            *result=hRMHSim_Results[i].value;
+            return true;
+        }
+    }
+    *result=(RMH_Result)strtoul(str, &end, 0);
+    return (end != str && *end == '\0');
+}
+
+static
+bool pRMHSim_ParseMac(const char *str, RMH_MacAddress_t mac) {
+    unsigned int m[6];
+    uint32_t i;
+    if (sscanf(str, "%x:%x:%x:%x:%x:%x", &m[0], &m[1], &m[2], &m[3], &m[4], &m[5]) != 6) {
+        return false;
+    }
+    for (i=0; i < 6; i++) {
+        mac[i]=(uint8_t)m[i];
+    }
+    return true;
+}
+
+static
+bool pRMHSim_ParseVersion(const char *str, RMH_MoCAVersion *version) {
+    if (strcmp(str, "1.0") == 0) *version=RMH_MOCA_VERSION_10;
+    else if (strcmp(str, "1.1") == 0) *version=RMH_MOCA_VERSION_11;
+    else if (strcmp(str, "2.0") == 0) *version=RMH_MOCA_VERSION_20;
+    else return false;
+    return true;
+}
+
+static
+bool pRMHSim_ParseNodeId(const char *str, uint32_t *nodeId) {
+    char *end;
+    *nodeId=strtoul(str, &end, 0);
+    return (end != str && *end == '\0' && *nodeId < RMH_MAX_MOCA_NODES);
+}
+
+static
+bool pRMHSim_ParseEvent(RMH *handle, char **argv, const uint32_t argc) {
+    RMHSim_ScriptEvent *event;
+    char *end;
+
+    if (argc < 2 || handle->numScriptEvents >= RMHSIM_MAX_EVENTS) {
+        return false;
+    }
+    event=&handle->scriptEvents[handle->numScriptEvents];
+    event->atMs=strtoul(argv[0], &end, 0);
+    if (end == argv[0] || *end != '\0') {
+        return false;
+    }
+    if (strcasecmp(argv[1], "link_up") == 0) event->type=RMHSIM_EVENT_LINK_UP;
+    else if (strcasecmp(argv[1], "link_down") == 0) event->type=RMHSIM_EVENT_LINK_DOWN;
+    else if (strcasecmp(argv[1], "join") == 0) event->type=RMHSIM_EVENT_NODE_JOIN;
+    else if (strcasecmp(argv[1], "drop") == 0) event->type=RMHSIM_EVENT_NODE_DROP;
+    else if (strcasecmp(argv[1], "nc") == 0) event->type=RMHSIM_EVENT_NC_CHANGE;
+    else if (strcasecmp(argv[1], "reset") == 0) event->type=RMHSIM_EVENT_MOCA_RESET;
+    else if (strcasecmp(argv[1], "low_bandwidth") == 0) event->type=RMHSIM_EVENT_LOW_BANDWIDTH;
+    else return false;
+
+    if (event->type == RMHSIM_EVENT_NODE_JOIN || event->type == RMHSIM_EVENT_NODE_DROP || event->type == RMHSIM_EVENT_NC_CHANGE) {
+        if (argc < 3 || !pRMHSim_ParseNodeId(argv[2], &event->nodeId)) {
+            return false;
+        }
+    }
+    handle->numScriptEvents++;
+    return true;
+}
+
+static
+bool pRMHSim_ParseNode(RMH *handle, char **argv, const uint32_t argc) {
+    RMHSim_Node *node;
+    uint32_t nodeId;
+
+    if (argc < 2 || !pRMHSim_ParseNodeId(argv[0], &nodeId)) {
+        return false;
+    }
+    node=&handle->nodes[nodeId];
+    if (strcasecmp(argv[1], "present") == 0) node->present=true;
+    else if (strcasecmp(argv[1], "absent") == 0) node->present=false;
+    else if (argc < 3) return false;
+    else if (strcasecmp(argv[1], "mac") == 0) return pRMHSim_ParseMac(argv[2], node->mac);
+    else if (strcasecmp(argv[1], "version") == 0) return pRMHSim_ParseVersion(argv[2], &node->highestVersion);
+    else if (strcasecmp(argv[1], "rx_power") == 0) node->rxPower=strtof(argv[2], NULL);
+    else if (strcasecmp(argv[1], "snr") == 0) node->snr=strtof(argv[2], NULL);
+    else if (strcasecmp(argv[1], "modulation") == 0) node->modulation=(RMH_SubcarrierProfile)strtoul(argv[2], NULL, 0);
+    else if (strcasecmp(argv[1], "rx_packet_rate") == 0) node->rxPacketRate=strtoul(argv[2], NULL, 0);
+    else if (strcasecmp(argv[1], "tx_packet_rate") == 0) node->txPacketRate=strtoul(argv[2], NULL, 0);
+    else if (strcasecmp(argv[1], "preferred_nc") == 0) node->preferredNC=strtoul(argv[2], NULL, 0) != 0;
+    else return false;
+    return true;
+}
+
+static
+bool pRMHSim_ParseLine(RMH *handle, char **argv, const uint32_t argc) {
+    const char *key=argv[0];
+    uint32_t i, j;
+
+    if (strcasecmp(key, "node") == 0) {
+        return pRMHSim_ParseNode(handle, &argv[1], argc-1);
+    }
+    else if (strcasecmp(key, "event") == 0) {
+        return pRMHSim_ParseEvent(handle, &argv[1], argc-1);
+    }
+    else if (argc < 2) {
+        return false;
+    }
+    else if (strcasecmp(key, "nodes") == 0) {
+        uint32_t numNodes=strtoul(argv[1], NULL, 0);
+        if (numNodes < 1 || numNodes > RMH_MAX_MOCA_NODES) return false;
+        for (i=0; i < RMH_MAX_MOCA_NODES; i++) {
+            handle->nodes[i].present=(i < numNodes);
+        }
+    }
+    else if (strcasecmp(key, "self") == 0) {
+        if (!pRMHSim_ParseNodeId(argv[1], &handle->selfNodeId)) return false;
+        handle->nodes[handle->selfNodeId].present=true;
+        memcpy(handle->mac, handle->nodes[handle->selfNodeId].mac, sizeof(handle->mac));
+    }
+    else if (strcasecmp(key, "interface") == 0) {
+        if (strlen(argv[1]) >= sizeof(handle->interfaceName)) return false;
+        strcpy(handle->interfaceName, argv[1]);
+    }
+    else if (strcasecmp(key, "nc") == 0) {
+        return pRMHSim_ParseNodeId(argv[1], &handle->ncNodeId);
+    }
+    else if (strcasecmp(key, "backup_nc") == 0) {
+        return pRMHSim_ParseNodeId(argv[1], &handle->backupNCNodeId);
+    }
+    else if (strcasecmp(key, "enabled") == 0) {
+        handle->enabled=strtoul(argv[1], NULL, 0) != 0;
+    }
+    else if (strcasecmp(key, "link") == 0) {
+        handle->linkUp=(strcasecmp(argv[1], "up") == 0);
+    }
+    else if (strcasecmp(key, "moca_version") == 0) {
+        return pRMHSim_ParseVersion(argv[1], &handle->highestVersion);
+    }
+    else if (strcasecmp(key, "lof") == 0) {
+        handle->lof=handle->rfChannelFreq=strtoul(argv[1], NULL, 0);
+    }
+    else if (strcasecmp(key, "flows") == 0) {
+        handle->numFlows=strtoul(argv[1], NULL, 0);
+        if (handle->numFlows > RMHSIM_MAX_FLOWS) return false;
+    }
+    else if (strcasecmp(key, "phy_rate") == 0) {
+        /* phy_rate <from|*> <to|*> <Mbps> */
+        uint32_t from, to, rate;
+        if (argc < 4) return false;
+        rate=strtoul(argv[3], NULL, 0);
+        for (i=0; i < RMH_MAX_MOCA_NODES; i++) {
+            if (strcmp(argv[1], "*") != 0 && (!pRMHSim_ParseNodeId(argv[1], &from) || from != i)) continue;
+            for (j=0; j < RMH_MAX_MOCA_NODES; j++) {
+                if (strcmp(argv[2], "*") != 0 && (!pRMHSim_ParseNodeId(argv[2], &to) || to != j)) continue;
+                if (i != j) handle->nodes[i].phyRate[j]=rate;
+            }
+        }
+    }
+    else if (strcasecmp(key, "latency") == 0) {
+        /* latency <API|*> <us> */
+        RMH_APIId apiId;
+        uint32_t latencyUs;
+        if (argc < 3) return false;
+        latencyUs=strtoul(argv[2], NULL, 0);
+        if (strcmp(argv[1], "*") == 0) {
+            for (i=0; i < RMH_NUM_APIS; i++) handle->apiLatencyUs[i]=latencyUs;
+        }
+        else if (pRMHSim_ParseAPI(argv[1], &apiId)) {
+            handle->apiLatencyUs[apiId]=latencyUs;
+        }
+        else {
+            return false;
+        }
+    }
+    else if (strcasecmp(key, "result") == 0) {
+        /* result <API> <RMH_Result> */
+        RMH_APIId apiId;
+        if (argc < 3 || !pRMHSim_ParseAPI(argv[1], &apiId) || !pRMHSim_ParseResult(argv[2], &handle->apiResult[apiId])) return false;
+        handle->apiResultForced[apiId]=true;
+    }
+    else if (strcasecmp(key, "event_loop") == 0) {
+        handle->scriptLoopMs=strtoul(argv[1], NULL, 0);
+    }
+    else {
+        return false;
+    }
+    return true;
+}
+
+__attribute__((visibility("hidden")))
+void pRMHSim_LoadConfig(RMH *handle, const char *filename) {
+    char line[256];
+    uint32_t lineNum=0;
+    FILE *file=fopen(filename, "r");
+
+    if (!file) {
+        RMHSIM_Print("Unable to open config '%s'. Using the default network\n", filename);
+        return;
+    }
+    while (fgets(line, sizeof(line), file)) {
+        char *argv[8];
+        uint32_t argc=0;
+        char *save=NULL;
+        char *tok;
+
+        lineNum++;
+        line[strcspn(line, "#\r\n")]='\0';
+        for (tok=strtok_r(line, " \t", &save); tok && argc < sizeof(argv)/sizeof(argv[0]); tok=strtok_r(NULL, " \t", &save)) {
+            argv[argc++]=tok;
+        }
+        if (argc && !pRMHSim_ParseLine(handle, argv, argc)) {
+            RMHSIM_Print("%s:%u: Ignoring bad line starting with '%s'\n", filename, lineNum, argv[0]);
+        }
+    }
+    fclose(file);
+    memcpy(handle->mac, handle->nodes[handle->selfNodeId].mac, sizeof(handle->mac));
+    for (lineNum=0; lineNum < RMHSIM_MAX_FLOWS; lineNum++) {
+        pRMHSim_SetFlowDefaults(handle, lineNum);
+    }
+}
+
+
+
+/**********************************************************************************************************************
+Scripted events. The thread walks the events in the order they appear in the config, waiting until each one is due,
+and replays the whole script every 'event_loop' milliseconds if that's set. Each event is applied to the network under
+the lock and the callback is made after the lock is released so the callback is free to call back into the library.
+**********************************************************************************************************************/
+static
+RMH_Event pRMHSim_ApplyEvent(RMH *handle, const RMHSim_ScriptEvent *scriptEvent, RMH_EventData *eventData) {
+    struct timespec now;
+
+    memset(eventData, 0, sizeof(*eventData));
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    pRMHSim_UpdateCounters(handle);
+    switch (scriptEvent->type) {
+    case RMHSIM_EVENT_LINK_UP:
+        handle->linkUp=true;
+        handle->linkUpTime=now;
+        handle->countersUpdated=now;
+        eventData->RMH_EVENT_LINK_STATUS_CHANGED.status=RMH_LINK_STATUS_UP;
+        return RMH_EVENT_LINK_STATUS_CHANGED;
+    case RMHSIM_EVENT_LINK_DOWN:
+        handle->linkUp=false;
+        handle->linkDownCount++;
+        eventData->RMH_EVENT_LINK_STATUS_CHANGED.status=RMH_LINK_STATUS_NO_LINK;
+        return RMH_EVENT_LINK_STATUS_CHANGED;
+    case RMHSIM_EVENT_NODE_JOIN:
+        handle->nodes[scriptEvent->nodeId].present=true;
+        handle->counters.admissionAttempts++;
+        handle->counters.admissionSucceeded++;
+        eventData->RMH_EVENT_NODE_JOINED.nodeId=scriptEvent->nodeId;
+        return RMH_EVENT_NODE_JOINED;
+    case RMHSIM_EVENT_NODE_DROP:
+        handle->nodes[scriptEvent->nodeId].present=false;
+        eventData->RMH_EVENT_NODE_DROPPED.nodeId=scriptEvent->nodeId;
+        return RMH_EVENT_NODE_DROPPED;
+    case RMHSIM_EVENT_NC_CHANGE:
+        handle->ncNodeId=scriptEvent->nodeId;
+        eventData->RMH_EVENT_NC_ID_CHANGED.ncValid=true;
+        eventData->RMH_EVENT_NC_ID_CHANGED.ncNodeId=scriptEvent->nodeId;
+        return RMH_EVENT_NC_ID_CHANGED;
+    case RMHSIM_EVENT_MOCA_RESET:
+        handle->resetCount++;
+        handle->lastResetReason=RMH_MOCA_RESET_REASON_REMOTE_NODE_REQUEST;
+        eventData->RMH_EVENT_MOCA_RESET.reason=RMH_MOCA_RESET_REASON_REMOTE_NODE_REQUEST;
+        return RMH_EVENT_MOCA_RESET;
+    case RMHSIM_EVENT_LOW_BANDWIDTH:
+        return RMH_EVENT_LOW_BANDWIDTH;
+    }
+    return 0;
+}
+
+static
+void *pRMHSim_EventThread(void *context) {
+    RMH *handle=(RMH *)context;
+    struct timespec scriptStart;
+    uint32_t i=0;
+
+    clock_gettime(CLOCK_MONOTONIC, &scriptStart);
+    pthread_mutex_lock(&handle->lock);
+    while (!handle->eventThreadExit) {
+        const RMHSim_ScriptEvent *scriptEvent=&handle->scriptEvents[i];
+        struct timespec due=scriptStart;
+        RMH_EventData eventData;
+        RMH_Event event;
+
+        due.tv_sec += scriptEvent->atMs / 1000;
+        due.tv_nsec += (scriptEvent->atMs % 1000) * 1000000;
+        if (due.tv_nsec >= 1000000000) {
+            due.tv_sec++;
+            due.tv_nsec -= 1000000000;
+        }
+        if (pthread_cond_timedwait(&handle->eventThreadCond, &handle->lock, &due) != ETIMEDOUT) {
+            continue; /* Woken to exit or spuriously */
+        }
+
+        event=pRMHSim_ApplyEvent(handle, scriptEvent, &eventData);
+        if (handle->eventCB && (handle->eventNotifyBitMask & event)) {
+            RMH_EventCallback eventCB=handle->eventCB;
+            void *userContext=handle->eventCBUserContext;
+            pthread_mutex_unlock(&handle->lock);
+            eventCB(event, &eventData, userContext);
+            pthread_mutex_lock(&handle->lock);
+        }
+
+        if (++i >= handle->numScriptEvents) {
+            if (!handle->scriptLoopMs) {
+                break;
+            }
+            i=0;
+            scriptStart.tv_sec += handle->scriptLoopMs / 1000;
+            scriptStart.tv_nsec += (handle->scriptLoopMs % 1000) * 1000000;
+            if (scriptStart.tv_nsec >= 1000000000) {
+                scriptStart.tv_sec++;
+                scriptStart.tv_nsec -= 1000000000;
+            }
+        }
+    }
+    pthread_mutex_unlock(&handle->lock);
+    return NULL;
+}
+
+__attribute__((visibility("hidden")))
+void pRMHSim_StartEvents(RMH *handle) {
+    if (handle->numScriptEvents) {
+        if (pthread_create(&handle->eventThread, NULL, pRMHSim_EventThread, handle) == 0) {
+            handle->eventThreadRunning=true;
+        }
+        else {
+            RMHSIM_Print("Unable to start the event thread. Scripted events will not be sent\n");
+        }
+    }
+}
+
+__attribute__((visibility("hidden")))
+void pRMHSim_StopEvents(RMH *handle) {
+    if (handle->eventThreadRunning) {
+        pthread_mutex_lock(&handle->lock);
+        handle->eventThreadExit=true;
+        pthread_cond_broadcast(&handle->eventThreadCond);
+        pthread_mutex_unlock(&handle->lock);
+        pthread_join(handle->eventThread, NULL);
+        handle->eventThreadRunning=false;
+    }
+}
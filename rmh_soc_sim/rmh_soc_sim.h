@@ -0,0 +1,265 @@
+/*
+ * If not stated otherwise in this file or this component's Licenses.txt file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2016 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef RMH_SOC_SIM_H
+#define RMH_SOC_SIM_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+#include "rmh_type.h"
+
+/**********************************************************************************************************************
+This is a simulated SoC library. It implements the SoC_IMPL__ entry points of librdkmocahalsoc.so.0 on top of a virtual
+MoCA network held in memory so the generic library, rmh and rmh_monitor can be run and benchmarked without hardware.
+
+The network is described by the file named in the environment variable RMH_SOC_SIM_CONFIG. Without it a four node
+MoCA 2.0 network with the local node as NC is used. See rmh_soc_sim.conf for the format.
+**********************************************************************************************************************/
+#define RMHSIM_CONFIG_ENV                   "RMH_SOC_SIM_CONFIG"
+#define RMHSIM_NUM_SUBCARRIERS              512
+#define RMHSIM_MAX_FLOWS                    32
+#define RMHSIM_MAX_EVENTS                   64
+#define RMHSIM_NUM_AGGREGATION_BINS         10
+
+typedef struct RMHSim_Node {
+    bool present;
+    RMH_MacAddress_t mac;
+    RMH_MoCAVersion highestVersion;
+    bool preferredNC;
+    bool qam256Capable;
+    bool bondingCapable;
+    uint32_t maxPacketAggregation;
+    uint32_t maxFrameSize;
+    uint32_t txPowerReduction;
+    float rxPower;                                              /* dBm as seen by the local node */
+    float snr;                                                  /* dB as seen by the local node */
+    uint32_t maxConstellation[4];                               /* GCD100, GCD50, P2P100, P2P50 */
+    uint32_t phyRate[RMH_MAX_MOCA_NODES];                       /* Mbps from this node to every other node */
+    RMH_SubcarrierProfile modulation;                           /* Typical subcarrier profile to this node */
+    uint32_t rxPacketRate;                                      /* Packets per second received from this node */
+    uint32_t txPacketRate;                                      /* Packets per second sent to this node */
+} RMHSim_Node;
+
+typedef struct RMHSim_Flow {
+    RMH_MacAddress_t flowId;
+    RMH_MacAddress_t ingressMac;
+    RMH_MacAddress_t egressMac;
+    uint32_t egressNodeId;
+    uint32_t peakDataRate;
+    uint32_t burstSize;
+    uint32_t leaseTime;
+    uint32_t flowTag;
+    uint32_t maxLatency;
+    uint32_t shortTermAvgRatio;
+    uint32_t maxRetry;
+    uint32_t vlanTag;
+    uint32_t flowPer;
+    uint32_t ingressClassificationRule;
+    uint32_t packetSize;
+    uint32_t dscpMoCA;
+    uint32_t dfid;
+    struct timespec created;
+} RMHSim_Flow;
+
+typedef enum RMHSim_EventType {
+    RMHSIM_EVENT_LINK_UP,
+    RMHSIM_EVENT_LINK_DOWN,
+    RMHSIM_EVENT_NODE_JOIN,
+    RMHSIM_EVENT_NODE_DROP,
+    RMHSIM_EVENT_NC_CHANGE,
+    RMHSIM_EVENT_MOCA_RESET,
+    RMHSIM_EVENT_LOW_BANDWIDTH
+} RMHSim_EventType;
+
+typedef struct RMHSim_ScriptEvent {
+    uint32_t atMs;                                              /* Time from the start of the script */
+    RMHSim_EventType type;
+    uint32_t nodeId;
+} RMHSim_ScriptEvent;
+
+typedef struct RMHSim_Counters {
+    uint64_t txBytes;
+    uint64_t rxBytes;
+    uint64_t txUnicastPackets;
+    uint64_t rxUnicastPackets;
+    uint64_t txBroadcastPackets;
+    uint64_t rxBroadcastPackets;
+    uint64_t txMulticastPackets;
+    uint64_t rxMulticastPackets;
+    uint64_t txMapPackets;
+    uint64_t rxMapPackets;
+    uint64_t txReservationRequestPackets;
+    uint64_t rxReservationRequestPackets;
+    uint64_t txLinkControlPackets;
+    uint64_t rxLinkControlPackets;
+    uint64_t txBeacons;
+    uint64_t rxBeacons;
+    uint64_t rxCorrectedErrors[RMH_MAX_MOCA_NODES];
+    uint64_t rxUncorrectedErrors[RMH_MAX_MOCA_NODES];
+    uint64_t rxNodePackets[RMH_MAX_MOCA_NODES];
+    uint64_t txNodePackets[RMH_MAX_MOCA_NODES];
+    uint64_t flowTxPackets[RMHSIM_MAX_FLOWS];
+    uint32_t admissionAttempts;
+    uint32_t admissionSucceeded;
+    uint32_t admissionFailures;
+} RMHSim_Counters;
+
+typedef struct RMH {
+    pthread_mutex_t lock;
+    RMH_EventCallback eventCB;
+    void* eventCBUserContext;
+    uint32_t eventNotifyBitMask;
+
+    /* Per API behaviour, indexed by RMH_APIId */
+    uint32_t apiLatencyUs[RMH_NUM_APIS];
+    RMH_Result apiResult[RMH_NUM_APIS];
+    bool apiResultForced[RMH_NUM_APIS];
+
+    /* Local node settings */
+    bool enabled;
+    bool linkUp;
+    bool scanLOFOnly;
+    bool preferredNCEnabled;
+    bool qam256Enabled;
+    bool turboEnabled;
+    bool bondingEnabled;
+    bool privacyEnabled;
+    bool txPowerControlEnabled;
+    bool txBeaconPowerReductionEnabled;
+    char interfaceName[32];
+    char softwareVersion[64];
+    char privacyPassword[32];
+    char driverLogFilename[128];
+    RMH_MacAddress_t mac;
+    RMH_MoCAVersion highestVersion;
+    RMH_Band band;
+    RMH_PowerMode powerMode;
+    RMH_PowerMode standbyMode;
+    RMH_LogLevel driverLogLevel;
+    RMH_MoCAResetReason lastResetReason;
+    uint32_t lof;
+    uint32_t frequencyMask;
+    int32_t primaryChannelOffset;
+    int32_t secondaryChannelOffset;
+    uint32_t maxPacketAggregation;
+    uint32_t maxFrameSize;
+    uint32_t lowBandwidthLimit;
+    int32_t txPowerLimit;
+    uint32_t qam256TargetPhyRate;
+    uint32_t primaryChannelTargetPhyRate;
+    uint32_t secondaryChannelTargetPhyRate;
+    uint32_t txBeaconPowerReduction;
+    uint32_t tabooStart;
+    uint32_t tabooMask;
+
+    /* Network */
+    uint32_t selfNodeId;
+    uint32_t ncNodeId;
+    uint32_t backupNCNodeId;
+    uint32_t rfChannelFreq;
+    uint32_t secondaryChannelFreq;
+    uint32_t resetCount;
+    uint32_t linkDownCount;
+    struct timespec linkUpTime;
+    RMHSim_Node nodes[RMH_MAX_MOCA_NODES];
+    uint32_t numFlows;
+    RMHSim_Flow flows[RMHSIM_MAX_FLOWS];
+
+    /* ACA */
+    uint32_t acaChannel;
+    uint32_t acaSourceNodeId;
+    uint32_t acaDestinationNodeMask;
+    RMH_ACAType acaType;
+    RMH_ACAStatus acaStatus;
+
+    /* Counters advance with time while the link is up */
+    RMHSim_Counters counters;
+    struct timespec countersUpdated;
+
+    /* Scripted events */
+    uint32_t numScriptEvents;
+    RMHSim_ScriptEvent scriptEvents[RMHSIM_MAX_EVENTS];
+    uint32_t scriptLoopMs;
+    bool eventThreadRunning;
+    bool eventThreadExit;
+    pthread_t eventThread;
+    pthread_cond_t eventThreadCond;
+} RMH;
+
+#define RMHSIM_Print(fmt, ...) fprintf(stderr, "RMH_SOC_SIM: " fmt, ##__VA_ARGS__)
+
+/**********************************************************************************************************************
+Every simulated API starts with RMHSIM_ENTER() and returns with RMHSIM_EXIT(). RMHSIM_ENTER() applies the configured
+latency outside of the lock, then takes the lock and brings the counters up to date. If a result has been forced for
+the API in the config file it is returned right away so any API can be made to fail without changing the simulator.
+**********************************************************************************************************************/
+#define RMHSIM_ENTER(HANDLE, API_NAME) { \
+    RMH_Result __forcedRet; \
+    if (!HANDLE) return RMH_INVALID_PARAM; \
+    if (pRMHSim_Enter(HANDLE, RMH_API_ID__##API_NAME, &__forcedRet)) return __forcedRet; \
+}
+
+#define RMHSIM_EXIT(HANDLE, RET) \
+    return pRMHSim_Exit(HANDLE, RET)
+
+/**********************************************************************************************************************
+Declare SoC_IMPL__ for every wrapped API which calls into the SoC. The parameter lists come straight from rmh_api.h so a
+simulated API which doesn't match the header fails to compile. APIs the simulator doesn't implement aren't exported at
+all, just like a SoC library missing them, so RMH reports them with RMH_GetUnimplementedAPIs.
+**********************************************************************************************************************/
+#include "librmh_wrap.h"
+
+#define __RMHSIM_DECLARE_FALSE(DECLARATION, API_NAME, PARAMS_LIST)
+#define __RMHSIM_DECLARE_TRUE(DECLARATION, API_NAME, PARAMS_LIST) \
+    RMH_Result SoC_IMPL__##API_NAME(__EXE_NUM_PARAMS_X(__COMMAND_MAKE_TYPE_LIST, __GET_ARGS(PARAMS_LIST)));
+
+#define RMH_API_IMPLEMENTATION_SOC_ONLY(DECLARATION, API_NAME, DESCRIPTION_STR, PARAMS_LIST, WRAP_API, TAGS_STR)            __RMHSIM_DECLARE_##WRAP_API(DECLARATION, API_NAME, PARAMS_LIST)
+#define RMH_API_IMPLEMENTATION_GENERIC_ONLY(DECLARATION, API_NAME, DESCRIPTION_STR, PARAMS_LIST, WRAP_API, TAGS_STR)
+#define RMH_API_IMPLEMENTATION_SOC_THEN_GENERIC(DECLARATION, API_NAME, DESCRIPTION_STR, PARAMS_LIST, WRAP_API, TAGS_STR)    __RMHSIM_DECLARE_##WRAP_API(DECLARATION, API_NAME, PARAMS_LIST)
+#define RMH_API_IMPLEMENTATION_GENERIC_THEN_SOC(DECLARATION, API_NAME, DESCRIPTION_STR, PARAMS_LIST, WRAP_API, TAGS_STR)    __RMHSIM_DECLARE_##WRAP_API(DECLARATION, API_NAME, PARAMS_LIST)
+#define RMH_API_IMPLEMENTATION_NO_WRAP(DECLARATION, API_NAME, DESCRIPTION_STR, PARAMS_LIST, WRAP_API, TAGS_STR)
+#undef RMH_API_H
+#include "rmh_api.h"
+#undef RMH_API_IMPLEMENTATION_SOC_ONLY
+#undef RMH_API_IMPLEMENTATION_GENERIC_ONLY
+#undef RMH_API_IMPLEMENTATION_SOC_THEN_GENERIC
+#undef RMH_API_IMPLEMENTATION_GENERIC_THEN_SOC
+#undef RMH_API_IMPLEMENTATION_NO_WRAP
+
+/* Optional native implementation of a generic API. rmh_soc.h declares it the same way for a real SoC library */
+RMH_Result SoC_IMPL__RMH_Network_GetSnapshot(const RMH_Handle handle, RMH_NetworkSnapshot* response);
+
+RMH_Handle RMH_Initialize(const RMH_EventCallback eventCB, void* userContext);
+bool pRMHSim_Enter(RMH *handle, const RMH_APIId apiId, RMH_Result *forcedRet);
+RMH_Result pRMHSim_Exit(RMH *handle, const RMH_Result ret);
+void pRMHSim_SetDefaults(RMH *handle);
+void pRMHSim_SetSelfDefaults(RMH *handle);
+void pRMHSim_LoadConfig(RMH *handle, const char *filename);
+void pRMHSim_UpdateCounters(RMH *handle);
+uint32_t pRMHSim_NumNodes(const RMH *handle);
+int32_t pRMHSim_FindFlow(const RMH *handle, const RMH_MacAddress_t flowId);
+void pRMHSim_StartEvents(RMH *handle);
+void pRMHSim_StopEvents(RMH *handle);
+
+#endif /* RMH_SOC_SIM_H */
@@ -0,0 +1,864 @@
+/*
+ * If not stated otherwise in this file or this component's Licenses.txt file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2016 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include "rmh_soc_sim.h"
+
+/**********************************************************************************************************************
+Most SoC APIs just read or write one value of the virtual network. These macros build those APIs.
+
+    RMHSIM_GET()        Return VALUE
+    RMHSIM_SET()        Store the input in FIELD
+    RMHSIM_NET_GET()    Return VALUE if the link is up. Otherwise RMH_INVALID_NETWORK_STATE
+    RMHSIM_NODE_GET()   Return VALUE for the remote node 'node'/'nodeId' if it's present on the network
+    RMHSIM_FLOW_GET()   Return VALUE for the ingress flow 'flow'/'flowIndex' if it exists
+**********************************************************************************************************************/
+#define RMHSIM_GET(API_NAME, TYPE, VALUE) \
+RMH_Result SoC_IMPL__##API_NAME(const RMH_Handle handle, TYPE* response) { \
+    RMHSIM_ENTER(handle, API_NAME); \
+    if (!response) RMHSIM_EXIT(handle, RMH_INVALID_PARAM); \
+    *response=(VALUE); \
+    RMHSIM_EXIT(handle, RMH_SUCCESS); \
+}
+
+#define RMHSIM_SET(API_NAME, TYPE, FIELD) \
+RMH_Result SoC_IMPL__##API_NAME(const RMH_Handle handle, const TYPE value) { \
+    RMHSIM_ENTER(handle, API_NAME); \
+    handle->FIELD=value; \
+    RMHSIM_EXIT(handle, RMH_SUCCESS); \
+}
+
+#define RMHSIM_NET_GET(API_NAME, TYPE, VALUE) \
+RMH_Result SoC_IMPL__##API_NAME(const RMH_Handle handle, TYPE* response) { \
+    RMHSIM_ENTER(handle, API_NAME); \
+    if (!response) RMHSIM_EXIT(handle, RMH_INVALID_PARAM); \
+    if (!pRMHSim_IsLinkUp(handle)) RMHSIM_EXIT(handle, RMH_INVALID_NETWORK_STATE); \
+    *response=(VALUE); \
+    RMHSIM_EXIT(handle, RMH_SUCCESS); \
+}
+
+#define RMHSIM_NODE_GET(API_NAME, TYPE, VALUE) \
+RMH_Result SoC_IMPL__##API_NAME(const RMH_Handle handle, const uint32_t nodeId, TYPE* response) { \
+    const RMHSim_Node *node; \
+    RMH_Result ret; \
+    RMHSIM_ENTER(handle, API_NAME); \
+    if (!response) RMHSIM_EXIT(handle, RMH_INVALID_PARAM); \
+    ret=pRMHSim_GetRemoteNode(handle, nodeId, &node); \
+    if (ret == RMH_SUCCESS) { \
+        *response=(VALUE); \
+    } \
+    RMHSIM_EXIT(handle, ret); \
+}
+
+#define RMHSIM_FLOW_GET(API_NAME, TYPE, VALUE) \
+RMH_Result SoC_IMPL__##API_NAME(const RMH_Handle handle, const RMH_MacAddress_t flowId, TYPE* response) { \
+    const RMHSim_Flow *flow; \
+    int32_t flowIndex; \
+    RMHSIM_ENTER(handle, API_NAME); \
+    if (!response) RMHSIM_EXIT(handle, RMH_INVALID_PARAM); \
+    if (!pRMHSim_IsLinkUp(handle)) RMHSIM_EXIT(handle, RMH_INVALID_NETWORK_STATE); \
+    flowIndex=pRMHSim_FindFlow(handle, flowId); \
+    if (flowIndex < 0) RMHSIM_EXIT(handle, RMH_INVALID_ID); \
+    flow=&handle->flows[flowIndex]; \
+    (void)flow; \
+    *response=(VALUE); \
+    RMHSIM_EXIT(handle, RMH_SUCCESS); \
+}
+
+static inline
+bool pRMHSim_IsLinkUp(const RMH *handle) {
+    return handle->enabled && handle->linkUp;
+}
+
+static
+RMH_Result pRMHSim_GetRemoteNode(const RMH *handle, const uint32_t nodeId, const RMHSim_Node **node) {
+    if (!pRMHSim_IsLinkUp(handle)) {
+        return RMH_INVALID_NETWORK_STATE;
+    }
+    if (nodeId >= RMH_MAX_MOCA_NODES || !handle->nodes[nodeId].present) {
+        return RMH_INVALID_ID;
+    }
+    *node=&handle->nodes[nodeId];
+    return RMH_SUCCESS;
+}
+
+static
+RMH_Result pRMHSim_GetString(const char *value, char* responseBuf, const size_t responseBufSize) {
+    if (!responseBuf || responseBufSize == 0) {
+        return RMH_INVALID_PARAM;
+    }
+    if (strlen(value) >= responseBufSize) {
+        return RMH_INSUFFICIENT_SPACE;
+    }
+    strcpy(responseBuf, value);
+    return RMH_SUCCESS;
+}
+
+/* The MoCA version the network is running at is the lowest version of any node on it */
+static
+RMH_MoCAVersion pRMHSim_NetworkVersion(const RMH *handle) {
+    RMH_MoCAVersion version=handle->highestVersion;
+    uint32_t i;
+    for (i=0; i < RMH_MAX_MOCA_NODES; i++) {
+        if (handle->nodes[i].present && i != handle->selfNodeId && handle->nodes[i].highestVersion < version) {
+            version=handle->nodes[i].highestVersion;
+        }
+    }
+    return version;
+}
+
+static
+bool pRMHSim_MixedMode(const RMH *handle) {
+    uint32_t i;
+    for (i=0; i < RMH_MAX_MOCA_NODES; i++) {
+        if (handle->nodes[i].present && i != handle->selfNodeId && handle->nodes[i].highestVersion != handle->highestVersion) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* The GCD rate is limited by the slowest link from this node */
+static
+uint32_t pRMHSim_GCDPhyRate(const RMH *handle) {
+    const RMHSim_Node *self=&handle->nodes[handle->selfNodeId];
+    uint32_t rate=0;
+    uint32_t i;
+    for (i=0; i < RMH_MAX_MOCA_NODES; i++) {
+        if (handle->nodes[i].present && i != handle->selfNodeId && (rate == 0 || self->phyRate[i] < rate)) {
+            rate=self->phyRate[i];
+        }
+    }
+    return rate;
+}
+
+static
+uint32_t pRMHSim_LinkUptime(const RMH *handle) {
+    struct timespec now;
+    if (!pRMHSim_IsLinkUp(handle)) {
+        return 0;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)(now.tv_sec - handle->linkUpTime.tv_sec);
+}
+
+static
+uint32_t pRMHSim_SumNodes(const uint64_t *counters) {
+    uint64_t total=0;
+    uint32_t i;
+    for (i=0; i < RMH_MAX_MOCA_NODES; i++) {
+        total += counters[i];
+    }
+    return (uint32_t)total;
+}
+
+static
+void pRMHSim_GetMesh(const RMH *handle, RMH_NodeMesh_Uint32_t* response, const uint32_t percent) {
+    uint32_t i, j;
+    memset(response, 0, sizeof(*response));
+    for (i=0; i < RMH_MAX_MOCA_NODES; i++) {
+        if (!handle->nodes[i].present) continue;
+        response->nodePresent[i]=true;
+        for (j=0; j < RMH_MAX_MOCA_NODES; j++) {
+            if (!handle->nodes[j].present || i == j) continue;
+            response->nodeValue[i].nodePresent[j]=true;
+            response->nodeValue[i].nodeValue[j]=(handle->nodes[i].phyRate[j] * percent) / 100;
+        }
+    }
+}
+
+
+
+/**********************************************************************************************************************
+Core
+**********************************************************************************************************************/
+RMH_Result SoC_IMPL__RMH_ValidateHandle(const RMH_Handle handle) {
+    RMHSIM_ENTER(handle, RMH_ValidateHandle);
+    RMHSIM_EXIT(handle, RMH_SUCCESS);
+}
+
+RMHSIM_SET(RMH_SetEventCallbacks,                           uint32_t,               eventNotifyBitMask)
+
+
+
+/**********************************************************************************************************************
+Self
+**********************************************************************************************************************/
+RMHSIM_GET(RMH_Self_GetEnabled,                             bool,                   handle->enabled)
+RMHSIM_GET(RMH_Self_GetMoCALinkUp,                          bool,                   pRMHSim_IsLinkUp(handle))
+RMHSIM_GET(RMH_Self_GetLOF,                                 uint32_t,               handle->lof)
+RMHSIM_SET(RMH_Self_SetLOF,                                 uint32_t,               lof)
+RMHSIM_GET(RMH_Self_GetScanLOFOnly,                         bool,                   handle->scanLOFOnly)
+RMHSIM_SET(RMH_Self_SetScanLOFOnly,                         bool,                   scanLOFOnly)
+RMHSIM_GET(RMH_Self_GetPreferredNCEnabled,                  bool,                   handle->preferredNCEnabled)
+RMHSIM_SET(RMH_Self_SetPreferredNCEnabled,                  bool,                   preferredNCEnabled)
+RMHSIM_GET(RMH_Self_GetPrimaryChannelOffset,                int32_t,                handle->primaryChannelOffset)
+RMHSIM_SET(RMH_Self_SetPrimaryChannelOffset,                int32_t,                primaryChannelOffset)
+RMHSIM_GET(RMH_Self_GetSecondaryChannelOffset,              int32_t,                handle->secondaryChannelOffset)
+RMHSIM_SET(RMH_Self_SetSecondaryChannelOffset,              int32_t,                secondaryChannelOffset)
+RMHSIM_GET(RMH_Self_GetHighestSupportedMoCAVersion,         RMH_MoCAVersion,        handle->highestVersion)
+RMHSIM_GET(RMH_Self_GetFrequencyMask,                       uint32_t,               handle->frequencyMask)
+RMHSIM_SET(RMH_Self_SetFrequencyMask,                       uint32_t,               frequencyMask)
+RMHSIM_GET(RMH_Self_GetMaxPacketAggregation,                uint32_t,               handle->maxPacketAggregation)
+RMHSIM_SET(RMH_Self_SetMaxPacketAggregation,                uint32_t,               maxPacketAggregation)
+RMHSIM_GET(RMH_Self_GetMaxFrameSize,                        uint32_t,               handle->maxFrameSize)
+RMHSIM_SET(RMH_Self_SetMaxFrameSize,                        uint32_t,               maxFrameSize)
+RMHSIM_GET(RMH_Self_GetLowBandwidthLimit,                   uint32_t,               handle->lowBandwidthLimit)
+RMHSIM_SET(RMH_Self_SetLowBandwidthLimit,                   uint32_t,               lowBandwidthLimit)
+RMHSIM_GET(RMH_Self_GetMaxBitrate,                          uint32_t,               (handle->highestVersion == RMH_MOCA_VERSION_20) ? 1000 : 400)
+RMHSIM_GET(RMH_Self_GetTxPowerLimit,                        int32_t,                handle->txPowerLimit)
+RMHSIM_SET(RMH_Self_SetTxPowerLimit,                        int32_t,                txPowerLimit)
+RMHSIM_GET(RMH_Self_GetSupportedBand,                       RMH_Band,               handle->band)
+RMHSIM_GET(RMH_Self_GetQAM256Enabled,                       bool,                   handle->qam256Enabled)
+RMHSIM_SET(RMH_Self_SetQAM256Enabled,                       bool,                   qam256Enabled)
+RMHSIM_GET(RMH_Self_GetQAM256TargetPhyRate,                 uint32_t,               handle->qam256TargetPhyRate)
+RMHSIM_SET(RMH_Self_SetQAM256TargetPhyRate,                 uint32_t,               qam256TargetPhyRate)
+RMHSIM_GET(RMH_Self_GetPrimaryChannelTargetPhyRate,         uint32_t,               handle->primaryChannelTargetPhyRate)
+RMHSIM_SET(RMH_Self_SetPrimaryChannelTargetPhyRate,         uint32_t,               primaryChannelTargetPhyRate)
+RMHSIM_GET(RMH_Self_GetSecondaryChannelTargetPhyRate,       uint32_t,               handle->secondaryChannelTargetPhyRate)
+RMHSIM_SET(RMH_Self_SetSecondaryChannelTargetPhyRate,       uint32_t,               secondaryChannelTargetPhyRate)
+RMHSIM_GET(RMH_Self_GetTurboEnabled,                        bool,                   handle->turboEnabled)
+RMHSIM_SET(RMH_Self_SetTurboEnabled,                        bool,                   turboEnabled)
+RMHSIM_GET(RMH_Self_GetBondingEnabled,                      bool,                   handle->bondingEnabled)
+RMHSIM_SET(RMH_Self_SetBondingEnabled,                      bool,                   bondingEnabled)
+RMHSIM_GET(RMH_Self_GetPrivacyEnabled,                      bool,                   handle->privacyEnabled)
+RMHSIM_SET(RMH_Self_SetPrivacyEnabled,                      bool,                   privacyEnabled)
+RMHSIM_GET(RMH_Self_GetMaxAllocationElements,               uint32_t,               (handle->highestVersion == RMH_MOCA_VERSION_20) ? 64 : 32)
+RMHSIM_GET(RMH_Self_GetLastResetReason,                     RMH_MoCAResetReason,    handle->lastResetReason)
+
+RMH_Result SoC_IMPL__RMH_Self_SetEnabled(const RMH_Handle handle, const bool value) {
+    RMHSIM_ENTER(handle, RMH_Self_SetEnabled);
+    if (value && !handle->enabled) {
+        /* The simulated network forms as soon as MoCA is enabled */
+        clock_gettime(CLOCK_MONOTONIC, &handle->linkUpTime);
+        handle->countersUpdated=handle->linkUpTime;
+    }
+    else if (!value && handle->enabled && handle->linkUp) {
+        handle->linkDownCount++;
+    }
+    handle->enabled=value;
+    RMHSIM_EXIT(handle, RMH_SUCCESS);
+}
+
+RMH_Result SoC_IMPL__RMH_Self_GetSoftwareVersion(const RMH_Handle handle, char* responseBuf, const size_t responseBufSize) {
+    RMHSIM_ENTER(handle, RMH_Self_GetSoftwareVersion);
+    RMHSIM_EXIT(handle, pRMHSim_GetString(handle->softwareVersion, responseBuf, responseBufSize));
+}
+
+RMH_Result SoC_IMPL__RMH_Self_GetSupportedFrequencies(const RMH_Handle handle, uint32_t* responseArray, const size_t responseArraySize, size_t* responseArrayUsed) {
+    uint32_t freq;
+    RMHSIM_ENTER(handle, RMH_Self_GetSupportedFrequencies);
+    if (!responseArray || !responseArrayUsed) RMHSIM_EXIT(handle, RMH_INVALID_PARAM);
+    *responseArrayUsed=0;
+    for (freq=1150; freq <= 1600 && *responseArrayUsed < responseArraySize; freq += 50) {
+        responseArray[(*responseArrayUsed)++]=freq;
+    }
+    RMHSIM_EXIT(handle, (freq <= 1600) ? RMH_INSUFFICIENT_SPACE : RMH_SUCCESS);
+}
+
+RMH_Result SoC_IMPL__RMH_Self_GetPrivacyPassword(const RMH_Handle handle, char* responseBuf, const size_t responseBufSize) {
+    RMHSIM_ENTER(handle, RMH_Self_GetPrivacyPassword);
+    RMHSIM_EXIT(handle, pRMHSim_GetString(handle->privacyPassword, responseBuf, responseBufSize));
+}
+
+RMH_Result SoC_IMPL__RMH_Self_SetPrivacyPassword(const RMH_Handle handle, const char* value) {
+    RMHSIM_ENTER(handle, RMH_Self_SetPrivacyPassword);
+    if (!value || strlen(value) < 12 || strlen(value) >= sizeof(handle->privacyPassword)) RMHSIM_EXIT(handle, RMH_INVALID_PARAM);
+    strcpy(handle->privacyPassword, value);
+    RMHSIM_EXIT(handle, RMH_SUCCESS);
+}
+
+RMH_Result SoC_IMPL__RMH_Self_GetPrivacyMACManagementKey(const RMH_Handle handle, char* responseBuf, const size_t responseBufSize) {
+    char key[32];
+    uint32_t hash=5381;
+    const char *c;
+    RMHSIM_ENTER(handle, RMH_Self_GetPrivacyMACManagementKey);
+    for (c=handle->privacyPassword; *c; c++) {
+        hash=hash * 33 + *c;
+    }
+    snprintf(key, sizeof(key), "%08x%08x", hash, ~hash);
+    RMHSIM_EXIT(handle, pRMHSim_GetString(key, responseBuf, responseBufSize));
+}
+
+RMH_Result SoC_IMPL__RMH_Self_GetTabooChannels(const RMH_Handle handle, uint32_t *channelMaskStart, uint32_t *channelMask) {
+    RMHSIM_ENTER(handle, RMH_Self_GetTabooChannels);
+    if (!channelMaskStart || !channelMask) RMHSIM_EXIT(handle, RMH_INVALID_PARAM);
+    *channelMaskStart=handle->tabooStart;
+    *channelMask=handle->tabooMask;
+    RMHSIM_EXIT(handle, RMH_SUCCESS);
+}
+
+RMH_Result SoC_IMPL__RMH_Self_SetTabooChannels(const RMH_Handle handle, const uint32_t channelMaskStart, const uint32_t channelMask) {
+    RMHSIM_ENTER(handle, RMH_Self_SetTabooChannels);
+    handle->tabooStart=channelMaskStart;
+    handle->tabooMask=channelMask;
+    RMHSIM_EXIT(handle, RMH_SUCCESS);
+}
+
+RMH_Result SoC_IMPL__RMH_Self_RestoreDefaultSettings(const RMH_Handle handle) {
+    RMHSIM_ENTER(handle, RMH_Self_RestoreDefaultSettings);
+    pRMHSim_SetSelfDefaults(handle);
+    RMHSIM_EXIT(handle, RMH_SUCCESS);
+}
+
+
+
+/**********************************************************************************************************************
+Interface
+**********************************************************************************************************************/
+RMH_Result SoC_IMPL__RMH_Interface_GetName(const RMH_Handle handle, char* responseBuf, const size_t responseBufSize) {
+    RMHSIM_ENTER(handle, RMH_Interface_GetName);
+    RMHSIM_EXIT(handle, pRMHSim_GetString(handle->interfaceName, responseBuf, responseBufSize));
+}
+
+RMH_Result SoC_IMPL__RMH_Interface_GetMac(const RMH_Handle handle, RMH_MacAddress_t* response) {
+    RMHSIM_ENTER(handle, RMH_Interface_GetMac);
+    if (!response) RMHSIM_EXIT(handle, RMH_INVALID_PARAM);
+    memcpy(*response, handle->mac, sizeof(*response));
+    RMHSIM_EXIT(handle, RMH_SUCCESS);
+}
+
+RMH_Result SoC_IMPL__RMH_Interface_SetMac(const RMH_Handle handle, const RMH_MacAddress_t value) {
+    RMHSIM_ENTER(handle, RMH_Interface_SetMac);
+    memcpy(handle->mac, value, sizeof(handle->mac));
+    memcpy(handle->nodes[handle->selfNodeId].mac, value, sizeof(handle->mac));
+    RMHSIM_EXIT(handle, RMH_SUCCESS);
+}
+
+
+
+/**********************************************************************************************************************
+Power
+**********************************************************************************************************************/
+RMHSIM_GET(RMH_Power_GetMode,                               RMH_PowerMode,          handle->powerMode)
+RMHSIM_GET(RMH_Power_GetSupportedModes,                     uint32_t,               RMH_POWER_MODE_M0_ACTIVE | RMH_POWER_MODE_M1_IDLE | RMH_POWER_MODE_M2_STANDBY | RMH_POWER_MODE_M3_SLEEP)
+RMHSIM_GET(RMH_Power_GetStandbyMode,                        RMH_PowerMode,          handle->standbyMode)
+RMHSIM_GET(RMH_Power_GetTxPowerControlEnabled,              bool,                   handle->txPowerControlEnabled)
+RMHSIM_SET(RMH_Power_SetTxPowerControlEnabled,              bool,                   txPowerControlEnabled)
+RMHSIM_GET(RMH_Power_GetTxBeaconPowerReductionEnabled,      bool,                   handle->txBeaconPowerReductionEnabled)
+RMHSIM_SET(RMH_Power_SetTxBeaconPowerReductionEnabled,      bool,                   txBeaconPowerReductionEnabled)
+RMHSIM_GET(RMH_Power_GetTxBeaconPowerReduction,             uint32_t,               handle->txBeaconPowerReduction)
+RMHSIM_SET(RMH_Power_SetTxBeaconPowerReduction,             uint32_t,               txBeaconPowerReduction)
+
+RMH_Result SoC_IMPL__RMH_Power_SetStandbyMode(const RMH_Handle handle, const RMH_PowerMode response) {
+    RMHSIM_ENTER(handle, RMH_Power_SetStandbyMode);
+    handle->standbyMode=response;
+    RMHSIM_EXIT(handle, RMH_SUCCESS);
+}
+
+
+
+/**********************************************************************************************************************
+Network
+**********************************************************************************************************************/
+RMHSIM_NET_GET(RMH_Network_GetNumNodes,                     uint32_t,               pRMHSim_NumNodes(handle))
+RMHSIM_NET_GET(RMH_Network_GetNodeId,                       uint32_t,               handle->selfNodeId)
+RMHSIM_NET_GET(RMH_Network_GetNCNodeId,                     uint32_t,               handle->ncNodeId)
+RMHSIM_NET_GET(RMH_Network_GetBackupNCNodeId,               uint32_t,               handle->backupNCNodeId)
+RMHSIM_NET_GET(RMH_Network_GetLinkUptime,                   uint32_t,               pRMHSim_LinkUptime(handle))
+RMHSIM_GET(RMH_Network_GetResetCount,                       uint32_t,               handle->resetCount)
+RMHSIM_GET(RMH_Network_GetLinkDownCount,                    uint32_t,               handle->linkDownCount)
+RMHSIM_NET_GET(RMH_Network_GetMixedMode,                    bool,                   pRMHSim_MixedMode(handle))
+RMHSIM_NET_GET(RMH_Network_GetRFChannelFreq,                uint32_t,               handle->rfChannelFreq)
+RMHSIM_NET_GET(RMH_Network_GetPrimaryChannelFreq,           uint32_t,               handle->rfChannelFreq + handle->primaryChannelOffset)
+RMHSIM_NET_GET(RMH_Network_GetSecondaryChannelFreq,         uint32_t,               handle->secondaryChannelFreq)
+RMHSIM_NET_GET(RMH_Network_GetMoCAVersion,                  RMH_MoCAVersion,        pRMHSim_NetworkVersion(handle))
+RMHSIM_NET_GET(RMH_Network_GetTxBroadcastPhyRate,           uint32_t,               pRMHSim_GCDPhyRate(handle))
+RMHSIM_NET_GET(RMH_Network_GetTxGCDPhyRate,                 uint32_t,               pRMHSim_GCDPhyRate(handle))
+RMHSIM_NET_GET(RMH_Network_GetTxMapPhyRate,                 uint32_t,               pRMHSim_GCDPhyRate(handle) / 4)
+RMHSIM_NET_GET(RMH_Network_GetTxGcdPowerReduction,          uint32_t,               0)
+
+RMH_Result SoC_IMPL__RMH_Network_GetNodeIds(const RMH_Handle handle, RMH_NodeList_Uint32_t* response) {
+    uint32_t i;
+    RMHSIM_ENTER(handle, RMH_Network_GetNodeIds);
+    if (!response) RMHSIM_EXIT(handle, RMH_INVALID_PARAM);
+    if (!pRMHSim_IsLinkUp(handle)) RMHSIM_EXIT(handle, RMH_INVALID_NETWORK_STATE);
+    memset(response, 0, sizeof(*response));
+    for (i=0; i < RMH_MAX_MOCA_NODES; i++) {
+        response->nodePresent[i]=handle->nodes[i].present;
+        response->nodeValue[i]=i;
+    }
+    RMHSIM_EXIT(handle, RMH_SUCCESS);
+}
+
+RMH_Result SoC_IMPL__RMH_Network_GetRemoteNodeIds(const RMH_Handle handle, RMH_NodeList_Uint32_t* response) {
+    uint32_t i;
+    RMHSIM_ENTER(handle, RMH_Network_GetRemoteNodeIds);
+    if (!response) RMHSIM_EXIT(handle, RMH_INVALID_PARAM);
+    if (!pRMHSim_IsLinkUp(handle)) RMHSIM_EXIT(handle, RMH_INVALID_NETWORK_STATE);
+    memset(response, 0, sizeof(*response));
+    for (i=0; i < RMH_MAX_MOCA_NODES; i++) {
+        response->nodePresent[i]=handle->nodes[i].present && i != handle->selfNodeId;
+        response->nodeValue[i]=i;
+    }
+    RMHSIM_EXIT(handle, RMH_SUCCESS);
+}
+
+RMH_Result SoC_IMPL__RMH_Network_GetNCMac(const RMH_Handle handle, RMH_MacAddress_t* response) {
+    RMHSIM_ENTER(handle, RMH_Network_GetNCMac);
+    if (!response) RMHSIM_EXIT(handle, RMH_INVALID_PARAM);
+    if (!pRMHSim_IsLinkUp(handle)) RMHSIM_EXIT(handle, RMH_INVALID_NETWORK_STATE);
+    memcpy(*response, handle->nodes[handle->ncNodeId].mac, sizeof(*response));
+    RMHSIM_EXIT(handle, RMH_SUCCESS);
+}
+
+RMH_Result SoC_IMPL__RMH_Network_GetTabooChannels(const RMH_Handle handle, uint32_t *channelMaskStart, uint32_t *channelMask) {
+    RMHSIM_ENTER(handle, RMH_Network_GetTabooChannels);
+    if (!channelMaskStart || !channelMask) RMHSIM_EXIT(handle, RMH_INVALID_PARAM);
+    if (!pRMHSim_IsLinkUp(handle)) RMHSIM_EXIT(handle, RMH_INVALID_NETWORK_STATE);
+    *channelMaskStart=handle->tabooStart;
+    *channelMask=handle->tabooMask;
+    RMHSIM_EXIT(handle, RMH_SUCCESS);
+}
+
+#define RMHSIM_NET_MESH(API_NAME, PERCENT) \
+RMH_Result SoC_IMPL__##API_NAME(const RMH_Handle handle, RMH_NodeMesh_Uint32_t* response) { \
+    RMHSIM_ENTER(handle, API_NAME); \
+    if (!response) RMHSIM_EXIT(handle, RMH_INVALID_PARAM); \
+    if (!pRMHSim_IsLinkUp(handle)) RMHSIM_EXIT(handle, RMH_INVALID_NETWORK_STATE); \
+    pRMHSim_GetMesh(handle, response, PERCENT); \
+    RMHSIM_EXIT(handle, RMH_SUCCESS); \
+}
+RMHSIM_NET_MESH(RMH_Network_GetTxUnicastPhyRate,            100)
+RMHSIM_NET_MESH(RMH_Network_GetTxNPER,                      100)
+RMHSIM_NET_MESH(RMH_Network_GetTxVLPER,                     90)
+
+RMH_Result SoC_IMPL__RMH_Network_GetBondedConnections(const RMH_Handle handle, RMH_NodeMesh_Uint32_t* response) {
+    uint32_t i, j;
+    RMHSIM_ENTER(handle, RMH_Network_GetBondedConnections);
+    if (!response) RMHSIM_EXIT(handle, RMH_INVALID_PARAM);
+    if (!pRMHSim_IsLinkUp(handle)) RMHSIM_EXIT(handle, RMH_INVALID_NETWORK_STATE);
+    memset(response, 0, sizeof(*response));
+    for (i=0; i < RMH_MAX_MOCA_NODES; i++) {
+        if (!handle->nodes[i].present) continue;
+        response->nodePresent[i]=true;
+        for (j=0; j < RMH_MAX_MOCA_NODES; j++) {
+            if (!handle->nodes[j].present || i == j) continue;
+            response->nodeValue[i].nodePresent[j]=true;
+            response->nodeValue[i].nodeValue[j]=handle->bondingEnabled && handle->nodes[i].bondingCapable && handle->nodes[j].bondingCapable;
+        }
+    }
+    RMHSIM_EXIT(handle, RMH_SUCCESS);
+}
+
+/* Optional native version of a generic API. Everything is read under a single lock, like one driver round trip */
+RMH_Result SoC_IMPL__RMH_Network_GetSnapshot(const RMH_Handle handle, RMH_NetworkSnapshot* response) {
+    uint32_t i;
+    RMHSIM_ENTER(handle, RMH_Network_GetSnapshot);
+    if (!response) RMHSIM_EXIT(handle, RMH_INVALID_PARAM);
+    memset(response, 0, sizeof(*response));
+    response->selfValid=RMH_SELF_SNAPSHOT_ENABLED | RMH_SELF_SNAPSHOT_LINK_STATUS | RMH_SELF_SNAPSHOT_MAC |
+                        RMH_SELF_SNAPSHOT_HIGHEST_MOCA_VERSION | RMH_SELF_SNAPSHOT_PREFERRED_NC_ENABLED | RMH_SELF_SNAPSHOT_LOF;
+    response->selfEnabled=handle->enabled;
+    response->linkStatus=!handle->enabled ? RMH_LINK_STATUS_DISABLED : handle->linkUp ? RMH_LINK_STATUS_UP : RMH_LINK_STATUS_NO_LINK;
+    memcpy(response->mac, handle->mac, sizeof(response->mac));
+    response->highestSupportedMoCAVersion=handle->highestVersion;
+    response->preferredNCEnabled=handle->preferredNCEnabled;
+    response->lof=handle->lof;
+    if (!pRMHSim_IsLinkUp(handle)) RMHSIM_EXIT(handle, RMH_SUCCESS);
+
+    response->networkValid=RMH_NETWORK_SNAPSHOT_NUM_NODES | RMH_NETWORK_SNAPSHOT_NODE_ID | RMH_NETWORK_SNAPSHOT_NC_NODE_ID |
+                           RMH_NETWORK_SNAPSHOT_NC_MAC | RMH_NETWORK_SNAPSHOT_BACKUP_NC_NODE_ID | RMH_NETWORK_SNAPSHOT_LINK_UPTIME |
+                           RMH_NETWORK_SNAPSHOT_MOCA_VERSION | RMH_NETWORK_SNAPSHOT_MIXED_MODE | RMH_NETWORK_SNAPSHOT_RF_CHANNEL_FREQ |
+                           RMH_NETWORK_SNAPSHOT_TX_TOTAL_PACKETS | RMH_NETWORK_SNAPSHOT_RX_TOTAL_PACKETS |
+                           RMH_NETWORK_SNAPSHOT_TX_TOTAL_ERRORS | RMH_NETWORK_SNAPSHOT_RX_TOTAL_ERRORS |
+                           RMH_NETWORK_SNAPSHOT_TX_DROPPED_PACKETS | RMH_NETWORK_SNAPSHOT_RX_DROPPED_PACKETS |
+                           RMH_NETWORK_SNAPSHOT_REMOTE_NODES;
+    response->numNodes=pRMHSim_NumNodes(handle);
+    response->nodeId=handle->selfNodeId;
+    response->ncNodeId=handle->ncNodeId;
+    response->backupNCNodeId=handle->backupNCNodeId;
+    memcpy(response->ncMac, handle->nodes[handle->ncNodeId].mac, sizeof(response->ncMac));
+    response->linkUptime=pRMHSim_LinkUptime(handle);
+    response->mocaVersion=pRMHSim_NetworkVersion(handle);
+    response->mixedMode=pRMHSim_MixedMode(handle);
+    response->rfChannelFreq=handle->rfChannelFreq;
+    response->txTotalPackets=(uint32_t)(handle->counters.txUnicastPackets + handle->counters.txBroadcastPackets + handle->counters.txMulticastPackets);
+    response->rxTotalPackets=(uint32_t)(handle->counters.rxUnicastPackets + handle->counters.rxBroadcastPackets + handle->counters.rxMulticastPackets);
+    response->txTotalErrors=0;
+    response->rxTotalErrors=pRMHSim_SumNodes(handle->counters.rxCorrectedErrors) + pRMHSim_SumNodes(handle->counters.rxUncorrectedErrors);
+    response->txDroppedPackets=0;
+    response->rxDroppedPackets=pRMHSim_SumNodes(handle->counters.rxUncorrectedErrors);
+
+    for (i=0; i < RMH_MAX_MOCA_NODES; i++) {
+        const RMHSim_Node *node=&handle->nodes[i];
+        RMH_NodeSnapshot *nodeSnapshot;
+        if (!node->present || i == handle->selfNodeId) continue;
+        nodeSnapshot=&response->remoteNodes[response->numRemoteNodes++];
+        nodeSnapshot->nodeId=i;
+        nodeSnapshot->valid=RMH_NODE_SNAPSHOT_MAC | RMH_NODE_SNAPSHOT_HIGHEST_MOCA_VERSION | RMH_NODE_SNAPSHOT_PREFERRED_NC |
+                            RMH_NODE_SNAPSHOT_RX_PACKETS | RMH_NODE_SNAPSHOT_TX_PACKETS | RMH_NODE_SNAPSHOT_RX_TOTAL_ERRORS |
+                            RMH_NODE_SNAPSHOT_TX_UNICAST_PHY_RATE | RMH_NODE_SNAPSHOT_TX_POWER_REDUCTION |
+                            RMH_NODE_SNAPSHOT_TX_UNICAST_POWER | RMH_NODE_SNAPSHOT_RX_UNICAST_POWER | RMH_NODE_SNAPSHOT_RX_SNR;
+        memcpy(nodeSnapshot->mac, node->mac, sizeof(nodeSnapshot->mac));
+        nodeSnapshot->highestSupportedMoCAVersion=node->highestVersion;
+        nodeSnapshot->preferredNC=node->preferredNC;
+        nodeSnapshot->rxPackets=(uint32_t)handle->counters.rxNodePackets[i];
+        nodeSnapshot->txPackets=(uint32_t)handle->counters.txNodePackets[i];
+        nodeSnapshot->rxTotalErrors=(uint32_t)(handle->counters.rxCorrectedErrors[i] + handle->counters.rxUncorrectedErrors[i]);
+        nodeSnapshot->txUnicastPhyRate=handle->nodes[handle->selfNodeId].phyRate[i];
+        nodeSnapshot->txPowerReduction=node->txPowerReduction;
+        nodeSnapshot->txUnicastPower=(float)handle->txPowerLimit - node->txPowerReduction;
+        nodeSnapshot->rxUnicastPower=node->rxPower;
+        nodeSnapshot->rxSNR=node->snr;
+    }
+    RMHSIM_EXIT(handle, RMH_SUCCESS);
+}
+
+
+
+/**********************************************************************************************************************
+Remote Node
+**********************************************************************************************************************/
+RMHSIM_NODE_GET(RMH_RemoteNode_GetPreferredNC,              bool,                   node->preferredNC)
+RMHSIM_NODE_GET(RMH_RemoteNode_GetHighestSupportedMoCAVersion, RMH_MoCAVersion,     node->highestVersion)
+RMHSIM_NODE_GET(RMH_RemoteNode_GetActiveMoCAVersion,        RMH_MoCAVersion,        pRMHSim_NetworkVersion(handle))
+RMHSIM_NODE_GET(RMH_RemoteNode_GetQAM256Capable,            bool,                   node->qam256Capable)
+RMHSIM_NODE_GET(RMH_RemoteNode_GetMaxPacketAggregation,     uint32_t,               node->maxPacketAggregation)
+RMHSIM_NODE_GET(RMH_RemoteNode_GetMaxFrameSize,             uint32_t,               node->maxFrameSize)
+RMHSIM_NODE_GET(RMH_RemoteNode_GetBondingCapable,           bool,                   node->bondingCapable)
+RMHSIM_NODE_GET(RMH_RemoteNode_GetRxUnicastPhyRate,         uint32_t,               node->phyRate[handle->selfNodeId])
+RMHSIM_NODE_GET(RMH_RemoteNode_GetRxBroadcastPhyRate,       uint32_t,               (node->phyRate[handle->selfNodeId] * 9) / 10)
+RMHSIM_NODE_GET(RMH_RemoteNode_GetRxBroadcastPower,         float,                  node->rxPower)
+RMHSIM_NODE_GET(RMH_RemoteNode_GetRxUnicastPower,           float,                  node->rxPower)
+RMHSIM_NODE_GET(RMH_RemoteNode_GetRxMapPower,               float,                  node->rxPower)
+RMHSIM_NODE_GET(RMH_RemoteNode_GetRxPackets,                uint32_t,               (uint32_t)handle->counters.rxNodePackets[nodeId])
+RMHSIM_NODE_GET(RMH_RemoteNode_GetRxSNR,                    float,                  node->snr)
+RMHSIM_NODE_GET(RMH_RemoteNode_GetRxCorrectedErrors,        uint32_t,               (uint32_t)handle->counters.rxCorrectedErrors[nodeId])
+RMHSIM_NODE_GET(RMH_RemoteNode_GetRxUnCorrectedErrors,      uint32_t,               (uint32_t)handle->counters.rxUncorrectedErrors[nodeId])
+RMHSIM_NODE_GET(RMH_RemoteNode_GetRxTotalErrors,            uint32_t,               (uint32_t)(handle->counters.rxCorrectedErrors[nodeId] + handle->counters.rxUncorrectedErrors[nodeId]))
+RMHSIM_NODE_GET(RMH_RemoteNode_GetTxUnicastPhyRate,         uint32_t,               handle->nodes[handle->selfNodeId].phyRate[nodeId])
+RMHSIM_NODE_GET(RMH_RemoteNode_GetTxUnicastPower,           float,                  (float)handle->txPowerLimit - node->txPowerReduction)
+RMHSIM_NODE_GET(RMH_RemoteNode_GetTxPowerReduction,         uint32_t,               node->txPowerReduction)
+RMHSIM_NODE_GET(RMH_RemoteNode_GetTxPackets,                uint32_t,               (uint32_t)handle->counters.txNodePackets[nodeId])
+RMHSIM_NODE_GET(RMH_RemoteNode_GetMaxConstellation_GCD100,  uint32_t,               node->maxConstellation[0])
+RMHSIM_NODE_GET(RMH_RemoteNode_GetMaxConstellation_GCD50,   uint32_t,               node->maxConstellation[1])
+RMHSIM_NODE_GET(RMH_RemoteNode_GetMaxConstellation_P2P100,  uint32_t,               node->maxConstellation[2])
+RMHSIM_NODE_GET(RMH_RemoteNode_GetMaxConstellation_P2P50,   uint32_t,               node->maxConstellation[3])
+
+RMH_Result SoC_IMPL__RMH_RemoteNode_GetMac(const RMH_Handle handle, const uint32_t nodeId, RMH_MacAddress_t* response) {
+    const RMHSim_Node *node;
+    RMH_Result ret;
+    RMHSIM_ENTER(handle, RMH_RemoteNode_GetMac);
+    if (!response) RMHSIM_EXIT(handle, RMH_INVALID_PARAM);
+    ret=pRMHSim_GetRemoteNode(handle, nodeId, &node);
+    if (ret == RMH_SUCCESS) {
+        memcpy(*response, node->mac, sizeof(*response));
+    }
+    RMHSIM_EXIT(handle, ret);
+}
+
+#define RMHSIM_NODE_SET_CONSTELLATION(API_NAME, INDEX) \
+RMH_Result SoC_IMPL__##API_NAME(const RMH_Handle handle, const uint32_t nodeId, const uint32_t maxConstellation) { \
+    const RMHSim_Node *node; \
+    RMH_Result ret; \
+    RMHSIM_ENTER(handle, API_NAME); \
+    ret=pRMHSim_GetRemoteNode(handle, nodeId, &node); \
+    if (ret == RMH_SUCCESS) { \
+        if (maxConstellation > RMH_MOCA_SUBCARRIER_PROFILE_QAM_1024) RMHSIM_EXIT(handle, RMH_INVALID_PARAM); \
+        handle->nodes[nodeId].maxConstellation[INDEX]=maxConstellation; \
+    } \
+    RMHSIM_EXIT(handle, ret); \
+}
+RMHSIM_NODE_SET_CONSTELLATION(RMH_RemoteNode_SetMaxConstellation_GCD100,    0)
+RMHSIM_NODE_SET_CONSTELLATION(RMH_RemoteNode_SetMaxConstellation_GCD50,     1)
+RMHSIM_NODE_SET_CONSTELLATION(RMH_RemoteNode_SetMaxConstellation_P2P100,    2)
+RMHSIM_NODE_SET_CONSTELLATION(RMH_RemoteNode_SetMaxConstellation_P2P50,     3)
+
+RMH_Result SoC_IMPL__RMH_RemoteNode_Reset(const RMH_Handle handle, const uint32_t nodeListMask, const uint32_t startTime) {
+    RMHSIM_ENTER(handle, RMH_RemoteNode_Reset);
+    if (!pRMHSim_IsLinkUp(handle)) RMHSIM_EXIT(handle, RMH_INVALID_NETWORK_STATE);
+    if (nodeListMask >= (1u << RMH_MAX_MOCA_NODES)) RMHSIM_EXIT(handle, RMH_INVALID_PARAM);
+    if (nodeListMask & (1u << handle->selfNodeId)) {
+        handle->resetCount++;
+    }
+    RMHSIM_EXIT(handle, RMH_SUCCESS);
+}
+
+/**********************************************************************************************************************
+Subcarrier modulation. Each link uses the profile of the remote node across the band. The outer 5% at either edge of
+the channel are one step lower, as are the lower PER modes, which makes the output of RMH_Log_PrintModulation look like
+a real network.
+**********************************************************************************************************************/
+static
+RMH_Result pRMHSim_GetModulation(const RMH *handle, const uint32_t nodeId, const RMH_PERMode perMode, const bool secondary, RMH_SubcarrierProfile* responseArray, const size_t responseArraySize, size_t* responseArrayUsed) {
+    const RMHSim_Node *node;
+    RMH_SubcarrierProfile profile;
+    RMH_Result ret;
+    uint32_t i;
+
+    if (!responseArray || !responseArrayUsed) {
+        return RMH_INVALID_PARAM;
+    }
+    ret=pRMHSim_GetRemoteNode(handle, nodeId, &node);
+    if (ret != RMH_SUCCESS) {
+        return ret;
+    }
+    if (secondary && pRMHSim_NetworkVersion(handle) != RMH_MOCA_VERSION_20) {
+        return RMH_INVALID_MOCA_VERSION;
+    }
+    profile=node->modulation;
+    if (perMode == RMH_PER_MODE_VERY_LOW && profile > RMH_MOCA_SUBCARRIER_PROFILE_BPSK) {
+        profile--;
+    }
+    *responseArrayUsed=(responseArraySize < RMHSIM_NUM_SUBCARRIERS) ? responseArraySize : RMHSIM_NUM_SUBCARRIERS;
+    for (i=0; i < *responseArrayUsed; i++) {
+        bool edge=(i < RMHSIM_NUM_SUBCARRIERS/20) || (i >= RMHSIM_NUM_SUBCARRIERS - RMHSIM_NUM_SUBCARRIERS/20);
+        responseArray[i]=(edge && profile > RMH_MOCA_SUBCARRIER_PROFILE_BPSK) ? profile-1 : profile;
+    }
+    return (responseArraySize < RMHSIM_NUM_SUBCARRIERS) ? RMH_INSUFFICIENT_SPACE : RMH_SUCCESS;
+}
+
+#define RMHSIM_NODE_MODULATION(API_NAME, SECONDARY) \
+RMH_Result SoC_IMPL__##API_NAME(const RMH_Handle handle, const uint32_t nodeId, const RMH_PERMode perMode, RMH_SubcarrierProfile* responseArray, const size_t responseArraySize, size_t* responseArrayUsed) { \
+    RMHSIM_ENTER(handle, API_NAME); \
+    RMHSIM_EXIT(handle, pRMHSim_GetModulation(handle, nodeId, perMode, SECONDARY, responseArray, responseArraySize, responseArrayUsed)); \
+}
+RMHSIM_NODE_MODULATION(RMH_RemoteNode_GetRxUnicastSubcarrierModulation,            false)
+RMHSIM_NODE_MODULATION(RMH_RemoteNode_GetTxUnicastSubcarrierModulation,            false)
+RMHSIM_NODE_MODULATION(RMH_RemoteNode_GetSecondaryRxUnicastSubcarrierModulation,   true)
+RMHSIM_NODE_MODULATION(RMH_RemoteNode_GetSecondaryTxUnicastSubcarrierModulation,   true)
+RMHSIM_NODE_MODULATION(RMH_RemoteNode_GetRxBroadcastSubcarrierModulation,          false)
+RMHSIM_NODE_MODULATION(RMH_RemoteNode_GetTxBroadcastSubcarrierModulation,          false)
+
+
+
+/**********************************************************************************************************************
+PQoS
+**********************************************************************************************************************/
+RMHSIM_GET(RMH_PQOS_GetMaxIngressFlows,                     uint32_t,               RMHSIM_MAX_FLOWS)
+RMHSIM_GET(RMH_PQOS_GetMaxEgressFlows,                      uint32_t,               RMHSIM_MAX_FLOWS)
+RMHSIM_NET_GET(RMH_PQoS_GetNumIngressFlows,                 uint32_t,               handle->numFlows)
+RMHSIM_NET_GET(RMH_PQoS_GetNumEgressFlows,                  uint32_t,               0)
+RMHSIM_NODE_GET(RMH_PQoS_GetEgressBandwidth,                uint32_t,               (handle->nodes[handle->selfNodeId].phyRate[nodeId] * 7) / 10)
+
+RMHSIM_FLOW_GET(RMH_PQoSFlow_GetPeakDataRate,               uint32_t,               flow->peakDataRate)
+RMHSIM_FLOW_GET(RMH_PQoSFlow_GetBurstSize,                  uint32_t,               flow->burstSize)
+RMHSIM_FLOW_GET(RMH_PQoSFlow_GetLeaseTime,                  uint32_t,               flow->leaseTime)
+RMHSIM_FLOW_GET(RMH_PQoSFlow_GetFlowTag,                    uint32_t,               flow->flowTag)
+RMHSIM_FLOW_GET(RMH_PQoSFlow_GetMaxLatency,                 uint32_t,               flow->maxLatency)
+RMHSIM_FLOW_GET(RMH_PQoSFlow_GetShortTermAvgRatio,          uint32_t,               flow->shortTermAvgRatio)
+RMHSIM_FLOW_GET(RMH_PQoSFlow_GetMaxRetry,                   uint32_t,               flow->maxRetry)
+RMHSIM_FLOW_GET(RMH_PQoSFlow_GetVLANTag,                    uint32_t,               flow->vlanTag)
+RMHSIM_FLOW_GET(RMH_PQoSFlow_GetFlowPer,                    uint32_t,               flow->flowPer)
+RMHSIM_FLOW_GET(RMH_PQoSFlow_GetIngressClassificationRule,  uint32_t,               flow->ingressClassificationRule)
+RMHSIM_FLOW_GET(RMH_PQoSFlow_GetPacketSize,                 uint32_t,               flow->packetSize)
+RMHSIM_FLOW_GET(RMH_PQoSFlow_GetTotalTxPackets,             uint32_t,               (uint32_t)handle->counters.flowTxPackets[flowIndex])
+RMHSIM_FLOW_GET(RMH_PQoSFlow_GetDSCPMoCA,                   uint32_t,               flow->dscpMoCA)
+RMHSIM_FLOW_GET(RMH_PQoSFlow_GetDFID,                       uint32_t,               flow->dfid)
+
+RMH_Result SoC_IMPL__RMH_PQoSFlow_GetLeaseTimeRemaining(const RMH_Handle handle, const RMH_MacAddress_t flowId, uint32_t* response) {
+    struct timespec now;
+    const RMHSim_Flow *flow;
+    int32_t flowIndex;
+    uint32_t age;
+    RMHSIM_ENTER(handle, RMH_PQoSFlow_GetLeaseTimeRemaining);
+    if (!response) RMHSIM_EXIT(handle, RMH_INVALID_PARAM);
+    if (!pRMHSim_IsLinkUp(handle)) RMHSIM_EXIT(handle, RMH_INVALID_NETWORK_STATE);
+    flowIndex=pRMHSim_FindFlow(handle, flowId);
+    if (flowIndex < 0) RMHSIM_EXIT(handle, RMH_INVALID_ID);
+    flow=&handle->flows[flowIndex];
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    age=(uint32_t)(now.tv_sec - flow->created.tv_sec);
+    /* A lease time of 0 means the flow never expires */
+    *response=(flow->leaseTime == 0) ? 0 : (age < flow->leaseTime) ? flow->leaseTime - age : 0;
+    RMHSIM_EXIT(handle, RMH_SUCCESS);
+}
+
+#define RMHSIM_FLOW_GET_MAC(API_NAME, FIELD) \
+RMH_Result SoC_IMPL__##API_NAME(const RMH_Handle handle, const RMH_MacAddress_t flowId, RMH_MacAddress_t* response) { \
+    int32_t flowIndex; \
+    RMHSIM_ENTER(handle, API_NAME); \
+    if (!response) RMHSIM_EXIT(handle, RMH_INVALID_PARAM); \
+    if (!pRMHSim_IsLinkUp(handle)) RMHSIM_EXIT(handle, RMH_INVALID_NETWORK_STATE); \
+    flowIndex=pRMHSim_FindFlow(handle, flowId); \
+    if (flowIndex < 0) RMHSIM_EXIT(handle, RMH_INVALID_ID); \
+    memcpy(*response, handle->flows[flowIndex].FIELD, sizeof(*response)); \
+    RMHSIM_EXIT(handle, RMH_SUCCESS); \
+}
+RMHSIM_FLOW_GET_MAC(RMH_PQoSFlow_GetDestination,            flowId)
+RMHSIM_FLOW_GET_MAC(RMH_PQoSFlow_GetIngressMac,             ingressMac)
+RMHSIM_FLOW_GET_MAC(RMH_PQoSFlow_GetEgressMac,              egressMac)
+
+RMH_Result SoC_IMPL__RMH_PQoS_GetIngressFlowIds(const RMH_Handle handle, RMH_MacAddress_t* responseArray, const size_t responseArraySize, size_t* responseArrayUsed) {
+    uint32_t i;
+    RMHSIM_ENTER(handle, RMH_PQoS_GetIngressFlowIds);
+    if (!responseArray || !responseArrayUsed) RMHSIM_EXIT(handle, RMH_INVALID_PARAM);
+    if (!pRMHSim_IsLinkUp(handle)) RMHSIM_EXIT(handle, RMH_INVALID_NETWORK_STATE);
+    for (i=0; i < handle->numFlows && i < responseArraySize; i++) {
+        memcpy(responseArray[i], handle->flows[i].flowId, sizeof(responseArray[i]));
+    }
+    *responseArrayUsed=i;
+    RMHSIM_EXIT(handle, (i < handle->numFlows) ? RMH_INSUFFICIENT_SPACE : RMH_SUCCESS);
+}
+
+
+
+/**********************************************************************************************************************
+Stats. These are 32 bit counters, like most SoCs, so they wrap on a long running or heavily loaded network.
+**********************************************************************************************************************/
+RMHSIM_GET(RMH_Stats_GetAdmissionAttempts,                  uint32_t,               handle->counters.admissionAttempts)
+RMHSIM_GET(RMH_Stats_GetAdmissionFailures,                  uint32_t,               handle->counters.admissionFailures)
+RMHSIM_GET(RMH_Stats_GetAdmissionSucceeded,                 uint32_t,               handle->counters.admissionSucceeded)
+RMHSIM_GET(RMH_Stats_GetAdmissionsDeniedAsNC,               uint32_t,               0)
+RMHSIM_GET(RMH_Stats_GetAdmissionsFailedNoResponse,         uint32_t,               0)
+RMHSIM_GET(RMH_Stats_GetAdmissionsFailedChannelUnusable,    uint32_t,               0)
+RMHSIM_GET(RMH_Stats_GetAdmissionsFailedT2Timeout,          uint32_t,               0)
+RMHSIM_GET(RMH_Stats_GetAdmissionsFailedResyncLoss,         uint32_t,               0)
+RMHSIM_GET(RMH_Stats_GetAdmissionsFailedPrivacyFullBlacklist, uint32_t,             0)
+RMHSIM_GET(RMH_Stats_GetTxTotalBytes,                       uint32_t,               (uint32_t)handle->counters.txBytes)
+RMHSIM_GET(RMH_Stats_GetRxTotalBytes,                       uint32_t,               (uint32_t)handle->counters.rxBytes)
+RMHSIM_GET(RMH_Stats_GetTxTotalPackets,                     uint32_t,               (uint32_t)(handle->counters.txUnicastPackets + handle->counters.txBroadcastPackets + handle->counters.txMulticastPackets))
+RMHSIM_GET(RMH_Stats_GetRxTotalPackets,                     uint32_t,               (uint32_t)(handle->counters.rxUnicastPackets + handle->counters.rxBroadcastPackets + handle->counters.rxMulticastPackets))
+RMHSIM_GET(RMH_Stats_GetTxUnicastPackets,                   uint32_t,               (uint32_t)handle->counters.txUnicastPackets)
+RMHSIM_GET(RMH_Stats_GetRxUnicastPackets,                   uint32_t,               (uint32_t)handle->counters.rxUnicastPackets)
+RMHSIM_GET(RMH_Stats_GetTxBroadcastPackets,                 uint32_t,               (uint32_t)handle->counters.txBroadcastPackets)
+RMHSIM_GET(RMH_Stats_GetRxBroadcastPackets,                 uint32_t,               (uint32_t)handle->counters.rxBroadcastPackets)
+RMHSIM_GET(RMH_Stats_GetTxMulticastPackets,                 uint32_t,               (uint32_t)handle->counters.txMulticastPackets)
+RMHSIM_GET(RMH_Stats_GetRxMulticastPackets,                 uint32_t,               (uint32_t)handle->counters.rxMulticastPackets)
+RMHSIM_GET(RMH_Stats_GetTxReservationRequestPackets,        uint32_t,               (uint32_t)handle->counters.txReservationRequestPackets)
+RMHSIM_GET(RMH_Stats_GetRxReservationRequestPackets,        uint32_t,               (uint32_t)handle->counters.rxReservationRequestPackets)
+RMHSIM_GET(RMH_Stats_GetTxMapPackets,                       uint32_t,               (uint32_t)handle->counters.txMapPackets)
+RMHSIM_GET(RMH_Stats_GetRxMapPackets,                       uint32_t,               (uint32_t)handle->counters.rxMapPackets)
+RMHSIM_GET(RMH_Stats_GetTxLinkControlPackets,               uint32_t,               (uint32_t)handle->counters.txLinkControlPackets)
+RMHSIM_GET(RMH_Stats_GetRxLinkControlPackets,               uint32_t,               (uint32_t)handle->counters.rxLinkControlPackets)
+RMHSIM_GET(RMH_Stats_GetTxBeacons,                          uint32_t,               (uint32_t)handle->counters.txBeacons)
+RMHSIM_GET(RMH_Stats_GetRxBeacons,                          uint32_t,               (uint32_t)handle->counters.rxBeacons)
+RMHSIM_GET(RMH_Stats_GetRxUnknownProtocolPackets,           uint32_t,               0)
+RMHSIM_GET(RMH_Stats_GetTxDroppedPackets,                   uint32_t,               0)
+RMHSIM_GET(RMH_Stats_GetRxDroppedPackets,                   uint32_t,               pRMHSim_SumNodes(handle->counters.rxUncorrectedErrors))
+RMHSIM_GET(RMH_Stats_GetTxTotalErrors,                      uint32_t,               0)
+RMHSIM_GET(RMH_Stats_GetRxTotalErrors,                      uint32_t,               pRMHSim_SumNodes(handle->counters.rxCorrectedErrors) + pRMHSim_SumNodes(handle->counters.rxUncorrectedErrors))
+RMHSIM_GET(RMH_Stats_GetRxCRCErrors,                        uint32_t,               pRMHSim_SumNodes(handle->counters.rxUncorrectedErrors))
+RMHSIM_GET(RMH_Stats_GetRxTimeoutErrors,                    uint32_t,               0)
+RMHSIM_GET(RMH_Stats_GetRxTotalAggregatedPackets,           uint32_t,               (uint32_t)(handle->counters.rxUnicastPackets / 4))
+RMHSIM_GET(RMH_Stats_GetTxTotalAggregatedPackets,           uint32_t,               (uint32_t)(handle->counters.txUnicastPackets / 4))
+
+/* Spread the unicast packets over the aggregation bins with the most in the middle */
+static
+RMH_Result pRMHSim_GetAggregation(const uint64_t packets, uint32_t* responseArray, const size_t responseArraySize, size_t* responseArrayUsed) {
+    static const uint32_t percent[RMHSIM_NUM_AGGREGATION_BINS] = { 5, 10, 15, 20, 20, 10, 8, 6, 4, 2 };
+    uint32_t i;
+
+    if (!responseArray || !responseArrayUsed) {
+        return RMH_INVALID_PARAM;
+    }
+    for (i=0; i < RMHSIM_NUM_AGGREGATION_BINS && i < responseArraySize; i++) {
+        responseArray[i]=(uint32_t)((packets * percent[i]) / 100);
+    }
+    *responseArrayUsed=i;
+    return (i < RMHSIM_NUM_AGGREGATION_BINS) ? RMH_INSUFFICIENT_SPACE : RMH_SUCCESS;
+}
+
+RMH_Result SoC_IMPL__RMH_Stats_GetRxPacketAggregation(const RMH_Handle handle, uint32_t* responseArray, const size_t responseArraySize, size_t* responseArrayUsed) {
+    RMHSIM_ENTER(handle, RMH_Stats_GetRxPacketAggregation);
+    RMHSIM_EXIT(handle, pRMHSim_GetAggregation(handle->counters.rxUnicastPackets, responseArray, responseArraySize, responseArrayUsed));
+}
+
+RMH_Result SoC_IMPL__RMH_Stats_GetTxPacketAggregation(const RMH_Handle handle, uint32_t* responseArray, const size_t responseArraySize, size_t* responseArrayUsed) {
+    RMHSIM_ENTER(handle, RMH_Stats_GetTxPacketAggregation);
+    RMHSIM_EXIT(handle, pRMHSim_GetAggregation(handle->counters.txUnicastPackets, responseArray, responseArraySize, responseArrayUsed));
+}
+
+#define RMHSIM_STATS_NODE_LIST(API_NAME, COUNTER) \
+RMH_Result SoC_IMPL__##API_NAME(const RMH_Handle handle, RMH_NodeList_Uint32_t* response) { \
+    uint32_t i; \
+    RMHSIM_ENTER(handle, API_NAME); \
+    if (!response) RMHSIM_EXIT(handle, RMH_INVALID_PARAM); \
+    memset(response, 0, sizeof(*response)); \
+    for (i=0; i < RMH_MAX_MOCA_NODES; i++) { \
+        response->nodePresent[i]=handle->nodes[i].present && i != handle->selfNodeId; \
+        response->nodeValue[i]=(uint32_t)handle->counters.COUNTER[i]; \
+    } \
+    RMHSIM_EXIT(handle, RMH_SUCCESS); \
+}
+RMHSIM_STATS_NODE_LIST(RMH_Stats_GetRxCorrectedErrors,      rxCorrectedErrors)
+RMHSIM_STATS_NODE_LIST(RMH_Stats_GetRxUncorrectedErrors,    rxUncorrectedErrors)
+
+RMH_Result SoC_IMPL__RMH_Stats_Reset(const RMH_Handle handle) {
+    RMHSIM_ENTER(handle, RMH_Stats_Reset);
+    memset(&handle->counters, 0, sizeof(handle->counters));
+    RMHSIM_EXIT(handle, RMH_SUCCESS);
+}
+
+
+
+/**********************************************************************************************************************
+Log
+**********************************************************************************************************************/
+RMHSIM_GET(RMH_Log_GetDriverLevel,                          RMH_LogLevel,           handle->driverLogLevel)
+RMHSIM_SET(RMH_Log_SetDriverLevel,                          RMH_LogLevel,           driverLogLevel)
+
+RMH_Result SoC_IMPL__RMH_Log_GetAPILevel(const RMH_Handle handle, uint32_t* response) {
+    RMHSIM_ENTER(handle, RMH_Log_GetAPILevel);
+    RMHSIM_EXIT(handle, RMH_SUCCESS);
+}
+
+RMH_Result SoC_IMPL__RMH_Log_SetAPILevel(const RMH_Handle handle, const uint32_t value) {
+    RMHSIM_ENTER(handle, RMH_Log_SetAPILevel);
+    RMHSIM_EXIT(handle, RMH_SUCCESS);
+}
+
+RMH_Result SoC_IMPL__RMH_Log_GetDriverFilename(const RMH_Handle handle, char* responseBuf, const size_t responseBufSize) {
+    RMHSIM_ENTER(handle, RMH_Log_GetDriverFilename);
+    RMHSIM_EXIT(handle, pRMHSim_GetString(handle->driverLogFilename, responseBuf, responseBufSize));
+}
+
+RMH_Result SoC_IMPL__RMH_Log_SetDriverFilename(const RMH_Handle handle, const char* value) {
+    RMHSIM_ENTER(handle, RMH_Log_SetDriverFilename);
+    if (!value || strlen(value) >= sizeof(handle->driverLogFilename)) RMHSIM_EXIT(handle, RMH_INVALID_PARAM);
+    strcpy(handle->driverLogFilename, value);
+    RMHSIM_EXIT(handle, RMH_SUCCESS);
+}
+
+
+
+/**********************************************************************************************************************
+ACA. Requests complete immediately.
+**********************************************************************************************************************/
+RMHSIM_GET(RMH_ACA_GetChannel,                              uint32_t,               handle->acaChannel)
+RMHSIM_GET(RMH_ACA_GetSourceNodeId,                         uint32_t,               handle->acaSourceNodeId)
+RMHSIM_GET(RMH_ACA_GetDestinationNodeMask,                  uint32_t,               handle->acaDestinationNodeMask)
+RMHSIM_GET(RMH_ACA_GetType,                                 RMH_ACAType,            handle->acaType)
+RMHSIM_GET(RMH_ACA_GetStatus,                               RMH_ACAStatus,          handle->acaStatus)
+RMHSIM_GET(RMH_ACA_GetTotalRxPower,                         int32_t,                (handle->acaStatus == RMH_ACA_STATUS_SUCCESS) ? -30 : 0)
+
+RMH_Result SoC_IMPL__RMH_ACA_Request(const RMH_Handle handle, const uint32_t channelNum, const uint32_t sourceNodeId, const uint32_t destinationNodeMask, const RMH_ACAType type) {
+    RMHSIM_ENTER(handle, RMH_ACA_Request);
+    if (!pRMHSim_IsLinkUp(handle)) RMHSIM_EXIT(handle, RMH_INVALID_NETWORK_STATE);
+    if (sourceNodeId >= RMH_MAX_MOCA_NODES || !handle->nodes[sourceNodeId].present) RMHSIM_EXIT(handle, RMH_INVALID_ID);
+    handle->acaChannel=channelNum;
+    handle->acaSourceNodeId=sourceNodeId;
+    handle->acaDestinationNodeMask=destinationNodeMask;
+    handle->acaType=type;
+    handle->acaStatus=RMH_ACA_STATUS_SUCCESS;
+    RMHSIM_EXIT(handle, RMH_SUCCESS);
+}
+
+RMH_Result SoC_IMPL__RMH_ACA_GetPowerProfile(const RMH_Handle handle, uint8_t* responseArray, const size_t responseArraySize, size_t* responseArrayUsed) {
+    uint32_t i;
+    RMHSIM_ENTER(handle, RMH_ACA_GetPowerProfile);
+    if (!responseArray || !responseArrayUsed) RMHSIM_EXIT(handle, RMH_INVALID_PARAM);
+    if (handle->acaStatus != RMH_ACA_STATUS_SUCCESS) RMHSIM_EXIT(handle, RMH_INVALID_INTERNAL_STATE);
+    for (i=0; i < RMHSIM_NUM_SUBCARRIERS && i < responseArraySize; i++) {
+        /* A gentle tilt across the channel */
+        responseArray[i]=(uint8_t)(200 - (i * 40) / RMHSIM_NUM_SUBCARRIERS);
+    }
+    *responseArrayUsed=i;
+    RMHSIM_EXIT(handle, (i < RMHSIM_NUM_SUBCARRIERS) ? RMH_INSUFFICIENT_SPACE : RMH_SUCCESS);
+}